@@ -0,0 +1,155 @@
+#include "BenchmarkReport.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <stdexcept>
+
+using namespace std;
+
+namespace satp::bench {
+    namespace {
+        [[nodiscard]] string jsonString(const string &value) {
+            string out = "\"";
+            for (const char c : value) {
+                if (c == '"' || c == '\\') out += '\\';
+                out += c;
+            }
+            return out + '"';
+        }
+
+        // Posizione subito dopo i due punti della chiave `key` cercata da `from`.
+        [[nodiscard]] size_t findValue(const string &json, const string &key, const size_t from) {
+            const string quoted = "\"" + key + "\"";
+            const size_t pos = json.find(quoted, from);
+            if (pos == string::npos) return string::npos;
+            const size_t colon = json.find(':', pos + quoted.size());
+            if (colon == string::npos) throw runtime_error("Malformed benchmark baseline: missing ':' after " + quoted);
+            return colon + 1u;
+        }
+
+        [[nodiscard]] string parseString(const string &json, size_t pos) {
+            pos = json.find('"', pos);
+            if (pos == string::npos) throw runtime_error("Malformed benchmark baseline: expected a string");
+            string out;
+            for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+                if (json[pos] == '\\' && pos + 1u < json.size()) ++pos;
+                out += json[pos];
+            }
+            if (pos >= json.size()) throw runtime_error("Malformed benchmark baseline: unterminated string");
+            return out;
+        }
+    } // namespace
+
+    void writeJsonReport(const filesystem::path &path,
+                         const vector<BenchmarkResult> &results,
+                         const BenchmarkOptions &options) {
+        ofstream out(path);
+        if (!out) throw runtime_error("Cannot open benchmark report: " + path.string());
+
+        out << setprecision(10);
+        out << "{\n"
+            << "  \"format\": \"satp_bench/1\",\n"
+            << "  \"repetitions\": " << options.repetitions << ",\n"
+            << "  \"min_time_ms\": " << options.minTime.count() << ",\n"
+            << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto &result = results[i];
+            out << (i == 0u ? "\n" : ",\n")
+                << "    {\"name\": " << jsonString(result.name)
+                << ", \"ns_per_op\": " << result.nsPerOp
+                << ", \"ns_per_op_variance\": " << result.nsPerOpVariance
+                << ", \"ns_per_op_stddev\": " << result.nsPerOpStddev()
+                << ", \"ns_per_op_min\": " << result.nsPerOpMin
+                << ", \"mops_per_s\": " << result.mopsPerSecond()
+                << ", \"iterations\": " << result.iterations
+                << ", \"repetitions\": " << result.repetitions;
+            if (result.counters.any()) {
+                using profiling::HardwareCounter;
+                out << ", \"ipc\": " << result.counters.ipc()
+                    << ", \"cycles_per_op\": " << result.perOp(HardwareCounter::Cycles)
+                    << ", \"instructions_per_op\": " << result.perOp(HardwareCounter::Instructions)
+                    << ", \"l1d_misses_per_op\": " << result.perOp(HardwareCounter::L1dMisses)
+                    << ", \"llc_misses_per_op\": " << result.perOp(HardwareCounter::LlcMisses)
+                    << ", \"branch_misses_per_op\": " << result.perOp(HardwareCounter::BranchMisses);
+            }
+            out << '}';
+        }
+        out << "\n  ]\n}\n";
+        if (!out) throw runtime_error("Cannot write benchmark report: " + path.string());
+    }
+
+    vector<BaselineEntry> readBaseline(const filesystem::path &path) {
+        ifstream in(path);
+        if (!in) throw runtime_error("Cannot open benchmark baseline: " + path.string());
+        const string json{istreambuf_iterator<char>(in), istreambuf_iterator<char>()};
+
+        vector<BaselineEntry> entries;
+        size_t pos = findValue(json, "name", 0u);
+        while (pos != string::npos) {
+            BaselineEntry entry;
+            entry.name = parseString(json, pos);
+            const size_t next = findValue(json, "name", pos);
+            const size_t value = findValue(json, "ns_per_op", pos);
+            if (value == string::npos || (next != string::npos && value > next)) {
+                throw runtime_error("Malformed benchmark baseline: no ns_per_op for " + entry.name);
+            }
+            char *end = nullptr;
+            entry.nsPerOp = strtod(json.c_str() + value, &end);
+            if (end == json.c_str() + value) {
+                throw runtime_error("Malformed benchmark baseline: invalid ns_per_op for " + entry.name);
+            }
+            entries.push_back(std::move(entry));
+            pos = next;
+        }
+        return entries;
+    }
+
+    vector<BenchmarkComparison> compareWithBaseline(const vector<BenchmarkResult> &results,
+                                                    const vector<BaselineEntry> &baseline,
+                                                    const double threshold) {
+        vector<BenchmarkComparison> comparisons;
+        for (const auto &result : results) {
+            for (const auto &entry : baseline) {
+                if (entry.name != result.name || !(entry.nsPerOp > 0.0)) continue;
+                const double delta = result.nsPerOp / entry.nsPerOp - 1.0;
+                comparisons.push_back({result.name, entry.nsPerOp, result.nsPerOp, delta, delta > threshold});
+                break;
+            }
+        }
+        return comparisons;
+    }
+
+    void printResult(ostream &out, const BenchmarkResult &result) {
+        const double cv = (result.nsPerOp > 0.0) ? 100.0 * result.nsPerOpStddev() / result.nsPerOp : 0.0;
+        out << left << setw(44) << result.name << right << fixed
+            << setprecision(3) << setw(12) << result.nsPerOp << " ns/op"
+            << setprecision(2) << "  +-" << setw(5) << cv << '%'
+            << setprecision(3) << setw(12) << result.mopsPerSecond() << " Mops/s"
+            << "  iters=" << result.iterations;
+        if (result.counters.any()) {
+            using profiling::HardwareCounter;
+            out << setprecision(2) << "  ipc=" << result.counters.ipc()
+                << "  cyc/op=" << result.perOp(HardwareCounter::Cycles)
+                << "  l1d/op=" << result.perOp(HardwareCounter::L1dMisses)
+                << "  llc/op=" << result.perOp(HardwareCounter::LlcMisses)
+                << "  br/op=" << result.perOp(HardwareCounter::BranchMisses);
+        }
+        out << '\n' << defaultfloat;
+    }
+
+    void printComparison(ostream &out, const vector<BenchmarkComparison> &comparisons, const double threshold) {
+        size_t regressions = 0;
+        out << "\nbaseline comparison (threshold +" << fixed << setprecision(1) << 100.0 * threshold << "%)\n";
+        for (const auto &comparison : comparisons) {
+            out << left << setw(44) << comparison.name << right
+                << setprecision(3) << setw(12) << comparison.baselineNsPerOp << " -> "
+                << setw(12) << comparison.currentNsPerOp << " ns/op"
+                << showpos << setprecision(1) << setw(9) << 100.0 * comparison.delta << '%' << noshowpos
+                << (comparison.regression ? "  REGRESSION" : "") << '\n';
+            if (comparison.regression) ++regressions;
+        }
+        out << defaultfloat << regressions << " regression(s) over " << comparisons.size() << " compared case(s)\n";
+    }
+} // namespace satp::bench
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkRunner.h"
+
+using namespace std;
+
+namespace satp::bench {
+    struct BaselineEntry {
+        string name;
+        double nsPerOp = 0.0;
+    };
+
+    struct BenchmarkComparison {
+        string name;
+        double baselineNsPerOp = 0.0;
+        double currentNsPerOp = 0.0;
+        double delta = 0.0; // current / baseline - 1: positivo = piu' lento
+        bool regression = false;
+    };
+
+    // Report JSON: un oggetto per caso con ns/op (media, varianza, stddev,
+    // minimo), Mops/s e iterazioni. Lo stesso file fa da baseline.
+    void writeJsonReport(const filesystem::path &path,
+                         const vector<BenchmarkResult> &results,
+                         const BenchmarkOptions &options);
+
+    // Legge nome e ns_per_op dei casi di un report scritto da writeJsonReport.
+    [[nodiscard]] vector<BaselineEntry> readBaseline(const filesystem::path &path);
+
+    // Confronta i casi presenti in entrambi: e' una regressione un rallentamento
+    // della media oltre `threshold` (0.10 = +10%).
+    [[nodiscard]] vector<BenchmarkComparison> compareWithBaseline(const vector<BenchmarkResult> &results,
+                                                                  const vector<BaselineEntry> &baseline,
+                                                                  double threshold);
+
+    void printResult(ostream &out, const BenchmarkResult &result);
+
+    void printComparison(ostream &out, const vector<BenchmarkComparison> &comparisons, double threshold);
+} // namespace satp::bench
@@ -0,0 +1,100 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace satp::bench {
+    double BenchmarkResult::nsPerOpStddev() const {
+        return sqrt(nsPerOpVariance);
+    }
+
+    double BenchmarkResult::mopsPerSecond() const {
+        return (nsPerOp > 0.0) ? 1'000.0 / nsPerOp : 0.0;
+    }
+
+    double BenchmarkResult::perOp(const profiling::HardwareCounter counter) const {
+        if (!counters.has(counter) || !(countedOps > 0.0)) return 0.0;
+        return static_cast<double>(counters.get(counter)) / countedOps;
+    }
+
+    namespace {
+        // Attiva i contatori per i timeLoop del thread finche' e' in vita.
+        class ActiveLoopCounters {
+        public:
+            explicit ActiveLoopCounters(detail::LoopCounters &counters) noexcept {
+                detail::activeLoopCounters = &counters;
+            }
+
+            ~ActiveLoopCounters() {
+                detail::activeLoopCounters = nullptr;
+            }
+
+            ActiveLoopCounters(const ActiveLoopCounters &) = delete;
+            ActiveLoopCounters &operator=(const ActiveLoopCounters &) = delete;
+        };
+    } // namespace
+
+    BenchmarkResult runBenchmark(const BenchmarkCase &benchmark, const BenchmarkOptions &options) {
+        if (!benchmark.body || benchmark.opsPerIteration == 0u) {
+            throw invalid_argument("Benchmark '" + benchmark.name + "' requires a body and opsPerIteration > 0");
+        }
+        if (options.repetitions == 0u) {
+            throw invalid_argument("Benchmark repetitions must be > 0");
+        }
+
+        constexpr size_t MAX_ITERATIONS = size_t{1} << 40u;
+        const auto minTime = chrono::duration_cast<chrono::nanoseconds>(options.minTime);
+        size_t iterations = 1;
+        while (true) {
+            const auto elapsed = benchmark.body(iterations);
+            if (elapsed >= minTime || iterations >= MAX_ITERATIONS) break;
+            // Stima lineare con margine del 20%, almeno raddoppiando.
+            const double scale = (elapsed.count() > 0)
+                                     ? 1.2 * static_cast<double>(minTime.count()) / static_cast<double>(elapsed.count())
+                                     : 10.0;
+            const double next = ceil(static_cast<double>(iterations) * clamp(scale, 2.0, 100.0));
+            iterations = min(MAX_ITERATIONS, static_cast<size_t>(next));
+        }
+
+        const double ops = static_cast<double>(iterations) * static_cast<double>(benchmark.opsPerIteration);
+        vector<double> samples;
+        samples.reserve(options.repetitions);
+        optional<profiling::PerfCounters> perf;
+        optional<detail::LoopCounters> loopCounters;
+        if (options.hardwareCounters) {
+            perf.emplace();
+            loopCounters.emplace(detail::LoopCounters{*perf, {}});
+        }
+        {
+            optional<ActiveLoopCounters> active;
+            if (loopCounters.has_value()) active.emplace(*loopCounters);
+            for (size_t r = 0; r < options.repetitions; ++r) {
+                samples.push_back(static_cast<double>(benchmark.body(iterations).count()) / ops);
+            }
+        }
+
+        BenchmarkResult result;
+        if (loopCounters.has_value()) {
+            result.counters = loopCounters->counted;
+            result.countedOps = ops * static_cast<double>(options.repetitions);
+        }
+        result.name = benchmark.name;
+        result.iterations = iterations;
+        result.repetitions = samples.size();
+        double sum = 0.0;
+        for (const double sample : samples) sum += sample;
+        result.nsPerOp = sum / static_cast<double>(samples.size());
+        if (samples.size() > 1u) {
+            double squares = 0.0;
+            for (const double sample : samples) squares += (sample - result.nsPerOp) * (sample - result.nsPerOp);
+            result.nsPerOpVariance = squares / static_cast<double>(samples.size() - 1u);
+        }
+        result.nsPerOpMin = ranges::min(samples);
+        return result;
+    }
+} // namespace satp::bench
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "satp/profiling/PerfCounters.h"
+
+using namespace std;
+
+namespace satp::bench {
+    // Impedisce al compilatore di scartare un risultato calcolato nel ciclo misurato.
+    template<typename T>
+    inline void doNotOptimize(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Un caso esegue `iterations` volte la propria operazione e restituisce il
+    // tempo misurato: i casi con una preparazione costosa per iterazione
+    // cronometrano solo la parte che interessa.
+    using BenchmarkBody = function<chrono::nanoseconds(size_t iterations)>;
+
+    struct BenchmarkCase {
+        string name;                // operazione/algoritmo/parametri, es. "process/hll/k=14"
+        size_t opsPerIteration = 1; // operazioni elementari per iterazione: ns/op e Mops/s sono per operazione
+        BenchmarkBody body;
+    };
+
+    struct BenchmarkOptions {
+        size_t repetitions = 10;
+        chrono::milliseconds minTime{20}; // tempo misurato minimo di ogni ripetizione
+        string filter;                    // sottostringa del nome; vuoto = tutti i casi
+        bool hardwareCounters = false;    // contatori hardware attorno ai cicli misurati
+    };
+
+    struct BenchmarkResult {
+        string name;
+        size_t iterations = 0;        // iterazioni di ogni ripetizione
+        size_t repetitions = 0;
+        double nsPerOp = 0.0;         // media tra le ripetizioni
+        double nsPerOpVariance = 0.0; // varianza campionaria tra le ripetizioni
+        double nsPerOpMin = 0.0;
+        // Contatori sommati sulle ripetizioni (non sulla calibrazione) per countedOps operazioni.
+        profiling::CounterValues counters;
+        double countedOps = 0.0;
+
+        [[nodiscard]] double nsPerOpStddev() const;
+
+        [[nodiscard]] double mopsPerSecond() const;
+
+        // Conteggio per operazione; 0 se il contatore non e' misurato.
+        [[nodiscard]] double perOp(profiling::HardwareCounter counter) const;
+    };
+
+    namespace detail {
+        // Contatori delle sezioni cronometrate del caso in esecuzione sul thread.
+        struct LoopCounters {
+            const profiling::PerfCounters &source;
+            profiling::CounterValues counted;
+        };
+
+        inline thread_local LoopCounters *activeLoopCounters = nullptr;
+    } // namespace detail
+
+    // Cronometra `iterations` chiamate di `op`; con i contatori attivi somma
+    // anche cicli, istruzioni e miss del solo ciclo, esclusa la preparazione.
+    template<typename Op>
+    [[nodiscard]] chrono::nanoseconds timeLoop(const size_t iterations, Op &&op) {
+        detail::LoopCounters *counters = detail::activeLoopCounters;
+        const auto before = (counters != nullptr) ? counters->source.read() : profiling::CounterValues{};
+        const auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            op();
+        }
+        const auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        if (counters != nullptr) counters->counted += counters->source.read() - before;
+        return elapsed;
+    }
+
+    // Calibra le iterazioni finche' una ripetizione dura almeno minTime (la
+    // calibrazione fa anche da warm-up), poi misura `repetitions` ripetizioni.
+    [[nodiscard]] BenchmarkResult runBenchmark(const BenchmarkCase &benchmark, const BenchmarkOptions &options);
+} // namespace satp::bench
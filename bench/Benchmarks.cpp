@@ -0,0 +1,245 @@
+#include "Benchmarks.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "satp/algorithms/HyperLogLog.h"
+#include "satp/algorithms/HyperLogLogPlusPlus.h"
+#include "satp/algorithms/LogLog.h"
+#include "satp/algorithms/NaiveCounting.h"
+#include "satp/algorithms/ProbabilisticCounting.h"
+#include "satp/dataset/Dataset.h"
+#include "satp/hashing/HashFactory.h"
+
+using namespace std;
+
+namespace satp::bench {
+    namespace {
+        namespace alg = satp::algorithms;
+
+        constexpr size_t POOL_SIZE = size_t{1} << 20u; // potenza di 2: l'indice ciclico e' una maschera
+        constexpr uint32_t POOL_SEED = 5489u;
+
+        using ValuePool = shared_ptr<const vector<uint32_t>>;
+
+        [[nodiscard]] ValuePool makeValuePool() {
+            mt19937 rng(POOL_SEED);
+            auto values = make_shared<vector<uint32_t>>(POOL_SIZE);
+            for (auto &value : *values) value = static_cast<uint32_t>(rng());
+            return values;
+        }
+
+        template<typename Algo>
+        void ingest(Algo &sketch, const vector<uint32_t> &values, const size_t first, const size_t count) {
+            for (size_t i = first; i < first + count; ++i) sketch.process(values[i & (POOL_SIZE - 1u)]);
+        }
+
+        [[nodiscard]] BenchmarkCase hashCase(const string &hashName) {
+            return {"hash64/" + hashName, 1u, [hashName](const size_t iterations) {
+                const auto hash = hashing::getHashFunctionBy(hashName, 0u);
+                uint64_t value = 0;
+                return timeLoop(iterations, [&] { doNotOptimize(hash->hash64(value++)); });
+            }};
+        }
+
+        // op = process di un valore del pool, ciclando da uno sketch vuoto.
+        template<typename Make>
+        [[nodiscard]] BenchmarkCase processCase(string name, ValuePool pool, Make make) {
+            return {"process/" + std::move(name), 1u, [pool, make](const size_t iterations) {
+                const auto hash = hashing::getHashFunctionBy();
+                auto sketch = make(*hash);
+                const auto &values = *pool;
+                size_t next = 0;
+                return timeLoop(iterations, [&] {
+                    sketch.process(values[next]);
+                    next = (next + 1u) & (POOL_SIZE - 1u);
+                });
+            }};
+        }
+
+        // op = count() su uno sketch con `elements` valori distinti.
+        template<typename Make>
+        [[nodiscard]] BenchmarkCase countCase(string name, ValuePool pool, const size_t elements, Make make) {
+            return {"count/" + std::move(name), 1u, [pool, elements, make](const size_t iterations) {
+                const auto hash = hashing::getHashFunctionBy();
+                auto sketch = make(*hash);
+                ingest(sketch, *pool, 0u, elements);
+                return timeLoop(iterations, [&] { doNotOptimize(sketch.count()); });
+            }};
+        }
+
+        // op = merge di uno sketch con `elements` valori in uno con altri `elements`.
+        template<typename Make>
+        [[nodiscard]] BenchmarkCase mergeCase(string name, ValuePool pool, const size_t elements, Make make) {
+            return {"merge/" + std::move(name), 1u, [pool, elements, make](const size_t iterations) {
+                const auto hash = hashing::getHashFunctionBy();
+                auto target = make(*hash);
+                auto source = make(*hash);
+                ingest(target, *pool, 0u, elements);
+                ingest(source, *pool, elements, elements);
+                return timeLoop(iterations, [&] { target.merge(source); });
+            }};
+        }
+
+        [[nodiscard]] BenchmarkCase reducedToCase(ValuePool pool, const uint32_t precision, const uint32_t target) {
+            const string name = "reducedTo/hllpp/p=" + to_string(precision) + "->" + to_string(target);
+            return {name, 1u, [pool, precision, target](const size_t iterations) {
+                const auto hash = hashing::getHashFunctionBy();
+                alg::HyperLogLogPlusPlus sketch(precision, *hash);
+                ingest(sketch, *pool, 0u, POOL_SIZE);
+                return timeLoop(iterations, [&] {
+                    const auto reduced = sketch.reducedTo(target);
+                    doNotOptimize(&reduced);
+                });
+            }};
+        }
+
+        // Hash con indice sparse (i 25 bit alti) diverso per ogni i < 2^25:
+        // ogni addHash aggiunge esattamente un indice al buffer temporaneo.
+        [[nodiscard]] uint64_t distinctSparseHash(const uint64_t i) {
+            constexpr uint64_t SPARSE_MASK = (uint64_t{1} << 25u) - 1u;
+            const uint64_t sparseIdx = (i * 2'654'435'761u) & SPARSE_MASK; // moltiplicatore dispari: biiezione mod 2^25
+            uint64_t low = i + 0x9E3779B97F4A7C15ull;
+            low = (low ^ (low >> 30u)) * 0xBF58476D1CE4E5B9ull;
+            low = (low ^ (low >> 27u)) * 0x94D049BB133111EBull;
+            return (sparseIdx << 39u) | ((low ^ (low >> 31u)) >> 25u);
+        }
+
+        // op = un flush del buffer temporaneo (TMP_SET_FLUSH_SIZE indici) in una
+        // lista sparse di `listEntries` indici. Il riempimento non e' cronometrato:
+        // si misura solo l'inserimento che fa scattare il flush.
+        [[nodiscard]] BenchmarkCase flushCase(const uint32_t precision, const size_t listEntries) {
+            constexpr size_t FLUSH = alg::HyperLogLogPlusPlus::TMP_SET_FLUSH_SIZE;
+            const string name = "flush_tmp_set/hllpp/p=" + to_string(precision) + ",list=" + to_string(listEntries);
+            return {name, 1u, [precision, listEntries](const size_t iterations) {
+                const auto hash = hashing::getHashFunctionBy();
+                alg::HyperLogLogPlusPlus sketch(precision, *hash);
+                const size_t last = listEntries + FLUSH - 1u;
+                chrono::nanoseconds total{0};
+                for (size_t it = 0; it < iterations; ++it) {
+                    sketch.reset();
+                    for (size_t i = 0; i < last; ++i) sketch.addHash(distinctSparseHash(i));
+                    total += timeLoop(1u, [&] { sketch.addHash(distinctSparseHash(last)); });
+                }
+                return total;
+            }};
+        }
+
+        // Dataset temporaneo con una partizione di POOL_SIZE valori, rimosso
+        // quando il catalogo viene distrutto.
+        class DecodeFixture {
+        public:
+            explicit DecodeFixture(const vector<uint32_t> &values)
+                : path_(filesystem::temp_directory_path() / "satp_bench_decode.bin") {
+                dataset::DatasetInfo info;
+                info.elements_per_partition = values.size();
+                info.partition_count = 1;
+                info.seed = POOL_SEED;
+                dataset::DatasetWriter writer(path_, info);
+                writer.append(span<const uint32_t>(values));
+                writer.close();
+                index_ = dataset::indexBinaryDataset(path_);
+            }
+
+            ~DecodeFixture() {
+                error_code ignored;
+                filesystem::remove(path_, ignored);
+            }
+
+            DecodeFixture(const DecodeFixture &) = delete;
+            DecodeFixture &operator=(const DecodeFixture &) = delete;
+
+            [[nodiscard]] const dataset::DatasetIndex &index() const noexcept {
+                return index_;
+            }
+
+        private:
+            filesystem::path path_;
+            dataset::DatasetIndex index_;
+        };
+
+        // op = un valore decodificato (lettura, inflate zlib e conversione
+        // little-endian di loadValuesInto via PartitionReader::load).
+        [[nodiscard]] BenchmarkCase decodeCase(ValuePool pool) {
+            auto fixture = make_shared<unique_ptr<DecodeFixture>>();
+            return {"decode_partition/u32/n=" + to_string(POOL_SIZE), POOL_SIZE, [pool, fixture](const size_t iterations) {
+                if (!*fixture) *fixture = make_unique<DecodeFixture>(*pool);
+                dataset::PartitionReader reader((*fixture)->index());
+                vector<uint32_t> values;
+                return timeLoop(iterations, [&] {
+                    reader.load(0u, values);
+                    doNotOptimize(values.data());
+                });
+            }};
+        }
+
+        [[nodiscard]] auto makeHll(const uint32_t k) {
+            return [k](const hashing::HashFunction &hash) { return alg::HyperLogLog(k, 32u, hash); };
+        }
+
+        [[nodiscard]] auto makeLogLog(const uint32_t k) {
+            return [k](const hashing::HashFunction &hash) { return alg::LogLog(k, 32u, hash); };
+        }
+
+        [[nodiscard]] auto makeHllpp(const uint32_t p,
+                                     const alg::HyperLogLogPlusPlus::EstimatorMode mode =
+                                         alg::HyperLogLogPlusPlus::EstimatorMode::BiasTable) {
+            return [p, mode](const hashing::HashFunction &hash) { return alg::HyperLogLogPlusPlus(p, mode, hash); };
+        }
+
+        [[nodiscard]] auto makePc(const uint32_t l) {
+            return [l](const hashing::HashFunction &hash) { return alg::ProbabilisticCounting(l, hash); };
+        }
+    } // namespace
+
+    vector<BenchmarkCase> makeBenchmarks() {
+        const ValuePool pool = makeValuePool();
+        vector<BenchmarkCase> cases;
+
+        for (const string hashName : {"splitmix64", "xxhash64", "murmurhash3", "siphash24"}) {
+            cases.push_back(hashCase(hashName));
+        }
+
+        cases.push_back(processCase("pc/L=31", pool, makePc(31u)));
+        for (const uint32_t k : {10u, 14u, 16u}) {
+            cases.push_back(processCase("ll/k=" + to_string(k), pool, makeLogLog(k)));
+        }
+        for (const uint32_t k : {10u, 14u, 16u}) {
+            cases.push_back(processCase("hll/k=" + to_string(k), pool, makeHll(k)));
+        }
+        for (const uint32_t p : {10u, 14u, 18u}) {
+            cases.push_back(processCase("hllpp/p=" + to_string(p), pool, makeHllpp(p)));
+        }
+        cases.push_back(processCase("naive", pool, [](const hashing::HashFunction &hash) {
+            return alg::NaiveCounting(hash);
+        }));
+
+        cases.push_back(countCase("pc/L=31", pool, POOL_SIZE, makePc(31u)));
+        cases.push_back(countCase("ll/k=14", pool, POOL_SIZE, makeLogLog(14u)));
+        cases.push_back(countCase("hll/k=14", pool, POOL_SIZE, makeHll(14u)));
+        cases.push_back(countCase("hllpp/p=14,sparse", pool, 1'000u, makeHllpp(14u)));
+        cases.push_back(countCase("hllpp/p=14,normal", pool, POOL_SIZE, makeHllpp(14u)));
+        cases.push_back(countCase("hllpp/p=14,normal,improved", pool, POOL_SIZE,
+                                  makeHllpp(14u, alg::HyperLogLogPlusPlus::EstimatorMode::Improved)));
+
+        cases.push_back(mergeCase("pc/L=31", pool, POOL_SIZE / 2u, makePc(31u)));
+        cases.push_back(mergeCase("ll/k=14", pool, POOL_SIZE / 2u, makeLogLog(14u)));
+        cases.push_back(mergeCase("hll/k=14", pool, POOL_SIZE / 2u, makeHll(14u)));
+        cases.push_back(mergeCase("hllpp/p=18,sparse", pool, 2'000u, makeHllpp(18u)));
+        cases.push_back(mergeCase("hllpp/p=14,normal", pool, POOL_SIZE / 2u, makeHllpp(14u)));
+
+        cases.push_back(reducedToCase(pool, 14u, 10u));
+        cases.push_back(reducedToCase(pool, 18u, 14u));
+
+        cases.push_back(flushCase(18u, 3u * alg::HyperLogLogPlusPlus::TMP_SET_FLUSH_SIZE));
+
+        cases.push_back(decodeCase(pool));
+        return cases;
+    }
+} // namespace satp::bench
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+#include "BenchmarkRunner.h"
+
+using namespace std;
+
+namespace satp::bench {
+    // Catalogo dei microbenchmark: hash64 di ogni HashFunction, process per
+    // algoritmo e precisione, count, merge e reducedTo, flush del buffer sparse
+    // di HLL++ e decodifica di una partizione del dataset. Input deterministici:
+    // due esecuzioni misurano lo stesso lavoro.
+    [[nodiscard]] vector<BenchmarkCase> makeBenchmarks();
+} // namespace satp::bench
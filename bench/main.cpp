@@ -0,0 +1,119 @@
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchmarkReport.h"
+#include "BenchmarkRunner.h"
+#include "Benchmarks.h"
+
+using namespace std;
+
+namespace {
+    struct BenchArguments {
+        satp::bench::BenchmarkOptions options;
+        optional<filesystem::path> jsonPath;
+        optional<filesystem::path> baselinePath;
+        double threshold = 0.10;
+        bool listOnly = false;
+    };
+
+    void printUsage(ostream &out) {
+        out << "usage: satp_bench [--filter <substr>] [--repetitions <n>] [--min-time-ms <ms>]\n"
+               "                  [--json <path>] [--baseline <path>] [--threshold <fraction>] [--counters] [--list]\n"
+               "  --json       scrive il report JSON (riusabile come baseline)\n"
+               "  --baseline   confronta con un report salvato; exit 1 se un caso rallenta oltre la soglia\n"
+               "  --threshold  soglia di regressione sulla media ns/op (default 0.10 = +10%)\n"
+               "  --counters   IPC e miss per operazione dai contatori hardware (Linux perf_event_open)\n";
+    }
+
+    [[nodiscard]] BenchArguments parseArguments(const int argc, char **argv) {
+        BenchArguments args;
+        for (int i = 1; i < argc; ++i) {
+            const string_view flag = argv[i];
+            if (flag == "--list") {
+                args.listOnly = true;
+                continue;
+            }
+            if (flag == "--counters") {
+                args.options.hardwareCounters = true;
+                continue;
+            }
+            if (i + 1 >= argc) throw invalid_argument("Missing value for " + string(flag));
+            const string value = argv[++i];
+            if (flag == "--filter") {
+                args.options.filter = value;
+            } else if (flag == "--repetitions") {
+                args.options.repetitions = stoul(value);
+            } else if (flag == "--min-time-ms") {
+                args.options.minTime = chrono::milliseconds(stoul(value));
+            } else if (flag == "--json") {
+                args.jsonPath = value;
+            } else if (flag == "--baseline") {
+                args.baselinePath = value;
+            } else if (flag == "--threshold") {
+                args.threshold = stod(value);
+                if (!(args.threshold >= 0.0)) throw invalid_argument("--threshold must be >= 0");
+            } else {
+                throw invalid_argument("Unknown option " + string(flag));
+            }
+        }
+        if (args.options.repetitions == 0u) throw invalid_argument("--repetitions must be > 0");
+        return args;
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    BenchArguments args;
+    try {
+        args = parseArguments(argc, argv);
+    } catch (const exception &error) {
+        cerr << "satp_bench: " << error.what() << '\n';
+        printUsage(cerr);
+        return 2;
+    }
+
+    try {
+        // La baseline si legge prima di misurare: un file sbagliato non spreca l'esecuzione.
+        vector<satp::bench::BaselineEntry> baseline;
+        if (args.baselinePath.has_value()) baseline = satp::bench::readBaseline(*args.baselinePath);
+
+        if (args.options.hardwareCounters && !args.listOnly && !satp::profiling::PerfCounters().available()) {
+            cerr << "satp_bench: contatori hardware non disponibili (perf_event_paranoid o PMU assente), "
+                    "misuro solo i tempi\n";
+        }
+
+        const auto cases = satp::bench::makeBenchmarks();
+        vector<satp::bench::BenchmarkResult> results;
+        for (const auto &benchmark : cases) {
+            if (!args.options.filter.empty() && benchmark.name.find(args.options.filter) == string::npos) continue;
+            if (args.listOnly) {
+                cout << benchmark.name << '\n';
+                continue;
+            }
+            results.push_back(satp::bench::runBenchmark(benchmark, args.options));
+            satp::bench::printResult(cout, results.back());
+        }
+        if (args.listOnly) return 0;
+
+        if (args.jsonPath.has_value()) {
+            satp::bench::writeJsonReport(*args.jsonPath, results, args.options);
+            cout << "json: " << args.jsonPath->string() << '\n';
+        }
+        if (args.baselinePath.has_value()) {
+            const auto comparisons = satp::bench::compareWithBaseline(results, baseline, args.threshold);
+            satp::bench::printComparison(cout, comparisons, args.threshold);
+            for (const auto &comparison : comparisons) {
+                if (comparison.regression) return 1;
+            }
+        }
+    } catch (const exception &error) {
+        cerr << "satp_bench: " << error.what() << '\n';
+        return 2;
+    }
+    return 0;
+}
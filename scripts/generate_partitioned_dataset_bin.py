@@ -20,6 +20,7 @@ from typing import Any, Dict, List, Tuple
 DEFAULT_PROGRESS_UPDATES = 200
 UINT32_MAX = (1 << 32) - 1
 UINT32_DOMAIN_SIZE = UINT32_MAX + 1
+KEY_BITS_CHOICES = (32, 64)
 
 # Binary format:
 # - Header: magic/version/global params (v2 only).
@@ -28,17 +29,20 @@ UINT32_DOMAIN_SIZE = UINT32_MAX + 1
 #    truth_offset, truth_byte_size,
 #    n, d, values_encoding, truth_encoding, reserved) repeated p times.
 # - Data blocks:
-#   - values: zlib-compressed uint32 little-endian IDs.
+#   - values: zlib-compressed uint32 little-endian IDs (v2), or uint64 IDs (v3).
 #   - truth: zlib-compressed bitset where bit t=1 iff value at position t is a new distinct.
+# v3 keeps the v2 layout; only the values encoding changes.
 MAGIC = b"SATPDBN2"
 VERSION = 2
+VERSION_U64 = 3
 ENCODING_ZLIB_U32_LE = 1
 ENCODING_ZLIB_BITSET_LE = 2
+ENCODING_ZLIB_U64_LE = 3
 HEADER_FMT = "<8sIQQQQ"
 PARTITION_ENTRY_FMT = "<QQQQQQIII"
 
 
-def _validate_params(n: int, d: int, p: int) -> None:
+def _validate_params(n: int, d: int, p: int, key_bits: int = 32) -> None:
     if n < 0 or d < 0:
         raise ValueError("n and d must be non-negative")
     if p <= 0:
@@ -47,6 +51,11 @@ def _validate_params(n: int, d: int, p: int) -> None:
         raise ValueError("d must be <= n")
     if n > 0 and d == 0:
         raise ValueError("d=0 requires n=0")
+    if key_bits not in KEY_BITS_CHOICES:
+        raise ValueError(f"key_bits must be one of {KEY_BITS_CHOICES}")
+    if key_bits == 64:
+        # 64-bit keys are drawn from the whole uint64 domain: only d <= n applies.
+        return
     # Values are stored as uint32 in the current binary format.
     # n can be arbitrarily large (per-partition stream length), but the distinct
     # domain cannot exceed the uint32 key space.
@@ -102,17 +111,33 @@ def _drain_progress_queue(progress_queue: Any,
     return produced
 
 
-def _u32_chunk_bytes(buffer_u32: array.array) -> bytes:
-    if not buffer_u32:
+def _value_chunk_bytes(buffer_values: array.array) -> bytes:
+    if not buffer_values:
         return b""
     if sys.byteorder != "little":
-        tmp = array.array("I", buffer_u32)
+        tmp = array.array(buffer_values.typecode, buffer_values)
         tmp.byteswap()
         return tmp.tobytes()
-    return buffer_u32.tobytes()
+    return buffer_values.tobytes()
+
+
+def _value_typecode(key_bits: int) -> str:
+    return "Q" if key_bits == 64 else "I"
+
+
+def _sample_distinct_ids(rng: random.Random, id_domain_size: int, d: int, key_bits: int) -> List[int]:
+    if d == 0:
+        return []
+    if key_bits == 32:
+        return rng.sample(range(id_domain_size), d)
+    # range(2^64) is too large for random.sample: draw until d distinct keys exist.
+    ids: set[int] = set()
+    while len(ids) < d:
+        ids.add(rng.getrandbits(64))
+    return sorted(ids)
 
 
-def _write_partition_fragment(task: Tuple[int, int, int, int, int, str, Any, int]) -> Tuple[int, str, str]:
+def _write_partition_fragment(task: Tuple[int, int, int, int, int, str, Any, int, int]) -> Tuple[int, str, str]:
     (
         part_idx,
         n_per_partition,
@@ -122,12 +147,13 @@ def _write_partition_fragment(task: Tuple[int, int, int, int, int, str, Any, int
         tmp_dir,
         progress_queue,
         progress_batch,
+        key_bits,
     ) = task
     rng = random.Random(part_seed)
     values_path = pathlib.Path(tmp_dir) / f"part_{part_idx}.values.binfrag"
     truth_path = pathlib.Path(tmp_dir) / f"part_{part_idx}.truth.binfrag"
 
-    distinct_ids = rng.sample(range(id_domain_size), d_per_partition) if d_per_partition > 0 else []
+    distinct_ids = _sample_distinct_ids(rng, id_domain_size, d_per_partition, key_bits)
     forced_by_pos: Dict[int, int] = {}
     if d_per_partition > 0:
         mandatory_positions = rng.sample(range(n_per_partition), d_per_partition)
@@ -136,8 +162,8 @@ def _write_partition_fragment(task: Tuple[int, int, int, int, int, str, Any, int
             forced_by_pos[pos] = distinct_ids[i]
 
     pending_progress = 0
-    chunk = array.array("I")
-    chunk_capacity = 1 << 20  # values per flush (~4 MiB)
+    chunk = array.array(_value_typecode(key_bits))
+    chunk_capacity = 1 << 20  # values per flush (~4 MiB, ~8 MiB with 64-bit keys)
     truth_byte = 0
     truth_bit_pos = 0
     truth_chunk = bytearray()
@@ -161,7 +187,7 @@ def _write_partition_fragment(task: Tuple[int, int, int, int, int, str, Any, int
 
                 chunk.append(value)
                 if len(chunk) >= chunk_capacity:
-                    raw_chunk = _u32_chunk_bytes(chunk)
+                    raw_chunk = _value_chunk_bytes(chunk)
                     compressed_chunk = values_compressor.compress(raw_chunk)
                     if compressed_chunk:
                         out_values.write(compressed_chunk)
@@ -187,7 +213,7 @@ def _write_partition_fragment(task: Tuple[int, int, int, int, int, str, Any, int
                         pending_progress = 0
 
             if chunk:
-                raw_chunk = _u32_chunk_bytes(chunk)
+                raw_chunk = _value_chunk_bytes(chunk)
                 compressed_chunk = values_compressor.compress(raw_chunk)
                 if compressed_chunk:
                     out_values.write(compressed_chunk)
@@ -221,11 +247,13 @@ def generate_partitioned_dataset_bin(output_dir: pathlib.Path,
                                      seed: int,
                                      show_progress: bool = False,
                                      workers: int | None = None,
-                                     progress_batch: int | None = None) -> pathlib.Path:
-    _validate_params(n, d, p)
+                                     progress_batch: int | None = None,
+                                     key_bits: int = 32) -> pathlib.Path:
+    _validate_params(n, d, p, key_bits)
 
     output_dir.mkdir(parents=True, exist_ok=True)
-    out_name = f"dataset_n_{n}_d_{d}_p_{p}_s_{seed}.bin"
+    key_suffix = "_u64" if key_bits == 64 else ""
+    out_name = f"dataset_n_{n}_d_{d}_p_{p}_s_{seed}{key_suffix}.bin"
     out_path = output_dir / out_name
 
     max_workers = os.cpu_count() or 1
@@ -246,8 +274,8 @@ def generate_partitioned_dataset_bin(output_dir: pathlib.Path,
     truth_part_paths: Dict[int, str] = {}
 
     with tempfile.TemporaryDirectory(prefix="satp_parts_bin_", dir=str(output_dir)) as tmp_dir:
-        id_domain_size = min(n, UINT32_DOMAIN_SIZE)
-        tasks: List[Tuple[int, int, int, int, int, str, Any, int]] = []
+        id_domain_size = min(n, UINT32_DOMAIN_SIZE) if key_bits == 32 else (1 << 64)
+        tasks: List[Tuple[int, int, int, int, int, str, Any, int, int]] = []
         for part_idx in range(p):
             tasks.append((
                 part_idx,
@@ -258,6 +286,7 @@ def generate_partitioned_dataset_bin(output_dir: pathlib.Path,
                 tmp_dir,
                 None,
                 progress_batch,
+                key_bits,
             ))
 
         if workers_eff == 1:
@@ -273,8 +302,8 @@ def generate_partitioned_dataset_bin(output_dir: pathlib.Path,
             with ctx.Manager() as manager:
                 progress_queue = manager.Queue()
                 tasks = [
-                    (part_idx, n_part, d_part, id_dom, part_seed, tdir, progress_queue, pbatch)
-                    for (part_idx, n_part, d_part, id_dom, part_seed, tdir, _, pbatch) in tasks
+                    (part_idx, n_part, d_part, id_dom, part_seed, tdir, progress_queue, pbatch, kbits)
+                    for (part_idx, n_part, d_part, id_dom, part_seed, tdir, _, pbatch, kbits) in tasks
                 ]
 
                 with ctx.Pool(processes=workers_eff) as pool:
@@ -324,14 +353,15 @@ def generate_partitioned_dataset_bin(output_dir: pathlib.Path,
                 truth_size,
                 n,
                 d,
-                ENCODING_ZLIB_U32_LE,
+                ENCODING_ZLIB_U64_LE if key_bits == 64 else ENCODING_ZLIB_U32_LE,
                 ENCODING_ZLIB_BITSET_LE,
                 0,
             ))
 
         seed_u64 = seed & ((1 << 64) - 1)
         with out_path.open("wb", buffering=8 * 1024 * 1024) as out:
-            out.write(struct.pack(HEADER_FMT, MAGIC, VERSION, n, d, p, seed_u64))
+            version = VERSION_U64 if key_bits == 64 else VERSION
+            out.write(struct.pack(HEADER_FMT, MAGIC, version, n, d, p, seed_u64))
             for entry in entries:
                 out.write(struct.pack(PARTITION_ENTRY_FMT, *entry))
 
@@ -364,6 +394,8 @@ def parse_args() -> argparse.Namespace:
                         help="Number of worker processes (default: CPU count)")
     parser.add_argument("--progress-batch", type=int, default=None,
                         help="Elements per worker progress update (default: auto ~= (n*p)/200)")
+    parser.add_argument("--key-bits", type=int, choices=KEY_BITS_CHOICES, default=32,
+                        help="Key width: 32 (format v2, ids < min(n, 2^32)) or 64 (format v3, ids over the uint64 domain)")
     parser.add_argument("--no-progress", action="store_true", help="Disable progress output")
     return parser.parse_args()
 
@@ -379,6 +411,7 @@ def main() -> None:
         show_progress=not args.no_progress,
         workers=args.workers,
         progress_batch=args.progress_batch,
+        key_bits=args.key_bits,
     )
     print(out_path)
 
@@ -17,10 +17,11 @@ DEFAULT_HASH_FUNCTION = "splitmix64"
 DEFAULT_ALGORITHMS = "all"
 
 PC_L_DOMAIN = list(range(1, 32))        # ProbabilisticCounting: L in [1,31]
-LL_K_DOMAIN = list(range(4, 17))        # LogLog: k in [4,16], L=32
-HLL_K_DOMAIN = list(range(4, 17))       # HyperLogLog: k in [4,16], L=32
+LL_K_DOMAIN = list(range(4, 17))        # LogLog: k in [4,16], L in {32,64}
+HLL_K_DOMAIN = list(range(4, 17))       # HyperLogLog: k in [4,16], L in {32,64}
 HLLPP_K_DOMAIN = list(range(4, 19))     # HyperLogLog++: p(=k) in [4,18]
 PAPER_LLOG = 32
+LLOG_DOMAIN = [PAPER_LLOG, 64]          # HLL/LogLog: 32-bit (paper) or 64-bit hash domain
 
 
 def parse_csv_ints(raw: str) -> list[int]:
@@ -89,11 +90,17 @@ def run_benchmarks(main_bin: Path,
                    results_namespace: str,
                    hash_function: str,
                    commands: list[str],
-                   run_label: str) -> None:
+                   run_label: str,
+                   resume: bool = False,
+                   stop_width: float | None = None,
+                   stop_metric: str = "mre") -> None:
     payload = "\n".join([
         f"set datasetPath {dataset_path}",
         f"set resultsNamespace {results_namespace}",
         f"set hashFunction {hash_function}",
+        f"set resume {'on' if resume else 'off'}",
+        f"set stopWidth {stop_width if stop_width is not None else 'off'}",
+        f"set stopMetric {stop_metric}",
         *commands,
         "quit"
     ]) + "\n"
@@ -218,23 +225,25 @@ def build_full_commands(base_l: int,
         ])
         append_run_modes(commands, "hllpp", run_streaming, run_merge)
 
-    # HLL: k in [4,16], L fixed at 32
+    # HLL: k in [4,16], L in {32,64}
     for k in HLL_K_DOMAIN:
-        commands.extend([
-            f"set k {k}",
-            f"set l {base_l}",
-            f"set lLog {PAPER_LLOG}",
-        ])
-        append_run_modes(commands, "hll", run_streaming, run_merge)
-
-    # LogLog: k in [4,16], L fixed at 32
+        for l_log in LLOG_DOMAIN:
+            commands.extend([
+                f"set k {k}",
+                f"set l {base_l}",
+                f"set lLog {l_log}",
+            ])
+            append_run_modes(commands, "hll", run_streaming, run_merge)
+
+    # LogLog: k in [4,16], L in {32,64}
     for k in LL_K_DOMAIN:
-        commands.extend([
-            f"set k {k}",
-            f"set l {base_l}",
-            f"set lLog {PAPER_LLOG}",
-        ])
-        append_run_modes(commands, "ll", run_streaming, run_merge)
+        for l_log in LLOG_DOMAIN:
+            commands.extend([
+                f"set k {k}",
+                f"set l {base_l}",
+                f"set lLog {l_log}",
+            ])
+            append_run_modes(commands, "ll", run_streaming, run_merge)
 
     # Probabilistic Counting: L in [1,31]
     for l in PC_L_DOMAIN:
@@ -305,13 +314,21 @@ def parse_args() -> argparse.Namespace:
     parser.add_argument("--l-values", default=None,
                         help="Optional CSV of L values to sweep for ProbabilisticCounting")
     parser.add_argument("--l-log", type=int, default=32,
-                        help="L parameter for LogLog/HLL")
+                        help="L parameter for LogLog/HLL (32 or 64)")
     parser.add_argument("--l-log-values", default=None,
                         help="Optional CSV of LLog values to sweep for LogLog/HLL")
     parser.add_argument("--clean-results", action="store_true",
                         help="Delete repo_root/results before running")
     parser.add_argument("--clean-target-results", action="store_true",
                         help="Delete only the result namespaces targeted by this run before executing")
+    parser.add_argument("--stop-width", type=float, default=None,
+                        help="Stop a streaming configuration once the 95%% CI of --stop-metric at the last "
+                             "checkpoint is narrower than this width (default: use all partitions)")
+    parser.add_argument("--stop-metric", choices=["mre", "mean"], default="mre",
+                        help="Metric for --stop-width: mre (absolute width) or mean (width relative to F0)")
+    parser.add_argument("--resume", action="store_true",
+                        help="Checkpoint streaming runs and skip jobs already written; rerun with the same "
+                             "arguments after an interruption to continue where it stopped")
     return parser.parse_args()
 
 
@@ -342,6 +359,9 @@ def main() -> None:
     if args.full and selected_algorithms != ["all"]:
         raise ValueError("--full currently requires --algorithms all")
 
+    if args.resume and (args.clean_results or args.clean_target_results):
+        raise ValueError("--resume cannot be combined with --clean-results/--clean-target-results")
+
     if args.clean_results:
         results_dir = repo_root / "results"
         if results_dir.exists():
@@ -386,14 +406,15 @@ def main() -> None:
         f"[params] hashFunctions={','.join(hash_functions)} algorithms={','.join(selected_algorithms)} "
         f"k={','.join(str(v) for v in k_values)} l={','.join(str(v) for v in l_values)} "
         f"lLog={','.join(str(v) for v in l_log_values)} "
-        f"streaming={not args.skip_streaming} merge={not args.skip_merge} full={args.full}"
+        f"streaming={not args.skip_streaming} merge={not args.skip_merge} full={args.full} resume={args.resume} "
+        f"stopWidth={args.stop_width if args.stop_width is not None else 'off'}"
     )
     if args.full:
         print(
             "[domains] "
             f"HLL++ k={HLLPP_K_DOMAIN[0]}..{HLLPP_K_DOMAIN[-1]}, "
-            f"HLL k={HLL_K_DOMAIN[0]}..{HLL_K_DOMAIN[-1]} L={PAPER_LLOG}, "
-            f"LogLog k={LL_K_DOMAIN[0]}..{LL_K_DOMAIN[-1]} L={PAPER_LLOG}, "
+            f"HLL k={HLL_K_DOMAIN[0]}..{HLL_K_DOMAIN[-1]} L={','.join(str(v) for v in LLOG_DOMAIN)}, "
+            f"LogLog k={LL_K_DOMAIN[0]}..{LL_K_DOMAIN[-1]} L={','.join(str(v) for v in LLOG_DOMAIN)}, "
             f"PC L={PC_L_DOMAIN[0]}..{PC_L_DOMAIN[-1]}"
         )
 
@@ -460,6 +481,9 @@ def main() -> None:
                 hash_function=hash_function,
                 commands=commands,
                 run_label=f"{run_label}:{hash_function}",
+                resume=args.resume,
+                stop_width=args.stop_width,
+                stop_metric=args.stop_metric,
             )
 
     print("\n[done] orchestration completed")
@@ -168,6 +168,38 @@ def run_heterogeneous_benchmark(repo_root: Path,
     run_cmd([str(main_bin)], cwd=repo_root, input_text=payload)
 
 
+def run_heterogeneous_matrix(repo_root: Path,
+                             main_bin: Path,
+                             dataset_path: Path,
+                             results_namespace: str,
+                             left_hash_functions: list[str],
+                             right_hash_functions: list[str],
+                             left_hash_seed_tokens: list[str],
+                             right_hash_seed_tokens: list[str],
+                             left_k_values: list[int],
+                             right_k_values: list[int],
+                             merge_strategies: list[str]) -> None:
+    # Una sola invocazione per dataset: il CLI espande le celle, scarta quelle
+    # non ammesse e scrive un CSV per cella come runmergehet.
+    payload = "\n".join([
+        f"set datasetPath {dataset_path}",
+        f"set resultsNamespace {results_namespace}",
+        f"set hashFunction {left_hash_functions[0]}",
+        f"set matrixLeftHashes {','.join(left_hash_functions)}",
+        f"set matrixRightHashes {','.join(right_hash_functions)}",
+        f"set matrixLeftSeeds {','.join(left_hash_seed_tokens)}",
+        f"set matrixRightSeeds {','.join(right_hash_seed_tokens)}",
+        f"set matrixLeftK {','.join(str(k) for k in left_k_values)}",
+        f"set matrixRightK {','.join(str(k) for k in right_k_values)}",
+        f"set matrixStrategies {','.join(merge_strategies)}",
+        "runmergematrix hllpp",
+        "quit"
+    ]) + "\n"
+
+    print(f"[bench-matrix] dataset={dataset_path}")
+    run_cmd([str(main_bin)], cwd=repo_root, input_text=payload)
+
+
 def parse_args() -> argparse.Namespace:
     parser = argparse.ArgumentParser(
         description=(
@@ -197,6 +229,8 @@ def parse_args() -> argparse.Namespace:
     parser.add_argument("--left-k-values", default=DEFAULT_K_VALUES)
     parser.add_argument("--right-k-values", default=DEFAULT_K_VALUES)
     parser.add_argument("--merge-strategies", default=DEFAULT_MERGE_STRATEGIES)
+    parser.add_argument("--matrix", action="store_true",
+                        help="Run every cell of a dataset in one runmergematrix invocation")
     parser.add_argument("--clean-results", action="store_true")
     parser.add_argument("--clean-target-results", action="store_true")
     return parser.parse_args()
@@ -300,6 +334,22 @@ def main() -> None:
             seed=seed,
         )
 
+        if args.matrix:
+            run_heterogeneous_matrix(
+                repo_root=repo_root,
+                main_bin=main_bin,
+                dataset_path=dataset_path,
+                results_namespace=resolved_namespace,
+                left_hash_functions=left_hash_functions,
+                right_hash_functions=right_hash_functions,
+                left_hash_seed_tokens=left_hash_seed_tokens,
+                right_hash_seed_tokens=right_hash_seed_tokens,
+                left_k_values=left_k_values,
+                right_k_values=right_k_values,
+                merge_strategies=merge_strategies,
+            )
+            continue
+
         for left_hash in left_hash_functions:
             for right_hash in right_hash_functions:
                 for left_seed_token in left_hash_seed_tokens:
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Legge i trace binari di runstream (streamingTrace=binary) e li converte nel CSV streaming.
+
+Formato (little-endian, vedi StreamingTraceFile.h): una sequenza di trace, ognuno con
+header fisso, nome e parametri dell'algoritmo, poi un record per checkpoint.
+"""
+from __future__ import annotations
+
+import argparse
+import csv
+import math
+import struct
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+
+MAGIC = b"SATPSTRM"
+VERSION = 1
+RECORD_FIELDS = 7
+HEADER_FMT = "<8sIIQQQQdQII"
+RECORD_FMT = "<Q7d"
+
+STREAMING_HEADER = [
+    "algorithm", "params", "mode", "runs", "sample_size", "number_of_elements_processed", "f0", "seed",
+    "f0_mean_t", "f0_hat_mean_t",
+    "variance", "stddev", "rse_theoretical", "rse_observed", "bias", "absolute_bias", "relative_bias",
+    "mean_relative_error", "rmse", "mae", "bytes_mean",
+]
+
+
+@dataclass
+class StreamingTrace:
+    algorithm: str
+    params: str
+    runs: int
+    sample_size: int
+    f0: int
+    seed: int
+    rse_theoretical: float
+    # Colonne: t, f0_mean_t, f0_hat_mean_t, variance, bias, mean_relative_error, rmse, mae
+    records: list[tuple[int, float, float, float, float, float, float, float]] = field(default_factory=list)
+
+
+def read_streaming_traces(path: Path) -> list[StreamingTrace]:
+    data = Path(path).read_bytes()
+    header_size = struct.calcsize(HEADER_FMT)
+    record_size = struct.calcsize(RECORD_FMT)
+    traces: list[StreamingTrace] = []
+    offset = 0
+    while offset < len(data):
+        if offset + header_size > len(data):
+            raise ValueError("Trace binario troncato")
+        (magic, version, fields, runs, sample_size, f0, seed, rse, points, name_len,
+         params_len) = struct.unpack_from(HEADER_FMT, data, offset)
+        if magic != MAGIC:
+            raise ValueError("Trace binario non valido: magic errato")
+        if version != VERSION or fields != RECORD_FIELDS:
+            raise ValueError("Trace binario non valido: versione non supportata")
+        offset += header_size
+
+        end = offset + name_len + params_len + points * record_size
+        if end > len(data):
+            raise ValueError("Trace binario troncato")
+        name = data[offset:offset + name_len].decode("utf-8")
+        offset += name_len
+        params = data[offset:offset + params_len].decode("utf-8")
+        offset += params_len
+        records = list(struct.iter_unpack(RECORD_FMT, data[offset:end]))
+        offset = end
+        traces.append(StreamingTrace(name, params, runs, sample_size, f0, seed, rse, records))
+    return traces
+
+
+def streaming_rows(trace: StreamingTrace):
+    """Righe nel formato di results_streaming.csv, con i campi derivati ricalcolati.
+
+    Il trace non registra la memoria degli sketch: bytes_mean resta vuoto.
+    """
+    for t, truth, mean, variance, bias, mre, rmse, mae in trace.records:
+        stddev = math.sqrt(variance)
+        yield [
+            trace.algorithm, trace.params, "streaming", trace.runs, trace.sample_size, t, trace.f0, trace.seed,
+            truth, mean,
+            variance, stddev, trace.rse_theoretical, stddev / truth if truth != 0.0 else 0.0,
+            bias, abs(bias), bias / truth if truth != 0.0 else 0.0,
+            mre, rmse, mae, "",
+        ]
+
+
+def main(argv: list[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace", type=Path, help="file .bin scritto da runstream")
+    parser.add_argument("-o", "--output", type=Path, help="CSV di destinazione (default: stdout)")
+    args = parser.parse_args(argv)
+
+    traces = read_streaming_traces(args.trace)
+    out = args.output.open("w", newline="") if args.output else sys.stdout
+    try:
+        writer = csv.writer(out, lineterminator="\n")
+        writer.writerow(STREAMING_HEADER)
+        for trace in traces:
+            writer.writerows(streaming_rows(trace))
+    finally:
+        if args.output:
+            out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -62,6 +62,7 @@ set -g MATRIX_COMMON_ARGS \
     --d-ratios 0.01,0.1,1.0 \
     --seeds 21041998 \
     --p 50 \
+    --matrix \
     --left-k-values 14 \
     --right-k-values 14
 
@@ -13,8 +13,10 @@ ProgressBar::ProgressBar(size_t total,
 }
 
 void ProgressBar::tick(size_t n) {
+    // Ticks arrive in batches: redraw whenever an updateEvery_ boundary is crossed.
+    const size_t before = count_ / updateEvery_;
     count_ += n;
-    if (count_ % updateEvery_ == 0 || count_ == total_) draw();
+    if (count_ / updateEvery_ != before || count_ == total_) draw();
 }
 
 void ProgressBar::finish() {
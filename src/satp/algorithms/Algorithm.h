@@ -1,5 +1,7 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 
 #include "satp/hashing/HashFunction.h"
@@ -10,11 +12,18 @@ namespace satp::algorithms {
     /**
      * @brief Interfaccia astratta per tutti gli algoritmi di stima della cardinalità.
      *
-     * - process()  : inserisce un nuovo ID nel calcolo dello sketch;
+     * - process()  : inserisce un nuovo ID nel calcolo dello sketch (ID a 32 o 64 bit,
+     *                oppure chiave di lunghezza arbitraria come sequenza di byte);
      * - count()    : restituisce la stima corrente della cardinalità (o il conteggio esatto
      *                per gli algoritmi “naive”);
      * - reset()    : facoltativo, azzera lo stato interno (utile nei benchmark).
      * - merge()    : combina lo stato di un altro sketch compatibile.
+     * - memoryBytes(): byte occupati ora dallo stato dello sketch: l'oggetto piu' gli
+     *                elementi vivi dei suoi container. La capacita' trattenuta per il
+     *                riuso tra run e i buffer di lavoro sono esclusi, cosi' la misura
+     *                dipende solo dallo stato (l'overhead dell'allocatore e' escluso);
+     * - logicalBits(): bit dello stato che lo sketch deve conservare (registri,
+     *                bitmap, lista sparse compressa), indipendenti dalla rappresentazione.
      *
      */
     class Algorithm {
@@ -27,6 +36,10 @@ namespace satp::algorithms {
 
         virtual void process(uint32_t id) = 0;
 
+        virtual void process(uint64_t id) = 0;
+
+        virtual void process(span<const byte> key) = 0;
+
         virtual uint64_t count() = 0;
 
         virtual void merge(const Algorithm &other) = 0;
@@ -36,6 +49,10 @@ namespace satp::algorithms {
 
         virtual string getName() = 0;
 
+        [[nodiscard]] virtual size_t memoryBytes() const = 0;
+
+        [[nodiscard]] virtual size_t logicalBits() const = 0;
+
     protected:
         [[nodiscard]] const hashing::HashFunction &hashFunction() const {
             return *hashFunction_;
@@ -0,0 +1,242 @@
+#include "Estimators.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "hllpp_tables.h"
+
+using namespace std;
+
+namespace satp::algorithms {
+    namespace {
+        constexpr double ALPHA_16 = 0.673;
+        constexpr double ALPHA_32 = 0.697;
+        constexpr double ALPHA_64 = 0.709;
+        constexpr double ALPHA_LOGLOG = 0.39701;
+        constexpr double ALPHA_INF = 0.72134752044448170368; // 1 / (2 ln 2)
+        constexpr size_t ML_BISECTION_STEPS = 200;
+
+        [[nodiscard]] double alphaFor(const uint32_t m) {
+            switch (m) {
+                case 16u: return ALPHA_16;
+                case 32u: return ALPHA_32;
+                case 64u: return ALPHA_64;
+                default: return 0.7213 / (1.0 + 1.079 / static_cast<double>(m));
+            }
+        }
+
+        // \sum_j 2^{-M[j]} dall'istogramma.
+        [[nodiscard]] double sumInversePowers(const RegisterView &view) {
+            const auto histogram = view.histogram();
+            double sum = 0.0;
+            for (size_t r = 0; r < histogram.size(); ++r) {
+                sum += static_cast<double>(histogram[r]) * ldexp(1.0, -static_cast<int>(r));
+            }
+            return sum;
+        }
+
+        [[nodiscard]] double rawEstimate(const RegisterView &view) {
+            const auto m = static_cast<double>(view.m());
+            return alphaFor(view.m()) * m * m / sumInversePowers(view);
+        }
+
+        [[nodiscard]] double linearCounting(const RegisterView &view) {
+            const auto m = static_cast<double>(view.m());
+            const auto zeros = static_cast<double>(view.zeroRegisters());
+            if (zeros <= 0.0) {
+                return m;
+            }
+            return m * log(m / zeros);
+        }
+
+        // sigma(x) = x + \sum_{k>=1} x^{2^k} 2^{k-1} (Ertl 2017, Algoritmo 6).
+        [[nodiscard]] double sigma(double x) {
+            if (x == 1.0) return numeric_limits<double>::infinity();
+            double y = 1.0;
+            double z = x;
+            double previous = 0.0;
+            do {
+                x *= x;
+                previous = z;
+                z += x * y;
+                y += y;
+            } while (z != previous);
+            return z;
+        }
+
+        // tau(x) = (1 - x - \sum_{k>=1} (1 - x^{2^{-k}})^2 2^{-k}) / 3.
+        [[nodiscard]] double tau(double x) {
+            if (x == 0.0 || x == 1.0) return 0.0;
+            double y = 1.0;
+            double z = 1.0 - x;
+            double previous = 0.0;
+            do {
+                x = sqrt(x);
+                previous = z;
+                y *= 0.5;
+                z -= (1.0 - x) * (1.0 - x) * y;
+            } while (z != previous);
+            return z / 3.0;
+        }
+    } // namespace
+
+    string_view RawEstimator::id() const {
+        return "raw";
+    }
+
+    double RawEstimator::estimate(const RegisterView &view) const {
+        return rawEstimate(view);
+    }
+
+    string_view LinearCountingEstimator::id() const {
+        return "linear";
+    }
+
+    double LinearCountingEstimator::estimate(const RegisterView &view) const {
+        return linearCounting(view);
+    }
+
+    string_view HyperLogLogEstimator::id() const {
+        return "hll";
+    }
+
+    double HyperLogLogEstimator::estimate(const RegisterView &view) const {
+        const auto m = static_cast<double>(view.m());
+        const double raw = rawEstimate(view);
+        if (raw <= 2.5 * m) {
+            return (view.zeroRegisters() != 0u) ? linearCounting(view) : raw;
+        }
+        const double twoPow32 = ldexp(1.0, 32);
+        if (view.hashBits() > 32u || raw <= twoPow32 / 30.0) {
+            return raw;
+        }
+        return -twoPow32 * log(1.0 - (raw / twoPow32));
+    }
+
+    string_view LogLogEstimator::id() const {
+        return "loglog";
+    }
+
+    double LogLogEstimator::estimate(const RegisterView &view) const {
+        const auto histogram = view.histogram();
+        double sumRegisters = 0.0;
+        for (size_t r = 1; r < histogram.size(); ++r) {
+            sumRegisters += static_cast<double>(r) * static_cast<double>(histogram[r]);
+        }
+        const auto m = static_cast<double>(view.m());
+        return ALPHA_LOGLOG * m * exp2(sumRegisters / m);
+    }
+
+    string_view HyperLogLogPlusPlusEstimator::id() const {
+        return "hllpp";
+    }
+
+    double HyperLogLogPlusPlusEstimator::estimate(const RegisterView &view) const {
+        if (view.precision() < hllpp_tables::MIN_K || view.precision() > hllpp_tables::MAX_K) {
+            throw invalid_argument("HLL++ estimator requires precision in [4, 18]");
+        }
+        const auto m = static_cast<double>(view.m());
+        const double raw = rawEstimate(view);
+        double corrected = raw;
+        if (raw <= 5.0 * m) {
+            corrected = max(0.0, raw - hllpp_tables::estimate_bias(view.precision(), raw));
+        }
+        const double linear = (view.zeroRegisters() != 0u) ? linearCounting(view) : corrected;
+        const double threshold = hllpp_tables::threshold_for_k(view.precision());
+        return (linear <= threshold) ? linear : corrected;
+    }
+
+    string_view ImprovedEstimator::id() const {
+        return "improved";
+    }
+
+    double ImprovedEstimator::estimate(const RegisterView &view) const {
+        return estimators::improvedEstimate(view.histogram(), view.m());
+    }
+
+    string_view MaximumLikelihoodEstimator::id() const {
+        return "ml";
+    }
+
+    double MaximumLikelihoodEstimator::estimate(const RegisterView &view) const {
+        const auto histogram = view.histogram();
+        const uint32_t q = view.q();
+        const auto m = static_cast<double>(view.m());
+        if (histogram[0] == view.m()) return 0.0;
+        if (histogram[q + 1u] == view.m()) return numeric_limits<double>::infinity();
+
+        // Con lambda = n/m, P(M=0) = e^{-lambda}, P(M=k) = e^{-lambda 2^{-k}}(1 - e^{-lambda 2^{-k}})
+        // per 1 <= k <= q e P(M=q+1) = 1 - e^{-lambda 2^{-q}}. La derivata della
+        // log-verosimiglianza (moltiplicata per m) e' score(n); decresce da +inf a -a.
+        double a = static_cast<double>(histogram[0]);
+        for (uint32_t k = 1; k <= q; ++k) {
+            a += static_cast<double>(histogram[k]) * ldexp(1.0, -static_cast<int>(k));
+        }
+        const auto score = [&](const double n) {
+            double value = -a;
+            for (uint32_t k = 1; k <= q + 1u; ++k) {
+                if (histogram[k] == 0u) continue;
+                const double weight = ldexp(1.0, -static_cast<int>(min(k, q)));
+                value += static_cast<double>(histogram[k]) * weight / expm1(n * weight / m);
+            }
+            return value;
+        };
+
+        double low = 1.0;
+        while (score(low) <= 0.0 && low > numeric_limits<double>::min()) low *= 0.5;
+        double high = max(low, 1.0);
+        while (score(high) > 0.0 && high < numeric_limits<double>::max() / 2.0) high *= 2.0;
+        for (size_t step = 0; step < ML_BISECTION_STEPS && high - low > high * 1e-15; ++step) {
+            const double mid = 0.5 * (low + high);
+            if (score(mid) > 0.0) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        return 0.5 * (low + high);
+    }
+} // namespace satp::algorithms
+
+namespace satp::algorithms::estimators {
+    const array<string_view, 7> &getIdsOfSupportedEstimators() {
+        static const array<string_view, 7> ids{
+            "raw",
+            "linear",
+            "hll",
+            "loglog",
+            "hllpp",
+            "improved",
+            "ml",
+        };
+        return ids;
+    }
+
+    unique_ptr<CardinalityEstimator> makeEstimator(const string_view id) {
+        if (id == "raw") return make_unique<RawEstimator>();
+        if (id == "linear") return make_unique<LinearCountingEstimator>();
+        if (id == "hll") return make_unique<HyperLogLogEstimator>();
+        if (id == "loglog") return make_unique<LogLogEstimator>();
+        if (id == "hllpp") return make_unique<HyperLogLogPlusPlusEstimator>();
+        if (id == "improved") return make_unique<ImprovedEstimator>();
+        if (id == "ml") return make_unique<MaximumLikelihoodEstimator>();
+        throw invalid_argument("Unsupported estimator id '" + string(id) + "'");
+    }
+
+    double improvedEstimate(const span<const uint32_t> histogram, const uint32_t m) {
+        if (histogram.size() < 2u) {
+            throw invalid_argument("improvedEstimate requires a histogram over [0, q + 1]");
+        }
+        const auto q = static_cast<uint32_t>(histogram.size() - 2u);
+        const auto buckets = static_cast<double>(m);
+
+        double z = buckets * tau(1.0 - static_cast<double>(histogram[q + 1u]) / buckets);
+        for (uint32_t k = q; k >= 1u; --k) {
+            z = 0.5 * (z + static_cast<double>(histogram[k]));
+        }
+        z += buckets * sigma(static_cast<double>(histogram[0]) / buckets);
+        return ALPHA_INF * buckets * buckets / z;
+    }
+} // namespace satp::algorithms::estimators
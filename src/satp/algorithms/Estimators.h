@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "RegisterView.h"
+
+using namespace std;
+
+namespace satp::algorithms {
+    /**
+     * @brief Stimatore di cardinalita' sullo stato dei registri di uno sketch.
+     *
+     * Separa la stima dall'ingestione: HyperLogLog, LogLog e HyperLogLog++
+     * espongono registerView() e qualunque stimatore si applica alla stessa
+     * vista. id() e' l'identificativo usato da CLI e CSV.
+     */
+    class CardinalityEstimator {
+    public:
+        virtual ~CardinalityEstimator() = default;
+
+        [[nodiscard]] virtual string_view id() const = 0;
+
+        [[nodiscard]] virtual double estimate(const RegisterView &view) const = 0;
+    };
+
+    // Stima raw di HyperLogLog, alpha_m * m^2 / sum_j 2^{-M[j]}, senza correzioni.
+    class RawEstimator final : public CardinalityEstimator {
+    public:
+        [[nodiscard]] string_view id() const override;
+        [[nodiscard]] double estimate(const RegisterView &view) const override;
+    };
+
+    // Linear counting m * ln(m / V) sui registri vuoti; con V = 0 vale m,
+    // come in HyperLogLog++.
+    class LinearCountingEstimator final : public CardinalityEstimator {
+    public:
+        [[nodiscard]] string_view id() const override;
+        [[nodiscard]] double estimate(const RegisterView &view) const override;
+    };
+
+    // Stimatore di HyperLogLog::count (Flajolet et al. 2007): raw, linear
+    // counting sotto 5m/2 e correzione di grande range con hash a 32 bit.
+    class HyperLogLogEstimator final : public CardinalityEstimator {
+    public:
+        [[nodiscard]] string_view id() const override;
+        [[nodiscard]] double estimate(const RegisterView &view) const override;
+    };
+
+    // Media geometrica di LogLog::count (Durand-Flajolet 2003).
+    class LogLogEstimator final : public CardinalityEstimator {
+    public:
+        [[nodiscard]] string_view id() const override;
+        [[nodiscard]] double estimate(const RegisterView &view) const override;
+    };
+
+    // Stimatore di HyperLogLog++ in rappresentazione normal: raw corretto con
+    // la tabella di bias e linear counting sotto la soglia empirica. Richiede
+    // precision in [4, 18].
+    class HyperLogLogPlusPlusEstimator final : public CardinalityEstimator {
+    public:
+        [[nodiscard]] string_view id() const override;
+        [[nodiscard]] double estimate(const RegisterView &view) const override;
+    };
+
+    // Stimatore migliorato di Ertl (2017, "New cardinality estimation
+    // algorithms for HyperLogLog sketches", Algoritmo 6): niente tabelle ne'
+    // soglie, corregge insieme registri vuoti e saturi.
+    class ImprovedEstimator final : public CardinalityEstimator {
+    public:
+        [[nodiscard]] string_view id() const override;
+        [[nodiscard]] double estimate(const RegisterView &view) const override;
+    };
+
+    // Massima verosimiglianza sotto il modello di Poisson (Ertl 2017): la
+    // radice dell'equazione di score, che e' monotona, si trova per bisezione.
+    class MaximumLikelihoodEstimator final : public CardinalityEstimator {
+    public:
+        [[nodiscard]] string_view id() const override;
+        [[nodiscard]] double estimate(const RegisterView &view) const override;
+    };
+} // namespace satp::algorithms
+
+namespace satp::algorithms::estimators {
+    [[nodiscard]] const array<string_view, 7> &getIdsOfSupportedEstimators();
+
+    // invalid_argument se l'id non e' tra getIdsOfSupportedEstimators().
+    [[nodiscard]] unique_ptr<CardinalityEstimator> makeEstimator(string_view id);
+
+    // Stimatore migliorato di Ertl dall'istogramma C[0..q+1] di m registri:
+    // O(q), usato anche da HyperLogLog++ con l'istogramma incrementale.
+    [[nodiscard]] double improvedEstimate(span<const uint32_t> histogram, uint32_t m);
+} // namespace satp::algorithms::estimators
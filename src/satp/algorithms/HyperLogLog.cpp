@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include "satp/algorithms/AlgorithmCatalog.h"
+#include "SketchState.h"
 
 using namespace std;
 
@@ -12,10 +13,11 @@ namespace satp::algorithms {
         constexpr uint32_t HLL_MIN_K = 4;
         constexpr uint32_t HLL_MAX_K = 16;
         constexpr uint32_t HLL_PAPER_L = 32;
+        constexpr uint32_t HLL_WIDE_L = 64;
 
         [[nodiscard]] uint32_t validateAndBucketCount(uint32_t K, uint32_t L) {
-            if (L != HLL_PAPER_L) {
-                throw invalid_argument("HyperLogLog paper-strict requires L = 32");
+            if (L != HLL_PAPER_L && L != HLL_WIDE_L) {
+                throw invalid_argument("HyperLogLog requires L = 32 or L = 64");
             }
             if (K < HLL_MIN_K || K > HLL_MAX_K) {
                 throw invalid_argument("HyperLogLog paper-strict requires k in [4,16]");
@@ -38,15 +40,39 @@ namespace satp::algorithms {
           zeroRegisters(numberOfBuckets) {}
 
     void HyperLogLog::process(uint32_t id) {
-        const uint32_t hash = hashFunction().hash32(id);
+        if (lengthOfBitMap == HLL_WIDE_L) {
+            insertHash(hashFunction().hash64(id));
+            return;
+        }
+        insertHash(hashFunction().hash32(id));
+    }
+
+    void HyperLogLog::process(uint64_t id) {
+        if (lengthOfBitMap == HLL_WIDE_L) {
+            insertHash(hashFunction().hash64(id));
+            return;
+        }
+        insertHash(hashFunction().hash32(id));
+    }
 
-        const uint32_t firstKBits = hash >> (lengthOfBitMap - k);
-        // the remaining (32-k) bits shifted to the MSB side; rho = leading zeros + 1.
-        const uint32_t rem = hash << k;
+    void HyperLogLog::process(span<const byte> key) {
+        if (lengthOfBitMap == HLL_WIDE_L) {
+            insertHash(hashFunction().hashBytes64(key));
+            return;
+        }
+        insertHash(hashFunction().hashBytes32(key));
+    }
+
+    void HyperLogLog::insertHash(const uint64_t hash) {
         const uint32_t wbits = lengthOfBitMap - k;
+        const auto firstKBits = static_cast<uint32_t>(hash >> wbits);
+        // the remaining (L-k) bits shifted to the MSB side; rho = leading zeros + 1.
+        const uint64_t rem = hash << (64u - wbits);
         const uint32_t b = (rem == 0u) ? (wbits + 1u) : (static_cast<uint32_t>(countl_zero(rem)) + 1u);
 
         const uint32_t old = bitmap[firstKBits];
+        SATP_SKETCH_STAT(++stats_.inserts);
+        SATP_SKETCH_STAT(stats_.recordRegisterUpdate(b > old));
         if (b > old) {
             sumInversePowers += ldexp(1.0, -static_cast<int>(b)) - ldexp(1.0, -static_cast<int>(old));
             if (old == 0u) {
@@ -80,7 +106,8 @@ namespace satp::algorithms {
             }
             return static_cast<uint64_t>(E);
         }
-        if (E <= ((1.0 / 30.0) * ldexp(1.0, 32))) { // 2^32
+        // With L = 64 hash collisions are negligible: no large-range correction.
+        if (lengthOfBitMap == HLL_WIDE_L || E <= ((1.0 / 30.0) * ldexp(1.0, 32))) { // 2^32
             return static_cast<uint64_t>(E);
         }
         const double two_pow_32 = ldexp(1.0, 32); // 2^32
@@ -91,12 +118,22 @@ namespace satp::algorithms {
         ranges::fill(bitmap, 0u);
         sumInversePowers = static_cast<double>(numberOfBuckets);
         zeroRegisters = numberOfBuckets;
+        SATP_SKETCH_STAT(stats_ = {});
     }
 
     string HyperLogLog::getName() {
         return catalog::getNameBy("hll");
     }
 
+    size_t HyperLogLog::memoryBytes() const {
+        return sizeof(*this) + bitmap.size() * sizeof(uint8_t);
+    }
+
+    // Un registro contiene rho in [0, L - k + 1].
+    size_t HyperLogLog::logicalBits() const {
+        return static_cast<size_t>(numberOfBuckets) * bit_width(lengthOfBitMap - k + 1u);
+    }
+
     void HyperLogLog::merge(const Algorithm &other) {
         const auto *typed = dynamic_cast<const HyperLogLog *>(&other);
         if (typed == nullptr) {
@@ -109,6 +146,7 @@ namespace satp::algorithms {
         if (k != other.k || lengthOfBitMap != other.lengthOfBitMap || numberOfBuckets != other.numberOfBuckets) {
             throw invalid_argument("HyperLogLog merge requires same k and L");
         }
+        SATP_SKETCH_STAT(++stats_.merges);
 
         for (uint32_t i = 0; i < numberOfBuckets; ++i) {
             bitmap[i] = max(bitmap[i], other.bitmap[i]);
@@ -123,4 +161,38 @@ namespace satp::algorithms {
             }
         }
     }
+
+    RegisterView HyperLogLog::registerView() const {
+        return RegisterView(k, lengthOfBitMap, bitmap);
+    }
+
+    void HyperLogLog::saveState(vector<uint8_t> &out) const {
+        detail::SketchStateWriter writer(out);
+        writer.u32(static_cast<uint32_t>(detail::SketchStateFormat::Registers));
+        writer.u32(k);
+        writer.u32(lengthOfBitMap);
+        writer.f64(sumInversePowers);
+        writer.bytes(bitmap);
+    }
+
+    void HyperLogLog::loadState(const span<const uint8_t> state) {
+        detail::SketchStateReader reader(state);
+        reader.expectFormat(detail::SketchStateFormat::Registers);
+        if (reader.u32() != k || reader.u32() != lengthOfBitMap) {
+            throw invalid_argument("HyperLogLog state requires same k and L");
+        }
+        const double savedSum = reader.f64();
+        const auto registers = reader.take(numberOfBuckets);
+        reader.finish();
+
+        const uint32_t maxRho = lengthOfBitMap - k + 1u;
+        if (ranges::any_of(registers, [maxRho](const uint8_t reg) { return reg > maxRho; })) {
+            throw invalid_argument("HyperLogLog state has an invalid register");
+        }
+        ranges::copy(registers, bitmap.begin());
+        // La somma salvata e' quella incrementale dello sketch originale: la
+        // stima coincide bit per bit invece di dipendere dall'ordine di somma.
+        sumInversePowers = savedSum;
+        zeroRegisters = static_cast<uint32_t>(ranges::count(bitmap, uint8_t{0}));
+    }
 } // namespace satp::algorithms
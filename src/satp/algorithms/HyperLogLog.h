@@ -6,6 +6,8 @@
 #include <limits>
 
 #include "Algorithm.h"
+#include "RegisterView.h"
+#include "SketchStats.h"
 
 using namespace std;
 
@@ -14,7 +16,7 @@ namespace satp::algorithms {
     public:
         // Algoritmo basato sul paper (Flajolet et al. 2007):
         // - k in [4,16], m = 2^k registers
-        // - 32-bit hash domain (L = 32)
+        // - 32-bit hash domain (L = 32), or 64-bit hash domain (L = 64) via hash64
         explicit HyperLogLog(
             uint32_t K,
             uint32_t L,
@@ -22,26 +24,58 @@ namespace satp::algorithms {
 
         void process(uint32_t id) override;
 
+        void process(uint64_t id) override;
+
+        void process(span<const byte> key) override;
+
         uint64_t count() override;
 
         void reset() override;
 
         string getName() override;
 
+        [[nodiscard]] size_t memoryBytes() const override;
+
+        [[nodiscard]] size_t logicalBits() const override;
+
         void merge(const Algorithm &other) override;
 
         void merge(const HyperLogLog &other);
 
+        // Stato compatto per gli snapshot dei checkpoint: saveState accoda a
+        // `out`, loadState sostituisce lo stato (stessi parametri, altrimenti
+        // invalid_argument). Dopo loadState count() da' la stessa stima.
+        void saveState(vector<uint8_t> &out) const;
+
+        void loadState(span<const uint8_t> state);
+
+        // Registri correnti per gli stimatori di Estimators.h.
+        [[nodiscard]] RegisterView registerView() const;
+
+#if SATP_SKETCH_STATS
+        // Contatori interni dall'ultimo reset() (vedi SketchStats.h).
+        [[nodiscard]] const SketchStats &stats() const noexcept {
+            return stats_;
+        }
+#endif
+
     private:
+        // `hash` holds L significant bits (upper bits zero when L = 32).
+        void insertHash(uint64_t hash);
+
         uint32_t k;
         uint32_t numberOfBuckets; // nel paper coincide con m
         uint32_t lengthOfBitMap;
-        // Logical register values fit in <=5 bits in paper settings; we store in uint8_t.
+        // Logical register values fit in <=5 bits with L = 32 and <=6 bits with L = 64; we store in uint8_t.
         vector<uint8_t> bitmap;
         double alphaM;
         double sumInversePowers; // \sum_j 2^{-M[j]}
         uint32_t zeroRegisters;
 
+#if SATP_SKETCH_STATS
+        SketchStats stats_;
+#endif
+
         static constexpr double ALPHA_16 = 0.673;
         static constexpr double ALPHA_32 = 0.697;
         static constexpr double ALPHA_64 = 0.709;
@@ -6,7 +6,9 @@
 #include <stdexcept>
 
 #include "satp/algorithms/AlgorithmCatalog.h"
+#include "Estimators.h"
 #include "hllpp_tables.h"
+#include "SketchState.h"
 
 using namespace std;
 
@@ -14,15 +16,24 @@ namespace satp::algorithms {
     HyperLogLogPlusPlus::HyperLogLogPlusPlus(
         uint32_t K,
         const hashing::HashFunction &hashFunction)
+        : HyperLogLogPlusPlus(K, EstimatorMode::BiasTable, hashFunction) {}
+
+    HyperLogLogPlusPlus::HyperLogLogPlusPlus(
+        uint32_t K,
+        EstimatorMode estimatorMode,
+        const hashing::HashFunction &hashFunction)
         : Algorithm(hashFunction),
           p(K),
           m(0),
           mSparse(1u << SPARSE_P),
           format(Format::Sparse),
+          mode(estimatorMode),
           alphaM(0.0),
           sumInversePowers(0.0),
           zeroRegisters(0),
-          sparseBits(0) {
+          tmpCount(0),
+          sparseBits(0),
+          sparseDistinct(0) {
         if (p < MIN_P || p > MAX_P) {
             throw invalid_argument("HLL++ requires p in [4, 18]");
         }
@@ -40,19 +51,38 @@ namespace satp::algorithms {
                 break;
         }
 
-        tmpSet.reserve(TMP_SET_FLUSH_SIZE * 2);
         reset();
     }
 
+    HyperLogLogPlusPlus::EstimatorMode HyperLogLogPlusPlus::estimatorMode() const noexcept {
+        return mode;
+    }
+
     void HyperLogLogPlusPlus::process(uint32_t id) {
-        const uint64_t hash = hashFunction().hash64(id);
+        insertHash(hashFunction().hash64(id));
+    }
+
+    void HyperLogLogPlusPlus::process(uint64_t id) {
+        insertHash(hashFunction().hash64(id));
+    }
+
+    void HyperLogLogPlusPlus::process(span<const byte> key) {
+        insertHash(hashFunction().hashBytes64(key));
+    }
+
+    void HyperLogLogPlusPlus::addHash(const uint64_t hash) {
+        insertHash(hash);
+    }
+
+    void HyperLogLogPlusPlus::insertHash(const uint64_t hash) {
+        SATP_SKETCH_STAT(++stats_.inserts);
         if (format == Format::Normal) {
             addNormalHash(hash);
             return;
         }
 
-        tmpSet.insert(encodeHash(hash));
-        if (tmpSet.size() >= TMP_SET_FLUSH_SIZE) {
+        insertSparse(encodeHash(hash));
+        if (tmpCount >= TMP_SET_FLUSH_SIZE) {
             flushTmpSetToSparseList();
             if (sparseBits > denseBits()) {
                 convertSparseToNormal();
@@ -62,10 +92,12 @@ namespace satp::algorithms {
 
     uint64_t HyperLogLogPlusPlus::count() {
         if (format == Format::Sparse) {
-            flushTmpSetToSparseList();
-            const auto zeros = static_cast<double>(mSparse - sparseList.size());
+            const auto zeros = static_cast<double>(mSparse - sparseDistinct);
             return static_cast<uint64_t>(linearCounting(mSparse, zeros));
         }
+        if (mode == EstimatorMode::Improved) {
+            return static_cast<uint64_t>(estimators::improvedEstimate(registerHistogram, m));
+        }
 
         const double raw = rawEstimateNormal();
         double corrected = raw;
@@ -91,9 +123,13 @@ namespace satp::algorithms {
         registers.clear();
         sumInversePowers = 0.0;
         zeroRegisters = 0u;
-        tmpSet.clear();
+        registerHistogram.clear();
+        tmpTable.assign(TMP_TABLE_SIZE, TMP_EMPTY_SLOT);
+        tmpCount = 0u;
         sparseList.clear();
         sparseBits = 0u;
+        sparseDistinct = 0u;
+        SATP_SKETCH_STAT(stats_ = {});
     }
 
     string HyperLogLogPlusPlus::getName() {
@@ -115,17 +151,17 @@ namespace satp::algorithms {
         if (this == &other) {
             return;
         }
+        SATP_SKETCH_STAT(++stats_.merges);
 
         if (format == Format::Sparse && other.format == Format::Sparse) {
             flushTmpSetToSparseList();
-
-            HyperLogLogPlusPlus rhs = other;
-            rhs.flushTmpSetToSparseList();
-
-            for (const auto encoded : rhs.sparseList) {
-                tmpSet.insert(encoded);
-            }
-            flushTmpSetToSparseList();
+            reserveSparseBuffers(sparseList.size() + other.sparseList.size() + other.tmpCount);
+            other.sortedTmpEntries(sparseScratch);
+            mergeSparseLists(other.sparseList, sparseScratch, mergeScratch);
+            mergeSparseLists(sparseList, mergeScratch, sparseScratch);
+            sparseList.swap(sparseScratch);
+            sparseDistinct = sparseList.size();
+            sparseBits = compressedSparseBits();
             if (sparseBits > denseBits()) {
                 convertSparseToNormal();
             }
@@ -136,17 +172,19 @@ namespace satp::algorithms {
             convertSparseToNormal();
         }
 
-        HyperLogLogPlusPlus rhs = other;
-        if (rhs.format == Format::Sparse) {
-            rhs.convertSparseToNormal();
+        // Nessuna copia di other: i suoi registri (o gli encoding sparse,
+        // decodificati alla stessa p) si fondono direttamente.
+        if (other.format == Format::Sparse) {
+            addEncodedRegisters(other);
+            return;
         }
 
-        if (registers.size() != rhs.registers.size()) {
+        if (registers.size() != other.registers.size()) {
             throw runtime_error("HLL++ merge internal error: register size mismatch");
         }
 
         for (size_t i = 0; i < registers.size(); ++i) {
-            addNormalRegister(static_cast<uint32_t>(i), rhs.registers[i]);
+            addNormalRegister(static_cast<uint32_t>(i), other.registers[i]);
         }
     }
 
@@ -158,6 +196,104 @@ namespace satp::algorithms {
         return reducePrecision(targetP, false);
     }
 
+    // Sparse: la lista ordinata con il buffer gia' fuso, un encoding per indice.
+    // Normal: somma incrementale delle potenze inverse e registri.
+    RegisterView HyperLogLogPlusPlus::registerView() const {
+        if (format == Format::Normal) {
+            return RegisterView(p, 64u, registers);
+        }
+        vector<uint8_t> dense(m, 0u);
+        const auto addEncoded = [&](const uint32_t encoded) {
+            const auto [idx, r] = decodeHash(encoded);
+            dense[idx] = max(dense[idx], r);
+        };
+        for (const uint32_t encoded : sparseList) addEncoded(encoded);
+        for (const uint32_t encoded : tmpTable) {
+            if (encoded != TMP_EMPTY_SLOT) addEncoded(encoded);
+        }
+        return RegisterView(p, 64u, dense);
+    }
+
+    void HyperLogLogPlusPlus::saveState(vector<uint8_t> &out) const {
+        detail::SketchStateWriter writer(out);
+        writer.u32(static_cast<uint32_t>(detail::SketchStateFormat::HyperLogLogPlusPlus));
+        writer.u32(p);
+        writer.u32(format == Format::Sparse ? 0u : 1u);
+        if (format == Format::Sparse) {
+            vector<uint32_t> entries = sparseList;
+            if (tmpCount != 0u) {
+                vector<uint32_t> pending;
+                sortedTmpEntries(pending);
+                mergeSparseLists(sparseList, pending, entries);
+            }
+            writer.u32(static_cast<uint32_t>(entries.size()));
+            for (const uint32_t encoded : entries) {
+                writer.u32(encoded);
+            }
+            return;
+        }
+        writer.f64(sumInversePowers);
+        writer.bytes(registers);
+    }
+
+    void HyperLogLogPlusPlus::loadState(const span<const uint8_t> state) {
+        detail::SketchStateReader reader(state);
+        reader.expectFormat(detail::SketchStateFormat::HyperLogLogPlusPlus);
+        if (reader.u32() != p) {
+            throw invalid_argument("HLL++ state requires same p");
+        }
+        const uint32_t savedFormat = reader.u32();
+        if (savedFormat > 1u) {
+            throw invalid_argument("HLL++ state has an unknown format");
+        }
+
+        if (savedFormat == 0u) {
+            const uint32_t entryCount = reader.u32();
+            if (entryCount > mSparse) {
+                throw invalid_argument("HLL++ state has too many sparse entries");
+            }
+            vector<uint32_t> entries(entryCount);
+            for (uint32_t &encoded : entries) {
+                encoded = reader.u32();
+                if (encoded == TMP_EMPTY_SLOT) {
+                    throw invalid_argument("HLL++ state has an invalid sparse entry");
+                }
+            }
+            reader.finish();
+            for (size_t i = 1; i < entries.size(); ++i) {
+                if (sparseIndex(entries[i - 1u]) >= sparseIndex(entries[i])) {
+                    throw invalid_argument("HLL++ state sparse list is not sorted");
+                }
+            }
+
+            reset();
+            sparseList = std::move(entries);
+            sparseDistinct = sparseList.size();
+            sparseBits = compressedSparseBits();
+            return;
+        }
+
+        const double savedSum = reader.f64();
+        const auto saved = reader.take(m);
+        reader.finish();
+        const uint32_t maxRho = (64u - p) + 1u;
+        if (ranges::any_of(saved, [maxRho](const uint8_t reg) { return reg > maxRho; })) {
+            throw invalid_argument("HLL++ state has an invalid register");
+        }
+
+        format = Format::Normal;
+        registers.assign(saved.begin(), saved.end());
+        sumInversePowers = savedSum;
+        zeroRegisters = static_cast<uint32_t>(ranges::count(registers, uint8_t{0}));
+        registerHistogram.assign(maxRho + 1u, 0u);
+        for (const uint8_t reg : registers) ++registerHistogram[reg];
+        sparseList.clear();
+        sparseBits = 0u;
+        sparseDistinct = 0u;
+        tmpTable.clear();
+        tmpCount = 0u;
+    }
+
     uint32_t HyperLogLogPlusPlus::encodeHash(uint64_t hash) const {
         const auto sparseIdx = static_cast<uint32_t>(hash >> (64u - SPARSE_P));
         const uint32_t idxTailBits = SPARSE_P - p;
@@ -211,7 +347,7 @@ namespace satp::algorithms {
             source.convertSparseToNormal();
         }
 
-        HyperLogLogPlusPlus reduced(targetP, hashFunction());
+        HyperLogLogPlusPlus reduced(targetP, mode, hashFunction());
         reduced.convertSparseToNormal();
 
         const uint32_t delta = p - targetP;
@@ -241,75 +377,115 @@ namespace satp::algorithms {
         return reduced;
     }
 
-    void HyperLogLogPlusPlus::flushTmpSetToSparseList() {
-        if (tmpSet.empty()) {
-            return;
+    void HyperLogLogPlusPlus::insertSparse(const uint32_t encoded) {
+        const uint32_t idx = sparseIndex(encoded);
+        constexpr uint32_t tableBits = static_cast<uint32_t>(countr_zero(TMP_TABLE_SIZE));
+        const size_t mask = TMP_TABLE_SIZE - 1u;
+        size_t slot = static_cast<uint32_t>(idx * 0x9E3779B1u) >> (32u - tableBits);
+        while (tmpTable[slot] != TMP_EMPTY_SLOT) {
+            if (sparseIndex(tmpTable[slot]) == idx) {
+                if (rhoFromEncoded(encoded) > rhoFromEncoded(tmpTable[slot])) {
+                    tmpTable[slot] = encoded;
+                }
+                return;
+            }
+            slot = (slot + 1u) & mask;
         }
 
-        vector<uint32_t> incoming;
-        incoming.reserve(tmpSet.size());
-        for (const uint32_t encoded: tmpSet) {
-            incoming.push_back(encoded);
+        tmpTable[slot] = encoded;
+        ++tmpCount;
+        if (!sparseListContains(idx)) {
+            ++sparseDistinct;
         }
-        tmpSet.clear();
+    }
 
-        auto cmpBySparseIndex = [this](uint32_t a, uint32_t b) {
-            const uint32_t idxA = sparseIndex(a);
-            const uint32_t idxB = sparseIndex(b);
-            if (idxA != idxB) {
-                return idxA < idxB;
-            }
-            const uint8_t rhoA = rhoFromEncoded(a);
-            const uint8_t rhoB = rhoFromEncoded(b);
-            if (rhoA != rhoB) {
-                return rhoA > rhoB;
+    bool HyperLogLogPlusPlus::sparseListContains(const uint32_t sparseIdx) const {
+        const auto it = ranges::lower_bound(sparseList, sparseIdx, {}, [this](const uint32_t encoded) {
+            return sparseIndex(encoded);
+        });
+        return it != sparseList.end() && sparseIndex(*it) == sparseIdx;
+    }
+
+    void HyperLogLogPlusPlus::sortedTmpEntries(vector<uint32_t> &out) const {
+        out.clear();
+        out.reserve(tmpCount);
+        for (const uint32_t encoded: tmpTable) {
+            if (encoded != TMP_EMPTY_SLOT) {
+                out.push_back(encoded);
             }
-            return a < b;
-        };
+        }
+        // La tabella tiene gia' un solo encoding (il rho massimo) per indice.
+        ranges::sort(out, {}, [this](const uint32_t encoded) { return sparseIndex(encoded); });
+    }
 
-        ranges::sort(incoming, cmpBySparseIndex);
+    // sparseList e i due scratch si scambiano a ogni flush: crescono insieme e
+    // in modo geometrico, cosi' dopo un reset() nessuna rotazione trova un
+    // buffer piu' piccolo di quelli gia' allocati.
+    void HyperLogLogPlusPlus::reserveSparseBuffers(const size_t entries) {
+        const size_t capacity = min({sparseList.capacity(), sparseScratch.capacity(), mergeScratch.capacity()});
+        if (capacity >= entries) {
+            return;
+        }
+        const size_t largest = max({sparseList.capacity(), sparseScratch.capacity(), mergeScratch.capacity()});
+        const size_t target = max(entries, 2u * largest);
+        sparseList.reserve(target);
+        sparseScratch.reserve(target);
+        mergeScratch.reserve(target);
+    }
 
-        vector<uint32_t> incomingUnique;
-        incomingUnique.reserve(incoming.size());
-        for (const uint32_t encoded: incoming) {
-            if (incomingUnique.empty() || sparseIndex(incomingUnique.back()) != sparseIndex(encoded)) {
-                incomingUnique.push_back(encoded);
+    // `merged` non deve coincidere con lhs o rhs.
+    void HyperLogLogPlusPlus::mergeSparseLists(const vector<uint32_t> &lhs,
+                                               const vector<uint32_t> &rhs,
+                                               vector<uint32_t> &merged) const {
+        merged.clear();
+        merged.reserve(lhs.size() + rhs.size());
+
+        size_t i = 0;
+        size_t j = 0;
+        while (i < lhs.size() && j < rhs.size()) {
+            const uint32_t idxA = sparseIndex(lhs[i]);
+            const uint32_t idxB = sparseIndex(rhs[j]);
+            if (idxA < idxB) {
+                merged.push_back(lhs[i++]);
+            } else if (idxB < idxA) {
+                merged.push_back(rhs[j++]);
+            } else {
+                const uint8_t rhoA = rhoFromEncoded(lhs[i]);
+                const uint8_t rhoB = rhoFromEncoded(rhs[j]);
+                merged.push_back((rhoB > rhoA) ? rhs[j] : lhs[i]);
+                ++i;
+                ++j;
             }
         }
+        while (i < lhs.size()) {
+            merged.push_back(lhs[i++]);
+        }
+        while (j < rhs.size()) {
+            merged.push_back(rhs[j++]);
+        }
+    }
+
+    void HyperLogLogPlusPlus::flushTmpSetToSparseList() {
+        if (tmpCount == 0u) {
+            return;
+        }
+        SATP_SKETCH_STAT(++stats_.sparseFlushes);
+        SATP_SKETCH_STAT(stats_.flushedEntries += tmpCount);
+
+        reserveSparseBuffers(sparseList.size() + tmpCount);
+        sortedTmpEntries(sparseScratch);
+        ranges::fill(tmpTable, TMP_EMPTY_SLOT);
+        tmpCount = 0u;
 
         if (sparseList.empty()) {
-            sparseList.swap(incomingUnique);
+            sparseList.swap(sparseScratch);
         } else {
-            vector<uint32_t> merged;
-            merged.reserve(sparseList.size() + incomingUnique.size());
-
-            size_t i = 0;
-            size_t j = 0;
-            while (i < sparseList.size() && j < incomingUnique.size()) {
-                const uint32_t idxA = sparseIndex(sparseList[i]);
-                const uint32_t idxB = sparseIndex(incomingUnique[j]);
-                if (idxA < idxB) {
-                    merged.push_back(sparseList[i++]);
-                } else if (idxB < idxA) {
-                    merged.push_back(incomingUnique[j++]);
-                } else {
-                    const uint8_t rhoA = rhoFromEncoded(sparseList[i]);
-                    const uint8_t rhoB = rhoFromEncoded(incomingUnique[j]);
-                    merged.push_back((rhoB > rhoA) ? incomingUnique[j] : sparseList[i]);
-                    ++i;
-                    ++j;
-                }
-            }
-            while (i < sparseList.size()) {
-                merged.push_back(sparseList[i++]);
-            }
-            while (j < incomingUnique.size()) {
-                merged.push_back(incomingUnique[j++]);
-            }
-            sparseList.swap(merged);
+            mergeSparseLists(sparseList, sparseScratch, mergeScratch);
+            sparseList.swap(mergeScratch);
         }
 
         sparseBits = compressedSparseBits();
+        SATP_SKETCH_STAT(stats_.sparseListEntries = sparseList.size());
     }
 
     void HyperLogLogPlusPlus::convertSparseToNormal() {
@@ -318,16 +494,35 @@ namespace satp::algorithms {
         registers.assign(m, 0u);
         sumInversePowers = static_cast<double>(m);
         zeroRegisters = m;
+        registerHistogram.assign((64u - p) + 2u, 0u);
+        registerHistogram[0] = m;
 
         for (const uint32_t encoded: sparseList) {
             const auto [idx, r] = decodeHash(encoded);
             addNormalRegister(idx, r);
         }
 
+        // La tabella vuota resta allocata: reset() la riusa senza allocare.
         sparseList.clear();
         sparseBits = 0u;
-        tmpSet.clear();
+        sparseDistinct = 0u;
+        tmpTable.clear();
+        tmpCount = 0u;
         format = Format::Normal;
+        SATP_SKETCH_STAT(stats_.converted = true);
+        SATP_SKETCH_STAT(stats_.convertedAtInsert = stats_.inserts);
+    }
+
+    void HyperLogLogPlusPlus::addEncodedRegisters(const HyperLogLogPlusPlus &source) {
+        for (const uint32_t encoded: source.sparseList) {
+            const auto [idx, r] = decodeHash(encoded);
+            addNormalRegister(idx, r);
+        }
+        for (const uint32_t encoded: source.tmpTable) {
+            if (encoded == TMP_EMPTY_SLOT) continue;
+            const auto [idx, r] = decodeHash(encoded);
+            addNormalRegister(idx, r);
+        }
     }
 
     void HyperLogLogPlusPlus::addNormalHash(uint64_t hash) {
@@ -341,6 +536,7 @@ namespace satp::algorithms {
 
     void HyperLogLogPlusPlus::addNormalRegister(uint32_t idx, uint8_t r) {
         const uint8_t old = registers[idx];
+        SATP_SKETCH_STAT(stats_.recordRegisterUpdate(r > old));
         if (r <= old) {
             return;
         }
@@ -349,9 +545,27 @@ namespace satp::algorithms {
         if (old == 0u) {
             --zeroRegisters;
         }
+        --registerHistogram[old];
+        ++registerHistogram[r];
         registers[idx] = r;
     }
 
+    // Dimensione e non capacita': conta la rappresentazione attiva (tmpTable e
+    // lista sparse, oppure registri e istogramma), cosi' uno sketch riusato
+    // dopo reset() riporta gli stessi byte di uno nuovo nello stesso stato.
+    size_t HyperLogLogPlusPlus::memoryBytes() const {
+        return sizeof(*this)
+               + registers.size() * sizeof(uint8_t)
+               + (registerHistogram.size() + tmpTable.size() + sparseList.size()) * sizeof(uint32_t);
+    }
+
+    size_t HyperLogLogPlusPlus::logicalBits() const {
+        if (format == Format::Sparse) {
+            return sparseBits + tmpCount * 32u; // sparseBits e' aggiornato a ogni flush
+        }
+        return denseBits();
+    }
+
     size_t HyperLogLogPlusPlus::denseBits() const {
         return static_cast<size_t>(m) * 6u;
     }
@@ -386,38 +600,7 @@ namespace satp::algorithms {
     }
 
     double HyperLogLogPlusPlus::estimateBias(double raw) const {
-        const auto &table = hllpp_tables::table_for_k(p);
-        if (table.empty()) {
-            return 0.0;
-        }
-
-        const size_t neighbors = min(BIAS_K_NEIGHBORS, table.size());
-        vector<pair<double, double> > nearest;
-        nearest.reserve(neighbors);
-
-        for (const auto &[rawPoint, biasPoint]: table) {
-            const double dist = abs(rawPoint - raw);
-            if (nearest.size() < neighbors) {
-                nearest.emplace_back(dist, biasPoint);
-                continue;
-            }
-
-            size_t worst = 0;
-            for (size_t i = 1; i < nearest.size(); ++i) {
-                if (nearest[i].first > nearest[worst].first) {
-                    worst = i;
-                }
-            }
-            if (dist < nearest[worst].first) {
-                nearest[worst] = {dist, biasPoint};
-            }
-        }
-
-        double sumBias = 0.0;
-        for (const auto &[_, b]: nearest) {
-            sumBias += b;
-        }
-        return sumBias / static_cast<double>(nearest.size());
+        return hllpp_tables::estimate_bias(p, raw);
     }
 
     double HyperLogLogPlusPlus::linearCounting(double buckets, double zeros) const {
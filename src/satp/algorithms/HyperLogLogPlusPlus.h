@@ -2,31 +2,73 @@
 
 #include <bit>
 #include <cstdint>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "Algorithm.h"
+#include "RegisterView.h"
+#include "SketchStats.h"
 
 using namespace std;
 
 namespace satp::algorithms {
     class HyperLogLogPlusPlus final : public Algorithm {
     public:
+        // Stimatore della rappresentazione normal. BiasTable e' quello del paper
+        // (tabelle di bias e soglia di linear counting); Improved e' lo stimatore
+        // di Ertl sull'istogramma dei registri, senza tabelle, in O(64 - p).
+        // In sparse entrambi usano linear counting a precisione 25.
+        enum class EstimatorMode {
+            BiasTable,
+            Improved
+        };
+
+        // Indici sparse nuovi accumulati nel buffer temporaneo prima di fonderlo
+        // nella lista sparse ordinata.
+        static constexpr size_t TMP_SET_FLUSH_SIZE = 1u << 12;
+
         // p = number of register index bits (m = 2^p registers).
         // Follows HyperLogLog++ as described by Heule et al. for p in [4, 18].
         explicit HyperLogLogPlusPlus(
             uint32_t K,
             const hashing::HashFunction &hashFunction);
 
+        explicit HyperLogLogPlusPlus(
+            uint32_t K,
+            EstimatorMode mode,
+            const hashing::HashFunction &hashFunction);
+
+        [[nodiscard]] EstimatorMode estimatorMode() const noexcept;
+
         void process(uint32_t id) override;
 
+        void process(uint64_t id) override;
+
+        void process(span<const byte> key) override;
+
+        // Inserts a value already hashed with hashFunction().hash64: lets callers
+        // that feed several sketches with the same hash compute it only once.
+        void addHash(uint64_t hash);
+
         uint64_t count() override;
 
         void reset() override;
 
         string getName() override;
 
+        [[nodiscard]] size_t memoryBytes() const override;
+
+        // Lista sparse compressa piu' il buffer temporaneo in formato sparse,
+        // denseBits() in formato normale.
+        [[nodiscard]] size_t logicalBits() const override;
+
+        // 6 bit per registro: la rappresentazione normale.
+        [[nodiscard]] size_t denseBits() const;
+
+        // Bit della lista sparse con gli indici codificati a differenze varint,
+        // il confronto con denseBits() decide il passaggio al formato normale.
+        [[nodiscard]] size_t compressedSparseBits() const;
+
         void merge(const Algorithm &other) override;
 
         void merge(const HyperLogLogPlusPlus &other);
@@ -35,6 +77,24 @@ namespace satp::algorithms {
 
         [[nodiscard]] HyperLogLogPlusPlus reducedToNaive(uint32_t targetP) const;
 
+        // Stato compatto per gli snapshot dei checkpoint: saveState accoda a
+        // `out`, loadState sostituisce lo stato (stessi parametri, altrimenti
+        // invalid_argument). Dopo loadState count() da' la stessa stima.
+        void saveState(vector<uint8_t> &out) const;
+
+        void loadState(span<const uint8_t> state);
+
+        // Registri correnti per gli stimatori di Estimators.h. In sparse i
+        // registri sono ricostruiti a precisione p.
+        [[nodiscard]] RegisterView registerView() const;
+
+#if SATP_SKETCH_STATS
+        // Contatori interni dall'ultimo reset() (vedi SketchStats.h).
+        [[nodiscard]] const SketchStats &stats() const noexcept {
+            return stats_;
+        }
+#endif
+
     private:
         enum class Format {
             Sparse,
@@ -44,22 +104,40 @@ namespace satp::algorithms {
         static constexpr uint32_t MIN_P = 4;
         static constexpr uint32_t MAX_P = 18;
         static constexpr uint32_t SPARSE_P = 25;
-        static constexpr size_t BIAS_K_NEIGHBORS = 6;
-        static constexpr size_t TMP_SET_FLUSH_SIZE = 1u << 12;
+        static constexpr size_t TMP_TABLE_SIZE = TMP_SET_FLUSH_SIZE * 2u; // potenza di 2, load factor <= 0.5
+        static constexpr uint32_t TMP_EMPTY_SLOT = 0u; // nessun encoding vale 0 (vedi encodeHash)
 
         uint32_t p;
         uint32_t m;
         uint32_t mSparse;
         Format format;
+        EstimatorMode mode;
 
         vector<uint8_t> registers;
         double alphaM;
         double sumInversePowers;
         uint32_t zeroRegisters;
-
-        unordered_set<uint32_t> tmpSet;
-        vector<uint32_t> sparseList;
+        // registerHistogram[r] = registri con valore r, r in [0, 64 - p + 1];
+        // mantenuto solo in normal, per EstimatorMode::Improved.
+        vector<uint32_t> registerHistogram;
+
+        // Buffer degli inserimenti sparse non ancora fusi in sparseList: tabella a
+        // indirizzamento aperto indicizzata per indice sparse, con il rho massimo.
+        vector<uint32_t> tmpTable;
+        size_t tmpCount;
+        vector<uint32_t> sparseList; // ordinata per indice sparse, un encoding per indice
         size_t sparseBits;
+        // Indici sparse distinti tra sparseList e tmpTable: la stima sparse e' O(1)
+        // e count() non deve fondere il buffer.
+        size_t sparseDistinct;
+        // Buffer di flush e merge sparse, scambiati con sparseList invece di
+        // riallocati: dopo un reset() mantengono la capacita' dei run precedenti.
+        vector<uint32_t> sparseScratch;
+        vector<uint32_t> mergeScratch;
+
+#if SATP_SKETCH_STATS
+        SketchStats stats_;
+#endif
 
         static constexpr double ALPHA_16 = 0.673;
         static constexpr double ALPHA_32 = 0.697;
@@ -72,13 +150,20 @@ namespace satp::algorithms {
         [[nodiscard]] HyperLogLogPlusPlus reducePrecision(uint32_t targetP,
                                                           bool correctDroppedBits) const;
 
+        void insertHash(uint64_t hash);
+        void insertSparse(uint32_t encoded);
+        [[nodiscard]] bool sparseListContains(uint32_t sparseIdx) const;
+        void sortedTmpEntries(vector<uint32_t> &out) const;
+        void reserveSparseBuffers(size_t entries);
+        void mergeSparseLists(const vector<uint32_t> &lhs,
+                              const vector<uint32_t> &rhs,
+                              vector<uint32_t> &out) const;
+        void addEncodedRegisters(const HyperLogLogPlusPlus &source);
         void flushTmpSetToSparseList();
         void convertSparseToNormal();
         void addNormalHash(uint64_t hash);
         void addNormalRegister(uint32_t idx, uint8_t rho);
 
-        [[nodiscard]] size_t denseBits() const;
-        [[nodiscard]] size_t compressedSparseBits() const;
         [[nodiscard]] double rawEstimateNormal() const;
         [[nodiscard]] double estimateBias(double raw) const;
         [[nodiscard]] double linearCounting(double buckets, double zeros) const;
@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include "satp/algorithms/AlgorithmCatalog.h"
+#include "SketchState.h"
 
 using namespace std;
 
@@ -12,10 +13,11 @@ namespace satp::algorithms {
         constexpr uint32_t LOGLOG_MIN_K = 4;
         constexpr uint32_t LOGLOG_MAX_K = 16;
         constexpr uint32_t LOGLOG_PAPER_L = 32;
+        constexpr uint32_t LOGLOG_WIDE_L = 64;
 
         [[nodiscard]] uint32_t validateAndBucketCount(uint32_t K, uint32_t L) {
-            if (L != LOGLOG_PAPER_L) {
-                throw invalid_argument("LogLog paper-strict requires L = 32");
+            if (L != LOGLOG_PAPER_L && L != LOGLOG_WIDE_L) {
+                throw invalid_argument("LogLog requires L = 32 or L = 64");
             }
             if (K < LOGLOG_MIN_K || K > LOGLOG_MAX_K) {
                 throw invalid_argument("LogLog paper-strict requires k in [4,16]");
@@ -36,15 +38,39 @@ namespace satp::algorithms {
           sumRegisters(0.0) {}
 
     void LogLog::process(uint32_t id) {
-        const uint32_t hash = hashFunction().hash32(id);
+        if (lengthOfBitMap == LOGLOG_WIDE_L) {
+            insertHash(hashFunction().hash64(id));
+            return;
+        }
+        insertHash(hashFunction().hash32(id));
+    }
+
+    void LogLog::process(uint64_t id) {
+        if (lengthOfBitMap == LOGLOG_WIDE_L) {
+            insertHash(hashFunction().hash64(id));
+            return;
+        }
+        insertHash(hashFunction().hash32(id));
+    }
+
+    void LogLog::process(span<const byte> key) {
+        if (lengthOfBitMap == LOGLOG_WIDE_L) {
+            insertHash(hashFunction().hashBytes64(key));
+            return;
+        }
+        insertHash(hashFunction().hashBytes32(key));
+    }
 
-        const uint32_t firstKBits = hash >> (lengthOfBitMap - k);
-        // the remaining (32-k) bits shifted to the MSB side; rho = leading zeros + 1.
-        const uint32_t rem = hash << k;
+    void LogLog::insertHash(const uint64_t hash) {
         const uint32_t wbits = lengthOfBitMap - k;
+        const auto firstKBits = static_cast<uint32_t>(hash >> wbits);
+        // the remaining (L-k) bits shifted to the MSB side; rho = leading zeros + 1.
+        const uint64_t rem = hash << (64u - wbits);
         const uint32_t b = (rem == 0u) ? (wbits + 1u) : (static_cast<uint32_t>(countl_zero(rem)) + 1u);
 
         const uint32_t old = bitmap[firstKBits];
+        SATP_SKETCH_STAT(++stats_.inserts);
+        SATP_SKETCH_STAT(stats_.recordRegisterUpdate(b > old));
         if (b > old) {
             bitmap[firstKBits] = static_cast<uint8_t>(b);
             sumRegisters += static_cast<double>(b - old);
@@ -59,12 +85,22 @@ namespace satp::algorithms {
     void LogLog::reset() {
         ranges::fill(bitmap, 0u);
         sumRegisters = 0.0;
+        SATP_SKETCH_STAT(stats_ = {});
     }
 
     string LogLog::getName() {
         return catalog::getNameBy("ll");
     }
 
+    size_t LogLog::memoryBytes() const {
+        return sizeof(*this) + bitmap.size() * sizeof(uint8_t);
+    }
+
+    // Un registro contiene rho in [0, L - k + 1].
+    size_t LogLog::logicalBits() const {
+        return static_cast<size_t>(numberOfBuckets) * bit_width(lengthOfBitMap - k + 1u);
+    }
+
     void LogLog::merge(const Algorithm &other) {
         const auto *typed = dynamic_cast<const LogLog *>(&other);
         if (typed == nullptr) {
@@ -77,6 +113,7 @@ namespace satp::algorithms {
         if (k != other.k || lengthOfBitMap != other.lengthOfBitMap || numberOfBuckets != other.numberOfBuckets) {
             throw invalid_argument("LogLog merge requires same k and L");
         }
+        SATP_SKETCH_STAT(++stats_.merges);
 
         for (uint32_t i = 0; i < numberOfBuckets; ++i) {
             bitmap[i] = max(bitmap[i], other.bitmap[i]);
@@ -87,4 +124,45 @@ namespace satp::algorithms {
             sumRegisters += static_cast<double>(reg);
         }
     }
+
+    // Stesso formato di HyperLogLog; la somma delle potenze inverse serve solo
+    // a chi carica lo stato in un HyperLogLog.
+    RegisterView LogLog::registerView() const {
+        return RegisterView(k, lengthOfBitMap, bitmap);
+    }
+
+    void LogLog::saveState(vector<uint8_t> &out) const {
+        double sumInversePowers = 0.0;
+        for (const auto reg : bitmap) {
+            sumInversePowers += ldexp(1.0, -static_cast<int>(reg));
+        }
+        detail::SketchStateWriter writer(out);
+        writer.u32(static_cast<uint32_t>(detail::SketchStateFormat::Registers));
+        writer.u32(k);
+        writer.u32(lengthOfBitMap);
+        writer.f64(sumInversePowers);
+        writer.bytes(bitmap);
+    }
+
+    void LogLog::loadState(const span<const uint8_t> state) {
+        detail::SketchStateReader reader(state);
+        reader.expectFormat(detail::SketchStateFormat::Registers);
+        if (reader.u32() != k || reader.u32() != lengthOfBitMap) {
+            throw invalid_argument("LogLog state requires same k and L");
+        }
+        (void) reader.f64();
+        const auto registers = reader.take(numberOfBuckets);
+        reader.finish();
+
+        const uint32_t maxRho = lengthOfBitMap - k + 1u;
+        if (ranges::any_of(registers, [maxRho](const uint8_t reg) { return reg > maxRho; })) {
+            throw invalid_argument("LogLog state has an invalid register");
+        }
+        ranges::copy(registers, bitmap.begin());
+        // Somma di interi piccoli: esatta in qualunque ordine.
+        sumRegisters = 0.0;
+        for (const auto reg : bitmap) {
+            sumRegisters += static_cast<double>(reg);
+        }
+    }
 } // namespace satp::algorithms
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <stdexcept>
 
 #include "satp/algorithms/AlgorithmCatalog.h"
@@ -12,23 +13,48 @@ namespace satp::algorithms {
     }
 
     void NaiveCounting::process(uint32_t id) {
-        if (!ids.contains(id)) {
-            ids.insert(id);
+        ids.add(id);
+    }
+
+    void NaiveCounting::process(uint64_t id) {
+        if (id <= numeric_limits<uint32_t>::max()) {
+            ids.add(static_cast<uint32_t>(id));
+            return;
         }
+        wideIds.insert(id);
+    }
+
+    void NaiveCounting::process(span<const byte> key) {
+        process(hashFunction().hashBytes64(key));
     }
 
     uint64_t NaiveCounting::count() {
-        return ids.size();
+        return ids.cardinality() + wideIds.size();
     }
 
     void NaiveCounting::reset() {
         ids.clear();
+        wideIds.clear();
     }
 
     string NaiveCounting::getName() {
         return catalog::getNameBy("naive");
     }
 
+    // Nodi di unordered_set come in libstdc++ con hash non memorizzato
+    // (std::hash<uint64_t>): puntatore al successivo piu' valore, piu' un
+    // bucket per elemento al fattore di carico massimo 1.
+    size_t NaiveCounting::memoryBytes() const {
+        return sizeof(*this)
+               + (ids.sizeInBytes() - sizeof(RoaringBitmap))
+               + wideIds.size() * (2u * sizeof(void *) + sizeof(uint64_t));
+    }
+
+    // L'insieme esatto: 32 bit per id stretto, 64 per id largo.
+    size_t NaiveCounting::logicalBits() const {
+        return static_cast<size_t>(ids.cardinality()) * 32u + wideIds.size() * 64u;
+    }
+
     void NaiveCounting::merge(const Algorithm &other) {
         const auto *typed = dynamic_cast<const NaiveCounting *>(&other);
         if (typed == nullptr) {
@@ -38,6 +64,7 @@ namespace satp::algorithms {
     }
 
     void NaiveCounting::merge(const NaiveCounting &other) {
-        ids.insert(other.ids.begin(), other.ids.end());
+        ids.unionWith(other.ids);
+        wideIds.insert(other.wideIds.begin(), other.wideIds.end());
     }
 } // namespace satp::algorithms
@@ -1,22 +1,25 @@
 #pragma once
-#include <vector>
 #include <cstdint>
-#include <set>
+#include <unordered_set>
 
 #include "Algorithm.h"
+#include "RoaringBitmap.h"
 
 using namespace std;
 
 namespace satp::algorithms {
     /**
-     * Implementazione “ingenua”:
-     * mantiene un vettore di tutti gli ID distinti visti finora
-     * e controlla linearmente se l'ID è già presente.
+     * Conteggio esatto (ground truth):
+     * gli ID a 32 bit sono memorizzati in una RoaringBitmap, gli ID oltre 2^32 in un
+     * hash set, perche' nel dominio a 64 bit i container roaring resterebbero quasi vuoti.
+     * Le chiavi di lunghezza arbitraria sono memorizzate come fingerprint a 64 bit
+     * (hashBytes64): il conteggio è esatto a meno di collisioni a 64 bit.
      *
      * Complessità:
-     *   process()  ->  O(n)   (ricerca lineare)
+     *   process()  ->  O(1) ammortizzato
      *   count()    ->  O(1)
-     *   memoria    ->  O(n)   (n = distinti)
+     *   merge()    ->  unione container per container
+     *   memoria    ->  ~2 byte per ID denso a 32 bit, O(n) per ID a 64 bit
      */
     class NaiveCounting final : public Algorithm {
     public:
@@ -25,17 +28,26 @@ namespace satp::algorithms {
 
         void process(uint32_t id) override;
 
+        void process(uint64_t id) override;
+
+        void process(span<const byte> key) override;
+
         uint64_t count() override;
 
         void reset() override;
 
         string getName() override;
 
+        [[nodiscard]] size_t memoryBytes() const override;
+
+        [[nodiscard]] size_t logicalBits() const override;
+
         void merge(const Algorithm &other) override;
 
         void merge(const NaiveCounting &other);
 
     private:
-        set<uint32_t> ids;
+        RoaringBitmap ids;
+        unordered_set<uint64_t> wideIds;
     };
 } // namespace satp::algorithms
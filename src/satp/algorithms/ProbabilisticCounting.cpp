@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "satp/algorithms/AlgorithmCatalog.h"
+#include "SketchState.h"
 
 using namespace std;
 
@@ -18,7 +19,19 @@ namespace satp::algorithms {
     }
 
     void ProbabilisticCounting::process(uint32_t id) {
-        const uint32_t hash = hashFunction().hash32(id) & ((1u << lengthBitMap) - 1u);
+        insertHash(hashFunction().hash32(id));
+    }
+
+    void ProbabilisticCounting::process(uint64_t id) {
+        insertHash(hashFunction().hash32(id));
+    }
+
+    void ProbabilisticCounting::process(span<const byte> key) {
+        insertHash(hashFunction().hashBytes32(key));
+    }
+
+    void ProbabilisticCounting::insertHash(const uint32_t fullHash) {
+        const uint32_t hash = fullHash & ((1u << lengthBitMap) - 1u);
         if (hash == 0) return;
 
         uint32_t rightMostOneBit = static_cast<uint32_t>(countr_zero(hash));
@@ -42,6 +55,14 @@ namespace satp::algorithms {
         return catalog::getNameBy("pc");
     }
 
+    size_t ProbabilisticCounting::memoryBytes() const {
+        return sizeof(*this);
+    }
+
+    size_t ProbabilisticCounting::logicalBits() const {
+        return lengthBitMap;
+    }
+
     void ProbabilisticCounting::merge(const Algorithm &other) {
         const auto *typed = dynamic_cast<const ProbabilisticCounting *>(&other);
         if (typed == nullptr) {
@@ -56,4 +77,25 @@ namespace satp::algorithms {
         }
         bitmap |= other.bitmap;
     }
+
+    void ProbabilisticCounting::saveState(vector<uint8_t> &out) const {
+        detail::SketchStateWriter writer(out);
+        writer.u32(static_cast<uint32_t>(detail::SketchStateFormat::Bitmap));
+        writer.u32(lengthBitMap);
+        writer.u32(bitmap);
+    }
+
+    void ProbabilisticCounting::loadState(const span<const uint8_t> state) {
+        detail::SketchStateReader reader(state);
+        reader.expectFormat(detail::SketchStateFormat::Bitmap);
+        if (reader.u32() != lengthBitMap) {
+            throw invalid_argument("ProbabilisticCounting state requires same L");
+        }
+        const uint32_t saved = reader.u32();
+        reader.finish();
+        if ((saved >> lengthBitMap) != 0u) {
+            throw invalid_argument("ProbabilisticCounting state has bits beyond L");
+        }
+        bitmap = saved;
+    }
 } // namespace satp::algorithms
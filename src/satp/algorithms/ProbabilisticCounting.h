@@ -18,17 +18,34 @@ namespace satp::algorithms {
 
         void process(uint32_t id) override;
 
+        void process(uint64_t id) override;
+
+        void process(span<const byte> key) override;
+
         uint64_t count() override;
 
         void reset() override;
 
         string getName() override;
 
+        [[nodiscard]] size_t memoryBytes() const override;
+
+        [[nodiscard]] size_t logicalBits() const override;
+
         void merge(const Algorithm &other) override;
 
         void merge(const ProbabilisticCounting &other);
 
+        // Stato compatto per gli snapshot dei checkpoint: saveState accoda a
+        // `out`, loadState sostituisce lo stato (stessi parametri, altrimenti
+        // invalid_argument). Dopo loadState count() da' la stessa stima.
+        void saveState(vector<uint8_t> &out) const;
+
+        void loadState(span<const uint8_t> state);
+
     private:
+        void insertHash(uint32_t hash);
+
         uint32_t lengthBitMap;
         uint32_t bitmap;
 
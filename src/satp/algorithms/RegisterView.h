@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace satp::algorithms {
+    /**
+     * @brief Vista in sola lettura dei registri di uno sketch della famiglia LogLog.
+     *
+     * Gli stimatori lavorano solo sull'istogramma dei valori dei registri:
+     * histogram()[r] = numero di registri con valore r, per r in [0, q + 1]
+     * con q = hashBits - precision. Lo stesso stato si puo' cosi' stimare con
+     * piu' stimatori senza reinserire gli elementi.
+     */
+    class RegisterView {
+    public:
+        RegisterView(const uint32_t precision,
+                     const uint32_t hashBits,
+                     const span<const uint8_t> registers)
+            : precision_(precision),
+              hashBits_(hashBits),
+              histogram_(static_cast<size_t>(hashBits - precision) + 2u, 0u) {
+            if (precision == 0u || precision >= hashBits || registers.size() != (size_t{1} << precision)) {
+                throw invalid_argument("RegisterView requires m = 2^precision registers");
+            }
+            for (const uint8_t reg : registers) {
+                if (reg >= histogram_.size()) {
+                    throw invalid_argument("RegisterView register out of range");
+                }
+                ++histogram_[reg];
+            }
+        }
+
+        // p: m = 2^p registri.
+        [[nodiscard]] uint32_t precision() const noexcept {
+            return precision_;
+        }
+
+        [[nodiscard]] uint32_t m() const noexcept {
+            return 1u << precision_;
+        }
+
+        // Bit di hash usati dallo sketch (32 o 64).
+        [[nodiscard]] uint32_t hashBits() const noexcept {
+            return hashBits_;
+        }
+
+        // q: bit di hash dopo l'indice; i registri valgono al piu' q + 1.
+        [[nodiscard]] uint32_t q() const noexcept {
+            return hashBits_ - precision_;
+        }
+
+        [[nodiscard]] span<const uint32_t> histogram() const noexcept {
+            return histogram_;
+        }
+
+        [[nodiscard]] uint32_t zeroRegisters() const noexcept {
+            return histogram_.front();
+        }
+
+    private:
+        uint32_t precision_;
+        uint32_t hashBits_;
+        vector<uint32_t> histogram_;
+    };
+} // namespace satp::algorithms
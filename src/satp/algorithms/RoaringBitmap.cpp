@@ -0,0 +1,319 @@
+#include "RoaringBitmap.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+using namespace std;
+
+namespace satp::algorithms {
+    namespace {
+        constexpr size_t DIRECT_INDEX_SLOTS = size_t{1} << 16u;
+
+        void setBit(vector<uint64_t> &bits, const uint32_t low) {
+            bits[low >> 6u] |= uint64_t{1} << (low & 63u);
+        }
+
+        // Imposta i bit in [first, last] (estremi inclusi).
+        void setRange(vector<uint64_t> &bits, const uint32_t first, const uint32_t last) {
+            const uint32_t firstWord = first >> 6u;
+            const uint32_t lastWord = last >> 6u;
+            const uint64_t firstMask = ~uint64_t{0} << (first & 63u);
+            const uint64_t lastMask = ~uint64_t{0} >> (63u - (last & 63u));
+            if (firstWord == lastWord) {
+                bits[firstWord] |= firstMask & lastMask;
+                return;
+            }
+            bits[firstWord] |= firstMask;
+            for (uint32_t w = firstWord + 1u; w < lastWord; ++w) {
+                bits[w] = ~uint64_t{0};
+            }
+            bits[lastWord] |= lastMask;
+        }
+
+        [[nodiscard]] uint32_t popcountWords(const vector<uint64_t> &bits) {
+            uint32_t total = 0;
+            for (const uint64_t word : bits) {
+                total += static_cast<uint32_t>(popcount(word));
+            }
+            return total;
+        }
+
+        // Visita in ordine crescente i 16 bit bassi memorizzati nel container,
+        // secondo il suo tipo: gli altri vettori possono contenere dati residui.
+        template<typename ContainerT, typename Fn>
+        void forEachValue(const ContainerT &container, Fn &&fn) {
+            using Type = decltype(container.type);
+            switch (container.type) {
+                case Type::Array:
+                    for (const uint16_t value : container.array) fn(static_cast<uint32_t>(value));
+                    return;
+                case Type::Bitmap:
+                    for (uint32_t w = 0; w < container.bits.size(); ++w) {
+                        uint64_t word = container.bits[w];
+                        while (word != 0u) {
+                            fn((w << 6u) + static_cast<uint32_t>(countr_zero(word)));
+                            word &= word - 1u;
+                        }
+                    }
+                    return;
+                case Type::Run:
+                    for (const auto &run : container.runs) {
+                        const uint32_t last = static_cast<uint32_t>(run.start) + run.length;
+                        for (uint32_t value = run.start; value <= last; ++value) fn(value);
+                    }
+                    return;
+            }
+        }
+    } // namespace
+
+    int32_t RoaringBitmap::findContainer(const uint16_t key) const {
+        if (!directIndex_.empty()) return directIndex_[key];
+        const auto it = ranges::lower_bound(keys_, key);
+        if (it == keys_.end() || *it != key) return -1;
+        return static_cast<int32_t>(distance(keys_.begin(), it));
+    }
+
+    size_t RoaringBitmap::findOrCreateContainer(const uint16_t key) {
+        const int32_t found = findContainer(key);
+        if (found >= 0) return static_cast<size_t>(found);
+
+        if (!directIndex_.empty()) {
+            keys_.push_back(key);
+            containers_.emplace_back();
+            directIndex_[key] = static_cast<int32_t>(containers_.size() - 1u);
+            return containers_.size() - 1u;
+        }
+
+        const auto pos = static_cast<size_t>(distance(keys_.begin(), ranges::lower_bound(keys_, key)));
+        keys_.insert(keys_.begin() + static_cast<ptrdiff_t>(pos), key);
+        containers_.insert(containers_.begin() + static_cast<ptrdiff_t>(pos), Container{});
+        if (keys_.size() > DIRECT_INDEX_THRESHOLD) {
+            buildDirectIndex();
+        }
+        return pos;
+    }
+
+    void RoaringBitmap::buildDirectIndex() {
+        directIndex_.assign(DIRECT_INDEX_SLOTS, -1);
+        for (size_t i = 0; i < keys_.size(); ++i) {
+            directIndex_[keys_[i]] = static_cast<int32_t>(i);
+        }
+    }
+
+    bool RoaringBitmap::add(const uint32_t value) {
+        const auto key = static_cast<uint16_t>(value >> 16u);
+        const auto low = static_cast<uint16_t>(value & 0xFFFFu);
+        if (!addToContainer(containers_[findOrCreateContainer(key)], low)) return false;
+        ++cardinality_;
+        return true;
+    }
+
+    bool RoaringBitmap::contains(const uint32_t value) const {
+        const int32_t index = findContainer(static_cast<uint16_t>(value >> 16u));
+        if (index < 0) return false;
+        return containerContains(containers_[static_cast<size_t>(index)], static_cast<uint16_t>(value & 0xFFFFu));
+    }
+
+    bool RoaringBitmap::addToContainer(Container &container, const uint16_t low) {
+        if (container.type == ContainerType::Run) {
+            expandRuns(container);
+        }
+        if (container.type == ContainerType::Array) {
+            const auto it = ranges::lower_bound(container.array, low);
+            if (it != container.array.end() && *it == low) return false;
+            if (container.cardinality < ARRAY_MAX_CARDINALITY) {
+                container.array.insert(it, low);
+                ++container.cardinality;
+                return true;
+            }
+            toBitmap(container);
+        }
+
+        uint64_t &word = container.bits[low >> 6u];
+        const uint64_t mask = uint64_t{1} << (low & 63u);
+        if ((word & mask) != 0u) return false;
+        word |= mask;
+        ++container.cardinality;
+        return true;
+    }
+
+    bool RoaringBitmap::containerContains(const Container &container, const uint16_t low) {
+        switch (container.type) {
+            case ContainerType::Array:
+                return ranges::binary_search(container.array, low);
+            case ContainerType::Bitmap:
+                return ((container.bits[low >> 6u] >> (low & 63u)) & 1u) != 0u;
+            case ContainerType::Run: {
+                const auto it = ranges::upper_bound(container.runs, low, {}, &Run::start);
+                if (it == container.runs.begin()) return false;
+                const auto &run = *prev(it);
+                return static_cast<uint32_t>(low) <= static_cast<uint32_t>(run.start) + run.length;
+            }
+        }
+        return false;
+    }
+
+    void RoaringBitmap::unionWith(const RoaringBitmap &other) {
+        if (&other == this) return;
+        for (size_t i = 0; i < other.containers_.size(); ++i) {
+            Container &target = containers_[findOrCreateContainer(other.keys_[i])];
+            if (target.cardinality == 0u) {
+                target = other.containers_[i];
+            } else {
+                unionContainers(target, other.containers_[i]);
+            }
+        }
+        cardinality_ = 0;
+        for (const auto &container : containers_) {
+            cardinality_ += container.cardinality;
+        }
+    }
+
+    void RoaringBitmap::unionContainers(Container &target, const Container &source) {
+        if (target.type == ContainerType::Run) {
+            expandRuns(target);
+        }
+        if (target.type == ContainerType::Array && source.type == ContainerType::Array) {
+            vector<uint16_t> merged;
+            merged.reserve(target.array.size() + source.array.size());
+            ranges::set_union(target.array, source.array, back_inserter(merged));
+            target.array = move(merged);
+            target.cardinality = static_cast<uint32_t>(target.array.size());
+            if (target.cardinality > ARRAY_MAX_CARDINALITY) {
+                toBitmap(target);
+            }
+            return;
+        }
+
+        toBitmap(target);
+        switch (source.type) {
+            case ContainerType::Array:
+                for (const uint16_t low : source.array) setBit(target.bits, low);
+                break;
+            case ContainerType::Bitmap:
+                for (size_t w = 0; w < BITMAP_WORDS; ++w) target.bits[w] |= source.bits[w];
+                break;
+            case ContainerType::Run:
+                for (const auto &run : source.runs) {
+                    setRange(target.bits, run.start, static_cast<uint32_t>(run.start) + run.length);
+                }
+                break;
+        }
+        target.cardinality = popcountWords(target.bits);
+        if (target.cardinality <= ARRAY_MAX_CARDINALITY) {
+            toArray(target);
+        }
+    }
+
+    void RoaringBitmap::toBitmap(Container &container) {
+        if (container.type == ContainerType::Bitmap) return;
+        vector<uint64_t> bits(BITMAP_WORDS, 0u);
+        if (container.type == ContainerType::Array) {
+            for (const uint16_t low : container.array) setBit(bits, low);
+        } else {
+            for (const auto &run : container.runs) {
+                setRange(bits, run.start, static_cast<uint32_t>(run.start) + run.length);
+            }
+        }
+        container.array = vector<uint16_t>();
+        container.runs = vector<Run>();
+        container.bits = move(bits);
+        container.type = ContainerType::Bitmap;
+    }
+
+    void RoaringBitmap::toArray(Container &container) {
+        if (container.type == ContainerType::Array) return;
+        vector<uint16_t> values;
+        values.reserve(container.cardinality);
+        forEachValue(container, [&values](const uint32_t low) { values.push_back(static_cast<uint16_t>(low)); });
+        container.bits = vector<uint64_t>();
+        container.runs = vector<Run>();
+        container.array = move(values);
+        container.type = ContainerType::Array;
+    }
+
+    void RoaringBitmap::toRuns(Container &container) {
+        if (container.type == ContainerType::Run) return;
+        vector<Run> runs;
+        runs.reserve(countRuns(container));
+        forEachValue(container, [&runs](const uint32_t low) {
+            if (!runs.empty() && static_cast<uint32_t>(runs.back().start) + runs.back().length + 1u == low) {
+                ++runs.back().length;
+                return;
+            }
+            runs.push_back(Run{static_cast<uint16_t>(low), 0u});
+        });
+        container.array = vector<uint16_t>();
+        container.bits = vector<uint64_t>();
+        container.runs = move(runs);
+        container.type = ContainerType::Run;
+    }
+
+    void RoaringBitmap::expandRuns(Container &container) {
+        if (container.cardinality > ARRAY_MAX_CARDINALITY) {
+            toBitmap(container);
+        } else {
+            toArray(container);
+        }
+    }
+
+    size_t RoaringBitmap::countRuns(const Container &container) {
+        switch (container.type) {
+            case ContainerType::Array: {
+                size_t runs = container.array.empty() ? 0u : 1u;
+                for (size_t i = 1; i < container.array.size(); ++i) {
+                    if (container.array[i] != container.array[i - 1u] + 1u) ++runs;
+                }
+                return runs;
+            }
+            case ContainerType::Bitmap: {
+                // Un run inizia dove un bit e' 1 e il precedente e' 0.
+                size_t runs = 0;
+                uint64_t carry = 0;
+                for (const uint64_t word : container.bits) {
+                    runs += static_cast<size_t>(popcount(word & ~((word << 1u) | carry)));
+                    carry = word >> 63u;
+                }
+                return runs;
+            }
+            case ContainerType::Run:
+                return container.runs.size();
+        }
+        return 0;
+    }
+
+    void RoaringBitmap::runOptimize() {
+        for (auto &container : containers_) {
+            const size_t runBytes = 2u + 4u * countRuns(container);
+            const size_t denseBytes = (container.cardinality > ARRAY_MAX_CARDINALITY)
+                                          ? BITMAP_WORDS * sizeof(uint64_t)
+                                          : 2u * static_cast<size_t>(container.cardinality);
+            if (runBytes < denseBytes) {
+                toRuns(container);
+            } else if (container.type == ContainerType::Run) {
+                expandRuns(container);
+            }
+        }
+    }
+
+    void RoaringBitmap::clear() {
+        keys_.clear();
+        containers_.clear();
+        directIndex_.clear();
+        cardinality_ = 0;
+    }
+
+    size_t RoaringBitmap::sizeInBytes() const {
+        size_t bytes = sizeof(*this)
+                       + keys_.size() * sizeof(uint16_t)
+                       + containers_.size() * sizeof(Container)
+                       + directIndex_.size() * sizeof(int32_t);
+        for (const auto &container : containers_) {
+            bytes += container.array.size() * sizeof(uint16_t)
+                    + container.bits.size() * sizeof(uint64_t)
+                    + container.runs.size() * sizeof(Run);
+        }
+        return bytes;
+    }
+} // namespace satp::algorithms
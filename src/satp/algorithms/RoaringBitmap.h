@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+namespace satp::algorithms {
+    /**
+     * Bitmap compressa "roaring" su valori a 32 bit: i 16 bit alti selezionano un
+     * container, i 16 bit bassi sono memorizzati nel container come
+     * - array ordinato di uint16_t (cardinalita' <= 4096),
+     * - bitmap da 2^16 bit (cardinalita' > 4096),
+     * - sequenza di run [start, start + length] (solo dopo runOptimize()).
+     *
+     * Finche' i container sono pochi la ricerca e' binaria sulle chiavi ordinate;
+     * oltre DIRECT_INDEX_THRESHOLD viene costruito un indice diretto da 65536 slot
+     * e add() diventa O(1) ammortizzato. La cardinalita' e' mantenuta
+     * incrementalmente e ricalcolata con popcount dopo unionWith().
+     */
+    class RoaringBitmap {
+    public:
+        // Ritorna true se il valore non era presente.
+        bool add(uint32_t value);
+
+        [[nodiscard]] bool contains(uint32_t value) const;
+
+        [[nodiscard]] uint64_t cardinality() const { return cardinality_; }
+
+        void unionWith(const RoaringBitmap &other);
+
+        // Converte in run i container per cui la codifica a run e' la piu' compatta.
+        void runOptimize();
+
+        void clear();
+
+        [[nodiscard]] size_t containerCount() const { return containers_.size(); }
+
+        [[nodiscard]] size_t sizeInBytes() const;
+
+    private:
+        enum class ContainerType : uint8_t { Array, Bitmap, Run };
+
+        struct Run {
+            uint16_t start;
+            uint16_t length; // il run copre [start, start + length]
+        };
+
+        struct Container {
+            ContainerType type = ContainerType::Array;
+            uint32_t cardinality = 0;
+            vector<uint16_t> array;
+            vector<uint64_t> bits;
+            vector<Run> runs;
+        };
+
+        [[nodiscard]] int32_t findContainer(uint16_t key) const;
+
+        [[nodiscard]] size_t findOrCreateContainer(uint16_t key);
+
+        void buildDirectIndex();
+
+        static bool addToContainer(Container &container, uint16_t low);
+
+        static bool containerContains(const Container &container, uint16_t low);
+
+        static void unionContainers(Container &target, const Container &source);
+
+        static void toBitmap(Container &container);
+
+        static void toArray(Container &container);
+
+        static void toRuns(Container &container);
+
+        static void expandRuns(Container &container);
+
+        static size_t countRuns(const Container &container);
+
+        static constexpr uint32_t ARRAY_MAX_CARDINALITY = 4096;
+        static constexpr size_t BITMAP_WORDS = 1024;
+        static constexpr size_t DIRECT_INDEX_THRESHOLD = 64;
+
+        vector<uint16_t> keys_; // ordinate finche' directIndex_ e' vuoto
+        vector<Container> containers_;
+        vector<int32_t> directIndex_; // 65536 slot, -1 = nessun container
+        uint64_t cardinality_ = 0;
+    };
+} // namespace satp::algorithms
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace satp::algorithms::detail {
+    // Formati dello stato serializzato (saveState/loadState). HyperLogLog e
+    // LogLog condividono i registri: lo stato di uno si puo' caricare nell'altro.
+    enum class SketchStateFormat : uint32_t {
+        Registers = 1,
+        Bitmap = 2,
+        HyperLogLogPlusPlus = 3
+    };
+
+    // Accoda campi little-endian a un buffer esterno, riusabile tra snapshot.
+    class SketchStateWriter {
+    public:
+        explicit SketchStateWriter(vector<uint8_t> &out) : out_(out) {
+        }
+
+        void u32(const uint32_t value) {
+            for (uint32_t shift = 0; shift < 32u; shift += 8u) {
+                out_.push_back(static_cast<uint8_t>(value >> shift));
+            }
+        }
+
+        void f64(const double value) {
+            const auto bits = bit_cast<uint64_t>(value);
+            u32(static_cast<uint32_t>(bits));
+            u32(static_cast<uint32_t>(bits >> 32u));
+        }
+
+        void bytes(const span<const uint8_t> values) {
+            out_.insert(out_.end(), values.begin(), values.end());
+        }
+
+    private:
+        vector<uint8_t> &out_;
+    };
+
+    class SketchStateReader {
+    public:
+        explicit SketchStateReader(const span<const uint8_t> state) : state_(state) {
+        }
+
+        [[nodiscard]] uint32_t u32() {
+            const auto raw = take(4u);
+            return static_cast<uint32_t>(raw[0])
+                   | (static_cast<uint32_t>(raw[1]) << 8u)
+                   | (static_cast<uint32_t>(raw[2]) << 16u)
+                   | (static_cast<uint32_t>(raw[3]) << 24u);
+        }
+
+        [[nodiscard]] double f64() {
+            const uint64_t low = u32();
+            const uint64_t high = u32();
+            return bit_cast<double>(low | (high << 32u));
+        }
+
+        [[nodiscard]] span<const uint8_t> take(const size_t count) {
+            if (state_.size() - offset_ < count) {
+                throw invalid_argument("Sketch state truncated");
+            }
+            const auto out = state_.subspan(offset_, count);
+            offset_ += count;
+            return out;
+        }
+
+        void expectFormat(const SketchStateFormat format) {
+            if (u32() != static_cast<uint32_t>(format)) {
+                throw invalid_argument("Sketch state has a different format");
+            }
+        }
+
+        void finish() const {
+            if (offset_ != state_.size()) {
+                throw invalid_argument("Sketch state has trailing bytes");
+            }
+        }
+
+    private:
+        span<const uint8_t> state_;
+        size_t offset_ = 0;
+    };
+} // namespace satp::algorithms::detail
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+using namespace std;
+
+// Contatori interni degli sketch (opzione CMake SATP_SKETCH_STATS). Senza la
+// macro SATP_SKETCH_STAT non genera codice e gli sketch non hanno stats().
+#if SATP_SKETCH_STATS
+#define SATP_SKETCH_STAT(statement) statement
+#else
+#define SATP_SKETCH_STAT(statement) static_cast<void>(0)
+#endif
+
+namespace satp::algorithms {
+#if SATP_SKETCH_STATS
+    inline constexpr bool SKETCH_STATS_ENABLED = true;
+#else
+    inline constexpr bool SKETCH_STATS_ENABLED = false;
+#endif
+
+    // Eventi dall'ultimo reset() dello sketch. In HLL++ gli aggiornamenti dei
+    // registri contano anche quelli di merge e conversione sparse -> normal;
+    // in HLL e LogLog solo quelli di process().
+    struct SketchStats {
+        uint64_t inserts = 0;          // hash inseriti da process()/addHash()
+        uint64_t registerWrites = 0;   // registri aumentati
+        uint64_t noOpUpdates = 0;      // aggiornamenti con rho non maggiore del registro
+        uint64_t sparseFlushes = 0;    // flush del buffer temporaneo nella lista sparse (HLL++)
+        uint64_t flushedEntries = 0;   // indici del buffer fusi nei flush
+        uint64_t sparseListEntries = 0; // lunghezza della lista sparse dopo l'ultimo flush
+        bool converted = false;        // passaggio sparse -> normal avvenuto (HLL++)
+        uint64_t convertedAtInsert = 0; // inserts al momento del passaggio
+        uint64_t merges = 0;
+
+        void recordRegisterUpdate(const bool written) noexcept {
+            if (written) {
+                ++registerWrites;
+            } else {
+                ++noOpUpdates;
+            }
+        }
+    };
+} // namespace satp::algorithms
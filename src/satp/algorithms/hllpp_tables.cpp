@@ -1,4 +1,7 @@
 #include "hllpp_tables.h"
+#include <array>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <string_view>
 #include <stdexcept>
@@ -881,3 +884,39 @@ uint32_t satp::algorithms::hllpp_tables::threshold_for_k(size_t k) {
         throw out_of_range{"threshold table: K out of range"};
     return THRESHOLDS[k - MIN_K];
 }
+
+double satp::algorithms::hllpp_tables::estimate_bias(size_t k, double raw) {
+    const auto &table = table_for_k(k);
+    if (table.empty()) {
+        return 0.0;
+    }
+
+    // Vicini su stack: count() viene chiamato a ogni checkpoint e non deve allocare.
+    const size_t neighbors = min(BIAS_NEIGHBORS, table.size());
+    array<pair<double, double>, BIAS_NEIGHBORS> nearest{};
+    size_t found = 0;
+
+    for (const auto &[rawPoint, biasPoint]: table) {
+        const double dist = abs(rawPoint - raw);
+        if (found < neighbors) {
+            nearest[found++] = {dist, biasPoint};
+            continue;
+        }
+
+        size_t worst = 0;
+        for (size_t i = 1; i < found; ++i) {
+            if (nearest[i].first > nearest[worst].first) {
+                worst = i;
+            }
+        }
+        if (dist < nearest[worst].first) {
+            nearest[worst] = {dist, biasPoint};
+        }
+    }
+
+    double sumBias = 0.0;
+    for (size_t i = 0; i < found; ++i) {
+        sumBias += nearest[i].second;
+    }
+    return sumBias / static_cast<double>(found);
+}
@@ -13,4 +13,10 @@ namespace satp::algorithms::hllpp_tables {
     extern const vector<pair<double, double> > &table_for_k(size_t k);
 
     extern uint32_t threshold_for_k(size_t k);
+
+    // Bias della stima raw: media dei BIAS_NEIGHBORS punti della tabella piu'
+    // vicini a `raw` (Heule et al., sezione 5.2).
+    inline constexpr size_t BIAS_NEIGHBORS = 6;
+
+    extern double estimate_bias(size_t k, double raw);
 } // namespace satp::algorithms::hllpp_tables
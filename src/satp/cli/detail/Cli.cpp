@@ -17,12 +17,20 @@ namespace satp::cli {
             if (commandName == "runstream") return RunMode::Streaming;
             if (commandName == "runmerge") return RunMode::Merge;
             if (commandName == "runmergehet") return RunMode::MergeHeterogeneous;
+            if (commandName == "runmergetopo") return RunMode::MergeTopology;
+            if (commandName == "runmergematrix") return RunMode::MergeMatrix;
+            if (commandName == "runestimators") return RunMode::Estimators;
+            if (commandName == "runlatency") return RunMode::Latency;
             return nullopt;
         }
 
         [[nodiscard]] const char *runUsageByMode(const RunMode mode) {
             if (mode == RunMode::Streaming) return "Uso: runstream <algo|all>";
             if (mode == RunMode::MergeHeterogeneous) return "Uso: runmergehet <algo|all>";
+            if (mode == RunMode::MergeTopology) return "Uso: runmergetopo <algo|all>";
+            if (mode == RunMode::MergeMatrix) return "Uso: runmergematrix <algo|all>";
+            if (mode == RunMode::Estimators) return "Uso: runestimators <algo|all>";
+            if (mode == RunMode::Latency) return "Uso: runlatency <algo|all>";
             return "Uso: runmerge <algo|all>";
         }
     } // namespace
@@ -64,6 +72,22 @@ namespace satp::cli {
                 executor_.run(config_, cmd.args, *mode);
                 continue;
             }
+            if (cmd.name == "reestimate") {
+                if (cmd.args.size() < 2) {
+                    cout << "Uso: reestimate <from> <to>\n";
+                    continue;
+                }
+                executor_.reestimate(config_, cmd.args[0], cmd.args[1]);
+                continue;
+            }
+            if (cmd.name == "runsim") {
+                if (cmd.args.empty()) {
+                    cout << "Uso: runsim <algo|all>\n";
+                    continue;
+                }
+                executor_.simulate(config_, cmd.args);
+                continue;
+            }
             if (cmd.name == "quit") {
                 break;
             }
@@ -6,12 +6,19 @@
 #include <string>
 #include <vector>
 
+#include "satp/algorithms/HyperLogLogPlusPlus.h"
 #include "satp/dataset/Dataset.h"
 #include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
+#include "satp/simulation/detail/metrics/EarlyStopping.h"
 
 using namespace std;
 
 namespace satp::cli {
+    enum class StreamingTraceFormat {
+        Csv,
+        Binary
+    };
+
     struct RunConfig {
         string datasetPath = "dataset.bin";
         string resultsNamespace = "legacy";
@@ -26,6 +33,35 @@ namespace satp::cli {
         uint32_t l = 16;    // bitmap size for PC
         uint32_t lLog = 32; // bitmap size for LogLog internals
         satp::evaluation::MergeStrategy mergeStrategy = satp::evaluation::MergeStrategy::Direct;
+        satp::evaluation::MergeTopology mergeTopology = satp::evaluation::MergeTopology::BalancedTree;
+        uint32_t topologyPartitions = 0;                // 0 = tutte le partizioni
+        optional<uint32_t> topologySampleSeed = nullopt; // nullopt = prime partizioni, senza campionamento
+        uint32_t workers = 0;                           // 0 = hardware_concurrency
+        uint32_t checkpoints = 200;                     // budget streaming; 0 = un checkpoint per elemento
+        StreamingTraceFormat streamingTrace = StreamingTraceFormat::Csv;
+        bool errorQuantiles = false;                    // colonne p50/p95/p99 dell'errore relativo
+        bool resume = false;                            // salta i job completati e riprende runstream
+        double stopWidth = 0.0;                         // arresto anticipato di runstream; 0 = disattivato
+        satp::evaluation::StoppingMetric stopMetric = satp::evaluation::StoppingMetric::MeanRelativeError;
+        bool snapshots = false;                         // runstream salva lo stato degli sketch per reestimate
+        bool perfCounters = false;                      // contatori hardware per fase in timing.csv
+        string tracePath;                               // timeline Chrome trace dei job; vuoto = disattivata
+        vector<string> estimators;                      // stimatori di runestimators; vuoto = tutti
+        satp::algorithms::HyperLogLogPlusPlus::EstimatorMode hllppEstimator =
+            satp::algorithms::HyperLogLogPlusPlus::EstimatorMode::BiasTable; // table | improved
+        uint64_t simMaxN = 1'000'000'000;                // runsim: cardinalita' dell'ultimo checkpoint
+        uint32_t simRuns = 100;                         // runsim: run simulati, indipendenti dal dataset
+        uint32_t simSeed = 1;
+        uint32_t latencyBatch = 1;                      // runlatency: process() per misura
+        double latencyRate = 0.0;                       // runlatency: elementi/s di replay; 0 = a piena velocita'
+        // Assi della matrice di runmergematrix; una lista vuota usa il parametro singolo corrispondente.
+        vector<string> matrixLeftHashes;
+        vector<string> matrixRightHashes;
+        vector<optional<uint32_t>> matrixLeftSeeds;  // nullopt = seed del dataset
+        vector<optional<uint32_t>> matrixRightSeeds;
+        vector<uint32_t> matrixLeftK;
+        vector<uint32_t> matrixRightK;
+        vector<satp::evaluation::MergeStrategy> matrixStrategies;
     };
 
     struct Command {
@@ -36,7 +72,13 @@ namespace satp::cli {
     enum class RunMode {
         Streaming,
         Merge,
-        MergeHeterogeneous
+        MergeHeterogeneous,
+        MergeTopology,
+        MergeMatrix,
+        Reestimate,
+        Estimators,
+        Simulation,
+        Latency
     };
 
     struct DatasetView {
@@ -51,6 +93,11 @@ namespace satp::cli {
         size_t runs = 0;
         uint32_t seed = 0;
         string resultsNamespace;
+        StreamingTraceFormat streamingTrace = StreamingTraceFormat::Csv;
+        bool resume = false;
+        bool snapshots = false;
+        vector<string> estimators;
+        filesystem::path datasetPath;
         filesystem::path repoRoot;
     };
 
@@ -1,5 +1,7 @@
 #include "satp/cli/detail/ExecutionCoordinator.h"
 
+#include <filesystem>
+#include <iostream>
 #include <utility>
 
 #include "satp/cli/detail/config/DatasetRuntime.h"
@@ -7,17 +9,60 @@
 #include "satp/cli/detail/execution/JobFactory.h"
 #include "satp/cli/detail/execution/RunReporter.h"
 #include "satp/hashing/HashFactory.h"
+#include "satp/profiling/PerfCounters.h"
+#include "satp/profiling/TraceSink.h"
 #include "satp/simulation/Simulation.h"
 
 using namespace std;
 
 namespace satp::cli {
+    namespace {
+        // Raccoglie la timeline dei job e la scrive a fine comando; anche se un
+        // job fallisce la raccolta viene disattivata.
+        class TraceSession {
+        public:
+            explicit TraceSession(const string &path)
+                : path_(path) {
+                if (!path_.empty()) satp::profiling::TraceSink::start();
+            }
+
+            ~TraceSession() {
+                satp::profiling::TraceSink::stop();
+            }
+
+            TraceSession(const TraceSession &) = delete;
+            TraceSession &operator=(const TraceSession &) = delete;
+
+            void finish() const {
+                if (path_.empty()) return;
+                satp::profiling::TraceSink::stop();
+                satp::profiling::TraceSink::write(path_);
+                cout << "[trace] " << satp::profiling::TraceSink::eventCount() << " span scritti in " << path_ << '\n';
+            }
+
+        private:
+            filesystem::path path_;
+        };
+    } // namespace
+
     void ExecutionCoordinator::run(const RunConfig &cfg,
                                    const vector<string> &algs,
                                    const RunMode mode) const {
         auto ctx = config::loadDatasetRuntimeContext(cfg);
         auto runtimeHash = satp::hashing::getHashFunctionBy(cfg.hashFunctionName, ctx.seed);
         satp::evaluation::EvaluationFramework bench(std::move(ctx.index), std::move(runtimeHash));
+        bench.setWorkerCount(cfg.workers);
+        bench.setStreamingCheckpoints((cfg.checkpoints == 0u)
+                                          ? satp::evaluation::EvaluationFramework::ALL_STREAMING_CHECKPOINTS
+                                          : cfg.checkpoints);
+        bench.setStreamingErrorQuantiles(cfg.errorQuantiles);
+        bench.setStreamingEarlyStopping({cfg.stopWidth, cfg.stopMetric});
+        bench.setHardwareCounters(cfg.perfCounters);
+        bench.setLatencyOptions({cfg.latencyBatch, cfg.latencyRate});
+        if (cfg.perfCounters && !satp::profiling::PerfCounters().available()) {
+            cout << "[perf] contatori hardware non disponibili (perf_event_paranoid o PMU assente): "
+                    "timing.csv avra' le colonne dei contatori vuote\n";
+        }
 
         const auto selected = executor::collectRequestedAlgorithms(algs);
         vector<executor::AlgorithmJob> jobs;
@@ -27,17 +72,35 @@ namespace satp::cli {
             const string rightHash = cfg.rightHashFunctionName.value_or(cfg.hashFunctionName);
             hashLabel = leftHash + "->" + rightHash;
             jobs = executor::buildHeterogeneousMergeJobs(bench, ctx, cfg);
+        } else if (mode == RunMode::MergeMatrix) {
+            hashLabel = "matrix";
+            jobs = executor::buildHeterogeneousMergeMatrixJobs(bench, ctx, cfg);
         } else {
             jobs = executor::buildAlgorithmJobs(bench, ctx, cfg, mode, cfg.hashFunctionName);
         }
 
         executor::printRunContext(ctx, mode, hashLabel);
 
+        const TraceSession trace(cfg.tracePath);
         for (const auto &job : jobs) {
             if (!executor::shouldRun(selected, job.spec.algorithmId)) {
                 continue;
             }
             job.run(job.spec);
         }
+        trace.finish();
+    }
+
+    void ExecutionCoordinator::reestimate(const RunConfig &cfg,
+                                          const string &sourceId,
+                                          const string &targetId) const {
+        const auto ctx = config::loadDatasetRuntimeContext(cfg);
+        const auto hashFunction = satp::hashing::getHashFunctionBy(cfg.hashFunctionName, ctx.seed);
+        executor::printRunContext(ctx, RunMode::Reestimate, cfg.hashFunctionName);
+        executor::runReestimation(ctx, cfg, *hashFunction, sourceId, targetId);
+    }
+
+    void ExecutionCoordinator::simulate(const RunConfig &cfg, const vector<string> &algs) const {
+        executor::runRegisterSimulation(cfg, executor::collectRequestedAlgorithms(algs));
     }
 } // namespace satp::cli
@@ -13,5 +13,13 @@ namespace satp::cli {
         void run(const RunConfig &cfg,
                  const vector<string> &algs,
                  RunMode mode) const;
+
+        // Comando reestimate: nessuna passata sul dataset, solo sugli snapshot.
+        void reestimate(const RunConfig &cfg,
+                        const string &sourceId,
+                        const string &targetId) const;
+
+        // Comando runsim: registri simulati, nessun dataset.
+        void simulate(const RunConfig &cfg, const vector<string> &algs) const;
     };
 } // namespace satp::cli
@@ -1,6 +1,9 @@
 #include "satp/cli/detail/config/ConfigPrinter.h"
 
 #include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "satp/algorithms/AlgorithmCatalog.h"
 #include "satp/cli/detail/config/DatasetRuntime.h"
@@ -22,6 +25,34 @@ namespace satp::cli::config {
             }();
             return value;
         }
+
+        // Lista CSV di un asse della matrice; vuota = parametro singolo.
+        template<typename T, typename Describe>
+        [[nodiscard]] string describeList(const vector<T> &values, Describe describe) {
+            if (values.empty()) return "default";
+            string out;
+            for (const auto &value : values) {
+                if (!out.empty()) out += ',';
+                out += describe(value);
+            }
+            return out;
+        }
+
+        [[nodiscard]] string describeName(const string &name) {
+            return name;
+        }
+
+        [[nodiscard]] string describeNumber(const uint32_t value) {
+            return to_string(value);
+        }
+
+        [[nodiscard]] string describeMatrixSeed(const optional<uint32_t> &seed) {
+            return seed.has_value() ? to_string(*seed) : string("dataset");
+        }
+
+        [[nodiscard]] string describeStrategy(const satp::evaluation::MergeStrategy strategy) {
+            return string(satp::evaluation::toString(strategy));
+        }
     } // namespace
 
     void printHelp() {
@@ -34,7 +65,20 @@ namespace satp::cli::config {
             << "                               Parametri: " << runParamListForHelp() << '\n'
             << "  runstream <algo|all>         Esegue uno o piu' algoritmi (modalita' streaming)\n"
             << "  runmerge <algo|all>          Esegue benchmark merge a coppie (0-1,2-3,...)\n"
+            << "  runestimators <algo|all>     Streaming con un solo sketch per run, stimato da tutti gli\n"
+            << "                               'estimators' (hll, ll, hllpp); un CSV per stimatore\n"
             << "  runmergehet <algo|all>       Esegue benchmark di merge eterogeneo (attualmente: hllpp)\n"
+            << "  runmergetopo <algo|all>      Unisce le partizioni con mergeTopology (balanced_tree|left_deep_chain)\n"
+            << "                               e riporta tempo e drift rispetto all'unione esatta per livello\n"
+            << "  runmergematrix <algo|all>    Merge eterogeneo su tutte le celle matrix* in un solo passaggio\n"
+            << "                               (liste CSV, 'default' = parametro singolo); un CSV per cella\n"
+            << "  reestimate <from> <to>       Ri-stima con <to> gli snapshot di runstream di <from> (snapshots on),\n"
+            << "                               senza rileggere il dataset (es. reestimate hll ll)\n"
+            << "  runlatency <algo|all>        Latenza per chiamata di process (latencyBatch elementi per misura),\n"
+            << "                               count ai checkpoint e merge tra run, su un thread: p50/p99/p99.9/max;\n"
+            << "                               latencyRate <elementi/s> riproduce il dataset a ritmo fisso\n"
+            << "  runsim <algo|all>            Simula i registri (hll, ll, hllpp) fino a simMaxN elementi distinti,\n"
+            << "                               simRuns run, senza dataset; un CSV per stimatore di 'estimators'\n"
             << "                               CSV automatico in results/<namespace>/<mode>/<algoritmo>/<hash>/<params>/\n"
             << "  quit                         Esce\n";
     }
@@ -91,6 +135,40 @@ namespace satp::cli::config {
             << "  rightHashSeed = " << describeHashSeed(cfg.rightHashSeed) << '\n'
             << "  l             = " << cfg.l << '\n'
             << "  lLog          = " << cfg.lLog << '\n'
-            << "  mergeStrategy = " << satp::evaluation::toString(cfg.mergeStrategy) << '\n';
+            << "  mergeStrategy = " << satp::evaluation::toString(cfg.mergeStrategy) << '\n'
+            << "  mergeTopology = " << satp::evaluation::toString(cfg.mergeTopology) << '\n'
+            << "  topologyParts = "
+            << (cfg.topologyPartitions == 0u ? string("all") : to_string(cfg.topologyPartitions)) << '\n'
+            << "  topologySeed  = "
+            << (cfg.topologySampleSeed.has_value() ? to_string(*cfg.topologySampleSeed) : string("none")) << '\n'
+            << "  workers       = " << (cfg.workers == 0u ? string("auto") : to_string(cfg.workers)) << '\n'
+            << "  checkpoints   = " << (cfg.checkpoints == 0u ? string("all") : to_string(cfg.checkpoints)) << '\n'
+            << "  streamTrace   = "
+            << (cfg.streamingTrace == StreamingTraceFormat::Binary ? "binary" : "csv") << '\n'
+            << "  errQuantiles  = " << (cfg.errorQuantiles ? "on" : "off") << '\n'
+            << "  resume        = " << (cfg.resume ? "on" : "off") << '\n'
+            << "  stopWidth     = " << (cfg.stopWidth == 0.0 ? string("off") : to_string(cfg.stopWidth)) << '\n'
+            << "  stopMetric    = " << satp::evaluation::toString(cfg.stopMetric) << '\n'
+            << "  snapshots     = " << (cfg.snapshots ? "on" : "off") << '\n'
+            << "  perfCounters  = " << (cfg.perfCounters ? "on" : "off") << '\n'
+            << "  trace         = " << (cfg.tracePath.empty() ? string("off") : cfg.tracePath) << '\n'
+            << "  estimators    = " << (cfg.estimators.empty() ? string("all") : describeList(cfg.estimators, describeName))
+            << '\n'
+            << "  hllppEstim    = "
+            << (cfg.hllppEstimator == satp::algorithms::HyperLogLogPlusPlus::EstimatorMode::Improved
+                    ? "improved"
+                    : "table") << '\n'
+            << "  simMaxN       = " << cfg.simMaxN << '\n'
+            << "  simRuns       = " << cfg.simRuns << '\n'
+            << "  simSeed       = " << cfg.simSeed << '\n'
+            << "  latencyBatch  = " << cfg.latencyBatch << '\n'
+            << "  latencyRate   = " << (cfg.latencyRate == 0.0 ? string("off") : to_string(cfg.latencyRate)) << '\n'
+            << "  mxLeftHashFn  = " << describeList(cfg.matrixLeftHashes, describeName) << '\n'
+            << "  mxRightHashFn = " << describeList(cfg.matrixRightHashes, describeName) << '\n'
+            << "  mxLeftSeeds   = " << describeList(cfg.matrixLeftSeeds, describeMatrixSeed) << '\n'
+            << "  mxRightSeeds  = " << describeList(cfg.matrixRightSeeds, describeMatrixSeed) << '\n'
+            << "  mxLeftK       = " << describeList(cfg.matrixLeftK, describeNumber) << '\n'
+            << "  mxRightK      = " << describeList(cfg.matrixRightK, describeNumber) << '\n'
+            << "  mxStrategies  = " << describeList(cfg.matrixStrategies, describeStrategy) << '\n';
     }
 } // namespace satp::cli::config
@@ -28,6 +28,11 @@ namespace satp::cli::config {
         ctx.runs = ctx.index.info.partition_count;
         ctx.seed = ctx.index.info.seed;
         ctx.resultsNamespace = cfg.resultsNamespace;
+        ctx.streamingTrace = cfg.streamingTrace;
+        ctx.resume = cfg.resume;
+        ctx.snapshots = cfg.snapshots;
+        ctx.estimators = cfg.estimators;
+        ctx.datasetPath = cfg.datasetPath;
         ctx.repoRoot = path_utils::detectRepoRoot(cfg.datasetPath);
         return ctx;
     }
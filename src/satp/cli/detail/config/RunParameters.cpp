@@ -1,10 +1,16 @@
 #include "satp/cli/detail/config/RunParameters.h"
 
+#include <algorithm>
+#include <cmath>
 #include <exception>
 #include <limits>
+#include <utility>
+#include <vector>
 
+#include "satp/algorithms/Estimators.h"
 #include "satp/hashing/HashFactory.h"
 #include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
+#include "satp/simulation/detail/metrics/EarlyStopping.h"
 
 using namespace std;
 
@@ -31,6 +37,20 @@ namespace satp::cli::config {
             }
         }
 
+        bool parseDouble(const string &raw, double &out) {
+            try {
+                size_t idx = 0;
+                const double value = stod(raw, &idx);
+                if (idx != raw.size() || !isfinite(value)) {
+                    return false;
+                }
+                out = value;
+                return true;
+            } catch (const exception &) {
+                return false;
+            }
+        }
+
         bool setDatasetPath(RunConfig &cfg, const string &value) {
             cfg.datasetPath = value;
             return true;
@@ -131,29 +151,307 @@ namespace satp::cli::config {
             return parseU32(value, cfg.lLog);
         }
 
-        bool setMergeStrategy(RunConfig &cfg, const string &value) {
+        bool parseMergeStrategy(const string &value, satp::evaluation::MergeStrategy &out) {
             using satp::evaluation::MergeStrategy;
             if (value == "direct") {
-                cfg.mergeStrategy = MergeStrategy::Direct;
+                out = MergeStrategy::Direct;
                 return true;
             }
             if (value == "reject") {
-                cfg.mergeStrategy = MergeStrategy::Reject;
+                out = MergeStrategy::Reject;
                 return true;
             }
             if (value == "reduce_then_merge") {
-                cfg.mergeStrategy = MergeStrategy::ReduceThenMerge;
+                out = MergeStrategy::ReduceThenMerge;
                 return true;
             }
             if (value == "unsafe_naive_merge") {
-                cfg.mergeStrategy = MergeStrategy::UnsafeNaiveMerge;
+                out = MergeStrategy::UnsafeNaiveMerge;
+                return true;
+            }
+            return false;
+        }
+
+        bool setMergeStrategy(RunConfig &cfg, const string &value) {
+            return parseMergeStrategy(value, cfg.mergeStrategy);
+        }
+
+        bool setMergeTopology(RunConfig &cfg, const string &value) {
+            using satp::evaluation::MergeTopology;
+            if (value == "balanced_tree") {
+                cfg.mergeTopology = MergeTopology::BalancedTree;
+                return true;
+            }
+            if (value == "left_deep_chain") {
+                cfg.mergeTopology = MergeTopology::LeftDeepChain;
+                return true;
+            }
+            return false;
+        }
+
+        bool setTopologyPartitions(RunConfig &cfg, const string &value) {
+            if (value == "all") {
+                cfg.topologyPartitions = 0;
+                return true;
+            }
+            return parseU32(value, cfg.topologyPartitions);
+        }
+
+        bool setTopologySampleSeed(RunConfig &cfg, const string &value) {
+            if (value == "none") {
+                cfg.topologySampleSeed = nullopt;
+                return true;
+            }
+            uint32_t parsed = 0;
+            if (!parseU32(value, parsed)) return false;
+            cfg.topologySampleSeed = parsed;
+            return true;
+        }
+
+        bool setWorkers(RunConfig &cfg, const string &value) {
+            if (value == "auto") {
+                cfg.workers = 0;
+                return true;
+            }
+            return parseU32(value, cfg.workers);
+        }
+
+        bool setCheckpoints(RunConfig &cfg, const string &value) {
+            if (value == "all") {
+                cfg.checkpoints = 0;
+                return true;
+            }
+            uint32_t parsed = 0;
+            if (!parseU32(value, parsed) || parsed == 0u) return false;
+            cfg.checkpoints = parsed;
+            return true;
+        }
+
+        bool setStreamingTrace(RunConfig &cfg, const string &value) {
+            if (value == "csv") {
+                cfg.streamingTrace = StreamingTraceFormat::Csv;
+                return true;
+            }
+            if (value == "binary") {
+                cfg.streamingTrace = StreamingTraceFormat::Binary;
+                return true;
+            }
+            return false;
+        }
+
+        bool setErrorQuantiles(RunConfig &cfg, const string &value) {
+            if (value == "on") {
+                cfg.errorQuantiles = true;
+                return true;
+            }
+            if (value == "off") {
+                cfg.errorQuantiles = false;
+                return true;
+            }
+            return false;
+        }
+
+        bool setPerfCounters(RunConfig &cfg, const string &value) {
+            if (value == "on") {
+                cfg.perfCounters = true;
+                return true;
+            }
+            if (value == "off") {
+                cfg.perfCounters = false;
+                return true;
+            }
+            return false;
+        }
+
+        // Percorso del file di timeline; "off" la disattiva.
+        bool setTrace(RunConfig &cfg, const string &value) {
+            if (value.empty()) return false;
+            if (value == "off") {
+                cfg.tracePath.clear();
+                return true;
+            }
+            cfg.tracePath = value;
+            return true;
+        }
+
+        bool setResume(RunConfig &cfg, const string &value) {
+            if (value == "on") {
+                cfg.resume = true;
+                return true;
+            }
+            if (value == "off") {
+                cfg.resume = false;
+                return true;
+            }
+            return false;
+        }
+
+        bool setStopWidth(RunConfig &cfg, const string &value) {
+            if (value == "off") {
+                cfg.stopWidth = 0.0;
+                return true;
+            }
+            double parsed = 0.0;
+            if (!parseDouble(value, parsed) || parsed <= 0.0) return false;
+            cfg.stopWidth = parsed;
+            return true;
+        }
+
+        bool setStopMetric(RunConfig &cfg, const string &value) {
+            const auto metric = satp::evaluation::parseStoppingMetric(value);
+            if (!metric.has_value()) return false;
+            cfg.stopMetric = *metric;
+            return true;
+        }
+
+        bool setSnapshots(RunConfig &cfg, const string &value) {
+            if (value == "on") {
+                cfg.snapshots = true;
+                return true;
+            }
+            if (value == "off") {
+                cfg.snapshots = false;
+                return true;
+            }
+            return false;
+        }
+
+        // Liste separate da virgola per gli assi della matrice; "default" svuota
+        // la lista e torna al parametro singolo. Nessun elemento viene
+        // applicato se uno solo non e' valido.
+        template<typename T, typename Parse>
+        bool setList(vector<T> &out, const string &value, Parse parse) {
+            if (value == "default") {
+                out.clear();
+                return true;
+            }
+            vector<T> parsed;
+            size_t begin = 0;
+            while (begin <= value.size()) {
+                size_t end = value.find(',', begin);
+                if (end == string::npos) end = value.size();
+                const string token = value.substr(begin, end - begin);
+                T item{};
+                if (token.empty() || !parse(token, item)) return false;
+                parsed.push_back(std::move(item));
+                begin = end + 1u;
+            }
+            out = std::move(parsed);
+            return true;
+        }
+
+        bool parseHashName(const string &value, string &out) {
+            try {
+                out = hashing::getHashFunctionBy(value, 0u)->name();
+            } catch (const exception &) {
+                return false;
+            }
+            return true;
+        }
+
+        bool parseOptionalSeed(const string &value, optional<uint32_t> &out) {
+            return setOptionalSeed(out, value);
+        }
+
+        bool setMatrixLeftHashes(RunConfig &cfg, const string &value) {
+            return setList(cfg.matrixLeftHashes, value, parseHashName);
+        }
+
+        bool setMatrixRightHashes(RunConfig &cfg, const string &value) {
+            return setList(cfg.matrixRightHashes, value, parseHashName);
+        }
+
+        bool setMatrixLeftSeeds(RunConfig &cfg, const string &value) {
+            return setList(cfg.matrixLeftSeeds, value, parseOptionalSeed);
+        }
+
+        bool setMatrixRightSeeds(RunConfig &cfg, const string &value) {
+            return setList(cfg.matrixRightSeeds, value, parseOptionalSeed);
+        }
+
+        bool setMatrixLeftK(RunConfig &cfg, const string &value) {
+            return setList(cfg.matrixLeftK, value, parseU32);
+        }
+
+        bool setMatrixRightK(RunConfig &cfg, const string &value) {
+            return setList(cfg.matrixRightK, value, parseU32);
+        }
+
+        bool setMatrixStrategies(RunConfig &cfg, const string &value) {
+            return setList(cfg.matrixStrategies, value, parseMergeStrategy);
+        }
+
+        bool parseEstimatorId(const string &value, string &out) {
+            const auto &ids = satp::algorithms::estimators::getIdsOfSupportedEstimators();
+            if (ranges::find(ids, value) == ids.end()) return false;
+            out = value;
+            return true;
+        }
+
+        // "all" (o "default") torna a tutti gli stimatori supportati.
+        bool setEstimators(RunConfig &cfg, const string &value) {
+            if (value == "all") {
+                cfg.estimators.clear();
+                return true;
+            }
+            return setList(cfg.estimators, value, parseEstimatorId);
+        }
+
+        // Accetta anche la notazione scientifica (es. 1e12), purche' intera.
+        bool setSimMaxN(RunConfig &cfg, const string &value) {
+            double parsed = 0.0;
+            if (!parseDouble(value, parsed) || parsed < 1.0 || parsed > 0x1p53 || parsed != floor(parsed)) {
+                return false;
+            }
+            cfg.simMaxN = static_cast<uint64_t>(parsed);
+            return true;
+        }
+
+        bool setSimRuns(RunConfig &cfg, const string &value) {
+            uint32_t parsed = 0;
+            if (!parseU32(value, parsed) || parsed == 0u) return false;
+            cfg.simRuns = parsed;
+            return true;
+        }
+
+        bool setSimSeed(RunConfig &cfg, const string &value) {
+            return parseU32(value, cfg.simSeed);
+        }
+
+        bool setLatencyBatch(RunConfig &cfg, const string &value) {
+            uint32_t parsed = 0;
+            if (!parseU32(value, parsed) || parsed == 0u) return false;
+            cfg.latencyBatch = parsed;
+            return true;
+        }
+
+        // Elementi/s di replay per runlatency; "off" misura a piena velocita'.
+        bool setLatencyRate(RunConfig &cfg, const string &value) {
+            if (value == "off") {
+                cfg.latencyRate = 0.0;
+                return true;
+            }
+            double parsed = 0.0;
+            if (!parseDouble(value, parsed) || parsed <= 0.0) return false;
+            cfg.latencyRate = parsed;
+            return true;
+        }
+
+        bool setHllppEstimator(RunConfig &cfg, const string &value) {
+            using Mode = satp::algorithms::HyperLogLogPlusPlus::EstimatorMode;
+            if (value == "table") {
+                cfg.hllppEstimator = Mode::BiasTable;
+                return true;
+            }
+            if (value == "improved") {
+                cfg.hllppEstimator = Mode::Improved;
                 return true;
             }
             return false;
         }
 
-        [[nodiscard]] const array<RunParamSpec, 13> &runParamSpecs() {
-            static const array<RunParamSpec, 13> specs{{
+        [[nodiscard]] const array<RunParamSpec, 40> &runParamSpecs() {
+            static const array<RunParamSpec, 40> specs{{
                 {"datasetPath", setDatasetPath},
                 {"resultsNamespace", setResultsNamespace},
                 {"hashFunction", setHashFunctionName},
@@ -166,7 +464,34 @@ namespace satp::cli::config {
                 {"rightK", setRightK},
                 {"l", setL},
                 {"lLog", setLLog},
-                {"mergeStrategy", setMergeStrategy}
+                {"mergeStrategy", setMergeStrategy},
+                {"mergeTopology", setMergeTopology},
+                {"topologyPartitions", setTopologyPartitions},
+                {"topologySampleSeed", setTopologySampleSeed},
+                {"workers", setWorkers},
+                {"checkpoints", setCheckpoints},
+                {"streamingTrace", setStreamingTrace},
+                {"errorQuantiles", setErrorQuantiles},
+                {"resume", setResume},
+                {"stopWidth", setStopWidth},
+                {"stopMetric", setStopMetric},
+                {"snapshots", setSnapshots},
+                {"perfCounters", setPerfCounters},
+                {"trace", setTrace},
+                {"estimators", setEstimators},
+                {"hllppEstimator", setHllppEstimator},
+                {"simMaxN", setSimMaxN},
+                {"simRuns", setSimRuns},
+                {"simSeed", setSimSeed},
+                {"latencyBatch", setLatencyBatch},
+                {"latencyRate", setLatencyRate},
+                {"matrixLeftHashes", setMatrixLeftHashes},
+                {"matrixRightHashes", setMatrixRightHashes},
+                {"matrixLeftSeeds", setMatrixLeftSeeds},
+                {"matrixRightSeeds", setMatrixRightSeeds},
+                {"matrixLeftK", setMatrixLeftK},
+                {"matrixRightK", setMatrixRightK},
+                {"matrixStrategies", setMatrixStrategies}
             }};
             return specs;
         }
@@ -183,8 +508,8 @@ namespace satp::cli::config {
         return false;
     }
 
-    const array<string_view, 13> &configurableParamNames() {
-        static const array<string_view, 13> names{
+    const array<string_view, 40> &configurableParamNames() {
+        static const array<string_view, 40> names{
             "datasetPath",
             "resultsNamespace",
             "hashFunction",
@@ -197,7 +522,34 @@ namespace satp::cli::config {
             "rightK",
             "l",
             "lLog",
-            "mergeStrategy"
+            "mergeStrategy",
+            "mergeTopology",
+            "topologyPartitions",
+            "topologySampleSeed",
+            "workers",
+            "checkpoints",
+            "streamingTrace",
+            "errorQuantiles",
+            "resume",
+            "stopWidth",
+            "stopMetric",
+            "snapshots",
+            "perfCounters",
+            "trace",
+            "estimators",
+            "hllppEstimator",
+            "simMaxN",
+            "simRuns",
+            "simSeed",
+            "latencyBatch",
+            "latencyRate",
+            "matrixLeftHashes",
+            "matrixRightHashes",
+            "matrixLeftSeeds",
+            "matrixRightSeeds",
+            "matrixLeftK",
+            "matrixRightK",
+            "matrixStrategies"
         };
         return names;
     }
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "satp/algorithms/AlgorithmCatalog.h"
+#include "satp/algorithms/Estimators.h"
 #include "satp/cli/detail/CliTypes.h"
 #include "satp/cli/detail/execution/ProgressReporter.h"
 #include "satp/cli/detail/execution/RunReporter.h"
@@ -53,61 +58,236 @@ namespace satp::cli::executor {
         return sum / static_cast<double>(count);
     }
 
-    template<typename Algo, typename... CtorArgs>
-    void runSingleAlgorithm(satp::evaluation::EvaluationFramework &bench,
-                            const DatasetRuntimeContext &ctx,
-                            const AlgorithmRunSpec &spec,
-                            const RunMode mode,
-                            CtorArgs &&... ctorArgs) {
-        const filesystem::path csvPath = path_utils::buildResultCsvPath(
-            ctx.repoRoot,
-            ctx.resultsNamespace,
+    // File accessori di runstream e runestimators accanto al CSV del job.
+    inline void configureStreamingFiles(satp::evaluation::EvaluationFramework &bench,
+                                        const DatasetRuntimeContext &ctx,
+                                        const filesystem::path &csvPath) {
+        bench.setStreamingResumeState(ctx.resume
+                                          ? path_utils::buildResumePath(csvPath, ctx.datasetPath, ".state")
+                                          : filesystem::path{});
+        bench.setStreamingSnapshotFile(ctx.snapshots
+                                           ? path_utils::buildSnapshotPath(csvPath, ctx.datasetPath)
+                                           : filesystem::path{});
+    }
+
+    // Scrive i risultati della valutazione appena conclusa e accoda i suoi
+    // tempi per fase a timing.csv (e, se raccolti, i contatori interni dello
+    // sketch a sketch_stats.csv); la scrittura stessa conta come output.
+    template<typename Write>
+    void writeResultsWithTiming(const satp::evaluation::EvaluationFramework &bench,
+                                const AlgorithmRunSpec &spec,
+                                const filesystem::path &csvPath,
+                                const char *mode,
+                                Write write) {
+        auto diagnostics = bench.lastDiagnostics();
+        const auto start = chrono::steady_clock::now();
+        write();
+        satp::evaluation::CsvResultWriter::appendSketchStats(
+            path_utils::buildSketchStatsCsvPath(csvPath),
+            makeCsvRunDescriptor(spec, bench.metadata()),
+            mode,
+            diagnostics.sketchStats);
+        const auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        diagnostics.phases.add(satp::profiling::Phase::Output, elapsed);
+        diagnostics.wall += elapsed;
+        satp::evaluation::CsvResultWriter::appendTiming(
+            path_utils::buildTimingCsvPath(csvPath),
+            makeCsvRunDescriptor(spec, bench.metadata()),
+            mode,
+            diagnostics,
+            bench.hardwareCounters());
+        printAllocationSummary(spec, diagnostics);
+        printTimingSummary(spec, diagnostics);
+    }
+
+    struct SelectedEstimators {
+        vector<unique_ptr<satp::algorithms::CardinalityEstimator>> owned;
+        vector<const satp::algorithms::CardinalityEstimator *> estimators;
+    };
+
+    // Gli id vuoti selezionano tutti gli stimatori supportati.
+    [[nodiscard]] inline SelectedEstimators makeSelectedEstimators(const vector<string> &configured) {
+        SelectedEstimators selected;
+        vector<string> ids = configured;
+        if (ids.empty()) {
+            const auto &all = satp::algorithms::estimators::getIdsOfSupportedEstimators();
+            ids.assign(all.begin(), all.end());
+        }
+        for (const auto &id : ids) {
+            selected.owned.push_back(satp::algorithms::estimators::makeEstimator(id));
+            selected.estimators.push_back(selected.owned.back().get());
+        }
+        return selected;
+    }
+
+    [[nodiscard]] inline AlgorithmRunSpec estimatorSpecFor(const AlgorithmRunSpec &spec, const string &estimatorId) {
+        return {
             spec.algorithmId,
-            spec.params,
+            spec.params + ",estimator=" + estimatorId,
             spec.hashName,
-            mode);
-        filesystem::create_directories(csvPath.parent_path());
+            spec.rseTheoretical
+        };
+    }
+
+    // Un CSV per stimatore; gli id vuoti selezionano tutti gli stimatori.
+    template<typename Algo, typename... CtorArgs>
+    void runEstimatorMode(satp::evaluation::EvaluationFramework &bench,
+                          const DatasetRuntimeContext &ctx,
+                          const AlgorithmRunSpec &spec,
+                          const filesystem::path &csvPath,
+                          const satp::evaluation::ProgressCallbacks &progress,
+                          CtorArgs &&... ctorArgs) {
+        const auto selected = makeSelectedEstimators(ctx.estimators);
+
+        configureStreamingFiles(bench, ctx, csvPath);
+        const auto results = bench.evaluateStreamingEstimators<Algo>(
+            selected.estimators,
+            progress,
+            std::forward<CtorArgs>(ctorArgs)...);
+        writeResultsWithTiming(bench, spec, csvPath, "estimators", [&] {
+            for (const auto &result : results) {
+                satp::evaluation::CsvResultWriter::appendStreaming(
+                    path_utils::buildEstimatorCsvPath(csvPath, result.estimator),
+                    makeCsvRunDescriptor(estimatorSpecFor(spec, result.estimator), bench.metadata()),
+                    result.series,
+                    bench.streamingErrorQuantiles());
+            }
+        });
+        for (const auto &result : results) {
+            const AlgorithmRunSpec estimatorSpec = estimatorSpecFor(spec, result.estimator);
+            const filesystem::path outputPath = path_utils::buildEstimatorCsvPath(csvPath, result.estimator);
+            if (result.series.empty()) {
+                cout << algorithmLogPrefix(estimatorSpec) << "[stream] csv=" << outputPath.string() << "  no data\n";
+                continue;
+            }
+            printStreamingSummary(estimatorSpec, outputPath, result.series.back());
+        }
+    }
+
+    template<typename Algo, typename... CtorArgs>
+    void runAlgorithmMode(satp::evaluation::EvaluationFramework &bench,
+                          const DatasetRuntimeContext &ctx,
+                          const AlgorithmRunSpec &spec,
+                          const RunMode mode,
+                          const satp::evaluation::MergeTopologyOptions &topologyOptions,
+                          const filesystem::path &csvPath,
+                          CtorArgs &&... ctorArgs) {
         const auto descriptor = makeCsvRunDescriptor(spec, bench.metadata());
         ProgressReporter progressReporter;
         const auto progress = progressReporter.callbacks();
+        if (mode == RunMode::Estimators) {
+            if constexpr (satp::evaluation::detail::RegisterSketch<Algo>) {
+                runEstimatorMode<Algo>(bench, ctx, spec, csvPath, progress, std::forward<CtorArgs>(ctorArgs)...);
+            } else {
+                cout << algorithmLogPrefix(spec) << "[estimators] skip, lo sketch non espone registri\n";
+            }
+            return;
+        }
         if (mode == RunMode::Streaming) {
+            configureStreamingFiles(bench, ctx, csvPath);
             const auto series = bench.evaluateStreaming<Algo>(progress, std::forward<CtorArgs>(ctorArgs)...);
-            satp::evaluation::CsvResultWriter::appendStreaming(csvPath, descriptor, series);
+            filesystem::path outputPath = csvPath;
+            if (ctx.streamingTrace == StreamingTraceFormat::Binary) outputPath.replace_extension(".bin");
+            writeResultsWithTiming(bench, spec, csvPath, "streaming", [&] {
+                if (ctx.streamingTrace == StreamingTraceFormat::Binary) {
+                    satp::evaluation::StreamingTraceFile::append(outputPath, descriptor, series);
+                } else {
+                    satp::evaluation::CsvResultWriter::appendStreaming(
+                        csvPath,
+                        descriptor,
+                        series,
+                        bench.streamingErrorQuantiles());
+                }
+            });
             if (series.empty()) {
-                cout << algorithmLogPrefix(spec) << "[stream] csv=" << csvPath.string()
-                          << "  no data\n";
+                cout << algorithmLogPrefix(spec) << "[stream] " << streamingOutputLabel(outputPath)
+                          << '=' << outputPath.string() << "  no data\n";
                 return;
             }
-            printStreamingSummary(spec, csvPath, series.back());
+            printStreamingSummary(spec, outputPath, series.back());
+            return;
+        }
+        if (mode == RunMode::Latency) {
+            const auto result = bench.evaluateLatency<Algo>(progress, std::forward<CtorArgs>(ctorArgs)...);
+            writeResultsWithTiming(bench, spec, csvPath, "latency", [&] {
+                satp::evaluation::CsvResultWriter::appendLatency(csvPath, descriptor, result);
+            });
+            printLatencySummary(spec, csvPath, result);
+            return;
+        }
+        if (mode == RunMode::MergeTopology) {
+            const auto result = bench.evaluateMergeTopology<Algo>(
+                topologyOptions,
+                progress,
+                std::forward<CtorArgs>(ctorArgs)...);
+            writeResultsWithTiming(bench, spec, csvPath, "merge_topology", [&] {
+                satp::evaluation::CsvResultWriter::appendMergeTopology(csvPath, descriptor, result);
+            });
+            printMergeTopologySummary(spec, csvPath, result);
             return;
         }
         const auto points = bench.evaluateMergePairs<Algo>(progress, std::forward<CtorArgs>(ctorArgs)...);
-        satp::evaluation::CsvResultWriter::appendMergePairs(csvPath, descriptor, points);
+        writeResultsWithTiming(bench, spec, csvPath, "merge", [&] {
+            satp::evaluation::CsvResultWriter::appendMergePairs(csvPath, descriptor, points);
+        });
         const auto stats = satp::evaluation::summarizeMergePairs(points);
         printMergeSummary(spec, csvPath, stats);
     }
 
-    template<typename Algo, typename Builder>
-    void runSingleHeterogeneousAlgorithm(
-        satp::evaluation::EvaluationFramework &bench,
-        const DatasetRuntimeContext &ctx,
-        const AlgorithmRunSpec &spec,
-        const satp::evaluation::HeterogeneousMergeRunDescriptor &descriptor,
-        Builder buildAlgo) {
+    // Con resume=on un job gia' scritto per questo dataset viene saltato, cosi'
+    // rilanciare una sessione interrotta non duplica righe nei CSV. Il marker
+    // .done e' creato solo dopo l'append dei risultati.
+    template<typename Algo, typename... CtorArgs>
+    void runSingleAlgorithm(satp::evaluation::EvaluationFramework &bench,
+                            const DatasetRuntimeContext &ctx,
+                            const AlgorithmRunSpec &spec,
+                            const RunMode mode,
+                            const satp::evaluation::MergeTopologyOptions &topologyOptions,
+                            CtorArgs &&... ctorArgs) {
         const filesystem::path csvPath = path_utils::buildResultCsvPath(
             ctx.repoRoot,
             ctx.resultsNamespace,
             spec.algorithmId,
             spec.params,
             spec.hashName,
-            RunMode::MergeHeterogeneous);
+            mode);
         filesystem::create_directories(csvPath.parent_path());
+        const filesystem::path donePath = path_utils::buildResumePath(csvPath, ctx.datasetPath, ".done");
+        if (ctx.resume && filesystem::exists(donePath)) {
+            cout << algorithmLogPrefix(spec) << "[resume] skip, gia' completato: " << donePath.string() << '\n';
+            return;
+        }
 
-        ProgressReporter progressReporter;
-        const auto progress = progressReporter.callbacks();
-        const auto points = bench.evaluateHeterogeneousMergePairs<Algo>(descriptor, progress, buildAlgo);
-        satp::evaluation::CsvResultWriter::appendHeterogeneousMergePairs(csvPath, descriptor, points);
+        runAlgorithmMode<Algo>(bench, ctx, spec, mode, topologyOptions, csvPath, std::forward<CtorArgs>(ctorArgs)...);
 
+        if (ctx.resume) {
+            ofstream marker(donePath);
+            if (!marker) {
+                throw runtime_error("Impossibile scrivere il marker di resume");
+            }
+            filesystem::remove(path_utils::buildResumePath(csvPath, ctx.datasetPath, ".state"));
+        }
+    }
+
+    [[nodiscard]] inline filesystem::path prepareResultCsvPath(const DatasetRuntimeContext &ctx,
+                                                               const AlgorithmRunSpec &spec,
+                                                               const RunMode mode) {
+        filesystem::path csvPath = path_utils::buildResultCsvPath(
+            ctx.repoRoot,
+            ctx.resultsNamespace,
+            spec.algorithmId,
+            spec.params,
+            spec.hashName,
+            mode);
+        filesystem::create_directories(csvPath.parent_path());
+        return csvPath;
+    }
+
+    inline void printHeterogeneousMergeSummary(
+        const AlgorithmRunSpec &spec,
+        const filesystem::path &csvPath,
+        const satp::evaluation::HeterogeneousMergeRunDescriptor &descriptor,
+        const vector<satp::evaluation::HeterogeneousMergePoint> &points) {
         const size_t finiteMergePairs = static_cast<size_t>(count_if(
             points.begin(),
             points.end(),
@@ -129,11 +309,69 @@ namespace satp::cli::executor {
                   << '\n';
     }
 
+    template<typename Algo, typename Builder>
+    void runSingleHeterogeneousAlgorithm(
+        satp::evaluation::EvaluationFramework &bench,
+        const DatasetRuntimeContext &ctx,
+        const AlgorithmRunSpec &spec,
+        const satp::evaluation::HeterogeneousMergeRunDescriptor &descriptor,
+        Builder buildAlgo) {
+        const filesystem::path csvPath = prepareResultCsvPath(ctx, spec, RunMode::MergeHeterogeneous);
+        ProgressReporter progressReporter;
+        const auto progress = progressReporter.callbacks();
+        const auto points = bench.evaluateHeterogeneousMergePairs<Algo>(descriptor, progress, buildAlgo);
+        writeResultsWithTiming(bench, spec, csvPath, "merge_heterogeneous", [&] {
+            satp::evaluation::CsvResultWriter::appendHeterogeneousMergePairs(csvPath, descriptor, points);
+        });
+        printHeterogeneousMergeSummary(spec, csvPath, descriptor, points);
+    }
+
+    struct HeterogeneousMergeCell {
+        AlgorithmRunSpec spec;
+        satp::evaluation::HeterogeneousMergeRunDescriptor descriptor;
+    };
+
+    // Ogni cella scrive il CSV di runmergehet; i tempi dell'unico passaggio
+    // vanno nel timing.csv del job matrice.
+    template<typename Algo, typename Builder>
+    void runHeterogeneousMergeMatrix(
+        satp::evaluation::EvaluationFramework &bench,
+        const DatasetRuntimeContext &ctx,
+        const AlgorithmRunSpec &spec,
+        const vector<HeterogeneousMergeCell> &cells,
+        Builder buildAlgo) {
+        vector<satp::evaluation::HeterogeneousMergeRunDescriptor> descriptors;
+        descriptors.reserve(cells.size());
+        for (const auto &cell : cells) {
+            descriptors.push_back(cell.descriptor);
+        }
+
+        ProgressReporter progressReporter;
+        const auto progress = progressReporter.callbacks();
+        const auto results = bench.evaluateHeterogeneousMergeMatrix<Algo>(descriptors, progress, buildAlgo);
+        vector<filesystem::path> cellPaths;
+        cellPaths.reserve(cells.size());
+        for (const auto &cell : cells) {
+            cellPaths.push_back(prepareResultCsvPath(ctx, cell.spec, RunMode::MergeHeterogeneous));
+        }
+        const filesystem::path matrixPath = prepareResultCsvPath(ctx, spec, RunMode::MergeMatrix);
+        writeResultsWithTiming(bench, spec, matrixPath, "merge_matrix", [&] {
+            for (size_t i = 0; i < cells.size(); ++i) {
+                satp::evaluation::CsvResultWriter::appendHeterogeneousMergePairs(
+                    cellPaths[i], cells[i].descriptor, results[i]);
+            }
+        });
+        for (size_t i = 0; i < cells.size(); ++i) {
+            printHeterogeneousMergeSummary(cells[i].spec, cellPaths[i], cells[i].descriptor, results[i]);
+        }
+    }
+
     template<typename Algo, typename... CtorArgs>
     void addAlgorithmJob(vector<AlgorithmJob> &jobs,
                          satp::evaluation::EvaluationFramework &bench,
                          const DatasetRuntimeContext &ctx,
                          const RunMode mode,
+                         const satp::evaluation::MergeTopologyOptions &topologyOptions,
                          string algorithmId,
                          string params,
                          string hashName,
@@ -146,13 +384,14 @@ namespace satp::cli::executor {
                 std::move(hashName),
                 rseTheoretical
             },
-            [&bench, &ctx, mode, ... capturedArgs = std::forward<CtorArgs>(ctorArgs)](
+            [&bench, &ctx, mode, topologyOptions, ... capturedArgs = std::forward<CtorArgs>(ctorArgs)](
                 const AlgorithmRunSpec &spec) {
                 runSingleAlgorithm<Algo>(
                     bench,
                     ctx,
                     spec,
                     mode,
+                    topologyOptions,
                     capturedArgs...);
             }
                 });
@@ -185,4 +424,26 @@ namespace satp::cli::executor {
             }
         });
     }
+
+    template<typename Algo, typename Builder>
+    void addHeterogeneousMergeMatrixJob(
+        vector<AlgorithmJob> &jobs,
+        satp::evaluation::EvaluationFramework &bench,
+        const DatasetRuntimeContext &ctx,
+        string algorithmId,
+        vector<HeterogeneousMergeCell> cells,
+        Builder buildAlgo) {
+        string params = "cells=" + to_string(cells.size());
+        jobs.push_back({
+            {
+                std::move(algorithmId),
+                std::move(params),
+                "matrix",
+                rseUnknown()
+            },
+            [&bench, &ctx, cells = std::move(cells), buildAlgo](const AlgorithmRunSpec &spec) {
+                runHeterogeneousMergeMatrix<Algo>(bench, ctx, spec, cells, buildAlgo);
+            }
+        });
+    }
 } // namespace satp::cli::executor
@@ -1,5 +1,10 @@
 #include "satp/cli/detail/execution/JobFactory.h"
 
+#include <array>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+
 #include "satp/algorithms/HyperLogLog.h"
 #include "satp/algorithms/HyperLogLogPlusPlus.h"
 #include "satp/algorithms/LogLog.h"
@@ -27,6 +32,12 @@ namespace satp::cli::executor {
             return configured.value_or(fallback);
         }
 
+        template<typename T>
+        [[nodiscard]] vector<T> axisOr(const vector<T> &axis, T fallback) {
+            if (!axis.empty()) return axis;
+            return {std::move(fallback)};
+        }
+
         [[nodiscard]] string hllppParams(const uint32_t k) {
             return "k=" + to_string(k);
         }
@@ -46,46 +57,58 @@ namespace satp::cli::executor {
             return satp::evaluation::MergeValidity::Invalid;
         }
 
-        void validateHllppStrategy(const satp::evaluation::MergeValidity validity,
-                                   const satp::evaluation::MergeStrategy strategy) {
+        // Motivo per cui la strategia non e' ammessa sul caso; nullptr se ammessa.
+        [[nodiscard]] const char *hllppStrategyViolation(const satp::evaluation::MergeValidity validity,
+                                                         const satp::evaluation::MergeStrategy strategy) {
             using satp::evaluation::MergeStrategy;
             using satp::evaluation::MergeValidity;
 
             if (strategy == MergeStrategy::Direct && validity != MergeValidity::Valid) {
-                throw invalid_argument("HLL++ direct merge richiede un caso valid");
+                return "HLL++ direct merge richiede un caso valid";
             }
             if (strategy == MergeStrategy::ReduceThenMerge && validity != MergeValidity::Recoverable) {
-                throw invalid_argument("HLL++ reduce_then_merge richiede un caso recoverable");
+                return "HLL++ reduce_then_merge richiede un caso recoverable";
             }
             if (strategy == MergeStrategy::UnsafeNaiveMerge && validity == MergeValidity::Valid) {
-                throw invalid_argument("HLL++ unsafe_naive_merge richiede un caso non-valid");
+                return "HLL++ unsafe_naive_merge richiede un caso non-valid";
+            }
+            return nullptr;
+        }
+
+        void validateHllppStrategy(const satp::evaluation::MergeValidity validity,
+                                   const satp::evaluation::MergeStrategy strategy) {
+            if (const char *violation = hllppStrategyViolation(validity, strategy)) {
+                throw invalid_argument(violation);
             }
         }
 
+        struct HllppMergeSide {
+            string hashName;
+            uint32_t hashSeed = 0;
+            uint32_t k = 0;
+        };
+
         [[nodiscard]] satp::evaluation::HeterogeneousMergeRunDescriptor makeHllppMergeDescriptor(
             satp::evaluation::EvaluationFramework &bench,
-            const DatasetRuntimeContext &ctx,
-            const RunConfig &cfg) {
-            const string leftHashName = resolveHashFunctionName(cfg.leftHashFunctionName, cfg.hashFunctionName);
-            const string rightHashName = resolveHashFunctionName(cfg.rightHashFunctionName, cfg.hashFunctionName);
-            const uint32_t leftHashSeed = resolveHashSeed(cfg.leftHashSeed, ctx.seed);
-            const uint32_t rightHashSeed = resolveHashSeed(cfg.rightHashSeed, ctx.seed);
-            const uint32_t leftK = resolveK(cfg.leftK, cfg.k);
-            const uint32_t rightK = resolveK(cfg.rightK, cfg.k);
+            const HllppMergeSide &leftSide,
+            const HllppMergeSide &rightSide,
+            const satp::evaluation::MergeStrategy strategy) {
+            const uint32_t leftK = leftSide.k;
+            const uint32_t rightK = rightSide.k;
 
             satp::evaluation::MergeSketchContext left{
-                leftHashName,
-                leftHashSeed,
+                leftSide.hashName,
+                leftSide.hashSeed,
                 hllppParams(leftK)
             };
             satp::evaluation::MergeSketchContext right{
-                rightHashName,
-                rightHashSeed,
+                rightSide.hashName,
+                rightSide.hashSeed,
                 hllppParams(rightK)
             };
 
             const auto validity = classifyHllppCompatibility(left, right);
-            validateHllppStrategy(validity, cfg.mergeStrategy);
+            validateHllppStrategy(validity, strategy);
 
             const satp::evaluation::MergeSketchContext baseline{
                 left.hashName,
@@ -101,7 +124,7 @@ namespace satp::cli::executor {
                 satp::algorithms::catalog::getNameBy("hllpp"),
                 left,
                 right,
-                cfg.mergeStrategy,
+                strategy,
                 validity,
                 satp::evaluation::MergeTopology::Pairwise,
                 bench.metadata(),
@@ -132,6 +155,60 @@ namespace satp::cli::executor {
             const uint32_t k = static_cast<uint32_t>(stoul(sketchContext.params.substr(pos + prefix.size())));
             return alg::HyperLogLogPlusPlus(k, hashFunction);
         }
+
+        // Etichetta params dei CSV di un algoritmo con la configurazione corrente.
+        [[nodiscard]] optional<string> algorithmParams(const string &algorithmId, const RunConfig &cfg) {
+            if (algorithmId == "hllpp") {
+                // La modalita' di default mantiene l'etichetta storica.
+                if (cfg.hllppEstimator == alg::HyperLogLogPlusPlus::EstimatorMode::Improved) {
+                    return hllppParams(cfg.k) + ",estimator=improved";
+                }
+                return hllppParams(cfg.k);
+            }
+            if (algorithmId == "hll" || algorithmId == "ll") {
+                return "k=" + to_string(cfg.k) + ",L=" + to_string(cfg.lLog);
+            }
+            if (algorithmId == "pc") return "L=" + to_string(cfg.l);
+            return nullopt;
+        }
+
+        template<typename Algo>
+        void reestimateWith(Algo sketch,
+                            const DatasetRuntimeContext &ctx,
+                            const RunConfig &cfg,
+                            const filesystem::path &snapshotPath,
+                            const AlgorithmRunSpec &spec) {
+            const auto result = satp::evaluation::reestimateStreaming(snapshotPath, sketch, cfg.errorQuantiles);
+            const filesystem::path csvPath = path_utils::buildResultCsvPath(
+                ctx.repoRoot,
+                ctx.resultsNamespace,
+                spec.algorithmId,
+                spec.params,
+                spec.hashName,
+                RunMode::Reestimate);
+            filesystem::create_directories(csvPath.parent_path());
+            satp::evaluation::CsvResultWriter::appendStreaming(
+                csvPath,
+                makeCsvRunDescriptor(spec, result.metadata),
+                result.series,
+                cfg.errorQuantiles);
+            if (result.series.empty()) {
+                cout << algorithmLogPrefix(spec) << "[reestimate] csv=" << csvPath.string() << "  no data\n";
+                return;
+            }
+            printStreamingSummary(spec, csvPath, result.series.back());
+        }
+
+        [[nodiscard]] satp::evaluation::MergeTopologyOptions makeTopologyOptions(const RunConfig &cfg) {
+            satp::evaluation::MergeTopologyOptions options;
+            options.topology = cfg.mergeTopology;
+            options.partitions = cfg.topologyPartitions;
+            if (cfg.topologySampleSeed.has_value()) {
+                options.sampleSeed = *cfg.topologySampleSeed;
+            }
+            options.workers = cfg.workers;
+            return options;
+        }
     } // namespace
 
     vector<AlgorithmJob> buildAlgorithmJobs(
@@ -140,9 +217,10 @@ namespace satp::cli::executor {
         const RunConfig &cfg,
         const RunMode mode,
         const string &hashName) {
-        const string kParam = "k=" + to_string(cfg.k);
-        const string kAndLLogParam = kParam + ",L=" + to_string(cfg.lLog);
-        const string lParam = "L=" + to_string(cfg.l);
+        const string kParam = *algorithmParams("hllpp", cfg);
+        const string kAndLLogParam = *algorithmParams("hll", cfg);
+        const string lParam = *algorithmParams("pc", cfg);
+        const auto topologyOptions = makeTopologyOptions(cfg);
 
         vector<AlgorithmJob> jobs;
         jobs.reserve(4);
@@ -152,17 +230,20 @@ namespace satp::cli::executor {
             bench,
             ctx,
             mode,
+            topologyOptions,
             "hllpp",
             kParam,
             hashName,
             rseHll(cfg.k),
-            cfg.k);
+            cfg.k,
+            cfg.hllppEstimator);
 
         addAlgorithmJob<alg::HyperLogLog>(
             jobs,
             bench,
             ctx,
             mode,
+            topologyOptions,
             "hll",
             kAndLLogParam,
             hashName,
@@ -175,6 +256,7 @@ namespace satp::cli::executor {
             bench,
             ctx,
             mode,
+            topologyOptions,
             "ll",
             kAndLLogParam,
             hashName,
@@ -187,6 +269,7 @@ namespace satp::cli::executor {
             bench,
             ctx,
             mode,
+            topologyOptions,
             "pc",
             lParam,
             hashName,
@@ -200,7 +283,17 @@ namespace satp::cli::executor {
         satp::evaluation::EvaluationFramework &bench,
         const DatasetRuntimeContext &ctx,
         const RunConfig &cfg) {
-        const auto descriptor = makeHllppMergeDescriptor(bench, ctx, cfg);
+        const HllppMergeSide left{
+            resolveHashFunctionName(cfg.leftHashFunctionName, cfg.hashFunctionName),
+            resolveHashSeed(cfg.leftHashSeed, ctx.seed),
+            resolveK(cfg.leftK, cfg.k)
+        };
+        const HllppMergeSide right{
+            resolveHashFunctionName(cfg.rightHashFunctionName, cfg.hashFunctionName),
+            resolveHashSeed(cfg.rightHashSeed, ctx.seed),
+            resolveK(cfg.rightK, cfg.k)
+        };
+        const auto descriptor = makeHllppMergeDescriptor(bench, left, right, cfg.mergeStrategy);
 
         vector<AlgorithmJob> jobs;
         jobs.reserve(1);
@@ -215,4 +308,188 @@ namespace satp::cli::executor {
             buildHllppFromContext);
         return jobs;
     }
+
+    vector<AlgorithmJob> buildHeterogeneousMergeMatrixJobs(
+        satp::evaluation::EvaluationFramework &bench,
+        const DatasetRuntimeContext &ctx,
+        const RunConfig &cfg) {
+        const auto leftHashes = axisOr(cfg.matrixLeftHashes,
+                                       resolveHashFunctionName(cfg.leftHashFunctionName, cfg.hashFunctionName));
+        const auto rightHashes = axisOr(cfg.matrixRightHashes,
+                                        resolveHashFunctionName(cfg.rightHashFunctionName, cfg.hashFunctionName));
+        const auto leftSeeds = axisOr(cfg.matrixLeftSeeds, cfg.leftHashSeed);
+        const auto rightSeeds = axisOr(cfg.matrixRightSeeds, cfg.rightHashSeed);
+        const auto leftKs = axisOr(cfg.matrixLeftK, resolveK(cfg.leftK, cfg.k));
+        const auto rightKs = axisOr(cfg.matrixRightK, resolveK(cfg.rightK, cfg.k));
+        const auto strategies = axisOr(cfg.matrixStrategies, cfg.mergeStrategy);
+
+        // Stesso ordine di orchestrate_heterogeneous_merge.py.
+        vector<HeterogeneousMergeCell> cells;
+        for (const auto &leftHash : leftHashes) {
+            for (const auto &rightHash : rightHashes) {
+                for (const auto &leftSeed : leftSeeds) {
+                    for (const auto &rightSeed : rightSeeds) {
+                        for (const uint32_t leftK : leftKs) {
+                            for (const uint32_t rightK : rightKs) {
+                                const HllppMergeSide left{leftHash, resolveHashSeed(leftSeed, ctx.seed), leftK};
+                                const HllppMergeSide right{rightHash, resolveHashSeed(rightSeed, ctx.seed), rightK};
+                                const auto validity = classifyHllppCompatibility(
+                                    {left.hashName, left.hashSeed, hllppParams(left.k)},
+                                    {right.hashName, right.hashSeed, hllppParams(right.k)});
+                                for (const auto strategy : strategies) {
+                                    if (const char *violation = hllppStrategyViolation(validity, strategy)) {
+                                        cout << "[skip] left=(" << left.hashName << ",seed=" << left.hashSeed
+                                                << ",k=" << left.k << ") right=(" << right.hashName
+                                                << ",seed=" << right.hashSeed << ",k=" << right.k << ") strategy="
+                                                << satp::evaluation::toString(strategy) << ": " << violation << '\n';
+                                        continue;
+                                    }
+                                    auto descriptor = makeHllppMergeDescriptor(bench, left, right, strategy);
+                                    AlgorithmRunSpec spec{
+                                        "hllpp",
+                                        heterogeneousParamsLabel(descriptor),
+                                        heterogeneousHashLabel(descriptor),
+                                        rseUnknown()
+                                    };
+                                    cells.push_back({std::move(spec), std::move(descriptor)});
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        vector<AlgorithmJob> jobs;
+        if (cells.empty()) return jobs;
+        jobs.reserve(1);
+        addHeterogeneousMergeMatrixJob<alg::HyperLogLogPlusPlus>(
+            jobs,
+            bench,
+            ctx,
+            "hllpp",
+            std::move(cells),
+            buildHllppFromContext);
+        return jobs;
+    }
+
+    bool runReestimation(const DatasetRuntimeContext &ctx,
+                         const RunConfig &cfg,
+                         const satp::hashing::HashFunction &hashFunction,
+                         const string &sourceId,
+                         const string &targetId) {
+        const auto sourceParams = algorithmParams(sourceId, cfg);
+        const auto targetParams = algorithmParams(targetId, cfg);
+        if (!sourceParams.has_value() || !targetParams.has_value()) {
+            cout << "Algoritmo non supportato per reestimate\n";
+            return false;
+        }
+
+        const filesystem::path sourceCsv = path_utils::buildResultCsvPath(
+            ctx.repoRoot,
+            ctx.resultsNamespace,
+            sourceId,
+            *sourceParams,
+            cfg.hashFunctionName,
+            RunMode::Streaming);
+        const filesystem::path snapshotPath = path_utils::buildSnapshotPath(sourceCsv, ctx.datasetPath);
+        if (!filesystem::exists(snapshotPath)) {
+            cout << "Snapshot non trovato (runstream " << sourceId << " con snapshots on): "
+                    << snapshotPath.string() << '\n';
+            return false;
+        }
+
+        // Lo stato deve essere compatibile con il target: loadState rifiuta
+        // formati o parametri diversi (es. registri HLL/LogLog con k diverso).
+        const double rseTheoretical = (targetId == "ll")
+                                          ? rseLogLog(cfg.k)
+                                          : (targetId == "pc") ? rseUnknown() : rseHll(cfg.k);
+        const AlgorithmRunSpec spec{targetId, *targetParams + ",from=" + sourceId, cfg.hashFunctionName, rseTheoretical};
+        if (targetId == "hllpp") {
+            reestimateWith(alg::HyperLogLogPlusPlus(cfg.k, cfg.hllppEstimator, hashFunction), ctx, cfg, snapshotPath, spec);
+        } else if (targetId == "hll") {
+            reestimateWith(alg::HyperLogLog(cfg.k, cfg.lLog, hashFunction), ctx, cfg, snapshotPath, spec);
+        } else if (targetId == "ll") {
+            reestimateWith(alg::LogLog(cfg.k, cfg.lLog, hashFunction), ctx, cfg, snapshotPath, spec);
+        } else {
+            reestimateWith(alg::ProbabilisticCounting(cfg.l, hashFunction), ctx, cfg, snapshotPath, spec);
+        }
+        return true;
+    }
+
+    void runRegisterSimulation(const RunConfig &cfg, const SelectedAlgorithms &selected) {
+        if (cfg.checkpoints == 0u) {
+            cout << "runsim richiede un budget di checkpoint finito (set checkpoints <n>)\n";
+            return;
+        }
+        const auto maxN = static_cast<size_t>(cfg.simMaxN);
+        satp::evaluation::RegisterSimulationOptions options;
+        options.cardinalities = satp::evaluation::CheckpointPlanner::build(maxN, cfg.checkpoints);
+        options.runs = cfg.simRuns;
+        options.seed = cfg.simSeed;
+        options.workers = cfg.workers;
+        options.errorQuantiles = cfg.errorQuantiles;
+        const satp::evaluation::EvaluationMetadata metadata{cfg.simRuns, maxN, maxN, cfg.simSeed};
+        const auto estimators = makeSelectedEstimators(cfg.estimators);
+        const filesystem::path repoRoot = path_utils::detectRepoRoot(cfg.datasetPath);
+
+        // Hash ideali: i registri non dipendono da hashFunction, solo da k e
+        // dai bit di hash dello sketch (lLog per hll/ll, 64 per hllpp).
+        struct SimulatedSketch {
+            AlgorithmRunSpec spec;
+            uint32_t hashBits;
+        };
+        const array<SimulatedSketch, 3> sketches{{
+            {{"hllpp", hllppParams(cfg.k), "ideal", rseHll(cfg.k)}, 64u},
+            {{"hll", *algorithmParams("hll", cfg), "ideal", rseHll(cfg.k)}, cfg.lLog},
+            {{"ll", *algorithmParams("ll", cfg), "ideal", rseLogLog(cfg.k)}, cfg.lLog},
+        }};
+
+        cout << "mode: " << modeLabel(RunMode::Simulation)
+                << '\t' << "maxN: " << maxN
+                << '\t' << "runs: " << cfg.simRuns
+                << '\t' << "seed: " << cfg.simSeed
+                << '\t' << "checkpoints: " << options.cardinalities.size() << '\n'
+                << "resultsRoot: " << (repoRoot / "results" / cfg.resultsNamespace).string() << '\n';
+        if (shouldRun(selected, "pc")) {
+            const AlgorithmRunSpec pcSpec{"pc", *algorithmParams("pc", cfg), "ideal", rseUnknown()};
+            cout << algorithmLogPrefix(pcSpec) << "[simulation] skip, lo sketch non ha registri\n";
+        }
+
+        for (const auto &sketch : sketches) {
+            if (!shouldRun(selected, sketch.spec.algorithmId)) continue;
+            options.precision = cfg.k;
+            options.hashBits = sketch.hashBits;
+            const auto results = satp::evaluation::simulateRegisterStreaming(options, estimators.estimators);
+
+            const filesystem::path csvPath = path_utils::buildResultCsvPath(
+                repoRoot,
+                cfg.resultsNamespace,
+                sketch.spec.algorithmId,
+                sketch.spec.params,
+                sketch.spec.hashName,
+                RunMode::Simulation);
+            filesystem::create_directories(csvPath.parent_path());
+            for (const auto &result : results) {
+                const AlgorithmRunSpec estimatorSpec{
+                    sketch.spec.algorithmId,
+                    sketch.spec.params + ",estimator=" + result.estimator,
+                    sketch.spec.hashName,
+                    sketch.spec.rseTheoretical
+                };
+                const filesystem::path outputPath = path_utils::buildEstimatorCsvPath(csvPath, result.estimator);
+                satp::evaluation::CsvResultWriter::appendStreaming(
+                    outputPath,
+                    makeCsvRunDescriptor(estimatorSpec, metadata),
+                    result.series,
+                    cfg.errorQuantiles);
+                if (result.series.empty()) {
+                    cout << algorithmLogPrefix(estimatorSpec) << "[simulation] csv=" << outputPath.string()
+                            << "  no data\n";
+                    continue;
+                }
+                printStreamingSummary(estimatorSpec, outputPath, result.series.back());
+            }
+        }
+    }
 } // namespace satp::cli::executor
@@ -4,7 +4,9 @@
 #include <vector>
 
 #include "satp/cli/detail/CliTypes.h"
+#include "satp/cli/detail/execution/AlgorithmSelection.h"
 #include "satp/cli/detail/execution/AlgorithmRunner.h"
+#include "satp/hashing/HashFunction.h"
 #include "satp/simulation/Simulation.h"
 
 using namespace std;
@@ -21,4 +23,24 @@ namespace satp::cli::executor {
         satp::evaluation::EvaluationFramework &bench,
         const DatasetRuntimeContext &ctx,
         const RunConfig &cfg);
+
+    // Espande gli assi matrix* in celle (left, right, strategia), scarta le
+    // combinazioni non ammesse e valuta le restanti in un solo passaggio.
+    [[nodiscard]] vector<AlgorithmJob> buildHeterogeneousMergeMatrixJobs(
+        satp::evaluation::EvaluationFramework &bench,
+        const DatasetRuntimeContext &ctx,
+        const RunConfig &cfg);
+
+    // Ri-stima gli snapshot di runstream di `sourceId` (parametri e hash correnti)
+    // con lo stimatore `targetId` e scrive il CSV in results/<ns>/reestimate/.
+    // false se un id non e' supportato o lo snapshot non esiste.
+    bool runReestimation(const DatasetRuntimeContext &ctx,
+                         const RunConfig &cfg,
+                         const satp::hashing::HashFunction &hashFunction,
+                         const string &sourceId,
+                         const string &targetId);
+
+    // runsim: simula i registri di hll, ll e hllpp (k, lLog, checkpoints,
+    // estimators, sim*) e scrive un CSV per stimatore in results/<ns>/simulation/.
+    void runRegisterSimulation(const RunConfig &cfg, const SelectedAlgorithms &selected);
 } // namespace satp::cli::executor
@@ -1,5 +1,6 @@
 #include "satp/cli/detail/execution/RunReporter.h"
 
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -12,6 +13,12 @@ namespace satp::cli::executor {
     const char *modeLabel(const RunMode mode) {
         if (mode == RunMode::Streaming) return "streaming";
         if (mode == RunMode::MergeHeterogeneous) return "merge_heterogeneous";
+        if (mode == RunMode::MergeTopology) return "merge_topology";
+        if (mode == RunMode::MergeMatrix) return "merge_matrix";
+        if (mode == RunMode::Reestimate) return "reestimate";
+        if (mode == RunMode::Estimators) return "estimators";
+        if (mode == RunMode::Simulation) return "simulation";
+        if (mode == RunMode::Latency) return "latency";
         return "merge";
     }
 
@@ -44,11 +51,17 @@ namespace satp::cli::executor {
                   << "resultsRoot: " << (ctx.repoRoot / "results" / ctx.resultsNamespace).string() << '\n';
     }
 
+    const char *streamingOutputLabel(const filesystem::path &outputPath) {
+        return (outputPath.extension() == ".bin") ? "trace" : "csv";
+    }
+
     void printStreamingSummary(const AlgorithmRunSpec &spec,
-                               const filesystem::path &csvPath,
+                               const filesystem::path &outputPath,
                                const satp::evaluation::StreamingPointStats &lastPoint) {
-        cout << algorithmLogPrefix(spec) << "[stream] csv=" << csvPath.string()
+        cout << algorithmLogPrefix(spec) << "[stream] " << streamingOutputLabel(outputPath)
+                  << '=' << outputPath.string()
                   << "  t=" << lastPoint.number_of_elements_processed
+                  << "  runs=" << lastPoint.runs
                   << "  mean=" << lastPoint.mean
                   << "  f0_hat=" << lastPoint.mean
                   << "  f0_true=" << lastPoint.truth_mean
@@ -73,4 +86,87 @@ namespace satp::cli::executor {
                   << "  delta_rmse=" << stats.delta_merge_serial_rmse
                   << '\n';
     }
+
+    void printAllocationSummary(const AlgorithmRunSpec &spec,
+                                const satp::evaluation::EvaluationDiagnostics &diagnostics) {
+        if (!diagnostics.allocationsTracked) return;
+        cout << algorithmLogPrefix(spec) << "[alloc]"
+                  << "  warmup_runs=" << diagnostics.warmupRuns
+                  << "  warmup_allocs=" << diagnostics.warmup.allocations
+                  << "  warmup_bytes=" << diagnostics.warmup.bytes
+                  << "  steady_runs=" << diagnostics.steadyRuns
+                  << "  steady_allocs=" << diagnostics.steadyState.allocations
+                  << "  steady_bytes=" << diagnostics.steadyState.bytes << '\n';
+    }
+
+    void printTimingSummary(const AlgorithmRunSpec &spec,
+                            const satp::evaluation::EvaluationDiagnostics &diagnostics) {
+        if (diagnostics.timedRuns == 0u) return;
+        const double wallSeconds = chrono::duration<double>(diagnostics.wall).count();
+        size_t slowest = 0;
+        for (size_t i = 1; i < satp::profiling::PHASE_COUNT; ++i) {
+            if (diagnostics.phases.nanoseconds[i] > diagnostics.phases.nanoseconds[slowest]) slowest = i;
+        }
+        cout << algorithmLogPrefix(spec) << "[timing]"
+                  << "  wall_s=" << wallSeconds
+                  << "  runs=" << diagnostics.timedRuns
+                  << "  elements_per_s="
+                  << (wallSeconds > 0.0 ? static_cast<double>(diagnostics.elements) / wallSeconds : 0.0)
+                  << "  slowest_phase=" << satp::profiling::phaseName(static_cast<satp::profiling::Phase>(slowest))
+                  << "  peak_rss_mb=" << static_cast<double>(diagnostics.peakRssBytes) / (1024.0 * 1024.0);
+        const auto counted = diagnostics.phases.totalCounted();
+        if (counted.has(satp::profiling::HardwareCounter::Cycles) && diagnostics.elements != 0u) {
+            const double elements = static_cast<double>(diagnostics.elements);
+            cout << "  ipc=" << counted.ipc()
+                      << "  cycles_per_element="
+                      << static_cast<double>(counted.get(satp::profiling::HardwareCounter::Cycles)) / elements
+                      << "  llc_misses_per_element="
+                      << static_cast<double>(counted.get(satp::profiling::HardwareCounter::LlcMisses)) / elements;
+        }
+        cout << '\n';
+    }
+
+    void printLatencySummary(const AlgorithmRunSpec &spec,
+                             const filesystem::path &csvPath,
+                             const satp::evaluation::LatencyResult &result) {
+        cout << algorithmLogPrefix(spec) << "[latency] csv=" << csvPath.string()
+                  << "  runs=" << result.runs
+                  << "  batch=" << result.batch
+                  << "  timer_overhead_ns=" << result.timer_overhead_ns;
+        if (result.target_rate > 0.0) {
+            cout << "  target_rate=" << result.target_rate << "  late_batches=" << result.late_batches;
+        }
+        cout << '\n';
+        for (const auto &point : result.operations) {
+            cout << algorithmLogPrefix(spec) << "[latency] " << satp::evaluation::toString(point.operation)
+                      << "  calls=" << point.calls
+                      << "  p50_ns=" << point.p50_ns
+                      << "  p99_ns=" << point.p99_ns
+                      << "  p999_ns=" << point.p999_ns
+                      << "  max_ns=" << point.max_ns << '\n';
+        }
+    }
+
+    void printMergeTopologySummary(const AlgorithmRunSpec &spec,
+                                   const filesystem::path &csvPath,
+                                   const satp::evaluation::MergeTopologyResult &result) {
+        double mergeSeconds = 0.0;
+        for (const auto &level : result.levels) {
+            if (level.level > 0u) mergeSeconds += level.wall_seconds;
+        }
+        cout << algorithmLogPrefix(spec) << "[merge_topology] csv=" << csvPath.string()
+                  << "  topology=" << satp::evaluation::toString(result.topology)
+                  << "  partitions=" << result.partitions
+                  << "  workers=" << result.workers
+                  << "  levels=" << result.levels.size();
+        if (!result.levels.empty()) {
+            const auto &root = result.levels.back();
+            cout << "  build_s=" << result.levels.front().wall_seconds
+                      << "  merge_s=" << mergeSeconds
+                      << "  exact=" << root.exact_union_mean
+                      << "  estimate=" << root.estimate_mean
+                      << "  drift_rel=" << root.drift_rel_mean;
+        }
+        cout << '\n';
+    }
 } // namespace satp::cli::executor
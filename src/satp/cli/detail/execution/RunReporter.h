@@ -22,11 +22,32 @@ namespace satp::cli::executor {
                          RunMode mode,
                          const string &hashName);
 
+    // "trace" per i trace binari (.bin), "csv" altrimenti.
+    [[nodiscard]] const char *streamingOutputLabel(const filesystem::path &outputPath);
+
     void printStreamingSummary(const AlgorithmRunSpec &spec,
-                               const filesystem::path &csvPath,
+                               const filesystem::path &outputPath,
                                const satp::evaluation::StreamingPointStats &lastPoint);
 
     void printMergeSummary(const AlgorithmRunSpec &spec,
                            const filesystem::path &csvPath,
                            const satp::evaluation::MergePairStats &stats);
+
+    // Allocazioni su heap per run (warm-up e regime); nulla se non misurate
+    // (CLI compilata senza SATP_COUNT_ALLOCATIONS).
+    void printAllocationSummary(const AlgorithmRunSpec &spec,
+                                const satp::evaluation::EvaluationDiagnostics &diagnostics);
+
+    // Tempo di parete, throughput e fase piu' costosa dell'ultima valutazione.
+    void printTimingSummary(const AlgorithmRunSpec &spec,
+                            const satp::evaluation::EvaluationDiagnostics &diagnostics);
+
+    // Quantili di latenza per operazione di runlatency.
+    void printLatencySummary(const AlgorithmRunSpec &spec,
+                             const filesystem::path &csvPath,
+                             const satp::evaluation::LatencyResult &result);
+
+    void printMergeTopologySummary(const AlgorithmRunSpec &spec,
+                                   const filesystem::path &csvPath,
+                                   const satp::evaluation::MergeTopologyResult &result);
 } // namespace satp::cli::executor
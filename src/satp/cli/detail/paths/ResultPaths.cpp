@@ -74,10 +74,50 @@ namespace satp::cli::path_utils {
         if (mode == RunMode::Merge) {
             fileName = "results_merge.csv";
             modeDir = "merge";
-        } else if (mode == RunMode::MergeHeterogeneous) {
+        } else if (mode == RunMode::MergeHeterogeneous || mode == RunMode::MergeMatrix) {
+            // Le celle della matrice scrivono gli stessi CSV di runmergehet.
             fileName = "results_merge_heterogeneous.csv";
             modeDir = "merge_heterogeneous";
+        } else if (mode == RunMode::MergeTopology) {
+            fileName = "results_merge_topology.csv";
+            modeDir = "merge_topology";
+        } else if (mode == RunMode::Reestimate) {
+            // Stesso schema dei CSV streaming: le serie si confrontano colonna per colonna.
+            modeDir = "reestimate";
+        } else if (mode == RunMode::Estimators) {
+            modeDir = "estimators";
+        } else if (mode == RunMode::Simulation) {
+            modeDir = "simulation";
+        } else if (mode == RunMode::Latency) {
+            fileName = "results_latency.csv";
+            modeDir = "latency";
         }
         return repoRoot / "results" / nsDir / modeDir / algorithmDir / hashDir / paramsDir / fileName;
     }
+
+    filesystem::path buildResumePath(const filesystem::path &resultPath,
+                                     const filesystem::path &datasetPath,
+                                     const string &extension) {
+        const string datasetTag = sanitizeForPath(datasetPath.stem().string());
+        return resultPath.parent_path() / ("resume_" + datasetTag + extension);
+    }
+
+    filesystem::path buildEstimatorCsvPath(const filesystem::path &resultPath,
+                                           const string &estimatorId) {
+        return resultPath.parent_path() / ("results_streaming_" + sanitizeForPath(estimatorId) + ".csv");
+    }
+
+    filesystem::path buildTimingCsvPath(const filesystem::path &resultPath) {
+        return resultPath.parent_path() / "timing.csv";
+    }
+
+    filesystem::path buildSketchStatsCsvPath(const filesystem::path &resultPath) {
+        return resultPath.parent_path() / "sketch_stats.csv";
+    }
+
+    filesystem::path buildSnapshotPath(const filesystem::path &resultPath,
+                                       const filesystem::path &datasetPath) {
+        const string datasetTag = sanitizeForPath(datasetPath.stem().string());
+        return resultPath.parent_path() / ("snapshots_" + datasetTag + ".bin");
+    }
 } // namespace satp::cli::path_utils
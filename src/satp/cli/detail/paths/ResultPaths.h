@@ -24,4 +24,29 @@ namespace satp::cli::path_utils {
         const string &params,
         const string &hashName,
         RunMode mode);
+
+    // File di resume di un job accanto al suo CSV, uno per dataset:
+    // resume_<dataset>.state (avanzamento streaming) e resume_<dataset>.done.
+    [[nodiscard]] filesystem::path buildResumePath(
+        const filesystem::path &resultPath,
+        const filesystem::path &datasetPath,
+        const string &extension);
+
+    // CSV streaming di uno stimatore di runestimators, accanto al CSV del job.
+    [[nodiscard]] filesystem::path buildEstimatorCsvPath(
+        const filesystem::path &resultPath,
+        const string &estimatorId);
+
+    // Tempi per fase dei job accanto al loro CSV: timing.csv.
+    [[nodiscard]] filesystem::path buildTimingCsvPath(
+        const filesystem::path &resultPath);
+
+    // Contatori interni degli sketch (SATP_SKETCH_STATS) accanto al CSV: sketch_stats.csv.
+    [[nodiscard]] filesystem::path buildSketchStatsCsvPath(
+        const filesystem::path &resultPath);
+
+    // Snapshot degli sketch di runstream accanto al CSV: snapshots_<dataset>.bin.
+    [[nodiscard]] filesystem::path buildSnapshotPath(
+        const filesystem::path &resultPath,
+        const filesystem::path &datasetPath);
 } // namespace satp::cli::path_utils
@@ -2,7 +2,9 @@
 
 // This module indexes and loads the binary datasets used to run sketching
 // experiments. It is the single public entrypoint for dataset metadata,
-// partition reads, and truth-bit access.
+// partition reads, and truth-bit access. DatasetWriter produces the same format
+// from C++ producers.
 
 #include "satp/dataset/detail/DatasetAccess.h"
 #include "satp/dataset/detail/DatasetTypes.h"
+#include "satp/dataset/detail/DatasetWriter.h"
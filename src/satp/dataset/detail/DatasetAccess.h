@@ -14,6 +14,11 @@ namespace satp::dataset {
                              size_t partitionIndex,
                              vector<uint32_t> &out);
 
+    // Works on both encodings: 32-bit values are widened.
+    void loadBinaryPartition(const DatasetIndex &index,
+                             size_t partitionIndex,
+                             vector<uint64_t> &out);
+
     void loadBinaryPartitionTruthBits(const DatasetIndex &index,
                                       size_t partitionIndex,
                                       vector<uint8_t> &outTruthBits);
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <vector>
 
+#include "satp/profiling/PhaseTimer.h"
+
 using namespace std;
 
 namespace satp::dataset {
@@ -25,6 +27,8 @@ namespace satp::dataset {
         size_t distinct_per_partition = 0;
         uint32_t seed = 0;
         size_t partition_count = 0;
+        // Width of the stored keys: 32 (v2, ENCODING_ZLIB_U32_LE) or 64 (v3, ENCODING_ZLIB_U64_LE).
+        uint32_t value_bits = 32;
     };
 
     struct DatasetIndex {
@@ -37,9 +41,17 @@ namespace satp::dataset {
     public:
         explicit PartitionReader(const DatasetIndex &index);
         void load(size_t partitionIndex, vector<uint32_t> &out);
+        void load(size_t partitionIndex, vector<uint64_t> &out);
         void loadWithTruthBits(size_t partitionIndex,
                                vector<uint32_t> &outValues,
                                vector<uint8_t> &outTruthBits);
+        void loadWithTruthBits(size_t partitionIndex,
+                               vector<uint64_t> &outValues,
+                               vector<uint8_t> &outTruthBits);
+
+        // Somma in `times` lettura, inflate e decodifica dei truth bit delle
+        // load successive; nullptr (default) disattiva la misura.
+        void setPhaseTimes(profiling::PhaseTimes *times) noexcept;
 
     private:
         const DatasetIndex &index_;
@@ -48,6 +60,7 @@ namespace satp::dataset {
         vector<uint8_t> decompressedValues_;
         vector<uint8_t> compressedTruth_;
         vector<uint8_t> decompressedTruth_;
+        profiling::PhaseTimes *phaseTimes_ = nullptr;
     };
 } // namespace satp::dataset
 
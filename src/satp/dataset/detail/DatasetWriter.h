@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <span>
+#include <vector>
+
+#include "satp/dataset/detail/DatasetTypes.h"
+
+using namespace std;
+
+namespace satp::dataset {
+    struct DatasetWriterOptions {
+        // 0 = std::thread::hardware_concurrency().
+        size_t workers = 0;
+        // Same default level used by generate_partitioned_dataset_bin.py.
+        int compressionLevel = 6;
+    };
+
+    // Streams values into a binary dataset file. Every `elements_per_partition`
+    // appended values close a partition: its truth bits are derived with an exact
+    // distinct tracker and the payloads are compressed on a bounded pool of worker
+    // tasks. Partitions are written to disk in index order, and the header plus the
+    // partition table are filled in by close().
+    //
+    // `info.distinct_per_partition == 0` with a non-empty partition means "derive it
+    // from the data"; every partition must still report the same distinct count,
+    // because the reader requires uniform partitions. `info.value_bits == 64` writes
+    // a v3 file with ENCODING_ZLIB_U64_LE values.
+    class DatasetWriter {
+    public:
+        DatasetWriter(const filesystem::path &path, const DatasetInfo &info, DatasetWriterOptions options = {});
+        ~DatasetWriter();
+
+        DatasetWriter(const DatasetWriter &) = delete;
+        DatasetWriter &operator=(const DatasetWriter &) = delete;
+
+        void append(uint32_t value);
+        void append(uint64_t value);
+        void append(span<const uint32_t> values);
+        void append(span<const uint64_t> values);
+        void close();
+
+        [[nodiscard]] size_t completedPartitions() const { return entries_.size(); }
+
+    private:
+        struct EncodedPartition {
+            vector<uint8_t> values;
+            vector<uint8_t> truth;
+            size_t elements = 0;
+            size_t distinct = 0;
+        };
+
+        template<typename Value>
+        void appendValue(vector<Value> &current, Value value);
+
+        template<typename Value>
+        void submitPartition(vector<Value> &current);
+
+        void submitCurrentPartition();
+        void writeOldestPending();
+        void writeHeaderAndTable();
+
+        filesystem::path path_;
+        DatasetInfo info_;
+        DatasetWriterOptions options_;
+        ofstream output_;
+        uint64_t nextOffset_ = 0;
+        size_t submittedPartitions_ = 0;
+        bool closed_ = false;
+        vector<uint32_t> current32_;
+        vector<uint64_t> current64_;
+        deque<future<EncodedPartition>> pending_;
+        vector<PartitionEntry> entries_;
+    };
+} // namespace satp::dataset
@@ -4,6 +4,7 @@
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 using namespace std;
 
@@ -26,16 +27,29 @@ namespace satp::dataset::detail {
                | (static_cast<uint64_t>(bytes[7]) << 56u);
     }
 
-    [[nodiscard]] inline size_t toSizeTChecked(uint64_t value, const string &field) {
+    inline void writeU32LE(uint8_t *bytes, uint32_t value) {
+        bytes[0] = static_cast<uint8_t>(value);
+        bytes[1] = static_cast<uint8_t>(value >> 8u);
+        bytes[2] = static_cast<uint8_t>(value >> 16u);
+        bytes[3] = static_cast<uint8_t>(value >> 24u);
+    }
+
+    inline void writeU64LE(uint8_t *bytes, uint64_t value) {
+        writeU32LE(bytes, static_cast<uint32_t>(value));
+        writeU32LE(bytes + 4u, static_cast<uint32_t>(value >> 32u));
+    }
+
+    // `field` e' un string_view: le chiamate con letterali non allocano sul percorso di lettura.
+    [[nodiscard]] inline size_t toSizeTChecked(uint64_t value, const string_view field) {
         if (value > static_cast<uint64_t>(numeric_limits<size_t>::max())) {
-            throw runtime_error("Binary dataset field '" + field + "' is too large for size_t");
+            throw runtime_error("Binary dataset field '" + string(field) + "' is too large for size_t");
         }
         return static_cast<size_t>(value);
     }
 
-    [[nodiscard]] inline streamoff toStreamoffChecked(uint64_t value, const string &field) {
+    [[nodiscard]] inline streamoff toStreamoffChecked(uint64_t value, const string_view field) {
         if (value > static_cast<uint64_t>(numeric_limits<streamoff>::max())) {
-            throw runtime_error("Binary dataset field '" + field + "' is too large for streamoff");
+            throw runtime_error("Binary dataset field '" + string(field) + "' is too large for streamoff");
         }
         return static_cast<streamoff>(value);
     }
@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 #include <zlib.h>
@@ -16,7 +17,14 @@ namespace satp::dataset::detail {
         }
     }
 
-    inline void seekChecked(ifstream &input, uint64_t offset, const string &field, const char *error) {
+    inline void writeExact(ofstream &output, const uint8_t *source, size_t bytes, const char *error) {
+        output.write(reinterpret_cast<const char *>(source), static_cast<streamsize>(bytes));
+        if (!output) {
+            throw runtime_error(error);
+        }
+    }
+
+    inline void seekChecked(ifstream &input, uint64_t offset, const string_view field, const char *error) {
         input.clear();
         input.seekg(toStreamoffChecked(offset, field), ios::beg);
         if (!input) {
@@ -38,5 +46,22 @@ namespace satp::dataset::detail {
             throw runtime_error(error);
         }
     }
+
+    inline void compressZlibBlock(const vector<uint8_t> &raw,
+                                  int level,
+                                  vector<uint8_t> &compressed,
+                                  const char *error) {
+        uLongf compressedLen = ::compressBound(static_cast<uLong>(raw.size()));
+        compressed.resize(static_cast<size_t>(compressedLen));
+        const int rc = ::compress2(reinterpret_cast<Bytef *>(compressed.data()),
+                                   &compressedLen,
+                                   reinterpret_cast<const Bytef *>(raw.data()),
+                                   static_cast<uLong>(raw.size()),
+                                   level);
+        if (rc != Z_OK) {
+            throw runtime_error(error);
+        }
+        compressed.resize(static_cast<size_t>(compressedLen));
+    }
 } // namespace satp::dataset::detail
 
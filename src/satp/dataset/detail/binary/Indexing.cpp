@@ -29,7 +29,9 @@ namespace satp::dataset {
         }
 
         const uint32_t version = detail::readU32LE(header.data() + 8u);
-        if (version != detail::VERSION) throw runtime_error("Invalid binary dataset: unsupported version");
+        if (version != detail::VERSION && version != detail::VERSION_U64) {
+            throw runtime_error("Invalid binary dataset: unsupported version");
+        }
 
         DatasetIndex index;
         index.path = path;
@@ -70,9 +72,17 @@ namespace satp::dataset {
             if (entry.elements != index.info.elements_per_partition || entry.distinct != index.info.distinct_per_partition) {
                 throw runtime_error("Invalid binary dataset: partition metadata mismatch");
             }
-            if (entry.values_encoding != detail::ENCODING_ZLIB_U32_LE) {
+            const bool u64Values = version == detail::VERSION_U64
+                                   && entry.values_encoding == detail::ENCODING_ZLIB_U64_LE;
+            if (entry.values_encoding != detail::ENCODING_ZLIB_U32_LE && !u64Values) {
                 throw runtime_error("Invalid binary dataset: unsupported values encoding");
             }
+            const uint32_t valueBits = u64Values ? 64u : 32u;
+            if (i == 0) {
+                index.info.value_bits = valueBits;
+            } else if (valueBits != index.info.value_bits) {
+                throw runtime_error("Invalid binary dataset: mixed values encodings");
+            }
             if (entry.truth_encoding != detail::ENCODING_ZLIB_BITSET_LE) {
                 throw runtime_error("Invalid binary dataset: unsupported truth encoding");
             }
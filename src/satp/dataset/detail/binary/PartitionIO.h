@@ -1,10 +1,13 @@
 #pragma once
 
+#include <type_traits>
 #include <vector>
 
 #include "satp/dataset/detail/DatasetTypes.h"
 #include "satp/dataset/detail/binary/Endian.h"
 #include "satp/dataset/detail/binary/FileIO.h"
+#include "satp/dataset/detail/binary/Format.h"
+#include "satp/profiling/PhaseTimer.h"
 
 using namespace std;
 
@@ -17,22 +20,41 @@ namespace satp::dataset::detail {
         return index.partitions[partitionIndex];
     }
 
+    template<typename Value>
     inline void loadValuesInto(ifstream &input,
                                const PartitionEntry &entry,
                                vector<uint8_t> &compressed,
                                vector<uint8_t> &decompressed,
-                               vector<uint32_t> &out) {
+                               vector<Value> &out,
+                               profiling::PhaseTimes *times = nullptr) {
+        static_assert(is_same_v<Value, uint32_t> || is_same_v<Value, uint64_t>,
+                      "partition values are loaded as uint32_t or uint64_t");
+        const bool u64Values = entry.values_encoding == ENCODING_ZLIB_U64_LE;
+        if constexpr (is_same_v<Value, uint32_t>) {
+            if (u64Values) throw runtime_error("64-bit binary dataset values require a uint64_t buffer");
+        }
+
         out.assign(entry.elements, 0u);
         if (entry.elements == 0) return;
 
+        profiling::PhaseTimer readTimer(times, profiling::Phase::Read);
         seekChecked(input, entry.values_offset, "entry.values_offset", "Cannot seek binary dataset partition");
         compressed.resize(toSizeTChecked(entry.values_byte_size, "entry.values_byte_size"));
         readExact(input, compressed.data(), compressed.size(), "Cannot read binary dataset partition payload");
+        readTimer.stop();
 
-        const size_t expectedBytes = toSizeTChecked(static_cast<uint64_t>(entry.elements) * 4ull,
+        const profiling::PhaseTimer inflateTimer(times, profiling::Phase::Inflate);
+        const uint64_t valueBytes = u64Values ? 8ull : 4ull;
+        const size_t expectedBytes = toSizeTChecked(static_cast<uint64_t>(entry.elements) * valueBytes,
                                                     "partition.uncompressed_size");
         decompressZlibBlock(compressed, expectedBytes, decompressed, "Cannot decompress binary dataset partition");
 
+        if (u64Values) {
+            for (size_t i = 0; i < entry.elements; ++i) {
+                out[i] = static_cast<Value>(readU64LE(decompressed.data() + (i * 8u)));
+            }
+            return;
+        }
         for (size_t i = 0; i < entry.elements; ++i) {
             out[i] = readU32LE(decompressed.data() + (i * 4u));
         }
@@ -42,7 +64,9 @@ namespace satp::dataset::detail {
                                   const PartitionEntry &entry,
                                   vector<uint8_t> &compressed,
                                   vector<uint8_t> &decompressed,
-                                  vector<uint8_t> &outTruthBits) {
+                                  vector<uint8_t> &outTruthBits,
+                                  profiling::PhaseTimes *times = nullptr) {
+        const profiling::PhaseTimer timer(times, profiling::Phase::TruthDecode);
         const size_t expectedTruthBytes = (entry.elements + 7u) / 8u;
         outTruthBits.assign(expectedTruthBytes, 0u);
         if (expectedTruthBytes == 0) return;
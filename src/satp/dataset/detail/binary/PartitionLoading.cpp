@@ -16,6 +16,17 @@ namespace satp::dataset {
         detail::loadValuesInto(input, entry, compressed, decompressed, out);
     }
 
+    void loadBinaryPartition(const DatasetIndex &index,
+                             size_t partitionIndex,
+                             vector<uint64_t> &out) {
+        const auto &entry = detail::partitionEntryOrThrow(index, partitionIndex);
+        ifstream input(index.path, ios::binary);
+        if (!input) throw runtime_error("Cannot open binary dataset file");
+        vector<uint8_t> compressed;
+        vector<uint8_t> decompressed;
+        detail::loadValuesInto(input, entry, compressed, decompressed, out);
+    }
+
     void loadBinaryPartitionTruthBits(const DatasetIndex &index,
                                       size_t partitionIndex,
                                       vector<uint8_t> &outTruthBits) {
@@ -37,7 +48,17 @@ namespace satp::dataset {
                                detail::partitionEntryOrThrow(index_, partitionIndex),
                                compressedValues_,
                                decompressedValues_,
-                               out);
+                               out,
+                               phaseTimes_);
+    }
+
+    void PartitionReader::load(size_t partitionIndex, vector<uint64_t> &out) {
+        detail::loadValuesInto(input_,
+                               detail::partitionEntryOrThrow(index_, partitionIndex),
+                               compressedValues_,
+                               decompressedValues_,
+                               out,
+                               phaseTimes_);
     }
 
     void PartitionReader::loadWithTruthBits(size_t partitionIndex,
@@ -45,6 +66,18 @@ namespace satp::dataset {
                                             vector<uint8_t> &outTruthBits) {
         const auto &entry = detail::partitionEntryOrThrow(index_, partitionIndex);
         load(partitionIndex, outValues);
-        detail::loadTruthBitsInto(input_, entry, compressedTruth_, decompressedTruth_, outTruthBits);
+        detail::loadTruthBitsInto(input_, entry, compressedTruth_, decompressedTruth_, outTruthBits, phaseTimes_);
+    }
+
+    void PartitionReader::loadWithTruthBits(size_t partitionIndex,
+                                            vector<uint64_t> &outValues,
+                                            vector<uint8_t> &outTruthBits) {
+        const auto &entry = detail::partitionEntryOrThrow(index_, partitionIndex);
+        load(partitionIndex, outValues);
+        detail::loadTruthBitsInto(input_, entry, compressedTruth_, decompressedTruth_, outTruthBits, phaseTimes_);
+    }
+
+    void PartitionReader::setPhaseTimes(profiling::PhaseTimes *times) noexcept {
+        phaseTimes_ = times;
     }
 } // namespace satp::dataset
@@ -0,0 +1,237 @@
+#include "satp/dataset/detail/DatasetWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+
+#include "satp/dataset/detail/binary/Endian.h"
+#include "satp/dataset/detail/binary/FileIO.h"
+#include "satp/dataset/detail/binary/Format.h"
+
+using namespace std;
+
+namespace satp::dataset {
+    namespace {
+        size_t resolveWorkers(size_t requested) {
+            if (requested != 0) return requested;
+            return max<size_t>(1u, thread::hardware_concurrency());
+        }
+
+        template<typename Value>
+        void encodeValues(const vector<Value> &values, vector<uint8_t> &raw) {
+            raw.resize(values.size() * sizeof(Value));
+            for (size_t i = 0; i < values.size(); ++i) {
+                if constexpr (is_same_v<Value, uint64_t>) {
+                    detail::writeU64LE(raw.data() + (i * 8u), values[i]);
+                } else {
+                    detail::writeU32LE(raw.data() + (i * 4u), values[i]);
+                }
+            }
+        }
+
+        template<typename Value>
+        size_t encodeTruthBits(const vector<Value> &values, vector<uint8_t> &raw) {
+            raw.assign((values.size() + 7u) / 8u, 0u);
+            unordered_set<Value> seen;
+            seen.reserve(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (seen.insert(values[i]).second) {
+                    raw[i >> 3u] = static_cast<uint8_t>(raw[i >> 3u] | (1u << (i & 7u)));
+                }
+            }
+            return seen.size();
+        }
+    } // namespace
+
+    DatasetWriter::DatasetWriter(const filesystem::path &path, const DatasetInfo &info, DatasetWriterOptions options)
+        : path_(path), info_(info), options_(options), output_(path, ios::binary | ios::trunc) {
+        if (!output_) throw runtime_error("Cannot create binary dataset file");
+        if (info_.value_bits != 32u && info_.value_bits != 64u) {
+            throw invalid_argument("DatasetWriter: value_bits must be 32 or 64");
+        }
+        if (info_.distinct_per_partition > info_.elements_per_partition) {
+            throw invalid_argument("DatasetWriter: distinct exceeds nOfElements");
+        }
+        if (options_.compressionLevel < Z_NO_COMPRESSION || options_.compressionLevel > Z_BEST_COMPRESSION) {
+            throw invalid_argument("DatasetWriter: compression level must be in [0,9]");
+        }
+        options_.workers = resolveWorkers(options_.workers);
+
+        const uint64_t reserved = detail::HEADER_SIZE
+                                  + static_cast<uint64_t>(info_.partition_count) * detail::ENTRY_SIZE;
+        const vector<uint8_t> placeholder(detail::toSizeTChecked(reserved, "header+table"), 0u);
+        detail::writeExact(output_, placeholder.data(), placeholder.size(), "Cannot write binary dataset header");
+        nextOffset_ = reserved;
+        if (info_.value_bits == 64u) {
+            current64_.reserve(info_.elements_per_partition);
+        } else {
+            current32_.reserve(info_.elements_per_partition);
+        }
+        entries_.reserve(info_.partition_count);
+    }
+
+    DatasetWriter::~DatasetWriter() {
+        // close() was not reached: wait for the workers, the file stays incomplete.
+        for (auto &job : pending_) {
+            if (job.valid()) job.wait();
+        }
+    }
+
+    template<typename Value>
+    void DatasetWriter::appendValue(vector<Value> &current, const Value value) {
+        if (closed_ || submittedPartitions_ >= info_.partition_count) {
+            throw runtime_error("DatasetWriter: more values than declared partitions");
+        }
+        current.push_back(value);
+        if (current.size() == info_.elements_per_partition) {
+            submitPartition(current);
+        }
+    }
+
+    void DatasetWriter::append(uint32_t value) {
+        if (info_.value_bits == 64u) {
+            appendValue(current64_, static_cast<uint64_t>(value));
+            return;
+        }
+        appendValue(current32_, value);
+    }
+
+    void DatasetWriter::append(uint64_t value) {
+        if (info_.value_bits == 64u) {
+            appendValue(current64_, value);
+            return;
+        }
+        if (value > numeric_limits<uint32_t>::max()) {
+            throw invalid_argument("DatasetWriter: 64-bit value in a 32-bit dataset");
+        }
+        appendValue(current32_, static_cast<uint32_t>(value));
+    }
+
+    void DatasetWriter::append(span<const uint32_t> values) {
+        for (const uint32_t value : values) {
+            append(value);
+        }
+    }
+
+    void DatasetWriter::append(span<const uint64_t> values) {
+        for (const uint64_t value : values) {
+            append(value);
+        }
+    }
+
+    void DatasetWriter::submitCurrentPartition() {
+        if (info_.value_bits == 64u) {
+            submitPartition(current64_);
+        } else {
+            submitPartition(current32_);
+        }
+    }
+
+    template<typename Value>
+    void DatasetWriter::submitPartition(vector<Value> &current) {
+        while (pending_.size() >= options_.workers) {
+            writeOldestPending();
+        }
+
+        const int level = options_.compressionLevel;
+        pending_.push_back(async(launch::async, [values = move(current), level]() {
+            EncodedPartition encoded;
+            encoded.elements = values.size();
+            vector<uint8_t> raw;
+            encodeValues(values, raw);
+            detail::compressZlibBlock(raw, level, encoded.values, "Cannot compress binary dataset partition");
+            encoded.distinct = encodeTruthBits(values, raw);
+            detail::compressZlibBlock(raw, level, encoded.truth, "Cannot compress binary dataset truth");
+            return encoded;
+        }));
+        ++submittedPartitions_;
+
+        current = vector<Value>();
+        current.reserve(info_.elements_per_partition);
+    }
+
+    void DatasetWriter::writeOldestPending() {
+        EncodedPartition encoded = pending_.front().get();
+        pending_.pop_front();
+
+        if (info_.distinct_per_partition == 0 && encoded.elements > 0) {
+            info_.distinct_per_partition = encoded.distinct;
+        }
+        if (encoded.distinct != info_.distinct_per_partition) {
+            throw runtime_error("DatasetWriter: partition distinct count mismatch");
+        }
+
+        PartitionEntry entry;
+        entry.values_offset = nextOffset_;
+        entry.values_byte_size = encoded.values.size();
+        detail::writeExact(output_, encoded.values.data(), encoded.values.size(),
+                           "Cannot write binary dataset partition payload");
+        nextOffset_ += entry.values_byte_size;
+
+        entry.truth_offset = nextOffset_;
+        entry.truth_byte_size = encoded.truth.size();
+        detail::writeExact(output_, encoded.truth.data(), encoded.truth.size(),
+                           "Cannot write binary dataset truth payload");
+        nextOffset_ += entry.truth_byte_size;
+
+        entry.elements = encoded.elements;
+        entry.distinct = encoded.distinct;
+        entry.values_encoding = (info_.value_bits == 64u)
+                                    ? detail::ENCODING_ZLIB_U64_LE
+                                    : detail::ENCODING_ZLIB_U32_LE;
+        entry.truth_encoding = detail::ENCODING_ZLIB_BITSET_LE;
+        entries_.push_back(entry);
+    }
+
+    void DatasetWriter::writeHeaderAndTable() {
+        array<uint8_t, detail::HEADER_SIZE> header{};
+        copy(detail::MAGIC.begin(), detail::MAGIC.end(), reinterpret_cast<char *>(header.data()));
+        detail::writeU32LE(header.data() + 8u, (info_.value_bits == 64u) ? detail::VERSION_U64 : detail::VERSION);
+        detail::writeU64LE(header.data() + 12u, info_.elements_per_partition);
+        detail::writeU64LE(header.data() + 20u, info_.distinct_per_partition);
+        detail::writeU64LE(header.data() + 28u, info_.partition_count);
+        detail::writeU64LE(header.data() + 36u, info_.seed);
+
+        output_.seekp(0, ios::beg);
+        detail::writeExact(output_, header.data(), header.size(), "Cannot write binary dataset header");
+
+        for (const auto &entry : entries_) {
+            array<uint8_t, detail::ENTRY_SIZE> rawEntry{};
+            detail::writeU64LE(rawEntry.data(), entry.values_offset);
+            detail::writeU64LE(rawEntry.data() + 8u, entry.values_byte_size);
+            detail::writeU64LE(rawEntry.data() + 16u, entry.truth_offset);
+            detail::writeU64LE(rawEntry.data() + 24u, entry.truth_byte_size);
+            detail::writeU64LE(rawEntry.data() + 32u, entry.elements);
+            detail::writeU64LE(rawEntry.data() + 40u, entry.distinct);
+            detail::writeU32LE(rawEntry.data() + 48u, entry.values_encoding);
+            detail::writeU32LE(rawEntry.data() + 52u, entry.truth_encoding);
+            detail::writeU32LE(rawEntry.data() + 56u, entry.reserved);
+            detail::writeExact(output_, rawEntry.data(), rawEntry.size(), "Cannot write binary partition table entry");
+        }
+    }
+
+    void DatasetWriter::close() {
+        if (closed_) return;
+
+        if (info_.elements_per_partition == 0) {
+            while (submittedPartitions_ < info_.partition_count) {
+                submitCurrentPartition();
+            }
+        }
+        if (!current32_.empty() || !current64_.empty() || submittedPartitions_ != info_.partition_count) {
+            throw runtime_error("DatasetWriter: incomplete dataset, missing partition values");
+        }
+
+        while (!pending_.empty()) {
+            writeOldestPending();
+        }
+        writeHeaderAndTable();
+        output_.flush();
+        if (!output_) throw runtime_error("Cannot flush binary dataset file");
+        output_.close();
+        closed_ = true;
+    }
+} // namespace satp::dataset
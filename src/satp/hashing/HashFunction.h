@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
 using namespace std;
 
@@ -16,6 +18,14 @@ namespace satp::hashing {
             return static_cast<uint32_t>(hash64(value) >> 32u);
         }
 
+        // Arbitrary-length keys (64-bit IDs, strings). Implementations run the full
+        // byte-oriented algorithm; hash64(v) is the fixed 8-byte fast path.
+        [[nodiscard]] virtual uint64_t hashBytes64(span<const byte> bytes) const = 0;
+
+        [[nodiscard]] virtual uint32_t hashBytes32(const span<const byte> bytes) const {
+            return static_cast<uint32_t>(hashBytes64(bytes) >> 32u);
+        }
+
         [[nodiscard]] virtual const char *name() const = 0;
     };
 } // namespace satp::hashing
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+namespace satp::hashing::detail {
+    // Little-endian loads used by the byte-oriented hash implementations.
+    [[nodiscard]] inline uint64_t readU64LE(const byte *bytes) noexcept {
+        uint64_t value = 0;
+        memcpy(&value, bytes, sizeof(value));
+        if constexpr (endian::native == endian::big) {
+            value = byteswap(value);
+        }
+        return value;
+    }
+
+    [[nodiscard]] inline uint32_t readU32LE(const byte *bytes) noexcept {
+        uint32_t value = 0;
+        memcpy(&value, bytes, sizeof(value));
+        if constexpr (endian::native == endian::big) {
+            value = byteswap(value);
+        }
+        return value;
+    }
+
+    // Reads the last `count` (<= 8) bytes of a key as a zero-padded little-endian lane.
+    [[nodiscard]] inline uint64_t readTailLE(const byte *bytes, const size_t count) noexcept {
+        uint64_t value = 0;
+        for (size_t i = 0; i < count; ++i) {
+            value |= static_cast<uint64_t>(to_integer<uint8_t>(bytes[i])) << (8u * i);
+        }
+        return value;
+    }
+} // namespace satp::hashing::detail
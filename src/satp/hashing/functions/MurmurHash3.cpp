@@ -1,11 +1,17 @@
 #include "satp/hashing/functions/MurmurHash3.h"
 
+#include <algorithm>
 #include <bit>
 
+#include "satp/hashing/detail/ByteReads.h"
+
 using namespace std;
 
 namespace satp::hashing::functions {
     namespace {
+        constexpr uint64_t C1 = 0x87c37b91114253d5ULL;
+        constexpr uint64_t C2 = 0x4cf5ad432745937fULL;
+
         [[nodiscard]] uint64_t fmix64(uint64_t value) {
             value ^= value >> 33u;
             value *= 0xff51afd7ed558ccdULL;
@@ -14,21 +20,28 @@ namespace satp::hashing::functions {
             value ^= value >> 33u;
             return value;
         }
+
+        [[nodiscard]] uint64_t mixK1(uint64_t k1) {
+            k1 *= C1;
+            k1 = rotl(k1, 31);
+            k1 *= C2;
+            return k1;
+        }
+
+        [[nodiscard]] uint64_t mixK2(uint64_t k2) {
+            k2 *= C2;
+            k2 = rotl(k2, 33);
+            k2 *= C1;
+            return k2;
+        }
     } // namespace
 
     uint64_t MurmurHash3::hash64(const uint64_t value) const {
         // MurmurHash3_x64_128 reduced to one 64-bit block (len = 8), returns h1.
-        constexpr uint64_t C1 = 0x87c37b91114253d5ULL;
-        constexpr uint64_t C2 = 0x4cf5ad432745937fULL;
-
         uint64_t h1 = seed_;
         uint64_t h2 = seed_;
 
-        uint64_t k1 = value;
-        k1 *= C1;
-        k1 = rotl(k1, 31);
-        k1 *= C2;
-        h1 ^= k1;
+        h1 ^= mixK1(value);
 
         h1 = rotl(h1, 27);
         h1 += h2;
@@ -47,5 +60,46 @@ namespace satp::hashing::functions {
         h1 += h2;
         return h1;
     }
-} // namespace satp::hashing::functions
 
+    uint64_t MurmurHash3::hashBytes64(const span<const byte> bytes) const {
+        // Reference MurmurHash3_x64_128 over the whole key, returns h1.
+        uint64_t h1 = seed_;
+        uint64_t h2 = seed_;
+
+        const size_t blocks = bytes.size() / 16u;
+        for (size_t i = 0; i < blocks; ++i) {
+            const byte *block = bytes.data() + (i * 16u);
+            h1 ^= mixK1(detail::readU64LE(block));
+            h1 = rotl(h1, 27);
+            h1 += h2;
+            h1 = h1 * 5ULL + 0x52dce729ULL;
+
+            h2 ^= mixK2(detail::readU64LE(block + 8));
+            h2 = rotl(h2, 31);
+            h2 += h1;
+            h2 = h2 * 5ULL + 0x38495ab5ULL;
+        }
+
+        const byte *tail = bytes.data() + (blocks * 16u);
+        const size_t tailBytes = bytes.size() & 15u;
+        if (tailBytes > 8u) {
+            h2 ^= mixK2(detail::readTailLE(tail + 8, tailBytes - 8u));
+        }
+        if (tailBytes != 0u) {
+            h1 ^= mixK1(detail::readTailLE(tail, min<size_t>(tailBytes, 8u)));
+        }
+
+        const auto len = static_cast<uint64_t>(bytes.size());
+        h1 ^= len;
+        h2 ^= len;
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = fmix64(h1);
+        h2 = fmix64(h2);
+
+        h1 += h2;
+        return h1;
+    }
+} // namespace satp::hashing::functions
@@ -15,6 +15,8 @@ namespace satp::hashing::functions {
 
         [[nodiscard]] uint64_t hash64(uint64_t value) const override;
 
+        [[nodiscard]] uint64_t hashBytes64(span<const byte> bytes) const override;
+
         [[nodiscard]] const char *name() const override {
             return "murmurhash3";
         }
@@ -2,6 +2,8 @@
 
 #include <bit>
 
+#include "satp/hashing/detail/ByteReads.h"
+
 using namespace std;
 
 namespace satp::hashing::functions {
@@ -28,6 +30,29 @@ namespace satp::hashing::functions {
             v1 ^= v2;
             v2 = rotl(v2, 32);
         }
+
+        void compressBlock(uint64_t &v0,
+                           uint64_t &v1,
+                           uint64_t &v2,
+                           uint64_t &v3,
+                           const uint64_t block) {
+            v3 ^= block;
+            sipRound(v0, v1, v2, v3);
+            sipRound(v0, v1, v2, v3);
+            v0 ^= block;
+        }
+
+        [[nodiscard]] uint64_t finalize(uint64_t v0,
+                                        uint64_t v1,
+                                        uint64_t v2,
+                                        uint64_t v3) {
+            v2 ^= 0xffULL;
+            sipRound(v0, v1, v2, v3);
+            sipRound(v0, v1, v2, v3);
+            sipRound(v0, v1, v2, v3);
+            sipRound(v0, v1, v2, v3);
+            return v0 ^ v1 ^ v2 ^ v3;
+        }
     } // namespace
 
     uint64_t SipHash24::hash64(const uint64_t value) const {
@@ -36,24 +61,30 @@ namespace satp::hashing::functions {
         uint64_t v2 = 0x6c7967656e657261ULL ^ k0_;
         uint64_t v3 = 0x7465646279746573ULL ^ k1_;
 
-        v3 ^= value;
-        sipRound(v0, v1, v2, v3);
-        sipRound(v0, v1, v2, v3);
-        v0 ^= value;
+        compressBlock(v0, v1, v2, v3, value);
 
         constexpr uint64_t lenBlock = (8ULL << 56u); // len = 8, no tail bytes
-        v3 ^= lenBlock;
-        sipRound(v0, v1, v2, v3);
-        sipRound(v0, v1, v2, v3);
-        v0 ^= lenBlock;
-
-        v2 ^= 0xffULL;
-        sipRound(v0, v1, v2, v3);
-        sipRound(v0, v1, v2, v3);
-        sipRound(v0, v1, v2, v3);
-        sipRound(v0, v1, v2, v3);
-
-        return v0 ^ v1 ^ v2 ^ v3;
+        compressBlock(v0, v1, v2, v3, lenBlock);
+
+        return finalize(v0, v1, v2, v3);
     }
-} // namespace satp::hashing::functions
 
+    uint64_t SipHash24::hashBytes64(const span<const byte> bytes) const {
+        uint64_t v0 = 0x736f6d6570736575ULL ^ k0_;
+        uint64_t v1 = 0x646f72616e646f6dULL ^ k1_;
+        uint64_t v2 = 0x6c7967656e657261ULL ^ k0_;
+        uint64_t v3 = 0x7465646279746573ULL ^ k1_;
+
+        const size_t fullBlocks = bytes.size() / 8u;
+        for (size_t i = 0; i < fullBlocks; ++i) {
+            compressBlock(v0, v1, v2, v3, detail::readU64LE(bytes.data() + (i * 8u)));
+        }
+
+        const size_t tailBytes = bytes.size() & 7u;
+        const uint64_t lastBlock = (static_cast<uint64_t>(bytes.size()) << 56u)
+                                   | detail::readTailLE(bytes.data() + (fullBlocks * 8u), tailBytes);
+        compressBlock(v0, v1, v2, v3, lastBlock);
+
+        return finalize(v0, v1, v2, v3);
+    }
+} // namespace satp::hashing::functions
@@ -1,5 +1,7 @@
 #include "satp/hashing/functions/SplitMix64.h"
 
+#include "satp/hashing/detail/ByteReads.h"
+
 using namespace std;
 
 namespace satp::hashing::functions {
@@ -9,5 +11,19 @@ namespace satp::hashing::functions {
         value = (value ^ (value >> 27u)) * 0x94D049BB133111EBULL;
         return value ^ (value >> 31u);
     }
-} // namespace satp::hashing::functions
 
+    uint64_t SplitMix64::hashBytes64(const span<const byte> bytes) const {
+        // SplitMix64 has no byte-oriented reference form: fold the key length and
+        // every zero-padded 8-byte lane through the finalizer.
+        uint64_t state = hash64(static_cast<uint64_t>(bytes.size()));
+        const size_t fullLanes = bytes.size() / 8u;
+        for (size_t i = 0; i < fullLanes; ++i) {
+            state = hash64(state ^ detail::readU64LE(bytes.data() + (i * 8u)));
+        }
+        const size_t tailBytes = bytes.size() & 7u;
+        if (tailBytes != 0u) {
+            state = hash64(state ^ detail::readTailLE(bytes.data() + (fullLanes * 8u), tailBytes));
+        }
+        return state;
+    }
+} // namespace satp::hashing::functions
@@ -11,6 +11,8 @@ namespace satp::hashing::functions {
     public:
         [[nodiscard]] uint64_t hash64(uint64_t value) const override;
 
+        [[nodiscard]] uint64_t hashBytes64(span<const byte> bytes) const override;
+
         [[nodiscard]] const char *name() const override {
             return "splitmix64";
         }
@@ -2,6 +2,8 @@
 
 #include <bit>
 
+#include "satp/hashing/detail/ByteReads.h"
+
 using namespace std;
 
 namespace satp::hashing::functions {
@@ -11,6 +13,27 @@ namespace satp::hashing::functions {
         constexpr uint64_t PRIME64_3 = 1609587929392839161ULL;
         constexpr uint64_t PRIME64_4 = 9650029242287828579ULL;
         constexpr uint64_t PRIME64_5 = 2870177450012600261ULL;
+
+        [[nodiscard]] uint64_t round(uint64_t acc, const uint64_t input) {
+            acc += input * PRIME64_2;
+            acc = rotl(acc, 31);
+            acc *= PRIME64_1;
+            return acc;
+        }
+
+        [[nodiscard]] uint64_t mergeRound(uint64_t acc, const uint64_t value) {
+            acc ^= round(0u, value);
+            return acc * PRIME64_1 + PRIME64_4;
+        }
+
+        [[nodiscard]] uint64_t avalanche(uint64_t h64) {
+            h64 ^= h64 >> 33u;
+            h64 *= PRIME64_2;
+            h64 ^= h64 >> 29u;
+            h64 *= PRIME64_3;
+            h64 ^= h64 >> 32u;
+            return h64;
+        }
     } // namespace
 
     uint64_t XXHash64::hash64(const uint64_t value) const {
@@ -26,13 +49,55 @@ namespace satp::hashing::functions {
         h64 = rotl(h64, 27);
         h64 = h64 * PRIME64_1 + PRIME64_4;
 
-        h64 ^= h64 >> 33u;
-        h64 *= PRIME64_2;
-        h64 ^= h64 >> 29u;
-        h64 *= PRIME64_3;
-        h64 ^= h64 >> 32u;
+        return avalanche(h64);
+    }
+
+    uint64_t XXHash64::hashBytes64(const span<const byte> bytes) const {
+        const byte *cursor = bytes.data();
+        const byte *const end = cursor + bytes.size();
+        uint64_t h64 = 0;
 
-        return h64;
+        if (bytes.size() >= 32u) {
+            uint64_t v1 = seed_ + PRIME64_1 + PRIME64_2;
+            uint64_t v2 = seed_ + PRIME64_2;
+            uint64_t v3 = seed_;
+            uint64_t v4 = seed_ - PRIME64_1;
+            const byte *const limit = end - 32;
+            do {
+                v1 = round(v1, detail::readU64LE(cursor));
+                v2 = round(v2, detail::readU64LE(cursor + 8));
+                v3 = round(v3, detail::readU64LE(cursor + 16));
+                v4 = round(v4, detail::readU64LE(cursor + 24));
+                cursor += 32;
+            } while (cursor <= limit);
+
+            h64 = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            h64 = mergeRound(h64, v1);
+            h64 = mergeRound(h64, v2);
+            h64 = mergeRound(h64, v3);
+            h64 = mergeRound(h64, v4);
+        } else {
+            h64 = seed_ + PRIME64_5;
+        }
+
+        h64 += static_cast<uint64_t>(bytes.size());
+
+        while (end - cursor >= 8) {
+            h64 ^= round(0u, detail::readU64LE(cursor));
+            h64 = rotl(h64, 27) * PRIME64_1 + PRIME64_4;
+            cursor += 8;
+        }
+        if (end - cursor >= 4) {
+            h64 ^= static_cast<uint64_t>(detail::readU32LE(cursor)) * PRIME64_1;
+            h64 = rotl(h64, 23) * PRIME64_2 + PRIME64_3;
+            cursor += 4;
+        }
+        while (cursor < end) {
+            h64 ^= static_cast<uint64_t>(to_integer<uint8_t>(*cursor)) * PRIME64_5;
+            h64 = rotl(h64, 11) * PRIME64_1;
+            ++cursor;
+        }
+
+        return avalanche(h64);
     }
 } // namespace satp::hashing::functions
-
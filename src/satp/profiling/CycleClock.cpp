@@ -0,0 +1,45 @@
+#include "satp/profiling/CycleClock.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace satp::profiling {
+    namespace {
+        constexpr chrono::milliseconds CALIBRATION_WINDOW{10};
+        constexpr int OVERHEAD_SAMPLES = 1000;
+
+        [[nodiscard]] double calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+            const auto wallStart = chrono::steady_clock::now();
+            const uint64_t tickStart = CycleClock::now();
+            auto wallEnd = wallStart;
+            while (wallEnd - wallStart < CALIBRATION_WINDOW) wallEnd = chrono::steady_clock::now();
+            const uint64_t tickEnd = CycleClock::now();
+            if (tickEnd <= tickStart) return 1.0;
+            const auto nanoseconds = chrono::duration_cast<chrono::nanoseconds>(wallEnd - wallStart).count();
+            return static_cast<double>(nanoseconds) / static_cast<double>(tickEnd - tickStart);
+#else
+            return 1.0; // now() e' gia' in nanosecondi
+#endif
+        }
+    } // namespace
+
+    double CycleClock::nanosecondsPerTick() {
+        static const double value = calibrate();
+        return value;
+    }
+
+    uint64_t CycleClock::overheadTicks() {
+        static const uint64_t value = [] {
+            uint64_t best = numeric_limits<uint64_t>::max();
+            for (int i = 0; i < OVERHEAD_SAMPLES; ++i) {
+                const uint64_t start = now();
+                best = min(best, now() - start);
+            }
+            return best;
+        }();
+        return value;
+    }
+} // namespace satp::profiling
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+namespace satp::profiling {
+    /**
+     * @brief Contatore a basso costo per misurare singole chiamate.
+     *
+     * Su x86 legge il TSC (invariante sui processori recenti: avanza a
+     * frequenza costante, indipendente dal clock del core); altrove ripiega
+     * su steady_clock in nanosecondi. I tick si convertono in nanosecondi con
+     * nanosecondsPerTick().
+     */
+    class CycleClock {
+    public:
+        [[nodiscard]] static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_lfence(); // rdtsc non attende le istruzioni precedenti
+            return __rdtsc();
+#else
+            return static_cast<uint64_t>(
+                chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        // Calibrato contro steady_clock alla prima chiamata (circa 10 ms).
+        [[nodiscard]] static double nanosecondsPerTick();
+
+        // Minimo di due letture consecutive, in tick: il rumore di fondo di
+        // ogni misura.
+        [[nodiscard]] static uint64_t overheadTicks();
+    };
+} // namespace satp::profiling
@@ -0,0 +1,41 @@
+#include "satp/profiling/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace satp::profiling {
+    void LatencyHistogram::merge(const LatencyHistogram &other) noexcept {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void LatencyHistogram::reset() noexcept {
+        counts_.fill(0u);
+        count_ = 0;
+        sum_ = 0;
+        min_ = numeric_limits<uint64_t>::max();
+        max_ = 0;
+    }
+
+    double LatencyHistogram::mean() const noexcept {
+        return (count_ != 0u) ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+    }
+
+    uint64_t LatencyHistogram::valueAtQuantile(const double q) const {
+        if (!(q >= 0.0 && q <= 1.0)) throw invalid_argument("Quantile di latenza fuori da [0, 1]");
+        if (count_ == 0u) return 0u;
+        const auto rank = std::max<uint64_t>(1u, static_cast<uint64_t>(ceil(q * static_cast<double>(count_))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(highestEquivalentValue(i), max_);
+        }
+        return max_;
+    }
+} // namespace satp::profiling
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+namespace satp::profiling {
+    /**
+     * @brief Istogramma di latenze a bucket logaritmici, nello stile di HdrHistogram.
+     *
+     * I valori sotto 2 * SUB_BUCKETS hanno un bucket ciascuno; oltre, ogni
+     * potenza di due e' divisa in SUB_BUCKETS bucket lineari, quindi un
+     * quantile e' riportato con errore relativo al piu' 1 / SUB_BUCKETS
+     * (~3%). La tabella ha dimensione fissa: record() non alloca e costa un
+     * bit_width e un incremento.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr unsigned SUB_BUCKET_BITS = 5;
+        static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+        static constexpr size_t BUCKET_COUNT = (2u * SUB_BUCKETS) + ((63u - SUB_BUCKET_BITS) * SUB_BUCKETS);
+
+        void record(const uint64_t value) noexcept {
+            ++counts_[bucketIndex(value)];
+            ++count_;
+            sum_ += value;
+            if (value < min_) min_ = value;
+            if (value > max_) max_ = value;
+        }
+
+        void merge(const LatencyHistogram &other) noexcept;
+        void reset() noexcept;
+
+        [[nodiscard]] uint64_t count() const noexcept { return count_; }
+        [[nodiscard]] uint64_t min() const noexcept { return (count_ != 0u) ? min_ : 0u; }
+        [[nodiscard]] uint64_t max() const noexcept { return max_; }
+        [[nodiscard]] double mean() const noexcept;
+
+        // Valore piu' alto del bucket che contiene il quantile q in [0, 1]
+        // (mai oltre max()); 0 se l'istogramma e' vuoto.
+        [[nodiscard]] uint64_t valueAtQuantile(double q) const;
+
+        [[nodiscard]] static constexpr size_t bucketIndex(const uint64_t value) noexcept {
+            if (value < 2u * SUB_BUCKETS) return static_cast<size_t>(value);
+            const auto exponent = static_cast<unsigned>(bit_width(value)) - 1u;
+            const unsigned shift = exponent - SUB_BUCKET_BITS;
+            return (2u * SUB_BUCKETS) + ((exponent - SUB_BUCKET_BITS - 1u) * SUB_BUCKETS)
+                   + static_cast<size_t>((value >> shift) - SUB_BUCKETS);
+        }
+
+        [[nodiscard]] static constexpr uint64_t highestEquivalentValue(const size_t index) noexcept {
+            if (index < 2u * SUB_BUCKETS) return index;
+            const size_t offset = index - (2u * SUB_BUCKETS);
+            const auto shift = static_cast<unsigned>(offset / SUB_BUCKETS) + 1u;
+            const uint64_t lowest = static_cast<uint64_t>(SUB_BUCKETS + (offset % SUB_BUCKETS)) << shift;
+            return lowest + ((uint64_t{1} << shift) - 1u);
+        }
+
+    private:
+        array<uint64_t, BUCKET_COUNT> counts_{};
+        uint64_t count_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t min_ = numeric_limits<uint64_t>::max();
+        uint64_t max_ = 0;
+    };
+} // namespace satp::profiling
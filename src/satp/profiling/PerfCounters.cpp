@@ -0,0 +1,104 @@
+#include "satp/profiling/PerfCounters.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace satp::profiling {
+#if defined(__linux__)
+    namespace {
+        struct CounterConfig {
+            uint32_t type;
+            uint64_t config;
+        };
+
+        [[nodiscard]] CounterConfig configFor(const HardwareCounter counter) noexcept {
+            switch (counter) {
+                case HardwareCounter::Cycles:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+                case HardwareCounter::Instructions:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+                case HardwareCounter::L1dMisses:
+                    return {PERF_TYPE_HW_CACHE,
+                            PERF_COUNT_HW_CACHE_L1D
+                            | (PERF_COUNT_HW_CACHE_OP_READ << 8u)
+                            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16u)};
+                case HardwareCounter::LlcMisses:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+                case HardwareCounter::BranchMisses:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+            }
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+        }
+
+        [[nodiscard]] int openCounter(const HardwareCounter counter) noexcept {
+            const CounterConfig config = configFor(counter);
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = config.type;
+            attr.config = config.config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            // pid 0, cpu -1: il thread chiamante su qualunque CPU.
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    } // namespace
+
+    PerfCounters::PerfCounters() noexcept {
+        for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i) {
+            fds_[i] = openCounter(static_cast<HardwareCounter>(i));
+        }
+    }
+
+    PerfCounters::~PerfCounters() {
+        for (const int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    CounterValues PerfCounters::read() const noexcept {
+        CounterValues out;
+        for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i) {
+            if (fds_[i] < 0) continue;
+            uint64_t sample[3] = {}; // valore, tempo abilitato, tempo in esecuzione
+            if (::read(fds_[i], sample, sizeof(sample)) != static_cast<ssize_t>(sizeof(sample))) continue;
+            uint64_t value = sample[0];
+            if (sample[2] != 0u && sample[2] < sample[1]) {
+                value = static_cast<uint64_t>(static_cast<double>(value) * static_cast<double>(sample[1])
+                                              / static_cast<double>(sample[2]));
+            }
+            out.counts[i] = value;
+            out.measured[i] = sample[2] != 0u;
+        }
+        return out;
+    }
+#else
+    PerfCounters::PerfCounters() noexcept {
+        fds_.fill(-1);
+    }
+
+    PerfCounters::~PerfCounters() = default;
+
+    CounterValues PerfCounters::read() const noexcept {
+        return {};
+    }
+#endif
+
+    bool PerfCounters::available() const noexcept {
+        for (const int fd : fds_) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    bool PerfCounters::available(const HardwareCounter counter) const noexcept {
+        return fds_[static_cast<size_t>(counter)] >= 0;
+    }
+} // namespace satp::profiling
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+namespace satp::profiling {
+    enum class HardwareCounter : uint8_t {
+        Cycles,
+        Instructions,
+        L1dMisses,   // miss in lettura della L1 dati
+        LlcMisses,   // miss dell'ultimo livello di cache
+        BranchMisses,
+    };
+
+    inline constexpr size_t HARDWARE_COUNTER_COUNT = 5;
+
+    [[nodiscard]] constexpr string_view counterName(const HardwareCounter counter) noexcept {
+        switch (counter) {
+            case HardwareCounter::Cycles: return "cycles";
+            case HardwareCounter::Instructions: return "instructions";
+            case HardwareCounter::L1dMisses: return "l1d_misses";
+            case HardwareCounter::LlcMisses: return "llc_misses";
+            case HardwareCounter::BranchMisses: return "branch_misses";
+        }
+        return "unknown";
+    }
+
+    // Conteggi per contatore; measured distingue lo zero misurato da un
+    // contatore che il kernel o la CPU non espongono.
+    struct CounterValues {
+        array<uint64_t, HARDWARE_COUNTER_COUNT> counts{};
+        array<bool, HARDWARE_COUNTER_COUNT> measured{};
+
+        [[nodiscard]] bool any() const noexcept {
+            for (const bool value : measured) {
+                if (value) return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool has(const HardwareCounter counter) const noexcept {
+            return measured[static_cast<size_t>(counter)];
+        }
+
+        [[nodiscard]] uint64_t get(const HardwareCounter counter) const noexcept {
+            return counts[static_cast<size_t>(counter)];
+        }
+
+        // Istruzioni per ciclo; 0 senza cicli e istruzioni misurati.
+        [[nodiscard]] double ipc() const noexcept {
+            if (!has(HardwareCounter::Cycles) || !has(HardwareCounter::Instructions)) return 0.0;
+            const uint64_t cycles = get(HardwareCounter::Cycles);
+            return (cycles != 0u) ? static_cast<double>(get(HardwareCounter::Instructions)) / static_cast<double>(cycles) : 0.0;
+        }
+
+        CounterValues &operator+=(const CounterValues &other) noexcept {
+            for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i) {
+                counts[i] += other.counts[i];
+                measured[i] = measured[i] || other.measured[i];
+            }
+            return *this;
+        }
+
+        // Differenza tra due letture cumulative; satura a zero, perche' la
+        // scalatura del multiplexing puo' far arretrare di poco una lettura.
+        [[nodiscard]] CounterValues operator-(const CounterValues &earlier) const noexcept {
+            CounterValues out;
+            for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i) {
+                out.counts[i] = (counts[i] > earlier.counts[i]) ? counts[i] - earlier.counts[i] : 0u;
+                out.measured[i] = measured[i];
+            }
+            return out;
+        }
+    };
+
+    /**
+     * @brief Contatori hardware del thread che costruisce l'oggetto (Linux perf_event_open).
+     *
+     * Ogni contatore e' aperto separatamente, in user space: quelli che il
+     * kernel rifiuta (perf_event_paranoid, VM senza PMU, altri sistemi
+     * operativi) restano chiusi e read() li riporta come non misurati. Se la
+     * PMU li multiplexa, i conteggi sono scalati sul tempo di attivita'.
+     * read() costa una syscall per contatore: va usato attorno a blocchi,
+     * come PhaseTimer.
+     */
+    class PerfCounters {
+    public:
+        PerfCounters() noexcept;
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        // true se almeno un contatore e' aperto.
+        [[nodiscard]] bool available() const noexcept;
+
+        [[nodiscard]] bool available(HardwareCounter counter) const noexcept;
+
+        // Conteggi cumulativi dall'apertura.
+        [[nodiscard]] CounterValues read() const noexcept;
+
+    private:
+        array<int, HARDWARE_COUNTER_COUNT> fds_;
+    };
+} // namespace satp::profiling
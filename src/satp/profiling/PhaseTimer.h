@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "satp/profiling/PerfCounters.h"
+#include "satp/profiling/TraceSink.h"
+
+using namespace std;
+
+namespace satp::profiling {
+    // Fasi in cui si divide il tempo di una valutazione.
+    enum class Phase : uint8_t {
+        Read,        // seek e lettura dei payload compressi dei valori
+        Inflate,     // inflate zlib e decodifica little-endian dei valori
+        TruthDecode, // lettura e inflate dei truth bit
+        Ingest,      // process() degli sketch
+        Merge,       // merge tra sketch
+        Estimate,    // count() e stimatori ai checkpoint
+        Output,      // CSV, trace, snapshot e stato di resume
+    };
+
+    inline constexpr size_t PHASE_COUNT = 7;
+
+    [[nodiscard]] constexpr string_view phaseName(const Phase phase) noexcept {
+        switch (phase) {
+            case Phase::Read: return "read";
+            case Phase::Inflate: return "inflate";
+            case Phase::TruthDecode: return "truth_decode";
+            case Phase::Ingest: return "ingest";
+            case Phase::Merge: return "merge";
+            case Phase::Estimate: return "estimate";
+            case Phase::Output: return "output";
+        }
+        return "unknown";
+    }
+
+    // Tempo, numero di misure e contatori hardware per fase. Non
+    // sincronizzato: un'istanza per thread, sommate a fine valutazione.
+    struct PhaseTimes {
+        array<uint64_t, PHASE_COUNT> nanoseconds{};
+        array<uint64_t, PHASE_COUNT> calls{};
+        array<CounterValues, PHASE_COUNT> hardware{};
+        // Contatori del thread proprietario letti da PhaseTimer; nullptr = solo
+        // tempi. Non e' sommato da operator+= e non va copiato fuori dal thread.
+        const PerfCounters *counters = nullptr;
+
+        void add(const Phase phase, const chrono::nanoseconds elapsed) noexcept {
+            const auto slot = static_cast<size_t>(phase);
+            nanoseconds[slot] += static_cast<uint64_t>(elapsed.count());
+            ++calls[slot];
+        }
+
+        void add(const Phase phase, const chrono::nanoseconds elapsed, const CounterValues &counted) noexcept {
+            add(phase, elapsed);
+            hardware[static_cast<size_t>(phase)] += counted;
+        }
+
+        [[nodiscard]] chrono::nanoseconds elapsed(const Phase phase) const noexcept {
+            return chrono::nanoseconds(static_cast<int64_t>(nanoseconds[static_cast<size_t>(phase)]));
+        }
+
+        [[nodiscard]] const CounterValues &counted(const Phase phase) const noexcept {
+            return hardware[static_cast<size_t>(phase)];
+        }
+
+        // Contatori correnti della sorgente, vuoti senza contatori.
+        [[nodiscard]] CounterValues sampleCounters() const noexcept {
+            return (counters != nullptr) ? counters->read() : CounterValues{};
+        }
+
+        // Somma dei contatori su tutte le fasi.
+        [[nodiscard]] CounterValues totalCounted() const noexcept {
+            CounterValues total;
+            for (const auto &values : hardware) total += values;
+            return total;
+        }
+
+        PhaseTimes &operator+=(const PhaseTimes &other) noexcept {
+            for (size_t i = 0; i < PHASE_COUNT; ++i) {
+                nanoseconds[i] += other.nanoseconds[i];
+                calls[i] += other.calls[i];
+                hardware[i] += other.hardware[i];
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Misura lo scope corrente e lo somma alla fase in `times`.
+     *
+     * Due letture di steady_clock (vDSO, decine di ns) per misura, piu' due
+     * letture dei contatori hardware se times->counters e' impostato: va messo
+     * attorno a blocchi (una partizione, un checkpoint), non al singolo
+     * elemento. Con TraceSink attivo la misura diventa anche uno span della
+     * timeline. Con times == nullptr e trace disattivato non legge l'orologio.
+     */
+    class PhaseTimer {
+    public:
+        PhaseTimer(PhaseTimes *times, const Phase phase) noexcept
+            : times_(times), phase_(phase), traced_(TraceSink::enabled()) {
+            if (times_ == nullptr && !traced_) return;
+            if (times_ != nullptr) startCounters_ = times_->sampleCounters();
+            start_ = chrono::steady_clock::now();
+        }
+
+        ~PhaseTimer() {
+            stop();
+        }
+
+        PhaseTimer(const PhaseTimer &) = delete;
+        PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+        // Chiude la misura prima della fine dello scope.
+        void stop() noexcept {
+            if (times_ == nullptr && !traced_) return;
+            const auto end = chrono::steady_clock::now();
+            if (times_ != nullptr) {
+                const auto elapsed = chrono::duration_cast<chrono::nanoseconds>(end - start_);
+                times_->add(phase_, elapsed, times_->sampleCounters() - startCounters_);
+                times_ = nullptr;
+            }
+            if (traced_) {
+                TraceSink::record(phaseName(phase_).data(), "phase", start_, end);
+                traced_ = false;
+            }
+        }
+
+    private:
+        PhaseTimes *times_;
+        Phase phase_;
+        bool traced_;
+        chrono::steady_clock::time_point start_{};
+        CounterValues startCounters_;
+    };
+} // namespace satp::profiling
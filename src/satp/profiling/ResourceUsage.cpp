@@ -0,0 +1,23 @@
+#include "satp/profiling/ResourceUsage.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace satp::profiling {
+    uint64_t peakRssBytes() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0 || usage.ru_maxrss < 0) return 0u;
+#if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss); // gia' in byte
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024u; // kilobyte su Linux
+#endif
+#else
+        return 0u;
+#endif
+    }
+} // namespace satp::profiling
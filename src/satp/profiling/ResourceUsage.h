@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+using namespace std;
+
+namespace satp::profiling {
+    // Picco del resident set size del processo dall'avvio (getrusage), in
+    // byte; 0 dove non e' disponibile. E' monotono: letto a fine job include
+    // i job precedenti dello stesso processo.
+    [[nodiscard]] uint64_t peakRssBytes() noexcept;
+} // namespace satp::profiling
@@ -0,0 +1,128 @@
+#include "satp/profiling/TraceSink.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace satp::profiling {
+    namespace {
+        struct TraceEvent {
+            const char *name;
+            const char *category;
+            int64_t beginNs; // steady_clock assoluto
+            int64_t durationNs;
+        };
+
+        struct ThreadBuffer {
+            uint32_t tid = 0;
+            vector<TraceEvent> events;
+        };
+
+        // Il registro tiene vivi i buffer dei thread terminati fino al
+        // prossimo start(): i worker di parallelFor escono prima di write().
+        struct Registry {
+            mutex lock;
+            vector<shared_ptr<ThreadBuffer>> buffers;
+            uint32_t nextTid = 1;
+            int64_t originNs = 0;
+        };
+
+        constexpr size_t BUFFER_RESERVE = 4096;
+
+        [[nodiscard]] Registry &registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        [[nodiscard]] int64_t steadyNs(const chrono::steady_clock::time_point point) noexcept {
+            return chrono::duration_cast<chrono::nanoseconds>(point.time_since_epoch()).count();
+        }
+
+        [[nodiscard]] ThreadBuffer &localBuffer() {
+            thread_local shared_ptr<ThreadBuffer> buffer;
+            if (buffer == nullptr) {
+                auto created = make_shared<ThreadBuffer>();
+                created->events.reserve(BUFFER_RESERVE);
+                auto &shared = registry();
+                const lock_guard guard(shared.lock);
+                created->tid = shared.nextTid++;
+                shared.buffers.push_back(created);
+                buffer = std::move(created);
+            }
+            return *buffer;
+        }
+
+        void writeMicros(ofstream &out, const int64_t nanoseconds) {
+            out << nanoseconds / 1000 << '.' << setw(3) << setfill('0') << nanoseconds % 1000;
+        }
+    } // namespace
+
+    void TraceSink::start() {
+        auto &shared = registry();
+        {
+            const lock_guard guard(shared.lock);
+            erase_if(shared.buffers, [](const shared_ptr<ThreadBuffer> &buffer) {
+                return buffer.use_count() == 1; // thread terminato
+            });
+            for (const auto &buffer : shared.buffers) buffer->events.clear();
+            shared.originNs = steadyNs(chrono::steady_clock::now());
+        }
+        enabled_.store(true, memory_order_relaxed);
+    }
+
+    void TraceSink::stop() noexcept {
+        enabled_.store(false, memory_order_relaxed);
+    }
+
+    void TraceSink::record(const char *name,
+                           const char *category,
+                           const chrono::steady_clock::time_point begin,
+                           const chrono::steady_clock::time_point end) noexcept {
+        try {
+            localBuffer().events.push_back({name, category, steadyNs(begin), steadyNs(end) - steadyNs(begin)});
+        } catch (...) {
+            // Senza memoria lo span si perde: la timeline non deve interrompere la valutazione.
+        }
+    }
+
+    size_t TraceSink::eventCount() {
+        auto &shared = registry();
+        const lock_guard guard(shared.lock);
+        size_t total = 0;
+        for (const auto &buffer : shared.buffers) total += buffer->events.size();
+        return total;
+    }
+
+    void TraceSink::write(const filesystem::path &path) {
+        auto &shared = registry();
+        const lock_guard guard(shared.lock);
+
+        if (path.has_parent_path()) filesystem::create_directories(path.parent_path());
+        ofstream out(path, ios::trunc);
+        if (!out) throw runtime_error("Impossibile aprire il file di trace: " + path.string());
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+            << R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"satp"}})";
+        for (const auto &buffer : shared.buffers) {
+            out << ",\n" << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->tid
+                << R"(,"args":{"name":"thread )" << buffer->tid << "\"}}";
+            for (const auto &event : buffer->events) {
+                out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                    << R"(","ph":"X","pid":1,"tid":)" << buffer->tid << ",\"ts\":";
+                writeMicros(out, max<int64_t>(0, event.beginNs - shared.originNs));
+                out << ",\"dur\":";
+                writeMicros(out, event.durationNs);
+                out << '}';
+            }
+        }
+        out << "\n]}\n";
+        if (!out) throw runtime_error("Errore di scrittura del file di trace: " + path.string());
+    }
+} // namespace satp::profiling
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+
+using namespace std;
+
+namespace satp::profiling {
+    /**
+     * @brief Raccolta di span per una timeline in formato Chrome trace event.
+     *
+     * Ogni thread scrive in un proprio buffer (thread_local), senza lock: il
+     * registro dei buffer e' protetto da un mutex preso solo al primo span di
+     * ogni thread, da start() e da write(). Disattivata, uno span costa una
+     * load atomica rilassata.
+     *
+     * I nomi e le categorie degli span devono essere stringhe con durata
+     * statica (letterali): si conserva solo il puntatore.
+     */
+    class TraceSink {
+    public:
+        // Attiva la raccolta e scarta gli span precedenti. Da chiamare senza
+        // worker in esecuzione.
+        static void start();
+
+        // Disattiva la raccolta; gli span raccolti restano fino a start().
+        static void stop() noexcept;
+
+        [[nodiscard]] static bool enabled() noexcept {
+            return enabled_.load(memory_order_relaxed);
+        }
+
+        static void record(const char *name,
+                           const char *category,
+                           chrono::steady_clock::time_point begin,
+                           chrono::steady_clock::time_point end) noexcept;
+
+        // Span raccolti da tutti i thread dall'ultimo start().
+        [[nodiscard]] static size_t eventCount();
+
+        // Scrive gli span in JSON (traceEvents, eventi "X" in microsecondi
+        // da start()), leggibile da chrome://tracing e Perfetto. Da chiamare
+        // quando i worker che registrano span sono terminati.
+        static void write(const filesystem::path &path);
+
+    private:
+        static inline atomic<bool> enabled_{false};
+    };
+
+    // Span dello scope corrente, registrato alla distruzione o a stop().
+    class TraceSpan {
+    public:
+        TraceSpan(const char *name, const char *category) noexcept
+            : name_(TraceSink::enabled() ? name : nullptr), category_(category) {
+            if (name_ != nullptr) begin_ = chrono::steady_clock::now();
+        }
+
+        ~TraceSpan() {
+            stop();
+        }
+
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+
+        void stop() noexcept {
+            if (name_ == nullptr) return;
+            TraceSink::record(name_, category_, begin_, chrono::steady_clock::now());
+            name_ = nullptr;
+        }
+
+    private:
+        const char *name_;
+        const char *category_;
+        chrono::steady_clock::time_point begin_{};
+    };
+} // namespace satp::profiling
@@ -2,13 +2,22 @@
 
 // This module coordinates sketching experiments on binary datasets. It exposes
 // the evaluation framework, progress callbacks, streaming checkpoint planning,
-// experiment statistics, merge summaries, and CSV result writing.
+// experiment statistics, merge summaries, merge topologies, CSV result writing,
+// binary streaming traces, re-estimation from checkpoint snapshots,
+// register-level simulation of large cardinalities without data and per-call
+// latency histograms.
 
 #include "satp/simulation/detail/framework/EvaluationFramework.h"
 #include "satp/simulation/detail/framework/EvaluationMetadata.h"
 #include "satp/simulation/detail/framework/ProgressCallbacks.h"
+#include "satp/simulation/detail/latency/LatencyTypes.h"
 #include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
 #include "satp/simulation/detail/merge/MergeSummary.h"
+#include "satp/simulation/detail/merge/MergeTopologyTypes.h"
 #include "satp/simulation/detail/metrics/Statistics.h"
 #include "satp/simulation/detail/results/CsvResultWriter.h"
+#include "satp/simulation/detail/results/StreamingSnapshotFile.h"
+#include "satp/simulation/detail/results/StreamingTraceFile.h"
 #include "satp/simulation/detail/streaming/CheckpointPlanner.h"
+#include "satp/simulation/detail/streaming/RegisterSimulation.h"
+#include "satp/simulation/detail/streaming/SnapshotReestimation.h"
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <vector>
 
+#include "satp/simulation/detail/framework/EvaluationContext.h"
 #include "satp/simulation/detail/framework/ProgressCallbacks.h"
 
 using namespace std;
@@ -27,17 +30,58 @@ namespace satp::evaluation::detail {
         }
     }
 
-    template<typename Algo>
-    inline void processValues(Algo &algo,
-                              const vector<uint32_t> &values,
-                              const ProgressCallbacks *progress) {
+    // No per-value progress: callers publish the batch once it is ingested
+    // (see ProgressTracker).
+    template<typename Algo, typename Value>
+    inline void ingestValues(Algo &algo, const vector<Value> &values) {
         for (const auto value : values) {
             algo.process(value);
-            advanceProgress(progress);
         }
     }
 
-    inline void validateStreamingPartition(const vector<uint32_t> &values,
+    // Buffers of one worker evaluating partition pairs. The reader is opened
+    // lazily, on the thread that uses it.
+    template<typename Value>
+    struct PartitionPairWorkspace {
+        optional<dataset::PartitionReader> reader;
+        vector<Value> partA;
+        vector<Value> partB;
+        // Truth bit di partA/partB, riempiti solo da loadWithTruthBits.
+        vector<uint8_t> truthA;
+        vector<uint8_t> truthB;
+        profiling::PhaseTimes phases; // tempi del worker che possiede il workspace
+        // Contatori hardware aperti dal thread del worker al primo load.
+        unique_ptr<profiling::PerfCounters> counters;
+
+        void load(const EvaluationContext &context, const size_t idxA, const size_t idxB) {
+            prepareReader(context);
+            reader->load(idxA, partA);
+            reader->load(idxB, partB);
+        }
+
+        // Come load, con i truth bit: bastano a costruire i distinti esatti
+        // senza decodificare di nuovo le partizioni.
+        void loadWithTruthBits(const EvaluationContext &context, const size_t idxA, const size_t idxB) {
+            prepareReader(context);
+            reader->loadWithTruthBits(idxA, partA, truthA);
+            reader->loadWithTruthBits(idxB, partB, truthB);
+        }
+
+    private:
+        void prepareReader(const EvaluationContext &context) {
+            if (context.hardwareCounters && counters == nullptr) {
+                counters = make_unique<profiling::PerfCounters>();
+                phases.counters = counters.get();
+            }
+            if (!reader.has_value()) {
+                reader.emplace(context.binaryDataset);
+                reader->setPhaseTimes(&phases);
+            }
+        }
+    };
+
+    template<typename Value>
+    inline void validateStreamingPartition(const vector<Value> &values,
                                            const vector<uint8_t> &truthBits,
                                            const size_t sampleSize) {
         if (values.size() != sampleSize) {
@@ -48,6 +92,12 @@ namespace satp::evaluation::detail {
         }
     }
 
+    // Evaluators keep uint32_t partition buffers on v2 datasets and switch to
+    // uint64_t only for datasets that store 64-bit keys.
+    [[nodiscard]] inline bool hasWideKeys(const EvaluationContext &context) noexcept {
+        return context.binaryDataset.info.value_bits == 64u;
+    }
+
     [[nodiscard]] inline bool truthBitIsSet(const vector<uint8_t> &truthBits,
                                             const size_t index) noexcept {
         const uint8_t byte = truthBits[index >> 3u];
@@ -1,19 +1,49 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
 
 #include "satp/hashing/HashFunction.h"
 #include "satp/dataset/Dataset.h"
 #include "satp/simulation/detail/framework/EvaluationMetadata.h"
 #include "satp/simulation/detail/framework/ProgressCallbacks.h"
+#include "satp/simulation/detail/latency/LatencyTypes.h"
+#include "satp/simulation/detail/metrics/EvaluationDiagnostics.h"
+#include "satp/simulation/detail/metrics/EarlyStopping.h"
 
 using namespace std;
 
 namespace satp::evaluation::detail {
+    class ExactDistinctCache;
+
     struct EvaluationContext {
         const dataset::DatasetIndex &binaryDataset;
         const EvaluationMetadata &metadata;
         const hashing::HashFunction &hashFunction;
         const ProgressCallbacks *progress = nullptr;
+        // Shared ground-truth cache; nullptr = every exact union is recomputed.
+        ExactDistinctCache *exactDistinct = nullptr;
+        // Worker threads for evaluators that run pairs/partitions in parallel; 0 = hardware_concurrency.
+        size_t workers = 0;
+        // Massimo numero di checkpoint della modalita' streaming; >= sampleSize = ogni elemento.
+        size_t streamingCheckpoints = 0;
+        // Quantili dell'errore relativo per checkpoint (sketch KLL per accumulatore).
+        bool streamingErrorQuantiles = false;
+        // File di stato per riprendere la modalita' streaming; vuoto = nessun resume.
+        filesystem::path streamingResumeState;
+        // Intervallo minimo tra due salvataggi dello stato; l'ultimo run e' sempre salvato.
+        chrono::milliseconds streamingResumeInterval{0};
+        // Arresto anticipato della modalita' streaming sull'ultimo checkpoint.
+        EarlyStoppingOptions streamingEarlyStopping;
+        // File di snapshot dello stato degli sketch per checkpoint; vuoto = nessuno.
+        filesystem::path streamingSnapshotFile;
+        // Destinazione di allocazioni e tempi per fase della valutazione; nullptr = non riportati.
+        EvaluationDiagnostics *diagnostics = nullptr;
+        // Contatori hardware per fase, aperti da ogni thread che misura.
+        bool hardwareCounters = false;
+        // Batch e ritmo della modalita' latency.
+        LatencyOptions latency;
     };
 } // namespace satp::evaluation::detail
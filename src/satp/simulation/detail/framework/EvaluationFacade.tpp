@@ -18,6 +18,25 @@ namespace satp::evaluation {
         return modes::streaming::evaluate<Algo>(evaluationContext, std::forward<Args>(ctorArgs)...);
     }
 
+    template<typename Algo, typename... Args>
+    vector<EstimatorStreamingSeries> EvaluationFramework::evaluateStreamingEstimators(
+        const vector<const algorithms::CardinalityEstimator *> &estimators,
+        Args &&... ctorArgs) const {
+        const auto evaluationContext = context();
+        return modes::streaming::evaluateEstimators<Algo>(evaluationContext, estimators,
+                                                          std::forward<Args>(ctorArgs)...);
+    }
+
+    template<typename Algo, typename... Args>
+    vector<EstimatorStreamingSeries> EvaluationFramework::evaluateStreamingEstimators(
+        const vector<const algorithms::CardinalityEstimator *> &estimators,
+        const ProgressCallbacks &progress,
+        Args &&... ctorArgs) const {
+        const auto evaluationContext = context(&progress);
+        return modes::streaming::evaluateEstimators<Algo>(evaluationContext, estimators,
+                                                          std::forward<Args>(ctorArgs)...);
+    }
+
     template<typename Algo, typename... Args>
     vector<MergePairPoint> EvaluationFramework::evaluateMergePairs(Args &&... ctorArgs) const {
         const auto evaluationContext = context();
@@ -47,4 +66,49 @@ namespace satp::evaluation {
         const auto evaluationContext = context(&progress);
         return modes::merge_heterogeneous::evaluate<Algo>(evaluationContext, descriptor, buildAlgo);
     }
+
+    template<typename Algo, typename Builder>
+    vector<vector<HeterogeneousMergePoint>> EvaluationFramework::evaluateHeterogeneousMergeMatrix(
+        const vector<HeterogeneousMergeRunDescriptor> &cells,
+        Builder buildAlgo) const {
+        const auto evaluationContext = context();
+        return modes::merge_heterogeneous::evaluateMatrix<Algo>(evaluationContext, cells, buildAlgo);
+    }
+
+    template<typename Algo, typename Builder>
+    vector<vector<HeterogeneousMergePoint>> EvaluationFramework::evaluateHeterogeneousMergeMatrix(
+        const vector<HeterogeneousMergeRunDescriptor> &cells,
+        const ProgressCallbacks &progress,
+        Builder buildAlgo) const {
+        const auto evaluationContext = context(&progress);
+        return modes::merge_heterogeneous::evaluateMatrix<Algo>(evaluationContext, cells, buildAlgo);
+    }
+
+    template<typename Algo, typename... Args>
+    MergeTopologyResult EvaluationFramework::evaluateMergeTopology(const MergeTopologyOptions &options,
+                                                                   Args &&... ctorArgs) const {
+        const auto evaluationContext = context();
+        return modes::merge_topology::evaluate<Algo>(evaluationContext, options, std::forward<Args>(ctorArgs)...);
+    }
+
+    template<typename Algo, typename... Args>
+    MergeTopologyResult EvaluationFramework::evaluateMergeTopology(const MergeTopologyOptions &options,
+                                                                   const ProgressCallbacks &progress,
+                                                                   Args &&... ctorArgs) const {
+        const auto evaluationContext = context(&progress);
+        return modes::merge_topology::evaluate<Algo>(evaluationContext, options, std::forward<Args>(ctorArgs)...);
+    }
+
+    template<typename Algo, typename... Args>
+    LatencyResult EvaluationFramework::evaluateLatency(Args &&... ctorArgs) const {
+        const auto evaluationContext = context();
+        return modes::latency::evaluate<Algo>(evaluationContext, std::forward<Args>(ctorArgs)...);
+    }
+
+    template<typename Algo, typename... Args>
+    LatencyResult EvaluationFramework::evaluateLatency(const ProgressCallbacks &progress,
+                                                       Args &&... ctorArgs) const {
+        const auto evaluationContext = context(&progress);
+        return modes::latency::evaluate<Algo>(evaluationContext, std::forward<Args>(ctorArgs)...);
+    }
 } // namespace satp::evaluation
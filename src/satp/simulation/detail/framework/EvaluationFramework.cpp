@@ -1,5 +1,6 @@
 #include "satp/simulation/detail/framework/EvaluationFramework.h"
 
+#include <cmath>
 #include <stdexcept>
 #include <utility>
 
@@ -22,7 +23,8 @@ namespace satp::evaluation {
               binaryDataset.info.distinct_per_partition,
               binaryDataset.info.seed
           },
-          hashFunction(std::move(hashFunction)) {
+          hashFunction(std::move(hashFunction)),
+          exactDistinct_(make_unique<detail::ExactDistinctCache>()) {
         if (this->hashFunction == nullptr) {
             throw invalid_argument("EvaluationFramework requires a non-null hash function");
         }
@@ -32,12 +34,110 @@ namespace satp::evaluation {
         return metadata_;
     }
 
+    void EvaluationFramework::setWorkerCount(const size_t workers) noexcept {
+        workers_ = workers;
+    }
+
+    size_t EvaluationFramework::workerCount() const noexcept {
+        return workers_;
+    }
+
+    void EvaluationFramework::setStreamingCheckpoints(const size_t checkpoints) {
+        if (checkpoints == 0u) {
+            throw invalid_argument("EvaluationFramework requires at least one streaming checkpoint");
+        }
+        streamingCheckpoints_ = checkpoints;
+    }
+
+    size_t EvaluationFramework::streamingCheckpoints() const noexcept {
+        return streamingCheckpoints_;
+    }
+
+    void EvaluationFramework::setStreamingErrorQuantiles(const bool enabled) noexcept {
+        streamingErrorQuantiles_ = enabled;
+    }
+
+    bool EvaluationFramework::streamingErrorQuantiles() const noexcept {
+        return streamingErrorQuantiles_;
+    }
+
+    void EvaluationFramework::setStreamingResumeState(filesystem::path statePath,
+                                                      const chrono::milliseconds saveInterval) {
+        streamingResumeState_ = std::move(statePath);
+        streamingResumeInterval_ = saveInterval;
+    }
+
+    const filesystem::path &EvaluationFramework::streamingResumeState() const noexcept {
+        return streamingResumeState_;
+    }
+
+    void EvaluationFramework::setStreamingEarlyStopping(const EarlyStoppingOptions &options) {
+        if (!(options.targetWidth >= 0.0) || !isfinite(options.targetWidth)) {
+            throw invalid_argument("Early stopping target width must be finite and non-negative");
+        }
+        if (options.minRuns < 2u) {
+            throw invalid_argument("Early stopping requires at least two runs");
+        }
+        streamingEarlyStopping_ = options;
+    }
+
+    const EarlyStoppingOptions &EvaluationFramework::streamingEarlyStopping() const noexcept {
+        return streamingEarlyStopping_;
+    }
+
+    void EvaluationFramework::setStreamingSnapshotFile(filesystem::path snapshotPath) {
+        streamingSnapshotFile_ = std::move(snapshotPath);
+    }
+
+    const filesystem::path &EvaluationFramework::streamingSnapshotFile() const noexcept {
+        return streamingSnapshotFile_;
+    }
+
+    void EvaluationFramework::setHardwareCounters(const bool enabled) noexcept {
+        hardwareCounters_ = enabled;
+    }
+
+    bool EvaluationFramework::hardwareCounters() const noexcept {
+        return hardwareCounters_;
+    }
+
+    void EvaluationFramework::setLatencyOptions(const LatencyOptions &options) {
+        if (options.batch == 0u) {
+            throw invalid_argument("Latency batch must be at least one element");
+        }
+        if (!(options.targetRate >= 0.0) || !isfinite(options.targetRate)) {
+            throw invalid_argument("Latency target rate must be finite and non-negative");
+        }
+        latency_ = options;
+    }
+
+    const LatencyOptions &EvaluationFramework::latencyOptions() const noexcept {
+        return latency_;
+    }
+
+    const EvaluationDiagnostics &EvaluationFramework::lastDiagnostics() const noexcept {
+        return lastDiagnostics_;
+    }
+
+    // Ogni valutazione parte da diagnostica vuota e la riempie alla fine.
     detail::EvaluationContext EvaluationFramework::context(const ProgressCallbacks *progress) const {
+        lastDiagnostics_ = {};
         return {
             binaryDataset,
             metadata_,
             *hashFunction,
-            progress
+            progress,
+            exactDistinct_.get(),
+            workers_,
+            streamingCheckpoints_,
+            streamingErrorQuantiles_,
+            streamingResumeState_,
+            streamingResumeInterval_,
+            streamingEarlyStopping_,
+            streamingSnapshotFile_,
+            &lastDiagnostics_,
+            hardwareCounters_,
+            latency_
         };
     }
 } // namespace satp::evaluation
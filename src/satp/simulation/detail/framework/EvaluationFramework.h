@@ -1,24 +1,38 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "satp/algorithms/Estimators.h"
 #include "satp/hashing/HashFunction.h"
 #include "satp/dataset/Dataset.h"
 #include "satp/simulation/detail/framework/EvaluationContext.h"
 #include "satp/simulation/detail/framework/EvaluationMetadata.h"
+#include "satp/simulation/detail/framework/ExactDistinctCache.h"
 #include "satp/simulation/detail/framework/ProgressCallbacks.h"
+#include "satp/simulation/detail/latency/LatencyTypes.h"
 #include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
+#include "satp/simulation/detail/merge/MergeTopologyTypes.h"
+#include "satp/simulation/detail/metrics/EvaluationDiagnostics.h"
+#include "satp/simulation/detail/metrics/EarlyStopping.h"
 #include "satp/simulation/detail/metrics/Statistics.h"
 
 namespace satp::evaluation {
     namespace modes::streaming {
         template<typename Algo, typename... Args>
         vector<StreamingPointStats> evaluate(const detail::EvaluationContext &context, Args &&... ctorArgs);
+
+        template<typename Algo, typename... Args>
+        vector<EstimatorStreamingSeries> evaluateEstimators(
+            const detail::EvaluationContext &context,
+            const vector<const algorithms::CardinalityEstimator *> &estimators,
+            Args &&... ctorArgs);
     } // namespace modes::streaming
 
     namespace modes::merge {
@@ -31,11 +45,31 @@ namespace satp::evaluation {
         vector<HeterogeneousMergePoint> evaluate(const detail::EvaluationContext &context,
                                                  const HeterogeneousMergeRunDescriptor &descriptor,
                                                  Builder buildAlgo);
+
+        template<typename Algo, typename Builder>
+        vector<vector<HeterogeneousMergePoint>> evaluateMatrix(const detail::EvaluationContext &context,
+                                                               const vector<HeterogeneousMergeRunDescriptor> &cells,
+                                                               Builder buildAlgo);
     } // namespace modes::merge_heterogeneous
 
+    namespace modes::merge_topology {
+        template<typename Algo, typename... Args>
+        MergeTopologyResult evaluate(const detail::EvaluationContext &context,
+                                     const MergeTopologyOptions &options,
+                                     Args &&... ctorArgs);
+    } // namespace modes::merge_topology
+
+    namespace modes::latency {
+        template<typename Algo, typename... Args>
+        LatencyResult evaluate(const detail::EvaluationContext &context, Args &&... ctorArgs);
+    } // namespace modes::latency
+
     class EvaluationFramework {
     public:
         static constexpr size_t DEFAULT_STREAMING_CHECKPOINTS = 200u;
+        // Budget che traccia la stima dopo ogni elemento dello stream.
+        static constexpr size_t ALL_STREAMING_CHECKPOINTS = numeric_limits<size_t>::max();
+        static constexpr chrono::milliseconds DEFAULT_RESUME_SAVE_INTERVAL{30'000};
 
         explicit EvaluationFramework(
             const filesystem::path &filePath,
@@ -51,6 +85,21 @@ namespace satp::evaluation {
         [[nodiscard]] vector<StreamingPointStats> evaluateStreaming(const ProgressCallbacks &progress,
                                                                     Args &&... ctorArgs) const;
 
+        // Un solo sketch per run: a ogni checkpoint tutti gli `estimators`
+        // stimano la stessa registerView(). Una serie per stimatore, nello
+        // stesso ordine; resume, arresto anticipato e snapshot valgono come
+        // per evaluateStreaming (l'arresto attende tutti gli stimatori).
+        template<typename Algo, typename... Args>
+        [[nodiscard]] vector<EstimatorStreamingSeries> evaluateStreamingEstimators(
+            const vector<const algorithms::CardinalityEstimator *> &estimators,
+            Args &&... ctorArgs) const;
+
+        template<typename Algo, typename... Args>
+        [[nodiscard]] vector<EstimatorStreamingSeries> evaluateStreamingEstimators(
+            const vector<const algorithms::CardinalityEstimator *> &estimators,
+            const ProgressCallbacks &progress,
+            Args &&... ctorArgs) const;
+
         template<typename Algo, typename... Args>
         [[nodiscard]] vector<MergePairPoint> evaluateMergePairs(Args &&... ctorArgs) const;
 
@@ -69,20 +118,114 @@ namespace satp::evaluation {
             const ProgressCallbacks &progress,
             Builder buildAlgo) const;
 
+        // Una serie di punti per cella, nello stesso ordine di `cells`.
+        template<typename Algo, typename Builder>
+        [[nodiscard]] vector<vector<HeterogeneousMergePoint>> evaluateHeterogeneousMergeMatrix(
+            const vector<HeterogeneousMergeRunDescriptor> &cells,
+            Builder buildAlgo) const;
+
+        template<typename Algo, typename Builder>
+        [[nodiscard]] vector<vector<HeterogeneousMergePoint>> evaluateHeterogeneousMergeMatrix(
+            const vector<HeterogeneousMergeRunDescriptor> &cells,
+            const ProgressCallbacks &progress,
+            Builder buildAlgo) const;
+
+        template<typename Algo, typename... Args>
+        [[nodiscard]] MergeTopologyResult evaluateMergeTopology(const MergeTopologyOptions &options,
+                                                                Args &&... ctorArgs) const;
+
+        template<typename Algo, typename... Args>
+        [[nodiscard]] MergeTopologyResult evaluateMergeTopology(const MergeTopologyOptions &options,
+                                                                const ProgressCallbacks &progress,
+                                                                Args &&... ctorArgs) const;
+
+        // Latenza delle singole chiamate process()/count()/merge() in tutti i
+        // run, su un solo thread, con le opzioni di setLatencyOptions.
+        template<typename Algo, typename... Args>
+        [[nodiscard]] LatencyResult evaluateLatency(Args &&... ctorArgs) const;
+
+        template<typename Algo, typename... Args>
+        [[nodiscard]] LatencyResult evaluateLatency(const ProgressCallbacks &progress,
+                                                    Args &&... ctorArgs) const;
+
         [[nodiscard]] const EvaluationMetadata &metadata() const noexcept;
 
+        // Worker threads used by the merge evaluators; 0 = hardware_concurrency.
+        void setWorkerCount(size_t workers) noexcept;
+        [[nodiscard]] size_t workerCount() const noexcept;
+
+        // Budget di checkpoint per evaluateStreaming; 0 non e' ammesso.
+        void setStreamingCheckpoints(size_t checkpoints);
+        [[nodiscard]] size_t streamingCheckpoints() const noexcept;
+
+        // Aggiunge p50/p95/p99 dell'errore relativo ai punti di evaluateStreaming.
+        void setStreamingErrorQuantiles(bool enabled) noexcept;
+        [[nodiscard]] bool streamingErrorQuantiles() const noexcept;
+
+        // evaluateStreaming salva l'avanzamento in statePath al piu' ogni
+        // saveInterval e, se il file esiste, riprende dal primo run mancante.
+        // Un path vuoto disattiva il resume.
+        void setStreamingResumeState(filesystem::path statePath,
+                                     chrono::milliseconds saveInterval = DEFAULT_RESUME_SAVE_INTERVAL);
+        [[nodiscard]] const filesystem::path &streamingResumeState() const noexcept;
+
+        // evaluateStreaming si ferma prima di metadata().runs quando
+        // l'intervallo di confidenza della metrica scelta e' abbastanza stretto;
+        // i punti riportano i run effettivamente usati.
+        void setStreamingEarlyStopping(const EarlyStoppingOptions &options);
+        [[nodiscard]] const EarlyStoppingOptions &streamingEarlyStopping() const noexcept;
+
+        // evaluateStreaming scrive in snapshotPath lo stato dello sketch a ogni
+        // checkpoint di ogni run (solo algoritmi con saveState), da rileggere
+        // con reestimateStreaming. Un path vuoto disattiva gli snapshot.
+        void setStreamingSnapshotFile(filesystem::path snapshotPath);
+        [[nodiscard]] const filesystem::path &streamingSnapshotFile() const noexcept;
+
+        // Raccoglie anche i contatori hardware (cicli, istruzioni, miss di
+        // cache e branch) per fase in lastDiagnostics(); dove perf_event_open
+        // non e' disponibile i contatori restano non misurati.
+        void setHardwareCounters(bool enabled) noexcept;
+        [[nodiscard]] bool hardwareCounters() const noexcept;
+
+        // Elementi per misura di process() (batch >= 1) ed eventuale ritmo di
+        // replay in elementi/s (0 = a piena velocita') di evaluateLatency.
+        void setLatencyOptions(const LatencyOptions &options);
+        [[nodiscard]] const LatencyOptions &latencyOptions() const noexcept;
+
+        // Allocazioni su heap e tempi per fase dell'ultima evaluateStreaming/
+        // evaluateStreamingEstimators o evaluateMergePairs. Le allocazioni sono
+        // separate tra warm-up e run successivi e misurate solo con l'hook di
+        // AllocationCounter (allocationsTracked); i tempi sono sempre raccolti.
+        // Non va letta mentre un'altra valutazione e' in corso sullo stesso framework.
+        [[nodiscard]] const EvaluationDiagnostics &lastDiagnostics() const noexcept;
+
     private:
         [[nodiscard]] detail::EvaluationContext context(const ProgressCallbacks *progress = nullptr) const;
 
         dataset::DatasetIndex binaryDataset;
         EvaluationMetadata metadata_;
         unique_ptr<hashing::HashFunction> hashFunction;
+        // Sorted distinct arrays per partition, reused by every merge evaluation on this dataset.
+        unique_ptr<detail::ExactDistinctCache> exactDistinct_;
+        size_t workers_ = 0;
+        size_t streamingCheckpoints_ = DEFAULT_STREAMING_CHECKPOINTS;
+        bool streamingErrorQuantiles_ = false;
+        filesystem::path streamingResumeState_;
+        chrono::milliseconds streamingResumeInterval_ = DEFAULT_RESUME_SAVE_INTERVAL;
+        EarlyStoppingOptions streamingEarlyStopping_;
+        filesystem::path streamingSnapshotFile_;
+        bool hardwareCounters_ = false;
+        LatencyOptions latency_;
+        mutable EvaluationDiagnostics lastDiagnostics_;
     };
 } // namespace satp::evaluation
 
 #include "satp/simulation/detail/framework/EvaluationFacade.tpp"
+#include "satp/simulation/detail/latency/LatencyEvaluation.tpp"
 #include "satp/simulation/detail/merge/HeterogeneousMergeEvaluation.tpp"
+#include "satp/simulation/detail/merge/HeterogeneousMergeMatrixEvaluation.tpp"
 #include "satp/simulation/detail/merge/MergeEvaluation.tpp"
+#include "satp/simulation/detail/merge/TopologyMergeEvaluation.tpp"
 #include "satp/simulation/detail/streaming/StreamingEvaluation.tpp"
 
 using namespace std;
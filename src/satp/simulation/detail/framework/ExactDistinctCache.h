@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "satp/dataset/Dataset.h"
+#include "satp/simulation/detail/framework/DatasetTraversal.h"
+#include "satp/simulation/detail/framework/EvaluationContext.h"
+
+using namespace std;
+
+namespace satp::evaluation::detail {
+    // Exact ground truth for merge evaluations. For every partition it keeps the
+    // sorted array of its distinct values: the truth bits mark the first
+    // occurrence of each value, so filtering by them and sorting is enough, with
+    // no hashing. The arrays are cached per partition in LRU order under a byte
+    // budget, so a partition used by several pairs, runs or topologies is
+    // filtered and sorted once. Arrays are handed out as shared_ptr, so
+    // eviction never invalidates an array that is still in use.
+    class ExactDistinctCache {
+    public:
+        static constexpr size_t DEFAULT_BUDGET_BYTES = size_t{512} << 20u;
+
+        explicit ExactDistinctCache(const size_t budgetBytes = DEFAULT_BUDGET_BYTES)
+            : budgetBytes_(budgetBytes) {
+        }
+
+        template<typename Value>
+        [[nodiscard]] shared_ptr<const vector<Value>> sortedDistinct(const dataset::DatasetIndex &dataset,
+                                                                     const size_t partitionIndex) {
+            return sortedDistinctBuiltBy<Value>(partitionIndex, [&] {
+                dataset::PartitionReader reader(dataset);
+                vector<Value> values;
+                vector<uint8_t> truthBits;
+                reader.loadWithTruthBits(partitionIndex, values, truthBits);
+                return sortedOf(firstOccurrences(values, truthBits));
+            });
+        }
+
+        // Same array, built on a miss from a partition the caller has already
+        // decoded: the dataset is not read a second time.
+        template<typename Value>
+        [[nodiscard]] shared_ptr<const vector<Value>> sortedDistinct(const size_t partitionIndex,
+                                                                     const vector<Value> &values,
+                                                                     const vector<uint8_t> &truthBits) {
+            return sortedDistinctBuiltBy<Value>(partitionIndex, [&] {
+                return sortedOf(firstOccurrences(values, truthBits));
+            });
+        }
+
+        // Same array, built on a miss from firstOccurrences() of the partition.
+        template<typename Value>
+        [[nodiscard]] shared_ptr<const vector<Value>> sortedDistinct(const size_t partitionIndex,
+                                                                     vector<Value> &&distinctValues) {
+            return sortedDistinctBuiltBy<Value>(partitionIndex, [&] {
+                return sortedOf(std::move(distinctValues));
+            });
+        }
+
+        // Distinct values of a decoded partition in stream order, not yet sorted.
+        template<typename Value>
+        [[nodiscard]] static vector<Value> firstOccurrences(const vector<Value> &values,
+                                                            const vector<uint8_t> &truthBits) {
+            if (truthBits.size() != (values.size() + 7u) / 8u) {
+                throw runtime_error("Invalid binary dataset: truth bitset size mismatch");
+            }
+            // Sized exactly from the bit count: callers may hold many of these at once.
+            size_t count = 0;
+            for (size_t byte = 0; byte < truthBits.size(); ++byte) {
+                const size_t valid = min<size_t>(8u, values.size() - (byte * 8u));
+                count += static_cast<size_t>(popcount(static_cast<unsigned>(truthBits[byte] & ((1u << valid) - 1u))));
+            }
+            // One slot of slack: the branchless store writes before checking the bit.
+            vector<Value> distinct(min(count + 1u, values.size()));
+            size_t kept = 0;
+            for (size_t i = 0; i < values.size() && kept < distinct.size(); ++i) {
+                distinct[kept] = values[i];
+                kept += truthBitIsSet(truthBits, i) ? 1u : 0u;
+            }
+            distinct.resize(kept);
+            return distinct;
+        }
+
+        [[nodiscard]] size_t hits() const {
+            lock_guard lock(mutex_);
+            return hits_;
+        }
+
+        [[nodiscard]] size_t misses() const {
+            lock_guard lock(mutex_);
+            return misses_;
+        }
+
+        [[nodiscard]] size_t cachedBytes() const {
+            lock_guard lock(mutex_);
+            return cachedBytes_;
+        }
+
+    private:
+        struct Entry {
+            shared_ptr<const vector<uint32_t>> narrow;
+            shared_ptr<const vector<uint64_t>> wide;
+            size_t bytes = 0;
+            list<size_t>::iterator lruPosition;
+        };
+
+        template<typename Value, typename Build>
+        [[nodiscard]] shared_ptr<const vector<Value>> sortedDistinctBuiltBy(const size_t partitionIndex,
+                                                                            Build &&build) {
+            static_assert(is_same_v<Value, uint32_t> || is_same_v<Value, uint64_t>,
+                          "ExactDistinctCache supports uint32_t and uint64_t values");
+            {
+                lock_guard lock(mutex_);
+                if (auto cached = findLocked<Value>(partitionIndex)) {
+                    ++hits_;
+                    return cached;
+                }
+                ++misses_;
+            }
+
+            // Built outside the lock: workers missing on different partitions proceed in parallel.
+            auto built = make_shared<const vector<Value>>(build());
+
+            lock_guard lock(mutex_);
+            if (auto cached = findLocked<Value>(partitionIndex)) return cached;
+            insertLocked(partitionIndex, built);
+            return built;
+        }
+
+        template<typename Value>
+        [[nodiscard]] static vector<Value> sortedOf(vector<Value> values) {
+            ranges::sort(values);
+            values.shrink_to_fit();
+            return values;
+        }
+
+        template<typename Value>
+        [[nodiscard]] shared_ptr<const vector<Value>> findLocked(const size_t partitionIndex) {
+            const auto it = entries_.find(partitionIndex);
+            if (it == entries_.end()) return nullptr;
+            shared_ptr<const vector<Value>> cached;
+            if constexpr (is_same_v<Value, uint32_t>) {
+                cached = it->second.narrow;
+            } else {
+                cached = it->second.wide;
+            }
+            if (cached != nullptr) {
+                lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+            }
+            return cached;
+        }
+
+        template<typename Value>
+        void insertLocked(const size_t partitionIndex, const shared_ptr<const vector<Value>> &values) {
+            auto [it, inserted] = entries_.try_emplace(partitionIndex);
+            Entry &entry = it->second;
+            if (inserted) {
+                lru_.push_front(partitionIndex);
+                entry.lruPosition = lru_.begin();
+            } else {
+                lru_.splice(lru_.begin(), lru_, entry.lruPosition);
+            }
+            if constexpr (is_same_v<Value, uint32_t>) {
+                entry.narrow = values;
+            } else {
+                entry.wide = values;
+            }
+            const size_t bytes = values->size() * sizeof(Value);
+            entry.bytes += bytes;
+            cachedBytes_ += bytes;
+
+            // The most recent entry always stays, even when it alone exceeds the budget.
+            while (cachedBytes_ > budgetBytes_ && lru_.size() > 1u) {
+                const size_t victim = lru_.back();
+                lru_.pop_back();
+                const auto victimIt = entries_.find(victim);
+                cachedBytes_ -= victimIt->second.bytes;
+                entries_.erase(victimIt);
+            }
+        }
+
+        size_t budgetBytes_;
+        mutable mutex mutex_;
+        unordered_map<size_t, Entry> entries_;
+        list<size_t> lru_; // front = most recently used
+        size_t cachedBytes_ = 0;
+        size_t hits_ = 0;
+        size_t misses_ = 0;
+    };
+
+    // |A u B| = |A| + |B| - |A n B| on sorted distinct arrays. The merge step is
+    // branchless: both cursors advance through comparisons, not branches.
+    template<typename Value>
+    [[nodiscard]] size_t sortedUnionCardinality(const vector<Value> &a, const vector<Value> &b) {
+        size_t i = 0;
+        size_t j = 0;
+        size_t common = 0;
+        while (i < a.size() && j < b.size()) {
+            const Value x = a[i];
+            const Value y = b[j];
+            common += static_cast<size_t>(x == y);
+            i += static_cast<size_t>(x <= y);
+            j += static_cast<size_t>(y <= x);
+        }
+        return a.size() + b.size() - common;
+    }
+
+    // Exact union of the pair held by `workspace`, which must have been filled
+    // by loadWithTruthBits(context, partitionA, partitionB).
+    template<typename Value>
+    [[nodiscard]] double exactUnionCardinality(const EvaluationContext &context,
+                                               const PartitionPairWorkspace<Value> &workspace,
+                                               const size_t partitionA,
+                                               const size_t partitionB) {
+        ExactDistinctCache localCache;
+        ExactDistinctCache &cache = (context.exactDistinct != nullptr) ? *context.exactDistinct : localCache;
+        const auto distinctA = cache.sortedDistinct(partitionA, workspace.partA, workspace.truthA);
+        const auto distinctB = cache.sortedDistinct(partitionB, workspace.partB, workspace.truthB);
+        return static_cast<double>(sortedUnionCardinality(*distinctA, *distinctB));
+    }
+} // namespace satp::evaluation::detail
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace satp::evaluation::detail {
+    [[nodiscard]] inline size_t resolveWorkerCount(const size_t requested) {
+        if (requested != 0u) return requested;
+        return max<size_t>(1u, thread::hardware_concurrency());
+    }
+
+    // Runs fn(worker, item) for every item in [0, count) on up to `workers`
+    // threads (0 = hardware_concurrency). Items are handed out dynamically, so
+    // uneven work balances itself. `worker` is in [0, workers) and is stable
+    // for the calling thread, which lets callers keep per-worker buffers. The
+    // first exception stops the remaining items and is rethrown to the caller.
+    template<typename Fn>
+    void parallelFor(const size_t count, const size_t workers, Fn &&fn) {
+        const size_t threads = min(resolveWorkerCount(workers), count);
+        if (threads <= 1u) {
+            for (size_t item = 0; item < count; ++item) fn(size_t{0}, item);
+            return;
+        }
+
+        atomic<size_t> next{0};
+        mutex errorMutex;
+        exception_ptr firstError;
+        auto body = [&](const size_t worker) {
+            for (;;) {
+                const size_t item = next.fetch_add(1u, memory_order_relaxed);
+                if (item >= count) return;
+                try {
+                    fn(worker, item);
+                } catch (...) {
+                    lock_guard lock(errorMutex);
+                    if (!firstError) firstError = current_exception();
+                    next.store(count, memory_order_relaxed);
+                    return;
+                }
+            }
+        };
+
+        vector<thread> pool;
+        pool.reserve(threads - 1u);
+        for (size_t worker = 1; worker < threads; ++worker) {
+            pool.emplace_back(body, worker);
+        }
+        body(0u);
+        for (auto &thread : pool) thread.join();
+        if (firstError) rethrow_exception(firstError);
+    }
+} // namespace satp::evaluation::detail
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include "satp/simulation/detail/framework/DatasetTraversal.h"
+#include "satp/simulation/detail/framework/ProgressCallbacks.h"
+
+using namespace std;
+
+namespace satp::evaluation::detail {
+    // Progress of one evaluation. Evaluators publish processed ticks in batches
+    // with a relaxed atomic add: no lock and no std::function call on the hot
+    // path, from any number of workers. A reporter thread samples the counter
+    // every `interval` and forwards the delta to onAdvance; finish() forwards
+    // the remainder, so the onAdvance ticks always add up to what was published.
+    // Callbacks never run concurrently and need not be thread-safe.
+    class ProgressTracker {
+    public:
+        static constexpr chrono::milliseconds DEFAULT_INTERVAL{100};
+
+        ProgressTracker(const ProgressCallbacks *progress,
+                        const size_t totalTicks,
+                        const chrono::milliseconds interval = DEFAULT_INTERVAL)
+            : progress_(progress) {
+            startProgress(progress_, totalTicks);
+            if (progress_ != nullptr && progress_->onAdvance) {
+                reporter_ = thread([this, interval]() { reportLoop(interval); });
+            }
+        }
+
+        ProgressTracker(const ProgressTracker &) = delete;
+        ProgressTracker &operator=(const ProgressTracker &) = delete;
+
+        // Senza finish() (es. eccezione di un worker) il reporter viene solo
+        // fermato, come prima onFinish non viene chiamato.
+        ~ProgressTracker() {
+            stopReporter();
+        }
+
+        void advance(const size_t ticks) noexcept {
+            completed_.fetch_add(ticks, memory_order_relaxed);
+        }
+
+        void finish() {
+            if (finished_) return;
+            finished_ = true;
+            stopReporter();
+            publish();
+            finishProgress(progress_);
+        }
+
+    private:
+        void reportLoop(const chrono::milliseconds interval) {
+            unique_lock lock(mutex_);
+            while (!wake_.wait_for(lock, interval, [this]() { return stopping_; })) {
+                lock.unlock();
+                publish();
+                lock.lock();
+            }
+        }
+
+        void stopReporter() {
+            if (!reporter_.joinable()) return;
+            {
+                lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            reporter_.join();
+        }
+
+        // Chiamato solo dal reporter o, dopo il join, dal thread che chiude.
+        void publish() {
+            const size_t completed = completed_.load(memory_order_relaxed);
+            if (completed == reported_) return;
+            advanceProgress(progress_, completed - reported_);
+            reported_ = completed;
+        }
+
+        const ProgressCallbacks *progress_;
+        atomic<size_t> completed_{0};
+        size_t reported_ = 0;
+        bool finished_ = false;
+        mutex mutex_;
+        condition_variable wake_;
+        bool stopping_ = false;
+        thread reporter_;
+    };
+} // namespace satp::evaluation::detail
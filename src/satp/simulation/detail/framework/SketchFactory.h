@@ -1,8 +1,14 @@
 #pragma once
 
 #include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
+#include "satp/algorithms/RegisterView.h"
+#include "satp/algorithms/SketchStats.h"
 #include "satp/simulation/detail/framework/EvaluationContext.h"
 
 using namespace std;
@@ -13,10 +19,63 @@ namespace satp::evaluation::detail {
         { a.merge(b) } -> same_as<void>;
     };
 
+    // Sketch che espongono lo stato per gli snapshot dei checkpoint.
+    template<typename Algo>
+    concept SnapshotAlgorithm = requires(const Algo &saved, Algo &loaded, vector<uint8_t> &out,
+                                         const span<const uint8_t> state) {
+        saved.saveState(out);
+        loaded.loadState(state);
+    };
+
+    // Sketch che espongono i registri agli stimatori di Estimators.h.
+    template<typename Algo>
+    concept RegisterSketch = requires(const Algo &sketch) {
+        { sketch.registerView() } -> same_as<algorithms::RegisterView>;
+    };
+
+    // Sketch che riportano la memoria occupata (Algorithm::memoryBytes).
+    template<typename Algo>
+    concept MemoryReportingSketch = requires(const Algo &sketch) {
+        { sketch.memoryBytes() } -> convertible_to<size_t>;
+    };
+
+    // Sketch con i contatori interni di SATP_SKETCH_STATS.
+    template<typename Algo>
+    concept StatsReportingSketch = requires(const Algo &sketch) {
+        { sketch.stats() } -> convertible_to<const algorithms::SketchStats &>;
+    };
+
     template<typename Algo, typename... Args>
     Algo makeAlgo(const EvaluationContext &context, Args &&... ctorArgs) {
         static_assert(constructible_from<Algo, Args..., const hashing::HashFunction &>,
                       "Algorithm must be constructible with (..., const hashing::HashFunction&)");
         return Algo(std::forward<Args>(ctorArgs)..., context.hashFunction);
     }
+
+    // Reuses the sketch in `slot` across runs: built with `make` on first use,
+    // then brought back to its initial state by reset(), which keeps the
+    // sketch's buffers allocated. Sketches without reset() are rebuilt.
+    template<typename Algo, typename Make>
+    Algo &reuseSketch(optional<Algo> &slot, Make &&make) {
+        if constexpr (requires(Algo &sketch) { sketch.reset(); }) {
+            if (slot.has_value()) {
+                slot->reset();
+                return *slot;
+            }
+        }
+        slot.emplace(make());
+        return *slot;
+    }
+
+    // Copies `source` into a reusable slot. Copy-assignment lets the sketch's
+    // containers keep their capacity, so a warm slot is refilled without allocating.
+    template<typename Algo>
+    Algo &assignSketch(optional<Algo> &slot, const Algo &source) {
+        if (slot.has_value()) {
+            *slot = source;
+        } else {
+            slot.emplace(source);
+        }
+        return *slot;
+    }
 } // namespace satp::evaluation::detail
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "satp/profiling/CycleClock.h"
+#include "satp/profiling/LatencyHistogram.h"
+#include "satp/simulation/detail/framework/EvaluationContext.h"
+#include "satp/simulation/detail/framework/SketchFactory.h"
+#include "satp/simulation/detail/framework/DatasetTraversal.h"
+#include "satp/simulation/detail/framework/EvaluationMetadata.h"
+#include "satp/simulation/detail/framework/ProgressTracker.h"
+#include "satp/simulation/detail/latency/LatencyTypes.h"
+#include "satp/simulation/detail/streaming/CheckpointPlanner.h"
+
+using namespace std;
+
+namespace satp::evaluation::modes::latency {
+    namespace {
+        [[nodiscard]] inline chrono::nanoseconds ticksToDuration(const uint64_t ticks, const double nanosecondsPerTick) {
+            return chrono::nanoseconds(llround(static_cast<double>(ticks) * nanosecondsPerTick));
+        }
+
+        [[nodiscard]] inline LatencyPoint toLatencyPoint(const LatencyOperation operation,
+                                                         const profiling::LatencyHistogram &histogram,
+                                                         const double nanosecondsPerTick) {
+            const auto at = [&](const double q) {
+                return static_cast<double>(histogram.valueAtQuantile(q)) * nanosecondsPerTick;
+            };
+            return {
+                operation,
+                histogram.count(),
+                at(0.50),
+                at(0.90),
+                at(0.99),
+                at(0.999),
+                static_cast<double>(histogram.max()) * nanosecondsPerTick,
+                histogram.mean() * nanosecondsPerTick
+            };
+        }
+
+        // Un solo thread, run in ordine: la latenza di una chiamata non deve
+        // risentire di altri worker. Le letture del dataset restano fuori
+        // dalle misure; count() e' misurato ai checkpoint streaming, merge()
+        // fonde lo sketch di ogni run in una copia di quello del run precedente.
+        template<typename Value, typename Algo, typename... Args>
+        LatencyResult measureCalls(const detail::EvaluationContext &context, Args &&... ctorArgs) {
+            const LatencyOptions &options = context.latency;
+            const size_t sampleSize = context.metadata.sampleSize;
+            const auto checkpointPositions = CheckpointPlanner::build(sampleSize, context.streamingCheckpoints);
+            const double nanosecondsPerTick = profiling::CycleClock::nanosecondsPerTick();
+            // Con un ritmo fissato il batch i parte a i * ticksPerBatch dall'inizio del run.
+            const double ticksPerBatch = (options.targetRate > 0.0)
+                                             ? static_cast<double>(options.batch) * 1e9
+                                               / (options.targetRate * nanosecondsPerTick)
+                                             : 0.0;
+
+            const profiling::TraceSpan evaluationSpan("latency", "evaluation");
+            const auto evaluationStart = chrono::steady_clock::now();
+            profiling::PhaseTimes phases;
+            optional<profiling::PerfCounters> counters;
+            if (context.hardwareCounters) {
+                counters.emplace();
+                phases.counters = &*counters;
+            }
+            detail::ProgressTracker progress(context.progress, context.metadata.runs * sampleSize);
+            satp::dataset::PartitionReader reader(context.binaryDataset);
+            reader.setPhaseTimes(&phases);
+
+            vector<Value> values;
+            optional<Algo> sketch;
+            optional<Algo> previous;
+            optional<Algo> merged;
+            profiling::LatencyHistogram processLatency;
+            profiling::LatencyHistogram countLatency;
+            profiling::LatencyHistogram mergeLatency;
+            uint64_t lateBatches = 0;
+            volatile double lastEstimate = 0.0; // count() non va eliminato dal compilatore
+
+            for (size_t run = 0; run < context.metadata.runs; ++run) {
+                const profiling::TraceSpan runSpan("run", "latency");
+                reader.load(run, values);
+                if (values.size() != sampleSize) {
+                    throw runtime_error("Invalid binary dataset: partition size mismatch while measuring latency");
+                }
+
+                Algo &algo = detail::reuseSketch(sketch, [&] { return detail::makeAlgo<Algo>(context, ctorArgs...); });
+                uint64_t ingestTicks = 0;
+                uint64_t estimateTicks = 0;
+                size_t checkpointIndex = 0;
+                size_t batchIndex = 0;
+                const uint64_t runStart = profiling::CycleClock::now();
+
+                for (size_t batchStart = 0; batchStart < sampleSize; batchStart += options.batch, ++batchIndex) {
+                    const size_t batchEnd = min(sampleSize, batchStart + options.batch);
+                    uint64_t start = profiling::CycleClock::now();
+                    uint64_t latencyStart = start;
+                    if (ticksPerBatch > 0.0) {
+                        const uint64_t scheduled = runStart
+                                                   + static_cast<uint64_t>(static_cast<double>(batchIndex) * ticksPerBatch);
+                        if (start > scheduled) {
+                            // In ritardo: la latenza parte dall'istante previsto, come la
+                            // vedrebbe chi ha inviato l'elemento (niente coordinated omission).
+                            ++lateBatches;
+                            latencyStart = scheduled;
+                        } else {
+                            while (start < scheduled) start = profiling::CycleClock::now();
+                            latencyStart = start;
+                        }
+                    }
+                    for (size_t t = batchStart; t < batchEnd; ++t) {
+                        algo.process(values[t]);
+                    }
+                    const uint64_t end = profiling::CycleClock::now();
+                    processLatency.record(end - latencyStart);
+                    ingestTicks += end - start;
+
+                    // Un solo count() per batch anche se il batch copre piu' checkpoint.
+                    const size_t reached = checkpointIndex;
+                    while (checkpointIndex < checkpointPositions.size()
+                           && checkpointPositions[checkpointIndex] <= batchEnd) {
+                        ++checkpointIndex;
+                    }
+                    if (checkpointIndex != reached) {
+                        const uint64_t countStart = profiling::CycleClock::now();
+                        lastEstimate = static_cast<double>(algo.count());
+                        const uint64_t countEnd = profiling::CycleClock::now();
+                        countLatency.record(countEnd - countStart);
+                        estimateTicks += countEnd - countStart;
+                    }
+                }
+                phases.add(profiling::Phase::Ingest, ticksToDuration(ingestTicks, nanosecondsPerTick));
+                phases.add(profiling::Phase::Estimate, ticksToDuration(estimateTicks, nanosecondsPerTick));
+
+                if constexpr (detail::MergeableAlgorithm<Algo>) {
+                    if (previous.has_value()) {
+                        Algo &target = detail::assignSketch(merged, *previous);
+                        const uint64_t mergeStart = profiling::CycleClock::now();
+                        target.merge(algo);
+                        const uint64_t mergeEnd = profiling::CycleClock::now();
+                        mergeLatency.record(mergeEnd - mergeStart);
+                        phases.add(profiling::Phase::Merge, ticksToDuration(mergeEnd - mergeStart, nanosecondsPerTick));
+                    }
+                    detail::assignSketch(previous, algo);
+                }
+                progress.advance(sampleSize);
+            }
+            static_cast<void>(lastEstimate);
+
+            detail::publishTiming(context.diagnostics, phases, evaluationStart, context.metadata.runs,
+                                  static_cast<uint64_t>(context.metadata.runs) * sampleSize);
+            progress.finish();
+
+            LatencyResult result;
+            result.runs = context.metadata.runs;
+            result.batch = options.batch;
+            result.target_rate = options.targetRate;
+            result.timer_overhead_ns = static_cast<double>(profiling::CycleClock::overheadTicks()) * nanosecondsPerTick;
+            result.late_batches = lateBatches;
+            result.operations.push_back(toLatencyPoint(LatencyOperation::Process, processLatency, nanosecondsPerTick));
+            if (countLatency.count() != 0u) {
+                result.operations.push_back(toLatencyPoint(LatencyOperation::Count, countLatency, nanosecondsPerTick));
+            }
+            if (mergeLatency.count() != 0u) {
+                result.operations.push_back(toLatencyPoint(LatencyOperation::Merge, mergeLatency, nanosecondsPerTick));
+            }
+            return result;
+        }
+    } // namespace
+
+    template<typename Algo, typename... Args>
+    LatencyResult evaluate(const detail::EvaluationContext &context, Args &&... ctorArgs) {
+        if (hasEmptyDataset(context.metadata)) return {};
+        if (detail::hasWideKeys(context)) {
+            return measureCalls<uint64_t, Algo>(context, std::forward<Args>(ctorArgs)...);
+        }
+        return measureCalls<uint32_t, Algo>(context, std::forward<Args>(ctorArgs)...);
+    }
+} // namespace satp::evaluation::modes::latency
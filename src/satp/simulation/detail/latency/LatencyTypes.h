@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+namespace satp::evaluation {
+    enum class LatencyOperation : uint8_t {
+        Process, // `batch` chiamate process() consecutive
+        Count,   // count() ai checkpoint streaming
+        Merge    // merge() dello sketch di un run in quello del run precedente
+    };
+
+    [[nodiscard]] constexpr string_view toString(const LatencyOperation operation) noexcept {
+        switch (operation) {
+            case LatencyOperation::Process: return "process";
+            case LatencyOperation::Count: return "count";
+            case LatencyOperation::Merge: return "merge";
+        }
+        return "unknown";
+    }
+
+    struct LatencyOptions {
+        size_t batch = 1;        // process() per misura
+        double targetRate = 0.0; // elementi/s da rispettare; 0 = a piena velocita'
+    };
+
+    // Latenza di una misura (una chiamata, o un batch per process) in nanosecondi.
+    struct LatencyPoint {
+        LatencyOperation operation = LatencyOperation::Process;
+        uint64_t calls = 0;
+        double p50_ns = 0.0;
+        double p90_ns = 0.0;
+        double p99_ns = 0.0;
+        double p999_ns = 0.0;
+        double max_ns = 0.0;
+        double mean_ns = 0.0;
+    };
+
+    struct LatencyResult {
+        size_t runs = 0;
+        size_t batch = 1;
+        double target_rate = 0.0;
+        // Costo di due letture consecutive del clock, incluso in ogni misura.
+        double timer_overhead_ns = 0.0;
+        // Con target_rate: batch partiti dopo l'istante previsto perche' lo
+        // sketch era in ritardo; la loro latenza include l'attesa.
+        uint64_t late_batches = 0;
+        vector<LatencyPoint> operations; // process, count, merge (se misurati)
+    };
+} // namespace satp::evaluation
@@ -1,18 +1,24 @@
 #pragma once
 
+#include <chrono>
 #include <cmath>
 #include <concepts>
 #include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
-#include <unordered_set>
 #include <vector>
 
 #include "satp/algorithms/HyperLogLogPlusPlus.h"
 #include "satp/hashing/HashFactory.h"
+#include "satp/profiling/PhaseTimer.h"
+#include "satp/profiling/TraceSink.h"
 #include "satp/simulation/detail/framework/DatasetTraversal.h"
 #include "satp/simulation/detail/framework/EvaluationContext.h"
+#include "satp/simulation/detail/framework/ExactDistinctCache.h"
+#include "satp/simulation/detail/framework/ParallelExecution.h"
+#include "satp/simulation/detail/framework/ProgressTracker.h"
 #include "satp/simulation/detail/framework/SketchFactory.h"
 #include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
 
@@ -44,15 +50,6 @@ namespace satp::evaluation::modes::merge_heterogeneous {
             return abs(estimate - exactUnion) / exactUnion;
         }
 
-        [[nodiscard]] inline double computeExactUnion(const vector<uint32_t> &partA,
-                                                      const vector<uint32_t> &partB) {
-            unordered_set<uint32_t> values;
-            values.reserve(partA.size() + partB.size());
-            values.insert(partA.begin(), partA.end());
-            values.insert(partB.begin(), partB.end());
-            return static_cast<double>(values.size());
-        }
-
         [[nodiscard]] inline const MergeSketchContext &serialReferenceOf(
             const HeterogeneousMergeRunDescriptor &descriptor) {
             if (descriptor.serialReference.has_value()) return *descriptor.serialReference;
@@ -88,52 +85,23 @@ namespace satp::evaluation::modes::merge_heterogeneous {
             const uint32_t rightK = parseSingleUnsignedParam(descriptor.right.params, "k");
             return min(leftK, rightK);
         }
-    } // namespace
-
-    template<typename Algo, typename Builder>
-    vector<HeterogeneousMergePoint> evaluate(const detail::EvaluationContext &context,
-                                             const HeterogeneousMergeRunDescriptor &descriptor,
-                                             Builder buildAlgo) {
-        static_assert(detail::MergeableAlgorithm<Algo>,
-                      "merge_heterogeneous::evaluate requires Algo::merge(const Algo&)");
-        static_assert(HeterogeneousSketchBuilder<Algo, Builder>,
-                      "builder must be callable as Algo(const MergeSketchContext&, const HashFunction&)");
-
-        if (context.metadata.runs < 2u || hasEmptyDataset(context.metadata)) return {};
 
-        const size_t pairCount = context.metadata.runs / 2u;
-        const bool hasBaseline = homogeneousBaselineOf(descriptor).has_value();
-        const size_t ticksPerPair = context.metadata.sampleSize * (hasBaseline ? 6u : 4u);
-        detail::startProgress(context.progress, pairCount * ticksPerPair);
-
-        satp::dataset::PartitionReader reader(context.binaryDataset);
-        vector<uint32_t> partA;
-        vector<uint32_t> partB;
-        vector<HeterogeneousMergePoint> points;
-        points.reserve(pairCount);
-
-        for (size_t pairIndex = 0; pairIndex < pairCount; ++pairIndex) {
-            const size_t idxA = 2u * pairIndex;
-            const size_t idxB = idxA + 1u;
-            reader.load(idxA, partA);
-            reader.load(idxB, partB);
-
-            const double exactUnion = computeExactUnion(partA, partB);
-
-            auto leftHash = satp::hashing::getHashFunctionBy(descriptor.left.hashName, descriptor.left.hashSeed);
-            auto rightHash = satp::hashing::getHashFunctionBy(descriptor.right.hashName, descriptor.right.hashSeed);
-            Algo sketchA = buildAlgo(descriptor.left, *leftHash);
-            Algo sketchB = buildAlgo(descriptor.right, *rightHash);
-            detail::processValues(sketchA, partA, context.progress);
-            detail::processValues(sketchB, partB, context.progress);
-
-            double estimateMerge = nanValue();
+        // Stima del merge secondo la strategia della cella; NaN per reject.
+        // `scratch` ospita la copia di sketchA da fondere, riusata tra coppie;
+        // riduzioni e merge contano come Merge in `phases`, count() come Estimate.
+        template<typename Algo>
+        [[nodiscard]] double mergedEstimate(const HeterogeneousMergeRunDescriptor &descriptor,
+                                            const Algo &sketchA,
+                                            const Algo &sketchB,
+                                            optional<Algo> &scratch,
+                                            profiling::PhaseTimes *phases) {
             switch (descriptor.strategy) {
                 case MergeStrategy::Reject:
-                    break;
+                    return nanValue();
                 case MergeStrategy::Direct:
                 case MergeStrategy::UnsafeNaiveMerge: {
-                    Algo merged = sketchA;
+                    profiling::PhaseTimer mergeTimer(phases, profiling::Phase::Merge);
+                    Algo &merged = detail::assignSketch(scratch, sketchA);
                     if constexpr (is_same_v<Algo, satp::algorithms::HyperLogLogPlusPlus>) {
                         if (descriptor.validity == MergeValidity::Recoverable &&
                             descriptor.strategy == MergeStrategy::UnsafeNaiveMerge) {
@@ -147,49 +115,37 @@ namespace satp::evaluation::modes::merge_heterogeneous {
                     } else {
                         merged.merge(sketchB);
                     }
-                    estimateMerge = static_cast<double>(merged.count());
-                    break;
+                    mergeTimer.stop();
+                    const profiling::PhaseTimer estimateTimer(phases, profiling::Phase::Estimate);
+                    return static_cast<double>(merged.count());
                 }
                 case MergeStrategy::ReduceThenMerge: {
                     if constexpr (!is_same_v<Algo, satp::algorithms::HyperLogLogPlusPlus>) {
                         throw logic_error("reduce_then_merge currently supports only HyperLogLogPlusPlus");
                     } else {
+                        profiling::PhaseTimer mergeTimer(phases, profiling::Phase::Merge);
                         const uint32_t targetK = reductionTargetKOf(descriptor);
                         Algo merged = sketchA.reducedTo(targetK);
                         const Algo reducedB = sketchB.reducedTo(targetK);
                         merged.merge(reducedB);
-                        estimateMerge = static_cast<double>(merged.count());
+                        mergeTimer.stop();
+                        const profiling::PhaseTimer estimateTimer(phases, profiling::Phase::Estimate);
+                        return static_cast<double>(merged.count());
                     }
-                    break;
                 }
             }
+            return nanValue();
+        }
 
-            const MergeSketchContext &serialContext = serialReferenceOf(descriptor);
-            auto serialHash = satp::hashing::getHashFunctionBy(serialContext.hashName, serialContext.hashSeed);
-            Algo serial = buildAlgo(serialContext, *serialHash);
-            detail::processValues(serial, partA, context.progress);
-            detail::processValues(serial, partB, context.progress);
-            const double estimateSerial = static_cast<double>(serial.count());
-
-            double baselineHomogeneous = nanValue();
-            if (hasBaseline) {
-                const MergeSketchContext &baselineContext = *homogeneousBaselineOf(descriptor);
-                auto baselineHash = satp::hashing::getHashFunctionBy(
-                    baselineContext.hashName,
-                    baselineContext.hashSeed);
-                Algo baselineA = buildAlgo(baselineContext, *baselineHash);
-                Algo baselineB = buildAlgo(baselineContext, *baselineHash);
-                detail::processValues(baselineA, partA, context.progress);
-                detail::processValues(baselineB, partB, context.progress);
-                baselineA.merge(baselineB);
-                baselineHomogeneous = static_cast<double>(baselineA.count());
-            }
-
+        [[nodiscard]] inline HeterogeneousMergePoint makePoint(const size_t pairIndex,
+                                                               const double exactUnion,
+                                                               const double estimateMerge,
+                                                               const double estimateSerial,
+                                                               const double baselineHomogeneous) {
             const double deltaVsBaseline = (isfinite(estimateMerge) && isfinite(baselineHomogeneous))
                                                ? abs(estimateMerge - baselineHomogeneous)
                                                : nanValue();
-
-            points.push_back({
+            return {
                 pairIndex,
                 exactUnion,
                 estimateMerge,
@@ -200,10 +156,157 @@ namespace satp::evaluation::modes::merge_heterogeneous {
                 computeRelativeError(estimateSerial, exactUnion),
                 baselineHomogeneous,
                 deltaVsBaseline
+            };
+        }
+
+        template<typename Value, typename Algo, typename Builder>
+        vector<HeterogeneousMergePoint> evaluatePairs(const detail::EvaluationContext &context,
+                                                      const HeterogeneousMergeRunDescriptor &descriptor,
+                                                      Builder &buildAlgo) {
+            const profiling::TraceSpan evaluationSpan("merge_heterogeneous", "evaluation");
+            const auto evaluationStart = chrono::steady_clock::now();
+            const size_t pairCount = context.metadata.runs / 2u;
+            const size_t sampleSize = context.metadata.sampleSize;
+            const MergeSketchContext &serialContext = serialReferenceOf(descriptor);
+            const optional<MergeSketchContext> &baselineContext = homogeneousBaselineOf(descriptor);
+            const bool hasBaseline = baselineContext.has_value();
+
+            // Uno sketch gia' costruito con lo stesso contesto viene riusato: il
+            // seriale riparte da una copia di sketchA e ingerisce solo partB, la
+            // baseline riusa sketchA/sketchB quando coincide con left/right.
+            const bool serialFromLeft = serialContext == descriptor.left;
+            const bool baselineFromLeft = hasBaseline && *baselineContext == descriptor.left;
+            const bool baselineFromRight = hasBaseline && *baselineContext == descriptor.right;
+            size_t ticksPerPair = sampleSize * (serialFromLeft ? 3u : 4u);
+            if (hasBaseline) {
+                ticksPerPair += baselineFromLeft ? 0u : sampleSize;
+                ticksPerPair += baselineFromRight ? 0u : sampleSize;
+            }
+            detail::ProgressTracker progress(context.progress, pairCount * ticksPerPair);
+
+            // Le hash function sono stateless (metodi const): una istanza per
+            // contesto e' condivisa da tutti i worker.
+            const auto leftHash = satp::hashing::getHashFunctionBy(descriptor.left.hashName, descriptor.left.hashSeed);
+            const auto rightHash = satp::hashing::getHashFunctionBy(descriptor.right.hashName, descriptor.right.hashSeed);
+            const auto serialHash = satp::hashing::getHashFunctionBy(serialContext.hashName, serialContext.hashSeed);
+            const auto baselineHash = hasBaseline
+                                          ? satp::hashing::getHashFunctionBy(
+                                              baselineContext->hashName,
+                                              baselineContext->hashSeed)
+                                          : nullptr;
+
+            const size_t workers = detail::resolveWorkerCount(context.workers);
+            vector<detail::PartitionPairWorkspace<Value>> workspaces(workers);
+            vector<optional<Algo>> sketchASlots(workers);
+            vector<optional<Algo>> sketchBSlots(workers);
+            vector<optional<Algo>> mergedSlots(workers);
+            vector<optional<Algo>> serialSlots(workers);
+            vector<optional<Algo>> baselineSlots(workers);
+            vector<HeterogeneousMergePoint> points(pairCount);
+
+            detail::parallelFor(pairCount, workers, [&](const size_t worker, const size_t pairIndex) {
+                const profiling::TraceSpan pairSpan("pair", "merge_heterogeneous");
+                auto &workspace = workspaces[worker];
+                const size_t idxA = 2u * pairIndex;
+                const size_t idxB = idxA + 1u;
+                workspace.loadWithTruthBits(context, idxA, idxB);
+                const auto &partA = workspace.partA;
+                const auto &partB = workspace.partB;
+
+                profiling::TraceSpan exactSpan("exact_union", "merge_heterogeneous");
+                const double exactUnion = detail::exactUnionCardinality(context, workspace, idxA, idxB);
+                exactSpan.stop();
+
+                profiling::PhaseTimer ingestTimer(&workspace.phases, profiling::Phase::Ingest);
+                Algo &sketchA = detail::reuseSketch(sketchASlots[worker], [&] {
+                    return buildAlgo(descriptor.left, *leftHash);
+                });
+                Algo &sketchB = detail::reuseSketch(sketchBSlots[worker], [&] {
+                    return buildAlgo(descriptor.right, *rightHash);
+                });
+                detail::ingestValues(sketchA, partA);
+                detail::ingestValues(sketchB, partB);
+                ingestTimer.stop();
+
+                const double estimateMerge = mergedEstimate(descriptor, sketchA, sketchB, mergedSlots[worker],
+                                                            &workspace.phases);
+
+                profiling::TraceSpan serialSpan("serial", "merge_heterogeneous");
+                optional<Algo> builtSerial;
+                profiling::PhaseTimer serialIngestTimer(&workspace.phases, profiling::Phase::Ingest);
+                Algo *serial = nullptr;
+                if (serialFromLeft) {
+                    serial = &detail::assignSketch(serialSlots[worker], sketchA);
+                } else {
+                    serial = &builtSerial.emplace(buildAlgo(serialContext, *serialHash));
+                    detail::ingestValues(*serial, partA);
+                }
+                detail::ingestValues(*serial, partB);
+                serialIngestTimer.stop();
+                profiling::PhaseTimer serialEstimateTimer(&workspace.phases, profiling::Phase::Estimate);
+                const double estimateSerial = static_cast<double>(serial->count());
+                serialEstimateTimer.stop();
+                serialSpan.stop();
+
+                double baselineHomogeneous = nanValue();
+                if (hasBaseline) {
+                    const profiling::TraceSpan baselineSpan("baseline", "merge_heterogeneous");
+                    profiling::PhaseTimer baselineIngestTimer(&workspace.phases, profiling::Phase::Ingest);
+                    optional<Algo> builtB;
+                    if (!baselineFromRight) {
+                        builtB.emplace(buildAlgo(*baselineContext, *baselineHash));
+                        detail::ingestValues(*builtB, partB);
+                    }
+                    const Algo &baselineB = baselineFromRight ? sketchB : *builtB;
+
+                    optional<Algo> builtA;
+                    Algo *baselineA = nullptr;
+                    if (baselineFromLeft) {
+                        baselineA = &detail::assignSketch(baselineSlots[worker], sketchA);
+                    } else {
+                        baselineA = &builtA.emplace(buildAlgo(*baselineContext, *baselineHash));
+                        detail::ingestValues(*baselineA, partA);
+                    }
+                    baselineIngestTimer.stop();
+
+                    profiling::PhaseTimer baselineMergeTimer(&workspace.phases, profiling::Phase::Merge);
+                    baselineA->merge(baselineB);
+                    baselineMergeTimer.stop();
+                    const profiling::PhaseTimer baselineEstimateTimer(&workspace.phases, profiling::Phase::Estimate);
+                    baselineHomogeneous = static_cast<double>(baselineA->count());
+                }
+
+                points[pairIndex] = makePoint(
+                    pairIndex,
+                    exactUnion,
+                    estimateMerge,
+                    estimateSerial,
+                    baselineHomogeneous);
+                progress.advance(ticksPerPair);
             });
+
+            profiling::PhaseTimes phases;
+            for (const auto &workspace : workspaces) phases += workspace.phases;
+            detail::publishTiming(context.diagnostics, phases, evaluationStart, pairCount,
+                                  static_cast<uint64_t>(pairCount) * 2u * sampleSize);
+            progress.finish();
+            return points;
         }
+    } // namespace
+
+    template<typename Algo, typename Builder>
+    vector<HeterogeneousMergePoint> evaluate(const detail::EvaluationContext &context,
+                                             const HeterogeneousMergeRunDescriptor &descriptor,
+                                             Builder buildAlgo) {
+        static_assert(detail::MergeableAlgorithm<Algo>,
+                      "merge_heterogeneous::evaluate requires Algo::merge(const Algo&)");
+        static_assert(HeterogeneousSketchBuilder<Algo, Builder>,
+                      "builder must be callable as Algo(const MergeSketchContext&, const HashFunction&)");
 
-        detail::finishProgress(context.progress);
-        return points;
+        if (context.metadata.runs < 2u || hasEmptyDataset(context.metadata)) return {};
+        if (detail::hasWideKeys(context)) {
+            return evaluatePairs<uint64_t, Algo>(context, descriptor, buildAlgo);
+        }
+        return evaluatePairs<uint32_t, Algo>(context, descriptor, buildAlgo);
     }
 } // namespace satp::evaluation::modes::merge_heterogeneous
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "satp/hashing/HashFactory.h"
+#include "satp/simulation/detail/framework/DatasetTraversal.h"
+#include "satp/simulation/detail/framework/EvaluationContext.h"
+#include "satp/simulation/detail/framework/ExactDistinctCache.h"
+#include "satp/simulation/detail/framework/ParallelExecution.h"
+#include "satp/simulation/detail/framework/ProgressTracker.h"
+#include "satp/simulation/detail/framework/SketchFactory.h"
+#include "satp/simulation/detail/merge/HeterogeneousMergeEvaluation.tpp"
+#include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
+
+using namespace std;
+
+namespace satp::evaluation::modes::merge_heterogeneous {
+    namespace {
+        template<typename Algo>
+        concept HashFedAlgorithm = requires(Algo algo, const uint64_t hash) {
+            algo.addHash(hash);
+            algo.reset();
+        };
+
+        // Contesti distinti della matrice. Ogni partizione viene hashata una
+        // volta per (hash, seed) e ogni sketch (hash, seed, params) e'
+        // costruito una volta per coppia; le celle vi fanno riferimento per indice.
+        struct MatrixPlan {
+            struct CellRefs {
+                size_t left = 0;
+                size_t right = 0;
+                size_t serial = 0;
+                optional<size_t> baseline;
+            };
+
+            vector<MergeSketchContext> hashes; // solo hashName/hashSeed significativi
+            vector<MergeSketchContext> sketches;
+            vector<size_t> sketchHash;         // sketch -> indice in hashes
+            vector<bool> needsSerial;
+            vector<bool> needsBaseline;
+            vector<CellRefs> cells;
+
+            [[nodiscard]] size_t serialCount() const {
+                size_t total = 0;
+                for (const bool needed : needsSerial) total += needed ? 1u : 0u;
+                return total;
+            }
+        };
+
+        [[nodiscard]] inline size_t internHash(MatrixPlan &plan, const MergeSketchContext &sketch) {
+            for (size_t i = 0; i < plan.hashes.size(); ++i) {
+                if (plan.hashes[i].hashName == sketch.hashName && plan.hashes[i].hashSeed == sketch.hashSeed) {
+                    return i;
+                }
+            }
+            plan.hashes.push_back({sketch.hashName, sketch.hashSeed, {}});
+            return plan.hashes.size() - 1u;
+        }
+
+        [[nodiscard]] inline size_t internSketch(MatrixPlan &plan, const MergeSketchContext &sketch) {
+            for (size_t i = 0; i < plan.sketches.size(); ++i) {
+                if (plan.sketches[i] == sketch) return i;
+            }
+            plan.sketches.push_back(sketch);
+            plan.sketchHash.push_back(internHash(plan, sketch));
+            plan.needsSerial.push_back(false);
+            plan.needsBaseline.push_back(false);
+            return plan.sketches.size() - 1u;
+        }
+
+        [[nodiscard]] inline MatrixPlan planMatrix(const vector<HeterogeneousMergeRunDescriptor> &cells) {
+            MatrixPlan plan;
+            plan.cells.reserve(cells.size());
+            for (const auto &descriptor : cells) {
+                MatrixPlan::CellRefs refs;
+                refs.left = internSketch(plan, descriptor.left);
+                refs.right = internSketch(plan, descriptor.right);
+                refs.serial = internSketch(plan, serialReferenceOf(descriptor));
+                plan.needsSerial[refs.serial] = true;
+                if (const auto &baseline = homogeneousBaselineOf(descriptor); baseline.has_value()) {
+                    refs.baseline = internSketch(plan, *baseline);
+                    plan.needsBaseline[*refs.baseline] = true;
+                }
+                plan.cells.push_back(refs);
+            }
+            return plan;
+        }
+
+        // Valori hashati per blocco: il buffer e' riusato tra blocchi e coppie,
+        // quindi la memoria per worker non dipende dalla dimensione delle partizioni.
+        constexpr size_t HASH_CHUNK = 4096u;
+
+        // Stato di un worker: buffer di hash del blocco corrente e sketch
+        // riusati tra le coppie tramite reset().
+        template<typename Value, typename Algo>
+        struct MatrixWorkspace {
+            detail::PartitionPairWorkspace<Value> partitions;
+            vector<uint64_t> hashChunk;
+            vector<optional<Algo>> sketchesA;
+            vector<optional<Algo>> sketchesB;
+            vector<optional<Algo>> serials;
+            optional<Algo> scratch;
+            vector<double> serialEstimates;
+            vector<double> baselineEstimates;
+        };
+
+        template<typename Algo, typename Builder>
+        Algo &freshSketch(optional<Algo> &slot,
+                          Builder &buildAlgo,
+                          const MergeSketchContext &sketchContext,
+                          const satp::hashing::HashFunction &hashFunction) {
+            return detail::reuseSketch(slot, [&] { return buildAlgo(sketchContext, hashFunction); });
+        }
+
+        // Hasha `values` a blocchi, una volta per (hash, seed), e passa ogni
+        // blocco a feed(sketch, hashes) per tutti gli sketch che usano quell'hash.
+        // L'ordine di ingestione di ogni sketch resta quello della partizione.
+        template<typename Value, typename Feed>
+        void feedInChunks(const vector<Value> &values,
+                          const MatrixPlan &plan,
+                          const vector<unique_ptr<satp::hashing::HashFunction>> &hashFunctions,
+                          vector<uint64_t> &chunk,
+                          Feed &&feed) {
+            for (size_t begin = 0; begin < values.size(); begin += HASH_CHUNK) {
+                const size_t end = min(values.size(), begin + HASH_CHUNK);
+                chunk.resize(end - begin);
+                for (size_t h = 0; h < hashFunctions.size(); ++h) {
+                    const auto &hashFunction = *hashFunctions[h];
+                    for (size_t i = begin; i < end; ++i) {
+                        chunk[i - begin] = hashFunction.hash64(values[i]);
+                    }
+                    for (size_t s = 0; s < plan.sketches.size(); ++s) {
+                        if (plan.sketchHash[s] == h) feed(s, chunk);
+                    }
+                }
+            }
+        }
+
+        template<typename Value, typename Algo, typename Builder>
+        vector<vector<HeterogeneousMergePoint>> evaluateMatrixPairs(
+            const detail::EvaluationContext &context,
+            const vector<HeterogeneousMergeRunDescriptor> &cells,
+            Builder &buildAlgo) {
+            const auto evaluationStart = chrono::steady_clock::now();
+            const size_t pairCount = context.metadata.runs / 2u;
+            const MatrixPlan plan = planMatrix(cells);
+            const size_t sketchCount = plan.sketches.size();
+
+            // Tick per coppia: ogni sketch ingerisce partA e partB, ogni seriale la sola partB.
+            const size_t ticksPerPair = context.metadata.sampleSize * (2u * sketchCount + plan.serialCount());
+            detail::ProgressTracker progress(context.progress, pairCount * ticksPerPair);
+
+            vector<unique_ptr<satp::hashing::HashFunction>> hashFunctions;
+            hashFunctions.reserve(plan.hashes.size());
+            for (const auto &hash : plan.hashes) {
+                hashFunctions.push_back(satp::hashing::getHashFunctionBy(hash.hashName, hash.hashSeed));
+            }
+
+            const size_t workers = detail::resolveWorkerCount(context.workers);
+            vector<MatrixWorkspace<Value, Algo>> workspaces(workers);
+            vector<vector<HeterogeneousMergePoint>> results(cells.size(), vector<HeterogeneousMergePoint>(pairCount));
+
+            detail::parallelFor(pairCount, workers, [&](const size_t worker, const size_t pairIndex) {
+                auto &ws = workspaces[worker];
+                profiling::PhaseTimes *phases = &ws.partitions.phases;
+                const size_t idxA = 2u * pairIndex;
+                const size_t idxB = idxA + 1u;
+                ws.partitions.loadWithTruthBits(context, idxA, idxB);
+                const double exactUnion = detail::exactUnionCardinality(context, ws.partitions, idxA, idxB);
+
+                ws.sketchesA.resize(sketchCount);
+                ws.sketchesB.resize(sketchCount);
+                ws.serials.resize(sketchCount);
+                ws.serialEstimates.assign(sketchCount, nanValue());
+                ws.baselineEstimates.assign(sketchCount, nanValue());
+
+                // Hash e ingestione nello stesso passaggio: contano come ingestione, come in process().
+                profiling::PhaseTimer ingestTimer(phases, profiling::Phase::Ingest);
+                for (size_t s = 0; s < sketchCount; ++s) {
+                    const auto &hashFunction = *hashFunctions[plan.sketchHash[s]];
+                    freshSketch(ws.sketchesA[s], buildAlgo, plan.sketches[s], hashFunction);
+                    freshSketch(ws.sketchesB[s], buildAlgo, plan.sketches[s], hashFunction);
+                }
+                feedInChunks(ws.partitions.partA, plan, hashFunctions, ws.hashChunk,
+                             [&](const size_t s, const vector<uint64_t> &hashes) {
+                                 for (const uint64_t hash : hashes) ws.sketchesA[s]->addHash(hash);
+                             });
+                // Il seriale parte da A completo e ingerisce B insieme allo sketch B.
+                for (size_t s = 0; s < sketchCount; ++s) {
+                    if (plan.needsSerial[s]) detail::assignSketch(ws.serials[s], *ws.sketchesA[s]);
+                }
+                feedInChunks(ws.partitions.partB, plan, hashFunctions, ws.hashChunk,
+                             [&](const size_t s, const vector<uint64_t> &hashes) {
+                                 Algo &sketchB = *ws.sketchesB[s];
+                                 for (const uint64_t hash : hashes) sketchB.addHash(hash);
+                                 if (!plan.needsSerial[s]) return;
+                                 Algo &serial = *ws.serials[s];
+                                 for (const uint64_t hash : hashes) serial.addHash(hash);
+                             });
+                ingestTimer.stop();
+
+                for (size_t s = 0; s < sketchCount; ++s) {
+                    if (plan.needsSerial[s]) {
+                        const profiling::PhaseTimer serialEstimateTimer(phases, profiling::Phase::Estimate);
+                        ws.serialEstimates[s] = static_cast<double>(ws.serials[s]->count());
+                    }
+                    if (plan.needsBaseline[s]) {
+                        profiling::PhaseTimer baselineMergeTimer(phases, profiling::Phase::Merge);
+                        Algo &baseline = detail::assignSketch(ws.scratch, *ws.sketchesA[s]);
+                        baseline.merge(*ws.sketchesB[s]);
+                        baselineMergeTimer.stop();
+                        const profiling::PhaseTimer baselineEstimateTimer(phases, profiling::Phase::Estimate);
+                        ws.baselineEstimates[s] = static_cast<double>(baseline.count());
+                    }
+                }
+
+                for (size_t c = 0; c < cells.size(); ++c) {
+                    const auto &refs = plan.cells[c];
+                    const double estimateMerge = mergedEstimate(cells[c],
+                                                                *ws.sketchesA[refs.left],
+                                                                *ws.sketchesB[refs.right],
+                                                                ws.scratch,
+                                                                phases);
+                    const double baseline = refs.baseline.has_value()
+                                                ? ws.baselineEstimates[*refs.baseline]
+                                                : nanValue();
+                    results[c][pairIndex] = makePoint(
+                        pairIndex,
+                        exactUnion,
+                        estimateMerge,
+                        ws.serialEstimates[refs.serial],
+                        baseline);
+                }
+                progress.advance(ticksPerPair);
+            });
+
+            profiling::PhaseTimes phases;
+            for (const auto &ws : workspaces) phases += ws.partitions.phases;
+            detail::publishTiming(context.diagnostics, phases, evaluationStart, pairCount,
+                                  static_cast<uint64_t>(pairCount) * 2u * context.metadata.sampleSize);
+            progress.finish();
+            return results;
+        }
+    } // namespace
+
+    // Valuta piu' celle (left, right, strategia) sullo stesso dataset in un
+    // solo passaggio: i punti di ogni cella coincidono con quelli di evaluate()
+    // sul descrittore corrispondente.
+    template<typename Algo, typename Builder>
+    vector<vector<HeterogeneousMergePoint>> evaluateMatrix(const detail::EvaluationContext &context,
+                                                           const vector<HeterogeneousMergeRunDescriptor> &cells,
+                                                           Builder buildAlgo) {
+        static_assert(detail::MergeableAlgorithm<Algo>,
+                      "merge_heterogeneous::evaluateMatrix requires Algo::merge(const Algo&)");
+        static_assert(HeterogeneousSketchBuilder<Algo, Builder>,
+                      "builder must be callable as Algo(const MergeSketchContext&, const HashFunction&)");
+        static_assert(HashFedAlgorithm<Algo>,
+                      "merge_heterogeneous::evaluateMatrix requires Algo::addHash(uint64_t) and Algo::reset()");
+
+        if (cells.empty()) return {};
+        if (context.metadata.runs < 2u || hasEmptyDataset(context.metadata)) {
+            return vector<vector<HeterogeneousMergePoint>>(cells.size());
+        }
+        if (detail::hasWideKeys(context)) {
+            return evaluateMatrixPairs<uint64_t, Algo>(context, cells, buildAlgo);
+        }
+        return evaluateMatrixPairs<uint32_t, Algo>(context, cells, buildAlgo);
+    }
+} // namespace satp::evaluation::modes::merge_heterogeneous
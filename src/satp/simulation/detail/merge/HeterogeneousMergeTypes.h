@@ -65,6 +65,8 @@ namespace satp::evaluation {
         string hashName;
         uint32_t hashSeed = 0;
         string params;
+
+        [[nodiscard]] bool operator==(const MergeSketchContext &) const = default;
     };
 
     struct HeterogeneousMergeRunDescriptor {
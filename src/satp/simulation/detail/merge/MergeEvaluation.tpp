@@ -1,67 +1,100 @@
 #pragma once
 
+#include <chrono>
 #include <cmath>
+#include <optional>
 #include <vector>
 
 #include "satp/simulation/detail/framework/EvaluationContext.h"
 #include "satp/simulation/detail/framework/SketchFactory.h"
 #include "satp/simulation/detail/framework/DatasetTraversal.h"
 #include "satp/simulation/detail/framework/EvaluationMetadata.h"
+#include "satp/simulation/detail/framework/ParallelExecution.h"
+#include "satp/simulation/detail/framework/ProgressTracker.h"
 
 using namespace std;
 
 namespace satp::evaluation::modes::merge {
-    template<typename Algo, typename... Args>
-    vector<MergePairPoint> evaluate(const detail::EvaluationContext &context,
-                                    Args &&... ctorArgs) {
-        static_assert(detail::MergeableAlgorithm<Algo>,
-                      "merge::evaluate requires Algo::merge(const Algo&)");
+    namespace {
+        template<typename Value, typename Algo, typename... Args>
+        vector<MergePairPoint> evaluatePairs(const detail::EvaluationContext &context,
+                                             Args &&... ctorArgs) {
+            const profiling::TraceSpan evaluationSpan("merge_pairs", "evaluation");
+            const auto evaluationStart = chrono::steady_clock::now();
+            const size_t pairCount = context.metadata.runs / 2u;
+            // Per coppia: sketchA (n) + sketchB (n) + la coda seriale su partB (n).
+            detail::ProgressTracker progress(context.progress, pairCount * context.metadata.sampleSize * 3u);
 
-        if (context.metadata.runs < 2u || hasEmptyDataset(context.metadata)) return {};
-
-        const size_t pairCount = context.metadata.runs / 2u;
-        detail::startProgress(context.progress, pairCount * context.metadata.sampleSize * 4u);
-        satp::dataset::PartitionReader reader(context.binaryDataset);
+            const size_t workers = detail::resolveWorkerCount(context.workers);
+            vector<detail::PartitionPairWorkspace<Value>> workspaces(workers);
+            vector<optional<Algo>> sketchASlots(workers);
+            vector<optional<Algo>> sketchBSlots(workers);
+            vector<optional<Algo>> serialSlots(workers);
+            vector<MergePairPoint> points(pairCount);
+            detail::RunAllocationTracker allocations(workers);
+            const auto make = [&] { return detail::makeAlgo<Algo>(context, ctorArgs...); };
 
-        vector<uint32_t> partA;
-        vector<uint32_t> partB;
-        vector<MergePairPoint> points;
-        points.reserve(pairCount);
+            detail::parallelFor(pairCount, workers, [&](const size_t worker, const size_t pairIndex) {
+                const profiling::TraceSpan pairSpan("pair", "merge");
+                const AllocationScope pairAllocations;
+                auto &workspace = workspaces[worker];
+                workspace.load(context, 2u * pairIndex, 2u * pairIndex + 1u);
 
-        for (size_t pairIndex = 0; pairIndex < pairCount; ++pairIndex) {
-            const size_t idxA = 2u * pairIndex;
-            const size_t idxB = idxA + 1u;
-            reader.load(idxA, partA);
-            reader.load(idxB, partB);
+                profiling::PhaseTimer ingestTimer(&workspace.phases, profiling::Phase::Ingest);
+                Algo &sketchA = detail::reuseSketch(sketchASlots[worker], make);
+                detail::ingestValues(sketchA, workspace.partA);
 
-            Algo sketchA = detail::makeAlgo<Algo>(context, std::forward<Args>(ctorArgs)...);
-            detail::processValues(sketchA, partA, context.progress);
+                Algo &sketchB = detail::reuseSketch(sketchBSlots[worker], make);
+                detail::ingestValues(sketchB, workspace.partB);
 
-            Algo sketchB = detail::makeAlgo<Algo>(context, std::forward<Args>(ctorArgs)...);
-            detail::processValues(sketchB, partB, context.progress);
+                // Lo sketch seriale dopo partA coincide con sketchA: si riparte
+                // da una sua copia invece di reingerire partA.
+                Algo &serial = detail::assignSketch(serialSlots[worker], sketchA);
+                detail::ingestValues(serial, workspace.partB);
+                ingestTimer.stop();
 
-            Algo merged = sketchA;
-            merged.merge(sketchB);
+                profiling::PhaseTimer mergeTimer(&workspace.phases, profiling::Phase::Merge);
+                sketchA.merge(sketchB);
+                mergeTimer.stop();
 
-            Algo serial = detail::makeAlgo<Algo>(context, std::forward<Args>(ctorArgs)...);
-            detail::processValues(serial, partA, context.progress);
-            detail::processValues(serial, partB, context.progress);
+                profiling::PhaseTimer estimateTimer(&workspace.phases, profiling::Phase::Estimate);
+                const double estimateMerge = static_cast<double>(sketchA.count());
+                const double estimateSerial = static_cast<double>(serial.count());
+                estimateTimer.stop();
+                const double deltaAbs = abs(estimateMerge - estimateSerial);
+                const double deltaRel = (estimateSerial != 0.0) ? (deltaAbs / estimateSerial) : 0.0;
 
-            const double estimateMerge = static_cast<double>(merged.count());
-            const double estimateSerial = static_cast<double>(serial.count());
-            const double deltaAbs = abs(estimateMerge - estimateSerial);
-            const double deltaRel = (estimateSerial != 0.0) ? (deltaAbs / estimateSerial) : 0.0;
-
-            points.push_back({
-                pairIndex,
-                estimateMerge,
-                estimateSerial,
-                deltaAbs,
-                deltaRel
+                points[pairIndex] = {
+                    pairIndex,
+                    estimateMerge,
+                    estimateSerial,
+                    deltaAbs,
+                    deltaRel
+                };
+                progress.advance(workspace.partA.size() + 2u * workspace.partB.size());
+                allocations.add(worker, pairAllocations.elapsed());
             });
+
+            allocations.publish(context.diagnostics);
+            profiling::PhaseTimes phases;
+            for (const auto &workspace : workspaces) phases += workspace.phases;
+            detail::publishTiming(context.diagnostics, phases, evaluationStart, pairCount,
+                                  static_cast<uint64_t>(pairCount) * 2u * context.metadata.sampleSize);
+            progress.finish();
+            return points;
         }
+    } // namespace
 
-        detail::finishProgress(context.progress);
-        return points;
+    template<typename Algo, typename... Args>
+    vector<MergePairPoint> evaluate(const detail::EvaluationContext &context,
+                                    Args &&... ctorArgs) {
+        static_assert(detail::MergeableAlgorithm<Algo>,
+                      "merge::evaluate requires Algo::merge(const Algo&)");
+
+        if (context.metadata.runs < 2u || hasEmptyDataset(context.metadata)) return {};
+        if (detail::hasWideKeys(context)) {
+            return evaluatePairs<uint64_t, Algo>(context, std::forward<Args>(ctorArgs)...);
+        }
+        return evaluatePairs<uint32_t, Algo>(context, std::forward<Args>(ctorArgs)...);
     }
 } // namespace satp::evaluation::modes::merge
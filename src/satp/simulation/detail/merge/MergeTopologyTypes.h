@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    struct MergeTopologyOptions {
+        MergeTopology topology = MergeTopology::BalancedTree;
+        size_t partitions = 0;                  // 0 = tutte le partizioni del dataset
+        optional<uint64_t> sampleSeed = nullopt; // nullopt = le prime `partitions` partizioni
+        size_t workers = 0;                     // 0 = worker count of the framework
+    };
+
+    // Livello 0 = sketch foglia costruiti dalle partizioni; ogni livello successivo
+    // e' un passo di merge della topologia. Le metriche riguardano i nodi vivi dopo
+    // il livello: ogni nodo copre un intervallo contiguo di partizioni e la sua
+    // stima e' confrontata con l'unione esatta di quelle partizioni.
+    struct MergeTopologyLevel {
+        size_t level = 0;
+        size_t merges = 0;
+        size_t nodes = 0;
+        double wall_seconds = 0.0;
+        double exact_union_mean = 0.0;
+        double estimate_mean = 0.0;
+        double drift_rel_mean = 0.0;
+        double drift_rel_max = 0.0;
+    };
+
+    struct MergeTopologyResult {
+        MergeTopology topology = MergeTopology::BalancedTree;
+        size_t partitions = 0;
+        size_t workers = 0;
+        vector<MergeTopologyLevel> levels;
+    };
+} // namespace satp::evaluation
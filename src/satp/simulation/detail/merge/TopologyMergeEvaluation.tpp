@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "satp/simulation/detail/framework/DatasetTraversal.h"
+#include "satp/simulation/detail/framework/EvaluationContext.h"
+#include "satp/simulation/detail/framework/ExactDistinctCache.h"
+#include "satp/simulation/detail/framework/ParallelExecution.h"
+#include "satp/simulation/detail/framework/ProgressTracker.h"
+#include "satp/simulation/detail/framework/SketchFactory.h"
+#include "satp/simulation/detail/merge/MergeTopologyTypes.h"
+
+using namespace std;
+
+namespace satp::evaluation::modes::merge_topology {
+    namespace {
+        [[nodiscard]] inline vector<size_t> selectPartitions(const size_t available,
+                                                             const MergeTopologyOptions &options) {
+            const size_t selected = (options.partitions == 0u) ? available : options.partitions;
+            if (selected > available) {
+                throw invalid_argument("merge topology: more partitions requested than the dataset has");
+            }
+
+            vector<size_t> indices(available);
+            iota(indices.begin(), indices.end(), size_t{0});
+            if (options.sampleSeed.has_value()) {
+                mt19937_64 rng(*options.sampleSeed);
+                ranges::shuffle(indices, rng);
+            }
+            indices.resize(selected);
+            ranges::sort(indices);
+            return indices;
+        }
+
+        template<typename Value>
+        [[nodiscard]] shared_ptr<const vector<Value>> unionOf(const vector<Value> &a, const vector<Value> &b) {
+            vector<Value> merged;
+            merged.reserve(a.size() + b.size());
+            ranges::set_union(a, b, back_inserter(merged));
+            merged.shrink_to_fit();
+            return make_shared<const vector<Value>>(std::move(merged));
+        }
+
+        // Un nodo dell'albero di merge: lo sketch e i distinti esatti (ordinati)
+        // dell'intervallo di partizioni che copre. exactSize resta valido anche
+        // quando l'array e' tenuto fuori dal nodo (accumulatore della catena).
+        template<typename Value, typename Algo>
+        struct MergeNode {
+            optional<Algo> sketch;
+            shared_ptr<const vector<Value>> exact;
+            size_t exactSize = 0;
+            double estimate = 0.0;
+        };
+
+        template<typename Value, typename Algo>
+        void appendLevel(MergeTopologyResult &result,
+                         vector<MergeNode<Value, Algo>> &nodes,
+                         const size_t merges,
+                         const double wallSeconds,
+                         const size_t workers,
+                         vector<profiling::PhaseTimes> &phases) {
+            // Stime fuori dal tempo del livello: count() puo' costare (es. correzione del bias HLL++).
+            detail::parallelFor(nodes.size(), workers, [&](const size_t worker, const size_t i) {
+                const profiling::PhaseTimer estimateTimer(&phases[worker], profiling::Phase::Estimate);
+                nodes[i].estimate = static_cast<double>(nodes[i].sketch->count());
+            });
+
+            MergeTopologyLevel level;
+            level.level = result.levels.size();
+            level.merges = merges;
+            level.nodes = nodes.size();
+            level.wall_seconds = wallSeconds;
+            for (const auto &node : nodes) {
+                const double exact = static_cast<double>(node.exactSize);
+                const double drift = (exact != 0.0) ? abs(node.estimate - exact) / exact : 0.0;
+                level.exact_union_mean += exact;
+                level.estimate_mean += node.estimate;
+                level.drift_rel_mean += drift;
+                level.drift_rel_max = max(level.drift_rel_max, drift);
+            }
+            const double n = static_cast<double>(nodes.size());
+            level.exact_union_mean /= n;
+            level.estimate_mean /= n;
+            level.drift_rel_mean /= n;
+            result.levels.push_back(level);
+        }
+
+        template<typename Value, typename Algo, typename... Args>
+        MergeTopologyResult evaluateTopology(const detail::EvaluationContext &context,
+                                             const MergeTopologyOptions &options,
+                                             Args &&... ctorArgs) {
+            using Clock = chrono::steady_clock;
+            const auto evaluationStart = Clock::now();
+            const vector<size_t> partitions = selectPartitions(context.metadata.runs, options);
+            const size_t workers = detail::resolveWorkerCount(
+                (options.workers != 0u) ? options.workers : context.workers);
+
+            MergeTopologyResult result;
+            result.topology = options.topology;
+            result.partitions = partitions.size();
+            result.workers = workers;
+            if (partitions.empty()) return result;
+
+            detail::ProgressTracker progress(context.progress, partitions.size() * context.metadata.sampleSize);
+
+            // Tempi per fase di ogni worker. parallelFor crea i thread a ogni
+            // livello, quindi qui non si aprono contatori hardware per thread.
+            vector<profiling::PhaseTimes> phases(workers);
+            detail::ExactDistinctCache localCache;
+            detail::ExactDistinctCache &cache = (context.exactDistinct != nullptr) ? *context.exactDistinct : localCache;
+
+            // Livello 0: uno sketch per partizione, costruiti in parallelo.
+            vector<MergeNode<Value, Algo>> nodes(partitions.size());
+            vector<optional<satp::dataset::PartitionReader>> readers(workers);
+            vector<vector<Value>> buffers(workers);
+            vector<vector<uint8_t>> truthBuffers(workers);
+            // Distinti di ogni foglia in ordine di stream: l'ordinamento (e la
+            // cache) restano fuori dal tempo del livello 0, che non dipende
+            // cosi' da cio' che la cache conteneva gia'.
+            vector<vector<Value>> leafDistinct(partitions.size());
+            const auto leafStart = Clock::now();
+            detail::parallelFor(partitions.size(), workers, [&](const size_t worker, const size_t i) {
+                if (!readers[worker].has_value()) {
+                    readers[worker].emplace(context.binaryDataset);
+                    readers[worker]->setPhaseTimes(&phases[worker]);
+                }
+                auto &values = buffers[worker];
+                readers[worker]->loadWithTruthBits(partitions[i], values, truthBuffers[worker]);
+                profiling::PhaseTimer ingestTimer(&phases[worker], profiling::Phase::Ingest);
+                Algo sketch = detail::makeAlgo<Algo>(context, ctorArgs...);
+                detail::ingestValues(sketch, values);
+                nodes[i].sketch.emplace(std::move(sketch));
+                ingestTimer.stop();
+                leafDistinct[i] = detail::ExactDistinctCache::firstOccurrences(values, truthBuffers[worker]);
+                progress.advance(values.size());
+            });
+            const double leafSeconds = chrono::duration<double>(Clock::now() - leafStart).count();
+            detail::parallelFor(partitions.size(), workers, [&](size_t, const size_t i) {
+                nodes[i].exact = cache.sortedDistinct(partitions[i], std::move(leafDistinct[i]));
+                nodes[i].exactSize = nodes[i].exact->size();
+            });
+            leafDistinct.clear();
+            appendLevel(result, nodes, 0u, leafSeconds, workers, phases);
+
+            if (options.topology == MergeTopology::BalancedTree) {
+                // Ogni livello fonde le coppie adiacenti (2j, 2j+1) in parallelo;
+                // un nodo dispari passa al livello successivo invariato.
+                while (nodes.size() > 1u) {
+                    const size_t merges = nodes.size() / 2u;
+                    const auto levelStart = Clock::now();
+                    detail::parallelFor(merges, workers, [&](const size_t worker, const size_t j) {
+                        const profiling::PhaseTimer mergeTimer(&phases[worker], profiling::Phase::Merge);
+                        nodes[2u * j].sketch->merge(*nodes[2u * j + 1u].sketch);
+                    });
+                    const double levelSeconds = chrono::duration<double>(Clock::now() - levelStart).count();
+
+                    detail::parallelFor(merges, workers, [&](size_t, const size_t j) {
+                        nodes[2u * j].exact = unionOf(*nodes[2u * j].exact, *nodes[2u * j + 1u].exact);
+                        nodes[2u * j].exactSize = nodes[2u * j].exact->size();
+                    });
+                    vector<MergeNode<Value, Algo>> next;
+                    next.reserve(merges + 1u);
+                    for (size_t j = 0; j < nodes.size(); j += 2u) {
+                        next.push_back(std::move(nodes[j]));
+                    }
+                    nodes = std::move(next);
+                    appendLevel(result, nodes, merges, levelSeconds, workers, phases);
+                }
+            } else {
+                // Catena left-deep: l'accumulatore assorbe una partizione per livello.
+                // La sua unione esatta vive in `accumulated` e cresce per fusione
+                // in `scratch` con swap, senza riallocare a ogni livello; ogni
+                // foglia viene rilasciata appena assorbita.
+                vector<MergeNode<Value, Algo>> accumulator(1);
+                accumulator[0] = std::move(nodes[0]);
+                vector<Value> accumulated(accumulator[0].exact->begin(), accumulator[0].exact->end());
+                accumulator[0].exact.reset();
+                vector<Value> scratch;
+                for (size_t i = 1; i < nodes.size(); ++i) {
+                    const auto levelStart = Clock::now();
+                    profiling::PhaseTimer mergeTimer(&phases[0], profiling::Phase::Merge);
+                    accumulator[0].sketch->merge(*nodes[i].sketch);
+                    mergeTimer.stop();
+                    const double levelSeconds = chrono::duration<double>(Clock::now() - levelStart).count();
+
+                    scratch.clear();
+                    const size_t bound = accumulated.size() + nodes[i].exactSize;
+                    if (scratch.capacity() < bound) scratch.reserve(max(bound, 2u * scratch.capacity()));
+                    ranges::set_union(accumulated, *nodes[i].exact, back_inserter(scratch));
+                    accumulated.swap(scratch);
+                    accumulator[0].exactSize = accumulated.size();
+                    nodes[i] = {};
+                    appendLevel(result, accumulator, 1u, levelSeconds, 1u, phases);
+                }
+            }
+
+            profiling::PhaseTimes total;
+            for (const auto &workerPhases : phases) total += workerPhases;
+            detail::publishTiming(context.diagnostics, total, evaluationStart, partitions.size(),
+                                  static_cast<uint64_t>(partitions.size()) * context.metadata.sampleSize);
+            progress.finish();
+            return result;
+        }
+    } // namespace
+
+    template<typename Algo, typename... Args>
+    MergeTopologyResult evaluate(const detail::EvaluationContext &context,
+                                 const MergeTopologyOptions &options,
+                                 Args &&... ctorArgs) {
+        static_assert(detail::MergeableAlgorithm<Algo>,
+                      "merge_topology::evaluate requires Algo::merge(const Algo&)");
+
+        if (options.topology != MergeTopology::BalancedTree &&
+            options.topology != MergeTopology::LeftDeepChain) {
+            throw invalid_argument("merge topology engine supports balanced_tree and left_deep_chain only");
+        }
+        if (hasEmptyDataset(context.metadata)) return {};
+        if (detail::hasWideKeys(context)) {
+            return evaluateTopology<uint64_t, Algo>(context, options, std::forward<Args>(ctorArgs)...);
+        }
+        return evaluateTopology<uint32_t, Algo>(context, options, std::forward<Args>(ctorArgs)...);
+    }
+} // namespace satp::evaluation::modes::merge_topology
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+namespace satp::evaluation {
+    struct AllocationStats {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+
+        AllocationStats &operator+=(const AllocationStats &other) noexcept {
+            allocations += other.allocations;
+            bytes += other.bytes;
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Contatori delle allocazioni su heap del thread corrente.
+     *
+     * Li alimenta un hook globale di operator new (tests/support/AllocationHook.cpp,
+     * linkato nei test e, con SATP_COUNT_ALLOCATIONS, nella CLI). Senza hook
+     * installed() e' false e i contatori restano a zero: i valutatori riportano
+     * le allocazioni solo quando sono misurate davvero.
+     */
+    class AllocationCounter {
+    public:
+        static void record(const size_t bytes) noexcept {
+            ++current_.allocations;
+            current_.bytes += bytes;
+        }
+
+        [[nodiscard]] static AllocationStats current() noexcept {
+            return current_;
+        }
+
+        static void markInstalled() noexcept {
+            installed_.store(true, memory_order_relaxed);
+        }
+
+        [[nodiscard]] static bool installed() noexcept {
+            return installed_.load(memory_order_relaxed);
+        }
+
+    private:
+        static inline thread_local AllocationStats current_{};
+        static inline atomic<bool> installed_{false};
+    };
+
+    // Allocazioni del thread corrente dalla costruzione dello scope.
+    class AllocationScope {
+    public:
+        AllocationScope() noexcept
+            : start_(AllocationCounter::current()) {
+        }
+
+        [[nodiscard]] AllocationStats elapsed() const noexcept {
+            const AllocationStats now = AllocationCounter::current();
+            return {now.allocations - start_.allocations, now.bytes - start_.bytes};
+        }
+
+    private:
+        AllocationStats start_;
+    };
+} // namespace satp::evaluation
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+#include "satp/simulation/detail/metrics/ErrorAccumulator.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    enum class StoppingMetric {
+        MeanRelativeError, // intervallo sull'errore relativo medio
+        Mean               // intervallo sulla stima media, relativo a \bar{F}_0
+    };
+
+    [[nodiscard]] inline string_view toString(const StoppingMetric metric) noexcept {
+        switch (metric) {
+            case StoppingMetric::MeanRelativeError: return "mre";
+            case StoppingMetric::Mean: return "mean";
+        }
+        return "unknown";
+    }
+
+    [[nodiscard]] inline optional<StoppingMetric> parseStoppingMetric(const string_view value) noexcept {
+        if (value == "mre") return StoppingMetric::MeanRelativeError;
+        if (value == "mean") return StoppingMetric::Mean;
+        return nullopt;
+    }
+
+    // Arresto anticipato della modalita' streaming: la valutazione si ferma
+    // quando l'intervallo di confidenza al 95% della metrica sull'ultimo
+    // checkpoint e' piu' stretto di targetWidth, dopo almeno minRuns run.
+    struct EarlyStoppingOptions {
+        double targetWidth = 0.0; // ampiezza totale dell'intervallo; 0 = disattivato
+        StoppingMetric metric = StoppingMetric::MeanRelativeError;
+        size_t minRuns = 10;
+
+        [[nodiscard]] bool enabled() const noexcept {
+            return targetWidth > 0.0;
+        }
+    };
+
+    // Ampiezza 2 z s / sqrt(n) dell'intervallo al 95% (approssimazione normale),
+    // dalla varianza campionaria gia' mantenuta da ErrorAccumulator.
+    [[nodiscard]] inline double confidenceWidth(const ErrorAccumulator &accumulator, const StoppingMetric metric) {
+        constexpr double Z_95 = 1.959963984540054;
+        const size_t runs = accumulator.runs();
+        if (runs < 2u) return numeric_limits<double>::infinity();
+
+        const double n = static_cast<double>(runs);
+        if (metric == StoppingMetric::Mean) {
+            const Stats stats = accumulator.toStats();
+            if (stats.truth_mean == 0.0) return numeric_limits<double>::infinity();
+            return 2.0 * Z_95 * sqrt(stats.variance / n) / stats.truth_mean;
+        }
+        return 2.0 * Z_95 * sqrt(accumulator.relativeErrorVariance() / n);
+    }
+
+    [[nodiscard]] inline bool hasConverged(const EarlyStoppingOptions &options, const ErrorAccumulator &accumulator) {
+        return options.enabled()
+               && accumulator.runs() >= options.minRuns
+               && confidenceWidth(accumulator, options.metric) <= options.targetWidth;
+    }
+} // namespace satp::evaluation
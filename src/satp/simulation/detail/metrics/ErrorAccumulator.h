@@ -2,7 +2,12 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
 
+#include "satp/simulation/detail/metrics/KllSketch.h"
+#include "satp/simulation/detail/metrics/StateCodec.h"
 #include "satp/simulation/detail/metrics/Statistics.h"
 
 using namespace std;
@@ -10,6 +15,14 @@ using namespace std;
 namespace satp::evaluation {
     class ErrorAccumulator {
     public:
+        ErrorAccumulator() = default;
+
+        // Con trackQuantiles l'errore relativo di ogni run alimenta anche uno
+        // sketch KLL, per i quantili p50/p95/p99 senza conservare le stime.
+        explicit ErrorAccumulator(const bool trackQuantiles) {
+            if (trackQuantiles) relativeErrors_.emplace();
+        }
+
         void add(double estimate, double truth) {
             ++count_;
 
@@ -23,11 +36,58 @@ namespace satp::evaluation {
             const double err = estimate - truth;
             absErrSum_ += abs(err);
             sqErrSum_ += err * err;
+            // Un run con truth = 0 contribuisce errore relativo nullo, come in absRelErrSum_.
+            const double relErr = (truth > 0.0) ? (abs(err) / truth) : 0.0;
             if (truth > 0.0) {
-                absRelErrSum_ += abs(err) / truth;
+                absRelErrSum_ += relErr;
+                if (relativeErrors_.has_value()) relativeErrors_->add(relErr);
+            }
+            const double relDelta = relErr - relErrMean_;
+            relErrMean_ += relDelta / static_cast<double>(count_);
+            relErrM2_ += relDelta * (relErr - relErrMean_);
+        }
+
+        // Byte occupati dallo sketch al checkpoint (Algorithm::memoryBytes), mediati sui run.
+        void addBytes(const double bytes) noexcept {
+            bytesSum_ += bytes;
+            ++bytesCount_;
+        }
+
+        // Unisce gli accumulatori di due insiemi disgiunti di run (es. due
+        // worker): momenti con la formula di Chan, somme e sketch dei quantili.
+        void merge(const ErrorAccumulator &other) {
+            if (other.count_ == 0) return;
+
+            const double n = static_cast<double>(count_);
+            const double m = static_cast<double>(other.count_);
+            const double delta = other.estimateMean_ - estimateMean_;
+            count_ += other.count_;
+            estimateMean_ += delta * m / (n + m);
+            estimateM2_ += other.estimateM2_ + delta * delta * n * m / (n + m);
+            const double relDelta = other.relErrMean_ - relErrMean_;
+            relErrMean_ += relDelta * m / (n + m);
+            relErrM2_ += other.relErrM2_ + relDelta * relDelta * n * m / (n + m);
+            truthSum_ += other.truthSum_;
+            absErrSum_ += other.absErrSum_;
+            sqErrSum_ += other.sqErrSum_;
+            absRelErrSum_ += other.absRelErrSum_;
+            bytesSum_ += other.bytesSum_;
+            bytesCount_ += other.bytesCount_;
+            if (relativeErrors_.has_value() && other.relativeErrors_.has_value()) {
+                relativeErrors_->merge(*other.relativeErrors_);
             }
         }
 
+        [[nodiscard]] size_t runs() const noexcept {
+            return count_;
+        }
+
+        // Varianza campionaria dell'errore relativo per run, la cui media e'
+        // mean_relative_error.
+        [[nodiscard]] double relativeErrorVariance() const noexcept {
+            return (count_ > 1) ? (relErrM2_ / static_cast<double>(count_ - 1)) : 0.0;
+        }
+
         [[nodiscard]] Stats toStats() const {
             if (count_ == 0) return {};
 
@@ -62,6 +122,7 @@ namespace satp::evaluation {
             const Stats stats = toStats();
             StreamingPointStats point{};
             point.number_of_elements_processed = elementIndex;
+            point.runs = count_;
             point.mean = stats.mean;
             point.variance = stats.variance;
             point.bias = stats.bias;
@@ -73,9 +134,53 @@ namespace satp::evaluation {
             point.stddev = stats.stddev;
             point.rse_observed = stats.rse_observed;
             point.truth_mean = stats.truth_mean;
+            if (bytesCount_ != 0u) point.bytes_mean = bytesSum_ / static_cast<double>(bytesCount_);
+            if (relativeErrors_.has_value() && relativeErrors_->count() != 0u) {
+                point.relative_error_p50 = relativeErrors_->quantile(0.50);
+                point.relative_error_p95 = relativeErrors_->quantile(0.95);
+                point.relative_error_p99 = relativeErrors_->quantile(0.99);
+            }
             return point;
         }
 
+        // Stato per il resume di una valutazione interrotta.
+        void writeState(detail::StateWriter &out) const {
+            out.u64(count_);
+            out.f64(estimateMean_);
+            out.f64(estimateM2_);
+            out.f64(truthSum_);
+            out.f64(absErrSum_);
+            out.f64(sqErrSum_);
+            out.f64(absRelErrSum_);
+            out.f64(relErrMean_);
+            out.f64(relErrM2_);
+            out.f64(bytesSum_);
+            out.u64(bytesCount_);
+            out.u64(relativeErrors_.has_value() ? 1u : 0u);
+            if (relativeErrors_.has_value()) relativeErrors_->writeState(out);
+        }
+
+        [[nodiscard]] static ErrorAccumulator readState(detail::StateReader &in) {
+            ErrorAccumulator accumulator;
+            accumulator.count_ = static_cast<size_t>(in.u64());
+            accumulator.estimateMean_ = in.f64();
+            accumulator.estimateM2_ = in.f64();
+            accumulator.truthSum_ = in.f64();
+            accumulator.absErrSum_ = in.f64();
+            accumulator.sqErrSum_ = in.f64();
+            accumulator.absRelErrSum_ = in.f64();
+            accumulator.relErrMean_ = in.f64();
+            accumulator.relErrM2_ = in.f64();
+            accumulator.bytesSum_ = in.f64();
+            accumulator.bytesCount_ = static_cast<size_t>(in.u64());
+            const uint64_t hasQuantiles = in.u64();
+            if (hasQuantiles > 1u) {
+                throw runtime_error("Stato ErrorAccumulator non valido");
+            }
+            if (hasQuantiles == 1u) accumulator.relativeErrors_ = KllSketch::readState(in);
+            return accumulator;
+        }
+
     private:
         size_t count_ = 0;
         double estimateMean_ = 0.0;
@@ -84,5 +189,10 @@ namespace satp::evaluation {
         double absErrSum_ = 0.0;
         double sqErrSum_ = 0.0;
         double absRelErrSum_ = 0.0;
+        double relErrMean_ = 0.0;
+        double relErrM2_ = 0.0;
+        double bytesSum_ = 0.0;
+        size_t bytesCount_ = 0;
+        optional<KllSketch> relativeErrors_;
     };
 } // namespace satp::evaluation
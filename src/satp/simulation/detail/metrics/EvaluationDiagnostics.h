@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "satp/profiling/PhaseTimer.h"
+#include "satp/profiling/ResourceUsage.h"
+#include "satp/simulation/detail/metrics/AllocationCounter.h"
+#include "satp/simulation/detail/metrics/SketchStatsSeries.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    // Costi dell'ultima valutazione, oltre all'accuratezza.
+    struct EvaluationDiagnostics {
+        // Allocazioni: il primo run (o la prima coppia di ogni worker) scalda
+        // sketch e buffer, i successivi dovrebbero non allocare.
+        bool allocationsTracked = false; // false senza hook: i contatori non sono significativi
+        size_t warmupRuns = 0;
+        size_t steadyRuns = 0;
+        AllocationStats warmup;
+        AllocationStats steadyState;
+
+        // Tempi (e, se richiesti, contatori hardware) per fase sommati su run e
+        // worker (nel merge parallelo la somma supera il tempo di parete) per
+        // timedRuns run, o coppie, che hanno letto `elements` valori dal dataset.
+        profiling::PhaseTimes phases;
+        chrono::nanoseconds wall{0};
+        size_t timedRuns = 0;
+        uint64_t elements = 0;
+        // Picco di RSS del processo a fine valutazione; 0 se non disponibile.
+        uint64_t peakRssBytes = 0;
+        // Contatori interni dello sketch per checkpoint (solo streaming, build
+        // con SATP_SKETCH_STATS); vuoto altrimenti.
+        vector<SketchStatsPoint> sketchStats;
+    };
+
+    namespace detail {
+        // Allocazioni per run raccolte per worker, senza sincronizzazione: il
+        // primo run di ogni worker e' di warm-up.
+        class RunAllocationTracker {
+        public:
+            explicit RunAllocationTracker(const size_t workers)
+                : workers_(workers) {
+            }
+
+            void add(const size_t worker, const AllocationStats &run) noexcept {
+                auto &slot = workers_[worker];
+                if (slot.runs++ == 0u) {
+                    slot.warmup += run;
+                } else {
+                    slot.steadyState += run;
+                }
+            }
+
+            void publish(EvaluationDiagnostics *out) const {
+                if (out == nullptr) return;
+                out->allocationsTracked = AllocationCounter::installed();
+                out->warmupRuns = 0;
+                out->steadyRuns = 0;
+                out->warmup = {};
+                out->steadyState = {};
+                for (const auto &slot : workers_) {
+                    if (slot.runs == 0u) continue;
+                    ++out->warmupRuns;
+                    out->steadyRuns += slot.runs - 1u;
+                    out->warmup += slot.warmup;
+                    out->steadyState += slot.steadyState;
+                }
+            }
+
+        private:
+            struct WorkerSlot {
+                size_t runs = 0;
+                AllocationStats warmup;
+                AllocationStats steadyState;
+            };
+
+            vector<WorkerSlot> workers_;
+        };
+
+        inline void publishTiming(EvaluationDiagnostics *out,
+                                  const profiling::PhaseTimes &phases,
+                                  const chrono::steady_clock::time_point start,
+                                  const size_t runs,
+                                  const uint64_t elements) {
+            if (out == nullptr) return;
+            out->phases = phases;
+            out->phases.counters = nullptr; // i contatori restano al thread che li ha aperti
+            out->wall = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+            out->timedRuns = runs;
+            out->elements = elements;
+            out->peakRssBytes = profiling::peakRssBytes();
+            out->sketchStats.clear();
+        }
+    } // namespace detail
+} // namespace satp::evaluation
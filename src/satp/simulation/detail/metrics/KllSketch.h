@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "satp/simulation/detail/metrics/StateCodec.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    // Sketch KLL (Karnin, Lang, Liberty) per quantili approssimati di double.
+    // Il livello h tiene campioni di peso 2^h; un livello pieno viene ordinato e
+    // meta' dei campioni (pari o dispari, a moneta) sale al livello successivo.
+    // La memoria resta O(k) e con k=200 l'errore di rango tipico e' sotto il 2%.
+    // La moneta e' deterministica: stessi input, stessi quantili. Finche' i
+    // campioni non riempiono il livello 0 i quantili sono esatti.
+    class KllSketch {
+    public:
+        static constexpr uint32_t DEFAULT_K = 200u;
+
+        explicit KllSketch(const uint32_t k = DEFAULT_K) : k_(k), levels_(1) {
+            if (k_ < MIN_LEVEL_CAPACITY) {
+                throw invalid_argument("KllSketch requires k >= 8");
+            }
+        }
+
+        void add(const double value) {
+            levels_[0].push_back(value);
+            ++count_;
+            if (levels_[0].size() >= levelCapacity(0u)) {
+                compress();
+            }
+        }
+
+        void merge(const KllSketch &other) {
+            if (k_ != other.k_) {
+                throw invalid_argument("KllSketch merge requires the same k");
+            }
+            if (levels_.size() < other.levels_.size()) {
+                levels_.resize(other.levels_.size());
+            }
+            for (size_t h = 0; h < other.levels_.size(); ++h) {
+                levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+            }
+            count_ += other.count_;
+            compress();
+        }
+
+        [[nodiscard]] uint64_t count() const noexcept {
+            return count_;
+        }
+
+        // q in [0, 1]; NaN se lo sketch e' vuoto.
+        [[nodiscard]] double quantile(const double q) const {
+            if (count_ == 0u) return numeric_limits<double>::quiet_NaN();
+
+            vector<pair<double, uint64_t>> weighted;
+            uint64_t totalWeight = 0;
+            for (size_t h = 0; h < levels_.size(); ++h) {
+                const uint64_t weight = uint64_t{1} << h;
+                for (const double value : levels_[h]) {
+                    weighted.emplace_back(value, weight);
+                    totalWeight += weight;
+                }
+            }
+            ranges::sort(weighted, {}, &pair<double, uint64_t>::first);
+
+            const double clamped = clamp(q, 0.0, 1.0);
+            const auto target = max<uint64_t>(1u, static_cast<uint64_t>(
+                ceil(clamped * static_cast<double>(totalWeight))));
+            uint64_t cumulative = 0;
+            for (const auto &[value, weight] : weighted) {
+                cumulative += weight;
+                if (cumulative >= target) return value;
+            }
+            return weighted.back().first;
+        }
+
+        // Stato completo, compresa la moneta: uno sketch riletto prosegue
+        // esattamente come l'originale.
+        void writeState(detail::StateWriter &out) const {
+            out.u64(k_);
+            out.u64(count_);
+            out.u64(coin_);
+            out.u64(levels_.size());
+            for (const auto &level : levels_) {
+                out.u64(level.size());
+                for (const double value : level) out.f64(value);
+            }
+        }
+
+        [[nodiscard]] static KllSketch readState(detail::StateReader &in) {
+            const uint64_t k = in.u64();
+            if (k > numeric_limits<uint32_t>::max()) {
+                throw runtime_error("Stato KllSketch non valido");
+            }
+            KllSketch sketch(static_cast<uint32_t>(k));
+            sketch.count_ = in.u64();
+            sketch.coin_ = in.u64();
+            sketch.levels_.resize(in.length(8u));
+            if (sketch.levels_.empty()) {
+                throw runtime_error("Stato KllSketch non valido");
+            }
+            for (auto &level : sketch.levels_) {
+                level.resize(in.length(8u));
+                for (double &value : level) value = in.f64();
+            }
+            return sketch;
+        }
+
+    private:
+        static constexpr size_t MIN_LEVEL_CAPACITY = 8u;
+
+        // Capacita' decrescenti di un fattore 2/3 scendendo dal livello piu' alto.
+        [[nodiscard]] size_t levelCapacity(const size_t level) const {
+            const auto depth = static_cast<double>(levels_.size() - 1u - level);
+            const auto capacity = static_cast<size_t>(ceil(static_cast<double>(k_) * pow(2.0 / 3.0, depth)));
+            return max(MIN_LEVEL_CAPACITY, capacity);
+        }
+
+        void compress() {
+            for (size_t h = 0; h < levels_.size(); ++h) {
+                if (levels_[h].size() < levelCapacity(h)) continue;
+                if (h + 1u == levels_.size()) levels_.emplace_back();
+                compactLevel(h);
+            }
+        }
+
+        void compactLevel(const size_t h) {
+            auto &level = levels_[h];
+            ranges::sort(level);
+            // Con un numero dispari di campioni il minimo resta al livello h.
+            const size_t keep = level.size() % 2u;
+            for (size_t i = keep + nextCoin(); i < level.size(); i += 2u) {
+                levels_[h + 1u].push_back(level[i]);
+            }
+            level.resize(keep);
+        }
+
+        [[nodiscard]] size_t nextCoin() noexcept {
+            coin_ ^= coin_ << 13u;
+            coin_ ^= coin_ >> 7u;
+            coin_ ^= coin_ << 17u;
+            return static_cast<size_t>(coin_ & 1u);
+        }
+
+        uint32_t k_;
+        uint64_t count_ = 0;
+        uint64_t coin_ = 0x9E3779B97F4A7C15ull;
+        vector<vector<double>> levels_;
+    };
+} // namespace satp::evaluation
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "satp/algorithms/SketchStats.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    // Contatori interni dello sketch a un checkpoint, mediati sui run (build
+    // con SATP_SKETCH_STATS).
+    struct SketchStatsPoint {
+        size_t number_of_elements_processed = 0;
+        size_t runs = 0;
+        double inserts_mean = 0.0;
+        double register_writes_mean = 0.0;
+        double noop_updates_mean = 0.0;
+        double noop_share = 0.0; // no-op sugli aggiornamenti dei registri
+        double sparse_flushes_mean = 0.0;
+        double flushed_entries_mean = 0.0;
+        double sparse_list_entries_mean = 0.0;
+        double converted_share = 0.0; // run gia' passati da sparse a normal
+        // Elementi inseriti al passaggio sparse -> normal, sui run convertiti; NaN se nessuno.
+        double conversion_elements_mean = numeric_limits<double>::quiet_NaN();
+        double merges_mean = 0.0;
+    };
+
+    namespace detail {
+        // Somme per checkpoint, allocate una volta per valutazione.
+        class SketchStatsSeries {
+        public:
+            explicit SketchStatsSeries(const vector<size_t> &checkpointPositions)
+                : positions_(checkpointPositions), totals_(checkpointPositions.size()) {
+            }
+
+            void add(const size_t checkpointIndex, const algorithms::SketchStats &stats) noexcept {
+                auto &total = totals_[checkpointIndex];
+                ++total.runs;
+                total.inserts += stats.inserts;
+                total.registerWrites += stats.registerWrites;
+                total.noOpUpdates += stats.noOpUpdates;
+                total.sparseFlushes += stats.sparseFlushes;
+                total.flushedEntries += stats.flushedEntries;
+                total.sparseListEntries += stats.sparseListEntries;
+                total.merges += stats.merges;
+                if (stats.converted) {
+                    ++total.convertedRuns;
+                    total.convertedAtInsert += stats.convertedAtInsert;
+                }
+            }
+
+            [[nodiscard]] vector<SketchStatsPoint> points() const {
+                vector<SketchStatsPoint> out;
+                out.reserve(totals_.size());
+                for (size_t i = 0; i < totals_.size(); ++i) {
+                    const auto &total = totals_[i];
+                    if (total.runs == 0u) continue;
+                    const auto runs = static_cast<double>(total.runs);
+                    const uint64_t updates = total.registerWrites + total.noOpUpdates;
+                    SketchStatsPoint point;
+                    point.number_of_elements_processed = positions_[i];
+                    point.runs = total.runs;
+                    point.inserts_mean = static_cast<double>(total.inserts) / runs;
+                    point.register_writes_mean = static_cast<double>(total.registerWrites) / runs;
+                    point.noop_updates_mean = static_cast<double>(total.noOpUpdates) / runs;
+                    point.noop_share = (updates != 0u)
+                                           ? static_cast<double>(total.noOpUpdates) / static_cast<double>(updates)
+                                           : 0.0;
+                    point.sparse_flushes_mean = static_cast<double>(total.sparseFlushes) / runs;
+                    point.flushed_entries_mean = static_cast<double>(total.flushedEntries) / runs;
+                    point.sparse_list_entries_mean = static_cast<double>(total.sparseListEntries) / runs;
+                    point.converted_share = static_cast<double>(total.convertedRuns) / runs;
+                    if (total.convertedRuns != 0u) {
+                        point.conversion_elements_mean = static_cast<double>(total.convertedAtInsert)
+                                                         / static_cast<double>(total.convertedRuns);
+                    }
+                    point.merges_mean = static_cast<double>(total.merges) / runs;
+                    out.push_back(point);
+                }
+                return out;
+            }
+
+        private:
+            struct Totals {
+                size_t runs = 0;
+                uint64_t inserts = 0;
+                uint64_t registerWrites = 0;
+                uint64_t noOpUpdates = 0;
+                uint64_t sparseFlushes = 0;
+                uint64_t flushedEntries = 0;
+                uint64_t sparseListEntries = 0;
+                size_t convertedRuns = 0;
+                uint64_t convertedAtInsert = 0;
+                uint64_t merges = 0;
+            };
+
+            const vector<size_t> &positions_;
+            vector<Totals> totals_;
+        };
+    } // namespace detail
+} // namespace satp::evaluation
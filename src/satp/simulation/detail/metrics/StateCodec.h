@@ -0,0 +1,72 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "satp/dataset/detail/binary/Endian.h"
+
+using namespace std;
+
+namespace satp::evaluation::detail {
+    // Codifica little-endian dello stato degli accumulatori. I double passano
+    // per bit_cast, quindi uno stato riletto riproduce bit per bit i risultati.
+    class StateWriter {
+    public:
+        void u64(const uint64_t value) {
+            const size_t offset = bytes_.size();
+            bytes_.resize(offset + 8u);
+            dataset::detail::writeU64LE(bytes_.data() + offset, value);
+        }
+
+        void f64(const double value) {
+            u64(bit_cast<uint64_t>(value));
+        }
+
+        [[nodiscard]] const vector<uint8_t> &bytes() const noexcept {
+            return bytes_;
+        }
+
+    private:
+        vector<uint8_t> bytes_;
+    };
+
+    class StateReader {
+    public:
+        StateReader(const uint8_t *data, const size_t size) : data_(data), size_(size) {
+        }
+
+        [[nodiscard]] uint64_t u64() {
+            if (size_ - offset_ < 8u) {
+                throw runtime_error("Stato serializzato troncato");
+            }
+            const uint64_t value = dataset::detail::readU64LE(data_ + offset_);
+            offset_ += 8u;
+            return value;
+        }
+
+        [[nodiscard]] double f64() {
+            return bit_cast<double>(u64());
+        }
+
+        // Conteggio di elementi che seguono, ciascuno di almeno minBytes byte.
+        [[nodiscard]] size_t length(const size_t minBytes) {
+            const uint64_t value = u64();
+            if (value > (size_ - offset_) / max<size_t>(minBytes, 1u)) {
+                throw runtime_error("Stato serializzato troncato");
+            }
+            return static_cast<size_t>(value);
+        }
+
+        [[nodiscard]] bool exhausted() const noexcept {
+            return offset_ == size_;
+        }
+
+    private:
+        const uint8_t *data_;
+        size_t size_;
+        size_t offset_ = 0;
+    };
+} // namespace satp::evaluation::detail
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -21,6 +24,7 @@ namespace satp::evaluation {
 
     struct StreamingPointStats {
         size_t number_of_elements_processed = 0; // 1-based index t
+        size_t runs = 0; // run accumulati; < metadata.runs con l'arresto anticipato
         double mean = 0.0; // \bar{\hat{F}_0(t)}
         double variance = 0.0;
         double bias = 0.0;
@@ -32,6 +36,19 @@ namespace satp::evaluation {
         double stddev = 0.0;
         double rse_observed = 0.0;
         double truth_mean = 0.0; // \bar{F_0(t)}
+        // Quantili dell'errore relativo |\hat{F}_0(t) - F_0(t)| / F_0(t) sui run;
+        // NaN se i quantili non sono abilitati.
+        double relative_error_p50 = numeric_limits<double>::quiet_NaN();
+        double relative_error_p95 = numeric_limits<double>::quiet_NaN();
+        double relative_error_p99 = numeric_limits<double>::quiet_NaN();
+        // Algorithm::memoryBytes() medio al checkpoint; NaN se lo sketch non lo espone.
+        double bytes_mean = numeric_limits<double>::quiet_NaN();
+    };
+
+    // Serie streaming di uno stimatore di evaluateStreamingEstimators.
+    struct EstimatorStreamingSeries {
+        string estimator; // CardinalityEstimator::id()
+        vector<StreamingPointStats> series;
     };
 
     struct MergePairPoint {
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <cmath>
 #include <filesystem>
+#include <string_view>
 #include <vector>
 
+#include "satp/profiling/TraceSink.h"
+#include "satp/simulation/detail/latency/LatencyTypes.h"
 #include "satp/simulation/detail/merge/HeterogeneousMergeTypes.h"
+#include "satp/simulation/detail/merge/MergeTopologyTypes.h"
+#include "satp/simulation/detail/metrics/EvaluationDiagnostics.h"
 #include "satp/simulation/detail/metrics/Statistics.h"
 #include "satp/simulation/detail/results/csv/CsvField.h"
 #include "satp/simulation/detail/results/csv/CsvFile.h"
@@ -19,7 +26,14 @@ namespace satp::evaluation {
             "algorithm,params,mode,runs,sample_size,number_of_elements_processed,f0,seed,"
             "f0_mean_t,f0_hat_mean_t,"
             "variance,stddev,rse_theoretical,rse_observed,bias,absolute_bias,relative_bias,"
-            "mean_relative_error,rmse,mae";
+            "mean_relative_error,rmse,mae,bytes_mean";
+        // STREAMING_HEADER piu' i quantili dell'errore relativo (setStreamingErrorQuantiles).
+        static constexpr const char *STREAMING_QUANTILES_HEADER =
+            "algorithm,params,mode,runs,sample_size,number_of_elements_processed,f0,seed,"
+            "f0_mean_t,f0_hat_mean_t,"
+            "variance,stddev,rse_theoretical,rse_observed,bias,absolute_bias,relative_bias,"
+            "mean_relative_error,rmse,mae,bytes_mean,"
+            "relative_error_p50,relative_error_p95,relative_error_p99";
         static constexpr const char *MERGE_HEADER =
             "algorithm,params,mode,pairs,sample_size,pair_index,seed,"
             "estimate_merge,estimate_serial,delta_merge_serial_abs,delta_merge_serial_rel";
@@ -31,20 +45,69 @@ namespace satp::evaluation {
             "error_merge_abs_exact,error_merge_rel_exact,"
             "error_serial_abs_exact,error_serial_rel_exact,"
             "baseline_homogeneous,delta_vs_baseline";
+        static constexpr const char *MERGE_TOPOLOGY_HEADER =
+            "algorithm,params,mode,topology,partitions,sample_size,seed,workers,"
+            "level,merges,nodes,wall_seconds,"
+            "exact_union_mean,estimate_mean,drift_rel_mean,drift_rel_max";
+        // Una riga per fase misurata piu' "total" sul tempo di parete; share e'
+        // la quota della fase sulla somma delle fasi, elements_per_s usa i
+        // valori letti dal dataset, peak_rss_bytes e' il picco del processo a
+        // fine job.
+        static constexpr const char *TIMING_HEADER =
+            "algorithm,params,mode,runs,sample_size,seed,"
+            "phase,calls,seconds,seconds_per_run,share,elements_per_s,peak_rss_bytes";
+        // Una riga per operazione misurata da evaluateLatency; i quantili sono
+        // la latenza di una misura (un batch per process) in nanosecondi,
+        // late_batches e' significativo solo con target_rate.
+        static constexpr const char *LATENCY_HEADER =
+            "algorithm,params,mode,runs,sample_size,seed,operation,batch,target_rate,calls,"
+            "p50_ns,p90_ns,p99_ns,p999_ns,max_ns,mean_ns,timer_overhead_ns,late_batches";
+        // Contatori interni dello sketch per checkpoint (build con
+        // SATP_SKETCH_STATS); conversion_elements_mean vuoto senza passaggi
+        // sparse -> normal.
+        static constexpr const char *SKETCH_STATS_HEADER =
+            "algorithm,params,mode,runs,sample_size,number_of_elements_processed,seed,"
+            "inserts_mean,register_writes_mean,noop_updates_mean,noop_share,"
+            "sparse_flushes_mean,flushed_entries_mean,sparse_list_entries_mean,"
+            "converted_share,conversion_elements_mean,merges_mean";
+        // TIMING_HEADER piu' i contatori hardware (setHardwareCounters); celle
+        // vuote per i contatori non misurati.
+        static constexpr const char *TIMING_COUNTERS_HEADER =
+            "algorithm,params,mode,runs,sample_size,seed,"
+            "phase,calls,seconds,seconds_per_run,share,elements_per_s,peak_rss_bytes,"
+            "cycles,instructions,ipc,l1d_misses,llc_misses,branch_misses,"
+            "cycles_per_element,l1d_misses_per_element,llc_misses_per_element,branch_misses_per_element";
 
         static void appendStreaming(const filesystem::path &csvPath,
                                     const CsvRunDescriptor &descriptor,
-                                    const vector<StreamingPointStats> &series) {
-            ofstream out = csv::openAppend(csvPath, STREAMING_HEADER, "Impossibile aprire il file CSV");
+                                    const vector<StreamingPointStats> &series,
+                                    const bool withErrorQuantiles = false) {
+            const profiling::TraceSpan span("csv_streaming", "output");
+            ofstream out = csv::openAppend(
+                csvPath,
+                withErrorQuantiles ? STREAMING_QUANTILES_HEADER : STREAMING_HEADER,
+                "Impossibile aprire il file CSV");
             for (const auto &point : series) {
-                writeSummaryRecord(out, descriptor, "streaming", point.number_of_elements_processed,
+                // Con l'arresto anticipato la colonna runs riporta i run usati.
+                const size_t runs = (point.runs != 0u) ? point.runs : descriptor.metadata.runs;
+                writeSummaryRecord(out, descriptor, "streaming", runs, point.number_of_elements_processed,
                                    point.truth_mean, point);
+                // Vuota per gli sketch senza memoryBytes() e le serie ri-stimate.
+                out << ',';
+                if (!isnan(point.bytes_mean)) out << point.bytes_mean;
+                if (withErrorQuantiles) {
+                    out << ',' << point.relative_error_p50
+                        << ',' << point.relative_error_p95
+                        << ',' << point.relative_error_p99;
+                }
+                out << '\n';
             }
         }
 
         static void appendMergePairs(const filesystem::path &csvPath,
                                      const CsvRunDescriptor &descriptor,
                                      const vector<MergePairPoint> &points) {
+            const profiling::TraceSpan span("csv_merge", "output");
             ofstream out = csv::openAppend(csvPath, MERGE_HEADER, "Impossibile aprire il file CSV merge");
             const size_t pairCount = points.size();
             for (const auto &point : points) {
@@ -55,6 +118,7 @@ namespace satp::evaluation {
         static void appendHeterogeneousMergePairs(const filesystem::path &csvPath,
                                                   const HeterogeneousMergeCsvDescriptor &descriptor,
                                                   const vector<HeterogeneousMergePoint> &points) {
+            const profiling::TraceSpan span("csv_merge_heterogeneous", "output");
             ofstream out = csv::openAppend(
                 csvPath,
                 HETEROGENEOUS_MERGE_HEADER,
@@ -65,18 +129,170 @@ namespace satp::evaluation {
             }
         }
 
+        static void appendMergeTopology(const filesystem::path &csvPath,
+                                        const CsvRunDescriptor &descriptor,
+                                        const MergeTopologyResult &result) {
+            const profiling::TraceSpan span("csv_merge_topology", "output");
+            ofstream out = csv::openAppend(csvPath, MERGE_TOPOLOGY_HEADER, "Impossibile aprire il file CSV merge topology");
+            for (const auto &level : result.levels) {
+                writeMergeTopologyRecord(out, descriptor, result, level);
+            }
+        }
+
+        static void appendTiming(const filesystem::path &csvPath,
+                                 const CsvRunDescriptor &descriptor,
+                                 const char *mode,
+                                 const EvaluationDiagnostics &diagnostics,
+                                 const bool withHardwareCounters = false) {
+            if (diagnostics.timedRuns == 0u) return;
+            const profiling::TraceSpan span("csv_timing", "output");
+            ofstream out = csv::openAppend(
+                csvPath,
+                withHardwareCounters ? TIMING_COUNTERS_HEADER : TIMING_HEADER,
+                "Impossibile aprire il file CSV timing");
+            chrono::nanoseconds phaseTotal{0};
+            for (size_t i = 0; i < profiling::PHASE_COUNT; ++i) {
+                phaseTotal += diagnostics.phases.elapsed(static_cast<profiling::Phase>(i));
+            }
+            for (size_t i = 0; i < profiling::PHASE_COUNT; ++i) {
+                const auto phase = static_cast<profiling::Phase>(i);
+                if (diagnostics.phases.calls[i] == 0u) continue;
+                writeTimingRecord(out, descriptor, mode, diagnostics, profiling::phaseName(phase),
+                                  diagnostics.phases.calls[i], diagnostics.phases.elapsed(phase), phaseTotal);
+                if (withHardwareCounters) writeCounterFields(out, diagnostics, diagnostics.phases.counted(phase));
+                out << '\n';
+            }
+            writeTimingRecord(out, descriptor, mode, diagnostics, "total",
+                              diagnostics.timedRuns, diagnostics.wall, phaseTotal);
+            if (withHardwareCounters) writeCounterFields(out, diagnostics, diagnostics.phases.totalCounted());
+            out << '\n';
+        }
+
+        static void appendLatency(const filesystem::path &csvPath,
+                                  const CsvRunDescriptor &descriptor,
+                                  const LatencyResult &result) {
+            const profiling::TraceSpan span("csv_latency", "output");
+            ofstream out = csv::openAppend(csvPath, LATENCY_HEADER, "Impossibile aprire il file CSV latency");
+            for (const auto &point : result.operations) {
+                out << csv::escapeCsvField(descriptor.algorithmName) << ','
+                    << csv::escapeCsvField(descriptor.algorithmParams) << ','
+                    << "latency" << ','
+                    << result.runs << ','
+                    << descriptor.metadata.sampleSize << ','
+                    << descriptor.metadata.seed << ','
+                    << toString(point.operation) << ','
+                    << ((point.operation == LatencyOperation::Process) ? result.batch : 1u) << ','
+                    << result.target_rate << ','
+                    << point.calls << ','
+                    << point.p50_ns << ','
+                    << point.p90_ns << ','
+                    << point.p99_ns << ','
+                    << point.p999_ns << ','
+                    << point.max_ns << ','
+                    << point.mean_ns << ','
+                    << result.timer_overhead_ns << ','
+                    << result.late_batches << '\n';
+            }
+        }
+
+        static void appendSketchStats(const filesystem::path &csvPath,
+                                      const CsvRunDescriptor &descriptor,
+                                      const char *mode,
+                                      const vector<SketchStatsPoint> &points) {
+            if (points.empty()) return;
+            const profiling::TraceSpan span("csv_sketch_stats", "output");
+            ofstream out = csv::openAppend(csvPath, SKETCH_STATS_HEADER, "Impossibile aprire il file CSV sketch stats");
+            for (const auto &point : points) {
+                out << csv::escapeCsvField(descriptor.algorithmName) << ','
+                    << csv::escapeCsvField(descriptor.algorithmParams) << ','
+                    << mode << ','
+                    << point.runs << ','
+                    << descriptor.metadata.sampleSize << ','
+                    << point.number_of_elements_processed << ','
+                    << descriptor.metadata.seed << ','
+                    << point.inserts_mean << ','
+                    << point.register_writes_mean << ','
+                    << point.noop_updates_mean << ','
+                    << point.noop_share << ','
+                    << point.sparse_flushes_mean << ','
+                    << point.flushed_entries_mean << ','
+                    << point.sparse_list_entries_mean << ','
+                    << point.converted_share << ',';
+                if (!isnan(point.conversion_elements_mean)) out << point.conversion_elements_mean;
+                out << ',' << point.merges_mean << '\n';
+            }
+        }
+
     private:
+        static void writeTimingRecord(ofstream &out,
+                                      const CsvRunDescriptor &descriptor,
+                                      const char *mode,
+                                      const EvaluationDiagnostics &diagnostics,
+                                      const string_view phase,
+                                      const uint64_t calls,
+                                      const chrono::nanoseconds elapsed,
+                                      const chrono::nanoseconds phaseTotal) {
+            const double seconds = chrono::duration<double>(elapsed).count();
+            const double share = (phaseTotal.count() > 0)
+                                     ? static_cast<double>(elapsed.count()) / static_cast<double>(phaseTotal.count())
+                                     : 0.0;
+            const double elementsPerSecond = (seconds > 0.0)
+                                                 ? static_cast<double>(diagnostics.elements) / seconds
+                                                 : 0.0;
+            out << csv::escapeCsvField(descriptor.algorithmName) << ','
+                << csv::escapeCsvField(descriptor.algorithmParams) << ','
+                << mode << ','
+                << diagnostics.timedRuns << ','
+                << descriptor.metadata.sampleSize << ','
+                << descriptor.metadata.seed << ','
+                << phase << ','
+                << calls << ','
+                << seconds << ','
+                << seconds / static_cast<double>(diagnostics.timedRuns) << ','
+                << share << ','
+                << elementsPerSecond << ','
+                << diagnostics.peakRssBytes;
+        }
+
+        static void writeCounterFields(ofstream &out,
+                                       const EvaluationDiagnostics &diagnostics,
+                                       const profiling::CounterValues &values) {
+            using profiling::HardwareCounter;
+            const auto raw = [&](const HardwareCounter counter) {
+                out << ',';
+                if (values.has(counter)) out << values.get(counter);
+            };
+            const auto perElement = [&](const HardwareCounter counter) {
+                out << ',';
+                if (values.has(counter) && diagnostics.elements != 0u) {
+                    out << static_cast<double>(values.get(counter)) / static_cast<double>(diagnostics.elements);
+                }
+            };
+            raw(HardwareCounter::Cycles);
+            raw(HardwareCounter::Instructions);
+            out << ',';
+            if (values.has(HardwareCounter::Cycles) && values.has(HardwareCounter::Instructions)) out << values.ipc();
+            raw(HardwareCounter::L1dMisses);
+            raw(HardwareCounter::LlcMisses);
+            raw(HardwareCounter::BranchMisses);
+            perElement(HardwareCounter::Cycles);
+            perElement(HardwareCounter::L1dMisses);
+            perElement(HardwareCounter::LlcMisses);
+            perElement(HardwareCounter::BranchMisses);
+        }
+
         template<typename Point>
         static void writeSummaryRecord(ofstream &out,
                                        const CsvRunDescriptor &descriptor,
                                        const char *mode,
+                                       const size_t runs,
                                        const size_t elementIndex,
                                        const double truthMean,
                                        const Point &point) {
             out << csv::escapeCsvField(descriptor.algorithmName) << ','
                 << csv::escapeCsvField(descriptor.algorithmParams) << ','
                 << mode << ','
-                << descriptor.metadata.runs << ','
+                << runs << ','
                 << descriptor.metadata.sampleSize << ','
                 << elementIndex << ','
                 << descriptor.metadata.distinctCount << ','
@@ -92,7 +308,7 @@ namespace satp::evaluation {
                 << point.relative_bias << ','
                 << point.mean_relative_error << ','
                 << point.rmse << ','
-                << point.mae << '\n';
+                << point.mae;
         }
 
         static void writeMergeRecord(ofstream &out,
@@ -141,5 +357,27 @@ namespace satp::evaluation {
                 << point.baseline_homogeneous << ','
                 << point.delta_vs_baseline << '\n';
         }
+
+        static void writeMergeTopologyRecord(ofstream &out,
+                                             const CsvRunDescriptor &descriptor,
+                                             const MergeTopologyResult &result,
+                                             const MergeTopologyLevel &level) {
+            out << csv::escapeCsvField(descriptor.algorithmName) << ','
+                << csv::escapeCsvField(descriptor.algorithmParams) << ','
+                << "merge_topology,"
+                << toString(result.topology) << ','
+                << result.partitions << ','
+                << descriptor.metadata.sampleSize << ','
+                << descriptor.metadata.seed << ','
+                << result.workers << ','
+                << level.level << ','
+                << level.merges << ','
+                << level.nodes << ','
+                << level.wall_seconds << ','
+                << level.exact_union_mean << ','
+                << level.estimate_mean << ','
+                << level.drift_rel_mean << ','
+                << level.drift_rel_max << '\n';
+        }
     };
 } // namespace satp::evaluation
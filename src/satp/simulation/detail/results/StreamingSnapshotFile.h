@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "satp/dataset/detail/binary/Endian.h"
+#include "satp/simulation/detail/framework/EvaluationMetadata.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    // Intestazione di un file di snapshot: dataset di origine, run scritti e
+    // posizioni dei checkpoint.
+    struct StreamingSnapshotHeader {
+        EvaluationMetadata metadata;
+        vector<size_t> checkpointPositions;
+    };
+
+    // Stato dello sketch di un run a un checkpoint, con F0(t) esatto.
+    struct StreamingSnapshotRecord {
+        size_t run = 0;
+        size_t checkpointIndex = 0;
+        uint64_t truth = 0;
+        vector<uint8_t> state;
+    };
+
+    // Snapshot dello stato degli sketch a ogni checkpoint di ogni run, per
+    // rieseguire stimatori diversi senza reingerire il dataset. Little-endian:
+    //   header  "SATPSNAP", u32 version, u32 reserved, u64 runs, u64 sample_size,
+    //           u64 f0, u64 seed, u64 checkpoints, u64 position per checkpoint
+    //   record  u64 truth, u32 state_len, state (saveState dell'algoritmo)
+    // I record seguono l'ordine run per run, checkpoint per checkpoint. runs
+    // viene scritto da finish(): un file interrotto risulta senza run.
+    class StreamingSnapshotWriter {
+    public:
+        static constexpr array<char, 8> MAGIC{'S', 'A', 'T', 'P', 'S', 'N', 'A', 'P'};
+        static constexpr uint32_t VERSION = 1u;
+        static constexpr size_t HEADER_BYTES = 56u;
+        static constexpr size_t RUNS_OFFSET = 16u;
+
+        StreamingSnapshotWriter(const filesystem::path &snapshotPath,
+                                const EvaluationMetadata &metadata,
+                                const vector<size_t> &checkpointPositions)
+            : out_(snapshotPath, ios::binary | ios::trunc) {
+            if (!out_) {
+                throw runtime_error("Impossibile aprire il file di snapshot");
+            }
+            vector<uint8_t> header(HEADER_BYTES + (8u * checkpointPositions.size()));
+            ranges::copy(MAGIC, header.begin());
+            dataset::detail::writeU32LE(header.data() + 8u, VERSION);
+            dataset::detail::writeU32LE(header.data() + 12u, 0u);
+            dataset::detail::writeU64LE(header.data() + RUNS_OFFSET, 0u);
+            dataset::detail::writeU64LE(header.data() + 24u, metadata.sampleSize);
+            dataset::detail::writeU64LE(header.data() + 32u, metadata.distinctCount);
+            dataset::detail::writeU64LE(header.data() + 40u, metadata.seed);
+            dataset::detail::writeU64LE(header.data() + 48u, checkpointPositions.size());
+            for (size_t i = 0; i < checkpointPositions.size(); ++i) {
+                dataset::detail::writeU64LE(header.data() + HEADER_BYTES + (8u * i), checkpointPositions[i]);
+            }
+            write(header);
+        }
+
+        void add(const uint64_t truth, const span<const uint8_t> state) {
+            array<uint8_t, 12> prefix{};
+            dataset::detail::writeU64LE(prefix.data(), truth);
+            dataset::detail::writeU32LE(prefix.data() + 8u, static_cast<uint32_t>(state.size()));
+            write(prefix);
+            write(state);
+        }
+
+        void finish(const size_t runs) {
+            array<uint8_t, 8> encoded{};
+            dataset::detail::writeU64LE(encoded.data(), runs);
+            out_.seekp(static_cast<streamoff>(RUNS_OFFSET));
+            write(encoded);
+            out_.flush();
+            if (!out_) {
+                throw runtime_error("Scrittura del file di snapshot fallita");
+            }
+        }
+
+    private:
+        void write(const span<const uint8_t> bytes) {
+            out_.write(reinterpret_cast<const char *>(bytes.data()), static_cast<streamsize>(bytes.size()));
+        }
+
+        ofstream out_;
+    };
+
+    class StreamingSnapshotReader {
+    public:
+        explicit StreamingSnapshotReader(const filesystem::path &snapshotPath)
+            : in_(snapshotPath, ios::binary) {
+            if (!in_) {
+                throw runtime_error("Impossibile aprire il file di snapshot");
+            }
+            array<uint8_t, StreamingSnapshotWriter::HEADER_BYTES> header{};
+            read(header);
+            if (!ranges::equal(StreamingSnapshotWriter::MAGIC, span(header).first(8u),
+                               [](const char a, const uint8_t b) { return static_cast<uint8_t>(a) == b; })) {
+                throw runtime_error("File di snapshot non valido: magic errato");
+            }
+            if (dataset::detail::readU32LE(header.data() + 8u) != StreamingSnapshotWriter::VERSION) {
+                throw runtime_error("File di snapshot non valido: versione non supportata");
+            }
+            header_.metadata.runs = dataset::detail::toSizeTChecked(
+                dataset::detail::readU64LE(header.data() + 16u), "runs");
+            header_.metadata.sampleSize = dataset::detail::toSizeTChecked(
+                dataset::detail::readU64LE(header.data() + 24u), "sample_size");
+            header_.metadata.distinctCount = dataset::detail::toSizeTChecked(
+                dataset::detail::readU64LE(header.data() + 32u), "f0");
+            header_.metadata.seed = static_cast<uint32_t>(dataset::detail::readU64LE(header.data() + 40u));
+            const size_t checkpoints = dataset::detail::toSizeTChecked(
+                dataset::detail::readU64LE(header.data() + 48u), "checkpoints");
+            if (checkpoints > header_.metadata.sampleSize) {
+                throw runtime_error("File di snapshot non valido: troppi checkpoint");
+            }
+            vector<uint8_t> positions(8u * checkpoints);
+            read(positions);
+            header_.checkpointPositions.resize(checkpoints);
+            for (size_t i = 0; i < checkpoints; ++i) {
+                header_.checkpointPositions[i] = dataset::detail::readU64LE(positions.data() + (8u * i));
+            }
+        }
+
+        [[nodiscard]] const StreamingSnapshotHeader &header() const noexcept {
+            return header_;
+        }
+
+        // Legge il record successivo riusando record.state; false a fine file.
+        bool next(StreamingSnapshotRecord &record) {
+            const size_t checkpoints = header_.checkpointPositions.size();
+            if (checkpoints == 0u || nextIndex_ >= header_.metadata.runs * checkpoints) {
+                return false;
+            }
+            array<uint8_t, 12> prefix{};
+            read(prefix);
+            record.run = nextIndex_ / checkpoints;
+            record.checkpointIndex = nextIndex_ % checkpoints;
+            record.truth = dataset::detail::readU64LE(prefix.data());
+            record.state.resize(dataset::detail::readU32LE(prefix.data() + 8u));
+            read(record.state);
+            ++nextIndex_;
+            return true;
+        }
+
+    private:
+        void read(const span<uint8_t> bytes) {
+            in_.read(reinterpret_cast<char *>(bytes.data()), static_cast<streamsize>(bytes.size()));
+            if (in_.gcount() != static_cast<streamsize>(bytes.size())) {
+                throw runtime_error("File di snapshot troncato");
+            }
+        }
+
+        ifstream in_;
+        StreamingSnapshotHeader header_;
+        size_t nextIndex_ = 0;
+    };
+} // namespace satp::evaluation
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "satp/dataset/detail/binary/Endian.h"
+#include "satp/simulation/detail/metrics/Statistics.h"
+#include "satp/simulation/detail/results/csv/CsvRunDescriptor.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    // Una serie streaming letta da un trace binario.
+    struct StreamingTrace {
+        CsvRunDescriptor descriptor;
+        vector<StreamingPointStats> series;
+    };
+
+    // Trace binario compatto della modalita' streaming, pensato per budget di
+    // checkpoint densi (fino a ogni elemento) dove il CSV diventa ingestibile.
+    // Il file e' una sequenza di trace little-endian, uno per append:
+    //   header  "SATPSTRM", u32 version, u32 record_fields,
+    //           u64 runs (usati), u64 sample_size, u64 f0, u64 seed, f64 rse_theoretical,
+    //           u64 points, u32 name_len, u32 params_len, name, params
+    //   record  u64 t, f64 f0_mean_t, f0_hat_mean_t, variance, bias,
+    //           mean_relative_error, rmse, mae
+    // stddev, absolute_bias, relative_bias e rse_observed si ricavano dai campi
+    // registrati con le stesse formule di ErrorAccumulator.
+    class StreamingTraceFile {
+    public:
+        static constexpr array<char, 8> MAGIC{'S', 'A', 'T', 'P', 'S', 'T', 'R', 'M'};
+        static constexpr uint32_t VERSION = 1u;
+        static constexpr uint32_t RECORD_FIELDS = 7u;
+        static constexpr size_t RECORD_BYTES = 8u + (8u * RECORD_FIELDS);
+
+        static void append(const filesystem::path &tracePath,
+                           const CsvRunDescriptor &descriptor,
+                           const vector<StreamingPointStats> &series) {
+            ofstream out(tracePath, ios::binary | ios::app);
+            if (!out) {
+                throw runtime_error("Impossibile aprire il trace binario");
+            }
+
+            vector<uint8_t> header(HEADER_BYTES);
+            ranges::copy(MAGIC, header.begin());
+            dataset::detail::writeU32LE(header.data() + 8u, VERSION);
+            dataset::detail::writeU32LE(header.data() + 12u, RECORD_FIELDS);
+            const size_t runs = (!series.empty() && series.front().runs != 0u)
+                                    ? series.front().runs
+                                    : descriptor.metadata.runs;
+            dataset::detail::writeU64LE(header.data() + 16u, runs);
+            dataset::detail::writeU64LE(header.data() + 24u, descriptor.metadata.sampleSize);
+            dataset::detail::writeU64LE(header.data() + 32u, descriptor.metadata.distinctCount);
+            dataset::detail::writeU64LE(header.data() + 40u, descriptor.metadata.seed);
+            dataset::detail::writeU64LE(header.data() + 48u, bit_cast<uint64_t>(descriptor.rseTheoretical));
+            dataset::detail::writeU64LE(header.data() + 56u, series.size());
+            dataset::detail::writeU32LE(header.data() + 64u, static_cast<uint32_t>(descriptor.algorithmName.size()));
+            dataset::detail::writeU32LE(header.data() + 68u, static_cast<uint32_t>(descriptor.algorithmParams.size()));
+            writeBytes(out, header);
+            out.write(descriptor.algorithmName.data(), static_cast<streamsize>(descriptor.algorithmName.size()));
+            out.write(descriptor.algorithmParams.data(), static_cast<streamsize>(descriptor.algorithmParams.size()));
+
+            vector<uint8_t> records(series.size() * RECORD_BYTES);
+            for (size_t i = 0; i < series.size(); ++i) {
+                const auto &point = series[i];
+                uint8_t *record = records.data() + (i * RECORD_BYTES);
+                dataset::detail::writeU64LE(record, point.number_of_elements_processed);
+                const array<double, RECORD_FIELDS> fields{
+                    point.truth_mean,
+                    point.mean,
+                    point.variance,
+                    point.bias,
+                    point.mean_relative_error,
+                    point.rmse,
+                    point.mae
+                };
+                for (size_t f = 0; f < fields.size(); ++f) {
+                    dataset::detail::writeU64LE(record + 8u + (8u * f), bit_cast<uint64_t>(fields[f]));
+                }
+            }
+            writeBytes(out, records);
+            if (!out) {
+                throw runtime_error("Scrittura del trace binario fallita");
+            }
+        }
+
+        [[nodiscard]] static vector<StreamingTrace> read(const filesystem::path &tracePath) {
+            ifstream in(tracePath, ios::binary);
+            if (!in) {
+                throw runtime_error("Impossibile aprire il trace binario");
+            }
+
+            vector<StreamingTrace> traces;
+            vector<uint8_t> header(HEADER_BYTES);
+            while (in.peek() != char_traits<char>::eof()) {
+                readBytes(in, header);
+                if (!ranges::equal(MAGIC, span(header).first(MAGIC.size()),
+                                   [](const char a, const uint8_t b) { return static_cast<uint8_t>(a) == b; })) {
+                    throw runtime_error("Trace binario non valido: magic errato");
+                }
+                if (dataset::detail::readU32LE(header.data() + 8u) != VERSION ||
+                    dataset::detail::readU32LE(header.data() + 12u) != RECORD_FIELDS) {
+                    throw runtime_error("Trace binario non valido: versione non supportata");
+                }
+
+                StreamingTrace trace;
+                trace.descriptor.metadata.runs = dataset::detail::readU64LE(header.data() + 16u);
+                trace.descriptor.metadata.sampleSize = dataset::detail::readU64LE(header.data() + 24u);
+                trace.descriptor.metadata.distinctCount = dataset::detail::readU64LE(header.data() + 32u);
+                trace.descriptor.metadata.seed =
+                    static_cast<uint32_t>(dataset::detail::readU64LE(header.data() + 40u));
+                trace.descriptor.rseTheoretical = bit_cast<double>(dataset::detail::readU64LE(header.data() + 48u));
+                const uint64_t points = dataset::detail::readU64LE(header.data() + 56u);
+                trace.descriptor.algorithmName.resize(dataset::detail::readU32LE(header.data() + 64u));
+                trace.descriptor.algorithmParams.resize(dataset::detail::readU32LE(header.data() + 68u));
+                in.read(trace.descriptor.algorithmName.data(),
+                        static_cast<streamsize>(trace.descriptor.algorithmName.size()));
+                in.read(trace.descriptor.algorithmParams.data(),
+                        static_cast<streamsize>(trace.descriptor.algorithmParams.size()));
+                if (!in) {
+                    throw runtime_error("Trace binario troncato");
+                }
+
+                vector<uint8_t> records(
+                    dataset::detail::toSizeTChecked(points, "points") * RECORD_BYTES);
+                readBytes(in, records);
+                trace.series.reserve(points);
+                for (size_t i = 0; i < points; ++i) {
+                    trace.series.push_back(decodeRecord(records.data() + (i * RECORD_BYTES)));
+                    trace.series.back().runs = trace.descriptor.metadata.runs;
+                }
+                traces.push_back(std::move(trace));
+            }
+            return traces;
+        }
+
+    private:
+        static constexpr size_t HEADER_BYTES = 72u;
+
+        static void writeBytes(ofstream &out, const vector<uint8_t> &bytes) {
+            out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<streamsize>(bytes.size()));
+        }
+
+        static void readBytes(ifstream &in, vector<uint8_t> &bytes) {
+            in.read(reinterpret_cast<char *>(bytes.data()), static_cast<streamsize>(bytes.size()));
+            if (in.gcount() != static_cast<streamsize>(bytes.size())) {
+                throw runtime_error("Trace binario troncato");
+            }
+        }
+
+        [[nodiscard]] static double readF64(const uint8_t *bytes) {
+            return bit_cast<double>(dataset::detail::readU64LE(bytes));
+        }
+
+        [[nodiscard]] static StreamingPointStats decodeRecord(const uint8_t *record) {
+            StreamingPointStats point{};
+            point.number_of_elements_processed = dataset::detail::readU64LE(record);
+            point.truth_mean = readF64(record + 8u);
+            point.mean = readF64(record + 16u);
+            point.variance = readF64(record + 24u);
+            point.bias = readF64(record + 32u);
+            point.mean_relative_error = readF64(record + 40u);
+            point.rmse = readF64(record + 48u);
+            point.mae = readF64(record + 56u);
+            point.stddev = sqrt(point.variance);
+            point.absolute_bias = abs(point.bias);
+            point.relative_bias = (point.truth_mean != 0.0) ? (point.bias / point.truth_mean) : 0.0;
+            point.rse_observed = (point.truth_mean != 0.0) ? (point.stddev / point.truth_mean) : 0.0;
+            return point;
+        }
+    };
+} // namespace satp::evaluation
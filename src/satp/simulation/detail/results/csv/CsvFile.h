@@ -4,17 +4,30 @@
 #include <fstream>
 #include <iomanip>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 
 using namespace std;
 
 namespace satp::evaluation::csv {
+    // Su un file gia' popolato l'intestazione deve coincidere con quella
+    // attesa: accodare righe con un altro schema (versione precedente o
+    // variante con colonne in piu') disallineerebbe le colonne.
     inline void writeHeaderIfNeeded(const filesystem::path &csvPath,
                                     ofstream &out,
                                     const string_view header) {
         const bool shouldWriteHeader = !filesystem::exists(csvPath) || filesystem::file_size(csvPath) == 0u;
         if (shouldWriteHeader) {
             out << header << '\n';
+            return;
+        }
+        ifstream in(csvPath);
+        string existing;
+        getline(in, existing);
+        if (!existing.empty() && existing.back() == '\r') existing.pop_back();
+        if (existing != header) {
+            throw runtime_error("Intestazione CSV incompatibile in " + csvPath.string() +
+                                ": atteso \"" + string(header) + "\", trovato \"" + existing + "\"");
         }
     }
 
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "satp/algorithms/Estimators.h"
+#include "satp/algorithms/RegisterView.h"
+#include "satp/simulation/detail/framework/ParallelExecution.h"
+#include "satp/simulation/detail/metrics/ErrorAccumulator.h"
+#include "satp/simulation/detail/metrics/Statistics.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    struct RegisterSimulationOptions {
+        uint32_t precision = 10;      // m = 2^precision registri
+        uint32_t hashBits = 32;       // L di HyperLogLog/LogLog, 64 per HyperLogLog++
+        vector<size_t> cardinalities; // checkpoint F0(t), strettamente crescenti (es. CheckpointPlanner::build)
+        size_t runs = 100;
+        uint64_t seed = 0;
+        size_t workers = 0;           // 0 = hardware_concurrency
+        bool errorQuantiles = false;
+    };
+
+    /**
+     * @brief Registri di uno sketch della famiglia LogLog campionati senza dati.
+     *
+     * Con hash ideali, n inserimenti distinti distribuiscono i conteggi dei
+     * bucket come una multinomiale(n, 1/m) e il registro di un bucket con c
+     * elementi e' il massimo di c rho geometrici troncati a q + 1:
+     * P(M <= r) = (1 - 2^{-r})^c per r <= q. addDistinct(n) campiona
+     * esattamente questa legge in O(m), indipendentemente da n; checkpoint
+     * successivi aggiungono solo gli elementi nuovi, come nello streaming.
+     */
+    class RegisterSimulator {
+    public:
+        RegisterSimulator(const uint32_t precision, const uint32_t hashBits, const uint64_t seed)
+            : precision_(precision),
+              hashBits_(hashBits),
+              registers_(size_t{1} << checkedPrecision(precision, hashBits), 0u),
+              rng_(seed) {}
+
+        // Aggiunge `count` elementi distinti mai visti.
+        void addDistinct(const size_t count) {
+            // Multinomiale come catena di binomiali: il bucket j riceve
+            // Bin(restanti, 1 / (m - j)) degli elementi non ancora assegnati.
+            uint64_t remaining = count;
+            const size_t m = registers_.size();
+            for (size_t j = 0; j < m && remaining != 0u; ++j) {
+                uint64_t c = remaining;
+                if (j + 1u < m) {
+                    binomial_distribution<uint64_t> bucket(remaining, 1.0 / static_cast<double>(m - j));
+                    c = bucket(rng_);
+                }
+                if (c == 0u) continue;
+                registers_[j] = max(registers_[j], sampleMaxRho(c));
+                remaining -= c;
+            }
+        }
+
+        [[nodiscard]] algorithms::RegisterView view() const {
+            return {precision_, hashBits_, registers_};
+        }
+
+        [[nodiscard]] span<const uint8_t> registers() const noexcept {
+            return registers_;
+        }
+
+    private:
+        [[nodiscard]] static uint32_t checkedPrecision(const uint32_t precision, const uint32_t hashBits) {
+            if (precision == 0u || precision > 30u || precision >= hashBits || hashBits > 64u) {
+                throw invalid_argument("RegisterSimulator requires 0 < precision <= 30 and precision < hashBits <= 64");
+            }
+            return precision;
+        }
+
+        // Inversione della CDF del massimo: il piu' piccolo r con
+        // (1 - 2^{-r})^c >= u, cioe' r = ceil(-log2(1 - u^{1/c})).
+        [[nodiscard]] uint8_t sampleMaxRho(const uint64_t count) {
+            const uint32_t maxRho = (hashBits_ - precision_) + 1u;
+            const double u = uniform_(rng_);
+            const double tail = -expm1(log(u) / static_cast<double>(count));
+            if (!(tail > 0.0)) return static_cast<uint8_t>(maxRho);
+            const double r = ceil(-log2(tail));
+            return static_cast<uint8_t>(clamp(r, 1.0, static_cast<double>(maxRho)));
+        }
+
+        uint32_t precision_;
+        uint32_t hashBits_;
+        vector<uint8_t> registers_;
+        mt19937_64 rng_;
+        uniform_real_distribution<double> uniform_{0.0, 1.0};
+    };
+
+    // Serie streaming di ogni stimatore su stati dei registri simulati: stessa
+    // forma di evaluateStreamingEstimators, con F0(t) = cardinalities[i] e
+    // costo O(runs * checkpoints * m) indipendente dalla cardinalita'. Utile per
+    // curve di accuratezza a n = 10^9..10^12 che l'ingestione reale non
+    // raggiunge; il modello assume hash ideali (nessuna collisione oltre al
+    // troncamento dei registri a q + 1).
+    [[nodiscard]] inline vector<EstimatorStreamingSeries> simulateRegisterStreaming(
+        const RegisterSimulationOptions &options,
+        const vector<const algorithms::CardinalityEstimator *> &estimators) {
+        if (estimators.empty() || ranges::find(estimators, nullptr) != estimators.end()) {
+            throw invalid_argument("simulateRegisterStreaming requires at least one non-null estimator");
+        }
+        const auto &cardinalities = options.cardinalities;
+        for (size_t i = 0; i < cardinalities.size(); ++i) {
+            if (cardinalities[i] == 0u || (i > 0u && cardinalities[i] <= cardinalities[i - 1u])) {
+                throw invalid_argument("simulateRegisterStreaming requires strictly increasing cardinalities > 0");
+            }
+        }
+        // Valida precision e hashBits prima di avviare i worker.
+        static_cast<void>(RegisterSimulator(options.precision, options.hashBits, options.seed));
+
+        const size_t checkpoints = cardinalities.size();
+        const size_t width = estimators.size();
+        const size_t workers = detail::resolveWorkerCount(options.workers);
+        // Stime per run, accumulate poi in ordine di run: parziali per worker
+        // dipenderebbero da quali run tocca a ciascuno, e la fusione in
+        // virgola mobile ne porterebbe traccia nelle medie.
+        const size_t slots = width * checkpoints;
+        vector<double> estimates(options.runs * slots);
+
+        detail::parallelFor(options.runs, workers, [&](size_t, const size_t run) {
+            // Il seed dipende solo dal run, non dal worker che lo esegue.
+            seed_seq seq{
+                static_cast<uint32_t>(options.seed), static_cast<uint32_t>(options.seed >> 32u),
+                static_cast<uint32_t>(run), static_cast<uint32_t>(static_cast<uint64_t>(run) >> 32u)
+            };
+            array<uint32_t, 2> runSeed{};
+            seq.generate(runSeed.begin(), runSeed.end());
+            RegisterSimulator simulator(options.precision,
+                                        options.hashBits,
+                                        (static_cast<uint64_t>(runSeed[0]) << 32u) | runSeed[1]);
+
+            double *runEstimates = estimates.data() + (run * slots);
+            size_t inserted = 0;
+            for (size_t i = 0; i < checkpoints; ++i) {
+                simulator.addDistinct(cardinalities[i] - inserted);
+                inserted = cardinalities[i];
+                const auto view = simulator.view();
+                for (size_t column = 0; column < width; ++column) {
+                    runEstimates[(column * checkpoints) + i] = estimators[column]->estimate(view);
+                }
+            }
+        });
+
+        vector<ErrorAccumulator> merged(slots, ErrorAccumulator(options.errorQuantiles));
+        for (size_t run = 0; run < options.runs; ++run) {
+            const double *runEstimates = estimates.data() + (run * slots);
+            for (size_t column = 0; column < width; ++column) {
+                for (size_t i = 0; i < checkpoints; ++i) {
+                    const size_t slot = (column * checkpoints) + i;
+                    merged[slot].add(runEstimates[slot], static_cast<double>(cardinalities[i]));
+                }
+            }
+        }
+
+        vector<EstimatorStreamingSeries> results(width);
+        for (size_t column = 0; column < width; ++column) {
+            results[column].estimator = string(estimators[column]->id());
+            if (options.runs == 0u) continue;
+            results[column].series.reserve(checkpoints);
+            for (size_t i = 0; i < checkpoints; ++i) {
+                results[column].series.push_back(
+                    merged[(column * checkpoints) + i].toStreamingPoint(cardinalities[i]));
+            }
+        }
+        return results;
+    }
+} // namespace satp::evaluation
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "satp/simulation/detail/framework/EvaluationMetadata.h"
+#include "satp/simulation/detail/framework/SketchFactory.h"
+#include "satp/simulation/detail/metrics/ErrorAccumulator.h"
+#include "satp/simulation/detail/metrics/Statistics.h"
+#include "satp/simulation/detail/results/StreamingSnapshotFile.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    struct ReestimationResult {
+        EvaluationMetadata metadata; // del dataset di origine, runs = run negli snapshot
+        vector<StreamingPointStats> series;
+    };
+
+    // Rilegge gli snapshot di evaluateStreaming e stima ogni stato con
+    // `sketch`, senza toccare il dataset: la serie ha la forma di quella di
+    // evaluateStreaming. Con lo stesso algoritmo e parametri le stime coincidono;
+    // uno sketch diverso ma compatibile (es. LogLog su registri HyperLogLog)
+    // prova un altro stimatore sugli stessi stati.
+    template<typename Algo>
+    [[nodiscard]] ReestimationResult reestimateStreaming(const filesystem::path &snapshotPath,
+                                                         Algo &sketch,
+                                                         const bool errorQuantiles = false) {
+        static_assert(detail::SnapshotAlgorithm<Algo>,
+                      "reestimateStreaming requires Algo::saveState/loadState");
+
+        StreamingSnapshotReader reader(snapshotPath);
+        const auto &header = reader.header();
+        vector<ErrorAccumulator> accumulators(header.checkpointPositions.size(), ErrorAccumulator(errorQuantiles));
+
+        StreamingSnapshotRecord record;
+        while (reader.next(record)) {
+            sketch.loadState(record.state);
+            accumulators[record.checkpointIndex].add(
+                static_cast<double>(sketch.count()),
+                static_cast<double>(record.truth));
+        }
+
+        ReestimationResult result{header.metadata, {}};
+        if (header.metadata.runs == 0u) return result;
+        result.series.reserve(accumulators.size());
+        for (size_t i = 0; i < accumulators.size(); ++i) {
+            result.series.push_back(accumulators[i].toStreamingPoint(header.checkpointPositions[i]));
+        }
+        return result;
+    }
+} // namespace satp::evaluation
@@ -1,69 +1,303 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "satp/algorithms/Estimators.h"
+
 #include "satp/simulation/detail/framework/EvaluationContext.h"
 #include "satp/simulation/detail/framework/SketchFactory.h"
 #include "satp/simulation/detail/framework/DatasetTraversal.h"
 #include "satp/simulation/detail/framework/EvaluationMetadata.h"
+#include "satp/simulation/detail/framework/ProgressTracker.h"
 #include "satp/simulation/detail/metrics/ErrorAccumulator.h"
+#include "satp/simulation/detail/results/StreamingSnapshotFile.h"
 #include "satp/simulation/detail/streaming/CheckpointPlanner.h"
+#include "satp/simulation/detail/streaming/StreamingResumeState.h"
 
 using namespace std;
 
 namespace satp::evaluation::modes::streaming {
-    template<typename Algo, typename... Args>
-    vector<StreamingPointStats> evaluate(const detail::EvaluationContext &context,
-                                         Args &&... ctorArgs) {
-        if (hasEmptyDataset(context.metadata)) return {};
+    namespace {
+        constexpr size_t PROGRESS_BATCH = 1u << 16;
+
+        // Stime di un checkpoint: una per colonna di accumulatori.
+        struct CountProbe {
+            [[nodiscard]] size_t width() const noexcept {
+                return 1u;
+            }
+
+            [[nodiscard]] vector<string_view> ids() const {
+                return {};
+            }
 
-        const auto checkpointPositions = CheckpointPlanner::build(
-            context.metadata.sampleSize,
-            EvaluationFramework::DEFAULT_STREAMING_CHECKPOINTS);
+            template<typename Algo>
+            void observe(Algo &algo, const span<double> estimates) const {
+                estimates[0] = static_cast<double>(algo.count());
+            }
+        };
+
+        // Tutti gli stimatori sulla stessa vista dei registri, costruita una volta.
+        struct EstimatorProbe {
+            const vector<const algorithms::CardinalityEstimator *> &estimators;
 
-        detail::startProgress(context.progress, context.metadata.runs * context.metadata.sampleSize);
-        satp::dataset::PartitionReader reader(context.binaryDataset);
+            [[nodiscard]] size_t width() const noexcept {
+                return estimators.size();
+            }
 
-        vector<ErrorAccumulator> accumulators(checkpointPositions.size());
-        vector<uint32_t> partitionValues;
-        vector<uint8_t> partitionTruthBits;
+            [[nodiscard]] vector<string_view> ids() const {
+                vector<string_view> out;
+                out.reserve(estimators.size());
+                for (const auto *estimator : estimators) out.push_back(estimator->id());
+                return out;
+            }
 
-        for (size_t run = 0; run < context.metadata.runs; ++run) {
-            reader.loadWithTruthBits(run, partitionValues, partitionTruthBits);
-            detail::validateStreamingPartition(partitionValues, partitionTruthBits, context.metadata.sampleSize);
+            template<typename Algo>
+            void observe(const Algo &algo, const span<double> estimates) const {
+                const auto view = algo.registerView();
+                for (size_t i = 0; i < estimators.size(); ++i) {
+                    estimates[i] = estimators[i]->estimate(view);
+                }
+            }
+        };
 
-            Algo algo = detail::makeAlgo<Algo>(context, std::forward<Args>(ctorArgs)...);
-            uint64_t truthPrefix = 0;
-            size_t checkpointIndex = 0;
+        // Punti per colonna: l'accumulatore della colonna e del checkpoint i
+        // e' in posizione column * checkpoints + i.
+        template<typename Value, typename Algo, typename Probe, typename... Args>
+        vector<StreamingPointStats> evaluatePartitions(const detail::EvaluationContext &context,
+                                                       const Probe &probe,
+                                                       Args &&... ctorArgs) {
+            const auto checkpointPositions = CheckpointPlanner::build(
+                context.metadata.sampleSize,
+                context.streamingCheckpoints);
 
-            for (size_t t = 0; t < context.metadata.sampleSize; ++t) {
-                algo.process(partitionValues[t]);
+            const profiling::TraceSpan evaluationSpan("streaming", "evaluation");
+            const auto evaluationStart = chrono::steady_clock::now();
+            profiling::PhaseTimes phases;
+            optional<profiling::PerfCounters> counters;
+            if (context.hardwareCounters) {
+                counters.emplace();
+                phases.counters = &*counters;
+            }
+            detail::ProgressTracker progress(context.progress, context.metadata.runs * context.metadata.sampleSize);
+            satp::dataset::PartitionReader reader(context.binaryDataset);
+            reader.setPhaseTimes(&phases);
 
-                const bool isNew = detail::truthBitIsSet(partitionTruthBits, t);
-                if (isNew) {
-                    ++truthPrefix;
+            // I run sono indipendenti e accumulati in ordine: riprendere da
+            // uno stato salvato da' gli stessi punti di una valutazione intera.
+            const bool resumable = !context.streamingResumeState.empty();
+            StreamingResumeState state;
+            state.fingerprint = StreamingResumeFile::fingerprint(
+                context.metadata,
+                checkpointPositions,
+                context.streamingErrorQuantiles,
+                context.streamingEarlyStopping,
+                probe.ids());
+            optional<StreamingResumeState> saved;
+            if (resumable) {
+                saved = StreamingResumeFile::load(context.streamingResumeState, state.fingerprint);
+            }
+            if (saved.has_value()) {
+                if (saved->completedRuns > context.metadata.runs
+                    || saved->accumulators.size() != checkpointPositions.size() * probe.width()) {
+                    throw runtime_error("Stato di resume non valido: avanzamento incoerente");
                 }
+                state = std::move(*saved);
+                progress.advance(state.completedRuns * context.metadata.sampleSize);
+            } else {
+                state.accumulators.assign(checkpointPositions.size() * probe.width(),
+                                          ErrorAccumulator(context.streamingErrorQuantiles));
+            }
+            auto &accumulators = state.accumulators;
+            auto lastSave = chrono::steady_clock::now();
 
-                const size_t elementIndex = t + 1u;
-                if (checkpointIndex < checkpointPositions.size()
-                    && elementIndex == checkpointPositions[checkpointIndex]) {
-                    accumulators[checkpointIndex].add(
-                        static_cast<double>(algo.count()),
-                        static_cast<double>(truthPrefix));
-                    ++checkpointIndex;
+            // Il criterio guarda l'ultimo checkpoint, quello a fine stream, di ogni colonna.
+            const size_t checkpoints = checkpointPositions.size();
+            const auto converged = [&]() {
+                if (accumulators.empty()) return false;
+                for (size_t column = 0; column < probe.width(); ++column) {
+                    if (!hasConverged(context.streamingEarlyStopping,
+                                      accumulators[(column * checkpoints) + checkpoints - 1u])) {
+                        return false;
+                    }
                 }
+                return true;
+            };
+            bool stopped = converged();
 
-                detail::advanceProgress(context.progress);
+            optional<StreamingSnapshotWriter> snapshots;
+            vector<uint8_t> snapshotState;
+            if (!context.streamingSnapshotFile.empty()) {
+                if (!detail::SnapshotAlgorithm<Algo>) {
+                    throw invalid_argument("Gli snapshot richiedono un algoritmo con saveState/loadState");
+                }
+                // Un file di snapshot parziale non si puo' completare da uno stato di resume.
+                if (resumable) {
+                    throw invalid_argument("Snapshot e resume non sono combinabili");
+                }
+                snapshots.emplace(context.streamingSnapshotFile, context.metadata, checkpointPositions);
             }
+
+            vector<Value> partitionValues;
+            vector<uint8_t> partitionTruthBits;
+            vector<double> estimates(probe.width());
+            optional<Algo> sketch;
+            detail::RunAllocationTracker allocations(1u);
+            detail::SketchStatsSeries sketchStats(checkpointPositions);
+            const size_t firstRun = state.completedRuns;
+
+            for (size_t run = state.completedRuns; run < context.metadata.runs && !stopped; ++run) {
+                const profiling::TraceSpan runSpan("run", "streaming");
+                const AllocationScope runAllocations;
+                reader.loadWithTruthBits(run, partitionValues, partitionTruthBits);
+                detail::validateStreamingPartition(partitionValues, partitionTruthBits, context.metadata.sampleSize);
+
+                Algo &algo = detail::reuseSketch(sketch, [&] { return detail::makeAlgo<Algo>(context, ctorArgs...); });
+                uint64_t truthPrefix = 0;
+                size_t checkpointIndex = 0;
+
+                // Ingest e' il ciclo meno i checkpoint: niente orologio per elemento.
+                const auto checkpointTime = phases.elapsed(profiling::Phase::Estimate)
+                                            + phases.elapsed(profiling::Phase::Output);
+                profiling::CounterValues checkpointCounted = phases.counted(profiling::Phase::Estimate);
+                checkpointCounted += phases.counted(profiling::Phase::Output);
+                const auto ingestCounters = phases.sampleCounters();
+                const auto ingestStart = chrono::steady_clock::now();
+
+                // Il progresso e' pubblicato a blocchi, fuori dal ciclo per elemento.
+                for (size_t batchStart = 0; batchStart < context.metadata.sampleSize; batchStart += PROGRESS_BATCH) {
+                    const size_t batchEnd = min(context.metadata.sampleSize, batchStart + PROGRESS_BATCH);
+                    for (size_t t = batchStart; t < batchEnd; ++t) {
+                        algo.process(partitionValues[t]);
+
+                        const bool isNew = detail::truthBitIsSet(partitionTruthBits, t);
+                        if (isNew) {
+                            ++truthPrefix;
+                        }
+
+                        const size_t elementIndex = t + 1u;
+                        if (checkpointIndex < checkpointPositions.size()
+                            && elementIndex == checkpointPositions[checkpointIndex]) {
+                            profiling::PhaseTimer estimateTimer(&phases, profiling::Phase::Estimate);
+                            probe.observe(algo, estimates);
+                            estimateTimer.stop();
+                            for (size_t column = 0; column < estimates.size(); ++column) {
+                                accumulators[(column * checkpoints) + checkpointIndex].add(
+                                    estimates[column],
+                                    static_cast<double>(truthPrefix));
+                            }
+                            if constexpr (detail::MemoryReportingSketch<Algo>) {
+                                const auto bytes = static_cast<double>(algo.memoryBytes());
+                                for (size_t column = 0; column < estimates.size(); ++column) {
+                                    accumulators[(column * checkpoints) + checkpointIndex].addBytes(bytes);
+                                }
+                            }
+                            if constexpr (detail::StatsReportingSketch<Algo>) {
+                                sketchStats.add(checkpointIndex, algo.stats());
+                            }
+                            if constexpr (detail::SnapshotAlgorithm<Algo>) {
+                                if (snapshots.has_value()) {
+                                    const profiling::PhaseTimer outputTimer(&phases, profiling::Phase::Output);
+                                    snapshotState.clear();
+                                    algo.saveState(snapshotState);
+                                    snapshots->add(truthPrefix, snapshotState);
+                                }
+                            }
+                            ++checkpointIndex;
+                        }
+                    }
+                    progress.advance(batchEnd - batchStart);
+                }
+                const auto loopElapsed = chrono::duration_cast<chrono::nanoseconds>(
+                    chrono::steady_clock::now() - ingestStart);
+                const auto loopCounted = phases.sampleCounters() - ingestCounters;
+                const auto checkpointElapsed = phases.elapsed(profiling::Phase::Estimate)
+                                               + phases.elapsed(profiling::Phase::Output) - checkpointTime;
+                profiling::CounterValues checkpointDelta = phases.counted(profiling::Phase::Estimate);
+                checkpointDelta += phases.counted(profiling::Phase::Output);
+                phases.add(profiling::Phase::Ingest,
+                           loopElapsed - checkpointElapsed,
+                           loopCounted - (checkpointDelta - checkpointCounted));
+
+                allocations.add(0u, runAllocations.elapsed());
+                state.completedRuns = run + 1u;
+                stopped = converged();
+                const auto now = chrono::steady_clock::now();
+                if (resumable && (stopped || state.completedRuns == context.metadata.runs
+                                  || now - lastSave >= context.streamingResumeInterval)) {
+                    const profiling::PhaseTimer outputTimer(&phases, profiling::Phase::Output);
+                    StreamingResumeFile::save(context.streamingResumeState, state);
+                    lastSave = now;
+                }
+            }
+
+            if (snapshots.has_value()) {
+                const profiling::PhaseTimer outputTimer(&phases, profiling::Phase::Output);
+                snapshots->finish(state.completedRuns);
+            }
+            allocations.publish(context.diagnostics);
+            const size_t timedRuns = state.completedRuns - firstRun;
+            detail::publishTiming(context.diagnostics, phases, evaluationStart, timedRuns,
+                                  static_cast<uint64_t>(timedRuns) * context.metadata.sampleSize);
+            if (context.diagnostics != nullptr) context.diagnostics->sketchStats = sketchStats.points();
+
+            // I tick dei run saltati chiudono comunque la barra.
+            progress.advance((context.metadata.runs - state.completedRuns) * context.metadata.sampleSize);
+            progress.finish();
+
+            vector<StreamingPointStats> out;
+            out.reserve(accumulators.size());
+            for (size_t i = 0; i < accumulators.size(); ++i) {
+                out.push_back(accumulators[i].toStreamingPoint(checkpointPositions[i % checkpoints]));
+            }
+            return out;
         }
+    } // namespace
 
-        detail::finishProgress(context.progress);
+    template<typename Algo, typename... Args>
+    vector<StreamingPointStats> evaluate(const detail::EvaluationContext &context,
+                                         Args &&... ctorArgs) {
+        if (hasEmptyDataset(context.metadata)) return {};
+        if (detail::hasWideKeys(context)) {
+            return evaluatePartitions<uint64_t, Algo>(context, CountProbe{}, std::forward<Args>(ctorArgs)...);
+        }
+        return evaluatePartitions<uint32_t, Algo>(context, CountProbe{}, std::forward<Args>(ctorArgs)...);
+    }
+
+    template<typename Algo, typename... Args>
+    vector<EstimatorStreamingSeries> evaluateEstimators(
+        const detail::EvaluationContext &context,
+        const vector<const algorithms::CardinalityEstimator *> &estimators,
+        Args &&... ctorArgs) {
+        static_assert(detail::RegisterSketch<Algo>,
+                      "evaluateStreamingEstimators requires Algo::registerView");
+        if (estimators.empty() || ranges::find(estimators, nullptr) != estimators.end()) {
+            throw invalid_argument("evaluateStreamingEstimators requires at least one estimator");
+        }
+
+        vector<EstimatorStreamingSeries> out;
+        out.reserve(estimators.size());
+        for (const auto *estimator : estimators) {
+            out.push_back({string(estimator->id()), {}});
+        }
+        if (hasEmptyDataset(context.metadata)) return out;
 
-        vector<StreamingPointStats> out;
-        out.reserve(checkpointPositions.size());
-        for (size_t i = 0; i < checkpointPositions.size(); ++i) {
-            out.push_back(accumulators[i].toStreamingPoint(checkpointPositions[i]));
+        const EstimatorProbe probe{estimators};
+        const auto points = detail::hasWideKeys(context)
+                                ? evaluatePartitions<uint64_t, Algo>(context, probe, std::forward<Args>(ctorArgs)...)
+                                : evaluatePartitions<uint32_t, Algo>(context, probe, std::forward<Args>(ctorArgs)...);
+        const size_t checkpoints = points.size() / estimators.size();
+        for (size_t column = 0; column < estimators.size(); ++column) {
+            const auto first = points.begin() + static_cast<ptrdiff_t>(column * checkpoints);
+            out[column].series.assign(first, first + static_cast<ptrdiff_t>(checkpoints));
         }
         return out;
     }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "satp/simulation/detail/framework/EvaluationMetadata.h"
+#include "satp/simulation/detail/metrics/EarlyStopping.h"
+#include "satp/simulation/detail/metrics/ErrorAccumulator.h"
+#include "satp/simulation/detail/metrics/StateCodec.h"
+
+using namespace std;
+
+namespace satp::evaluation {
+    // Avanzamento di una valutazione streaming: i primi completedRuns run sono
+    // gia' negli accumulatori, uno per checkpoint.
+    struct StreamingResumeState {
+        uint64_t fingerprint = 0;
+        size_t completedRuns = 0;
+        vector<ErrorAccumulator> accumulators;
+    };
+
+    // File di stato per riprendere runstream dopo un'interruzione:
+    //   "SATPRSUM", u64 version, u64 fingerprint, u64 completed_runs,
+    //   u64 accumulators, poi lo stato di ogni ErrorAccumulator.
+    // Il fingerprint lega lo stato a dataset, checkpoint e opzioni (quantili,
+    // arresto anticipato, stimatori): uno stato
+    // di un'altra configurazione viene rifiutato invece di essere mescolato.
+    class StreamingResumeFile {
+    public:
+        static constexpr array<char, 8> MAGIC{'S', 'A', 'T', 'P', 'R', 'S', 'U', 'M'};
+        static constexpr uint64_t VERSION = 3u;
+
+        [[nodiscard]] static uint64_t fingerprint(const EvaluationMetadata &metadata,
+                                                  const vector<size_t> &checkpointPositions,
+                                                  const bool errorQuantiles,
+                                                  const EarlyStoppingOptions &earlyStopping = {},
+                                                  const vector<string_view> &estimators = {}) {
+            // FNV-1a sui campi a 64 bit.
+            uint64_t hash = 0xcbf29ce484222325ull;
+            const auto mix = [&hash](const uint64_t value) {
+                for (size_t i = 0; i < 8u; ++i) {
+                    hash ^= (value >> (8u * i)) & 0xFFu;
+                    hash *= 0x100000001b3ull;
+                }
+            };
+            mix(metadata.runs);
+            mix(metadata.sampleSize);
+            mix(metadata.distinctCount);
+            mix(metadata.seed);
+            mix(errorQuantiles ? 1u : 0u);
+            mix(bit_cast<uint64_t>(earlyStopping.targetWidth));
+            mix(static_cast<uint64_t>(earlyStopping.metric));
+            mix(earlyStopping.minRuns);
+            mix(checkpointPositions.size());
+            for (const size_t position : checkpointPositions) mix(position);
+            // Senza stimatori il fingerprint resta quello di evaluateStreaming.
+            if (!estimators.empty()) {
+                mix(estimators.size());
+                for (const auto id : estimators) {
+                    mix(id.size());
+                    for (const char c : id) mix(static_cast<uint8_t>(c));
+                }
+            }
+            return hash;
+        }
+
+        // Scrive su un file temporaneo e lo rinomina: un'interruzione durante
+        // il salvataggio lascia intatto lo stato precedente.
+        static void save(const filesystem::path &statePath, const StreamingResumeState &state) {
+            detail::StateWriter writer;
+            writer.u64(VERSION);
+            writer.u64(state.fingerprint);
+            writer.u64(state.completedRuns);
+            writer.u64(state.accumulators.size());
+            for (const auto &accumulator : state.accumulators) {
+                accumulator.writeState(writer);
+            }
+
+            filesystem::path tmpPath = statePath;
+            tmpPath += ".tmp";
+            {
+                ofstream out(tmpPath, ios::binary | ios::trunc);
+                if (!out) {
+                    throw runtime_error("Impossibile scrivere lo stato di resume");
+                }
+                out.write(MAGIC.data(), static_cast<streamsize>(MAGIC.size()));
+                out.write(reinterpret_cast<const char *>(writer.bytes().data()),
+                          static_cast<streamsize>(writer.bytes().size()));
+                if (!out.flush()) {
+                    throw runtime_error("Scrittura dello stato di resume fallita");
+                }
+            }
+            filesystem::rename(tmpPath, statePath);
+        }
+
+        // nullopt se il file non esiste; eccezione se e' corrotto o appartiene
+        // a un'altra configurazione.
+        [[nodiscard]] static optional<StreamingResumeState> load(const filesystem::path &statePath,
+                                                                 const uint64_t expectedFingerprint) {
+            ifstream in(statePath, ios::binary);
+            if (!in) return nullopt;
+            const vector<uint8_t> bytes{istreambuf_iterator<char>(in), istreambuf_iterator<char>()};
+            if (bytes.size() < MAGIC.size() ||
+                !ranges::equal(MAGIC, bytes | views::take(MAGIC.size()),
+                               [](const char a, const uint8_t b) { return static_cast<uint8_t>(a) == b; })) {
+                throw runtime_error("Stato di resume non valido: magic errato");
+            }
+
+            detail::StateReader reader(bytes.data() + MAGIC.size(), bytes.size() - MAGIC.size());
+            if (reader.u64() != VERSION) {
+                throw runtime_error("Stato di resume non valido: versione non supportata");
+            }
+            StreamingResumeState state;
+            state.fingerprint = reader.u64();
+            if (state.fingerprint != expectedFingerprint) {
+                throw runtime_error("Stato di resume di un'altra configurazione: " + statePath.string());
+            }
+            state.completedRuns = static_cast<size_t>(reader.u64());
+            state.accumulators.resize(reader.length(8u));
+            for (auto &accumulator : state.accumulators) {
+                accumulator = ErrorAccumulator::readState(reader);
+            }
+            if (!reader.exhausted()) {
+                throw runtime_error("Stato di resume non valido: byte in eccesso");
+            }
+            return state;
+        }
+    };
+} // namespace satp::evaluation
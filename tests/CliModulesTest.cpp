@@ -82,17 +82,122 @@ TEST_CASE("CLI run config parameter setters update and validate values", "[cli][
     REQUIRE(satp::cli::config::setParam(cfg, "mergeStrategy", "reject"));
     REQUIRE(cfg.mergeStrategy == satp::evaluation::MergeStrategy::Reject);
 
+    REQUIRE(satp::cli::config::setParam(cfg, "mergeTopology", "left_deep_chain"));
+    REQUIRE(cfg.mergeTopology == satp::evaluation::MergeTopology::LeftDeepChain);
+
+    REQUIRE(satp::cli::config::setParam(cfg, "topologyPartitions", "8"));
+    REQUIRE(cfg.topologyPartitions == 8u);
+
+    REQUIRE(satp::cli::config::setParam(cfg, "topologySampleSeed", "3"));
+    REQUIRE(cfg.topologySampleSeed == optional<uint32_t>{3u});
+
+    REQUIRE(satp::cli::config::setParam(cfg, "workers", "auto"));
+    REQUIRE(cfg.workers == 0u);
+
+    REQUIRE(satp::cli::config::setParam(cfg, "checkpoints", "5000"));
+    REQUIRE(cfg.checkpoints == 5000u);
+    REQUIRE(satp::cli::config::setParam(cfg, "checkpoints", "all"));
+    REQUIRE(cfg.checkpoints == 0u);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "checkpoints", "0"));
+
+    REQUIRE(satp::cli::config::setParam(cfg, "streamingTrace", "binary"));
+    REQUIRE(cfg.streamingTrace == satp::cli::StreamingTraceFormat::Binary);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "streamingTrace", "parquet"));
+
+    REQUIRE(satp::cli::config::setParam(cfg, "errorQuantiles", "on"));
+    REQUIRE(cfg.errorQuantiles);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "errorQuantiles", "yes"));
+    REQUIRE(satp::cli::config::setParam(cfg, "perfCounters", "on"));
+    REQUIRE(cfg.perfCounters);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "perfCounters", "yes"));
+    REQUIRE(satp::cli::config::setParam(cfg, "trace", "results/trace.json"));
+    REQUIRE(cfg.tracePath == "results/trace.json");
+    REQUIRE(satp::cli::config::setParam(cfg, "trace", "off"));
+    REQUIRE(cfg.tracePath.empty());
+
+    REQUIRE(satp::cli::config::setParam(cfg, "resume", "on"));
+    REQUIRE(cfg.resume);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "resume", "1"));
+
+    REQUIRE(satp::cli::config::setParam(cfg, "stopWidth", "0.005"));
+    REQUIRE(cfg.stopWidth == 0.005);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "stopWidth", "-1"));
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "stopWidth", "nan"));
+    REQUIRE(satp::cli::config::setParam(cfg, "stopWidth", "off"));
+    REQUIRE(cfg.stopWidth == 0.0);
+    REQUIRE(satp::cli::config::setParam(cfg, "stopMetric", "mean"));
+    REQUIRE(cfg.stopMetric == satp::evaluation::StoppingMetric::Mean);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "stopMetric", "rmse"));
+
+    REQUIRE(satp::cli::config::setParam(cfg, "snapshots", "on"));
+    REQUIRE(cfg.snapshots);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "snapshots", "true"));
+
+    REQUIRE(satp::cli::config::setParam(cfg, "estimators", "improved,ml"));
+    REQUIRE(cfg.estimators == vector<string>{"improved", "ml"});
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "estimators", "improved,median"));
+    REQUIRE(cfg.estimators == vector<string>{"improved", "ml"});
+    REQUIRE(satp::cli::config::setParam(cfg, "estimators", "all"));
+    REQUIRE(cfg.estimators.empty());
+
+    REQUIRE(satp::cli::config::setParam(cfg, "hllppEstimator", "improved"));
+    REQUIRE(cfg.hllppEstimator == satp::algorithms::HyperLogLogPlusPlus::EstimatorMode::Improved);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "hllppEstimator", "ertl"));
+    REQUIRE(satp::cli::config::setParam(cfg, "hllppEstimator", "table"));
+    REQUIRE(cfg.hllppEstimator == satp::algorithms::HyperLogLogPlusPlus::EstimatorMode::BiasTable);
+
+    REQUIRE(satp::cli::config::setParam(cfg, "simMaxN", "1e12"));
+    REQUIRE(cfg.simMaxN == 1'000'000'000'000u);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "simMaxN", "1.5"));
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "simMaxN", "0"));
+    REQUIRE(satp::cli::config::setParam(cfg, "simRuns", "250"));
+    REQUIRE(cfg.simRuns == 250u);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "simRuns", "0"));
+    REQUIRE(satp::cli::config::setParam(cfg, "simSeed", "42"));
+    REQUIRE(cfg.simSeed == 42u);
+
+    REQUIRE(satp::cli::config::setParam(cfg, "latencyBatch", "64"));
+    REQUIRE(cfg.latencyBatch == 64u);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "latencyBatch", "0"));
+    REQUIRE(satp::cli::config::setParam(cfg, "latencyRate", "1e6"));
+    REQUIRE(cfg.latencyRate == 1e6);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "latencyRate", "-5"));
+    REQUIRE(satp::cli::config::setParam(cfg, "latencyRate", "off"));
+    REQUIRE(cfg.latencyRate == 0.0);
+
+    REQUIRE(satp::cli::config::setParam(cfg, "matrixRightHashes", "xxhash64,murmurhash3"));
+    REQUIRE(cfg.matrixRightHashes == vector<string>{"xxhash64", "murmurhash3"});
+
+    REQUIRE(satp::cli::config::setParam(cfg, "matrixLeftSeeds", "dataset,17"));
+    REQUIRE(cfg.matrixLeftSeeds == vector<optional<uint32_t>>{nullopt, 17u});
+
+    REQUIRE(satp::cli::config::setParam(cfg, "matrixLeftK", "10,14,18"));
+    REQUIRE(cfg.matrixLeftK == vector<uint32_t>{10u, 14u, 18u});
+
+    REQUIRE(satp::cli::config::setParam(cfg, "matrixStrategies", "reject,reduce_then_merge"));
+    REQUIRE(cfg.matrixStrategies.size() == 2u);
+    REQUIRE(cfg.matrixStrategies[1] == satp::evaluation::MergeStrategy::ReduceThenMerge);
+
+    // Una lista con un elemento non valido non modifica l'asse.
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "matrixLeftK", "10,x"));
+    REQUIRE(cfg.matrixLeftK.size() == 3u);
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "matrixRightHashes", "xxhash64,"));
+
+    REQUIRE(satp::cli::config::setParam(cfg, "matrixLeftK", "default"));
+    REQUIRE(cfg.matrixLeftK.empty());
+
     const uint32_t oldK = cfg.k;
     REQUIRE_FALSE(satp::cli::config::setParam(cfg, "k", "abc"));
     REQUIRE(cfg.k == oldK);
 
     REQUIRE_FALSE(satp::cli::config::setParam(cfg, "hashFunction", "not-a-hash"));
     REQUIRE_FALSE(satp::cli::config::setParam(cfg, "mergeStrategy", "not-a-strategy"));
+    REQUIRE_FALSE(satp::cli::config::setParam(cfg, "mergeTopology", "custom"));
     REQUIRE_FALSE(satp::cli::config::setParam(cfg, "unknownParam", "x"));
 }
 
 TEST_CASE("CLI run config exposes canonical parameter and hash lists", "[cli][config]") {
-    constexpr array<string_view, 13> expectedParams{
+    constexpr array<string_view, 40> expectedParams{
         "datasetPath",
         "resultsNamespace",
         "hashFunction",
@@ -105,7 +210,34 @@ TEST_CASE("CLI run config exposes canonical parameter and hash lists", "[cli][co
         "rightK",
         "l",
         "lLog",
-        "mergeStrategy"
+        "mergeStrategy",
+        "mergeTopology",
+        "topologyPartitions",
+        "topologySampleSeed",
+        "workers",
+        "checkpoints",
+        "streamingTrace",
+        "errorQuantiles",
+        "resume",
+        "stopWidth",
+        "stopMetric",
+        "snapshots",
+        "perfCounters",
+        "trace",
+        "estimators",
+        "hllppEstimator",
+        "simMaxN",
+        "simRuns",
+        "simSeed",
+        "latencyBatch",
+        "latencyRate",
+        "matrixLeftHashes",
+        "matrixRightHashes",
+        "matrixLeftSeeds",
+        "matrixRightSeeds",
+        "matrixLeftK",
+        "matrixRightK",
+        "matrixStrategies"
     };
     constexpr array<string_view, 4> expectedHashes{
         "splitmix64",
@@ -150,6 +282,8 @@ TEST_CASE("Executor output helpers expose stable labels and metrics", "[cli][exe
     REQUIRE(string(modeLabel(RunMode::Streaming)) == "streaming");
     REQUIRE(string(modeLabel(RunMode::Merge)) == "merge");
     REQUIRE(string(modeLabel(RunMode::MergeHeterogeneous)) == "merge_heterogeneous");
+    REQUIRE(string(modeLabel(RunMode::MergeTopology)) == "merge_topology");
+    REQUIRE(string(modeLabel(RunMode::MergeMatrix)) == "merge_matrix");
 
     REQUIRE(abs(rseHll(10u) - 0.0325) < 1e-12);
     REQUIRE(abs(rseLogLog(10u) - 0.040625) < 1e-12);
@@ -1,6 +1,9 @@
 #include <array>
 #include <cstdint>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 
 #include "catch2/catch_test_macros.hpp"
 
@@ -92,3 +95,52 @@ TEST_CASE("Factory enforces optional name/seed contract", "[hashing][factory]")
     REQUIRE_THROWS_AS(satp::hashing::getHashFunctionBy("splitmix64"), invalid_argument);
     REQUIRE_THROWS_AS(satp::hashing::getHashFunctionBy(nullopt, 123u), invalid_argument);
 }
+
+namespace {
+    [[nodiscard]] span<const byte> asBytes(const string_view text) {
+        return as_bytes(span(text.data(), text.size()));
+    }
+
+    [[nodiscard]] string littleEndianBytes(uint64_t value) {
+        string out(8u, '\0');
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = static_cast<char>((value >> (8u * i)) & 0xffu);
+        }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("Byte hashing matches reference vectors", "[hashing][bytes]") {
+    const satp::hashing::functions::XXHash64 xxhash{};
+    REQUIRE(xxhash.hashBytes64(asBytes("")) == 0xef46db3751d8e999ULL);
+    REQUIRE(xxhash.hashBytes64(asBytes("abc")) == 0x44bc2cf5ad770999ULL);
+
+    const satp::hashing::functions::MurmurHash3 murmur{};
+    REQUIRE(murmur.hashBytes64(asBytes("")) == 0ULL);
+    REQUIRE(murmur.hashBytes64(asBytes("The quick brown fox jumps over the lazy dog")) == 0xe34bbc7bbc071b6cULL);
+
+    // SipHash-2-4 paper vectors: key 00..0f, message 00..(len-1).
+    const satp::hashing::functions::SipHash24 sip{};
+    string message;
+    for (uint8_t i = 0; i < 15u; ++i) {
+        message.push_back(static_cast<char>(i));
+    }
+    REQUIRE(sip.hashBytes64(asBytes(string_view(message).substr(0, 0))) == 0x726fdb47dd0e0e31ULL);
+    REQUIRE(sip.hashBytes64(asBytes(string_view(message).substr(0, 8))) == 0x93f5f5799a932462ULL);
+    REQUIRE(sip.hashBytes64(asBytes(message)) == 0xa129ca6149be45e5ULL);
+}
+
+TEST_CASE("Byte hashing of 8-byte keys agrees with the integer fast path", "[hashing][bytes]") {
+    const satp::hashing::functions::XXHash64 xxhash(77u);
+    const satp::hashing::functions::SipHash24 sip{};
+    for (const uint64_t input : {0ULL, 42ULL, 0x0123456789abcdefULL, 0xffffffffffffffffULL}) {
+        const string encoded = littleEndianBytes(input);
+        REQUIRE(xxhash.hashBytes64(asBytes(encoded)) == xxhash.hash64(input));
+        REQUIRE(sip.hashBytes64(asBytes(encoded)) == sip.hash64(input));
+        REQUIRE(xxhash.hashBytes32(asBytes(encoded)) == xxhash.hash32(input));
+    }
+
+    const satp::hashing::functions::SplitMix64 splitmix{};
+    REQUIRE(splitmix.hashBytes64(asBytes("abc")) == splitmix.hashBytes64(asBytes("abc")));
+    REQUIRE(splitmix.hashBytes64(asBytes("abc")) != splitmix.hashBytes64(asBytes(string_view("abc\0", 4))));
+}
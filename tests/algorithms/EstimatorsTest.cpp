@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch_approx.hpp"
+#include "satp/algorithms/Estimators.h"
+#include "satp/algorithms/HyperLogLog.h"
+#include "satp/algorithms/HyperLogLogPlusPlus.h"
+#include "satp/algorithms/LogLog.h"
+#include "satp/hashing/HashFactory.h"
+#include "TestData.h"
+
+using namespace std;
+using Catch::Approx;
+
+namespace {
+    const satp::hashing::HashFunction &defaultHash() {
+        static const auto hash = satp::hashing::getHashFunctionBy();
+        return *hash;
+    }
+
+    [[nodiscard]] double estimateWith(const string_view id, const satp::algorithms::RegisterView &view) {
+        return satp::algorithms::estimators::makeEstimator(id)->estimate(view);
+    }
+}
+
+TEST_CASE("RegisterView costruisce l'istogramma dei registri", "[estimators][register-view]") {
+    const vector<uint8_t> registers{0, 1, 1, 3, 0, 0, 29, 2, 0, 0, 0, 0, 0, 0, 0, 1};
+    const satp::algorithms::RegisterView view(4u, 32u, registers);
+    REQUIRE(view.m() == 16u);
+    REQUIRE(view.q() == 28u);
+    REQUIRE(view.histogram().size() == 30u);
+    REQUIRE(view.zeroRegisters() == 10u);
+    REQUIRE(view.histogram()[1] == 3u);
+    REQUIRE(view.histogram()[29] == 1u);
+
+    const vector<uint8_t> tooHigh{30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    REQUIRE_THROWS_AS(satp::algorithms::RegisterView(4u, 32u, tooHigh), invalid_argument);
+    REQUIRE_THROWS_AS(satp::algorithms::RegisterView(5u, 32u, registers), invalid_argument);
+}
+
+TEST_CASE("Gli stimatori classici coincidono con count() degli sketch", "[estimators]") {
+    const auto part = satp::testdata::loadPartition(0);
+    satp::algorithms::HyperLogLog hll(10, 32, defaultHash());
+    satp::algorithms::LogLog loglog(10, 32, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus hllpp(10, defaultHash());
+    for (const auto v : part) {
+        hll.process(v);
+        loglog.process(v);
+        hllpp.process(v);
+    }
+
+    // count() tronca a intero; gli stimatori restituiscono la stima reale.
+    REQUIRE(estimateWith("hll", hll.registerView()) == Approx(static_cast<double>(hll.count())).margin(1.0));
+    REQUIRE(estimateWith("loglog", loglog.registerView()) == Approx(static_cast<double>(loglog.count())).margin(1.0));
+    REQUIRE(estimateWith("hllpp", hllpp.registerView()) == Approx(static_cast<double>(hllpp.count())).margin(1.0));
+
+    // HLL e LogLog condividono i registri: stessa vista, stesse stime.
+    REQUIRE(estimateWith("loglog", hll.registerView()) == estimateWith("loglog", loglog.registerView()));
+}
+
+TEST_CASE("Stimatore migliorato e massima verosimiglianza restano entro l'errore atteso", "[estimators][improved][ml]") {
+    constexpr uint32_t P = 10;
+    const double rse = 1.04 / sqrt(static_cast<double>(1u << P));
+
+    satp::algorithms::HyperLogLogPlusPlus small(P, defaultHash());
+    satp::algorithms::HyperLogLog large(P, 32, defaultHash());
+    for (uint32_t v = 0; v < 300; ++v) small.process(v);
+    for (uint32_t v = 0; v < 200'000; ++v) large.process(v);
+
+    // La vista sparse di HLL++ e' ricostruita a precisione p.
+    for (const auto id : {"improved", "ml"}) {
+        INFO("estimator = " << id);
+        REQUIRE(estimateWith(id, small.registerView()) == Approx(300.0).epsilon(4.0 * rse));
+        REQUIRE(estimateWith(id, large.registerView()) == Approx(200'000.0).epsilon(4.0 * rse));
+    }
+    REQUIRE(estimateWith("improved", large.registerView())
+            == Approx(estimateWith("ml", large.registerView())).epsilon(0.01));
+}
+
+TEST_CASE("Gli stimatori gestiscono registri vuoti e saturi", "[estimators][edge]") {
+    const vector<uint8_t> empty(16, 0u);
+    const vector<uint8_t> saturated(16, 29u);
+    const satp::algorithms::RegisterView emptyView(4u, 32u, empty);
+    const satp::algorithms::RegisterView saturatedView(4u, 32u, saturated);
+
+    REQUIRE(estimateWith("improved", emptyView) == 0.0);
+    REQUIRE(estimateWith("ml", emptyView) == 0.0);
+    REQUIRE(estimateWith("linear", emptyView) == 0.0);
+    REQUIRE(estimateWith("ml", saturatedView) == numeric_limits<double>::infinity());
+    REQUIRE(estimateWith("linear", saturatedView) == 16.0);
+    REQUIRE(estimateWith("improved", saturatedView) == numeric_limits<double>::infinity());
+
+    const vector<uint8_t> wide(1u << 19, 0u);
+    REQUIRE_THROWS_AS(estimateWith("hllpp", satp::algorithms::RegisterView(19u, 64u, wide)), invalid_argument);
+}
+
+TEST_CASE("La factory degli stimatori copre tutti gli id supportati", "[estimators][catalog]") {
+    for (const auto id : satp::algorithms::estimators::getIdsOfSupportedEstimators()) {
+        REQUIRE(satp::algorithms::estimators::makeEstimator(id)->id() == id);
+    }
+    REQUIRE_THROWS_AS(satp::algorithms::estimators::makeEstimator("median"), invalid_argument);
+}
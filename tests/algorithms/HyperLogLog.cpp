@@ -1,8 +1,12 @@
 #include "catch2/catch_test_macros.hpp"
 #include <array>
 #include <cmath>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include "satp/hashing/HashFactory.h"
+#include "satp/algorithms/Estimators.h"
 #include "satp/algorithms/HyperLogLog.h"
 #include "satp/algorithms/HyperLogLogPlusPlus.h"
 #include "TestData.h"
@@ -69,6 +73,27 @@ TEST_CASE("HyperLogLog valida parametri", "[hyperloglog-params]") {
     REQUIRE_THROWS_AS(satp::algorithms::HyperLogLog(5, 33, defaultHash()), invalid_argument);
     REQUIRE_NOTHROW(satp::algorithms::HyperLogLog(4, 32, defaultHash()));
     REQUIRE_NOTHROW(satp::algorithms::HyperLogLog(16, 32, defaultHash()));
+    REQUIRE_THROWS_AS(satp::algorithms::HyperLogLog(5, 63, defaultHash()), invalid_argument);
+    REQUIRE_THROWS_AS(satp::algorithms::HyperLogLog(5, 65, defaultHash()), invalid_argument);
+    REQUIRE_NOTHROW(satp::algorithms::HyperLogLog(4, 64, defaultHash()));
+    REQUIRE_NOTHROW(satp::algorithms::HyperLogLog(16, 64, defaultHash()));
+}
+
+TEST_CASE("HyperLogLog con L = 64 stima i distinti del dataset di test", "[hyperloglog-count][l64]") {
+    constexpr uint32_t K = 10;
+
+    auto dataset = satp::testdata::loadDataset();
+    auto NUMBER_OF_UNIQUE_ELEMENTS = dataset.distinct;
+
+    satp::algorithms::HyperLogLog hll(K, 64, defaultHash());
+    satp::testsupport::AlgorithmLoop loop(std::move(hll), std::move(dataset.values));
+
+    auto estimate = loop.process();
+
+    const double m = double(1u << K);
+    const double RSE = 1.04 / sqrt(m);
+    REQUIRE(static_cast<double>(estimate) >= static_cast<double>(NUMBER_OF_UNIQUE_ELEMENTS) * (1.0 - 3 * RSE));
+    REQUIRE(static_cast<double>(estimate) <= static_cast<double>(NUMBER_OF_UNIQUE_ELEMENTS) * (1.0 + 3 * RSE));
 }
 
 TEST_CASE("HyperLogLog++ valida parametri", "[hyperloglogpp-params]") {
@@ -126,6 +151,8 @@ TEST_CASE("HyperLogLog merge valida compatibilita' parametri", "[hyperloglog][me
     satp::algorithms::HyperLogLog a(10, 32, defaultHash());
     satp::algorithms::HyperLogLog b(11, 32, defaultHash());
     REQUIRE_THROWS_AS(a.merge(b), invalid_argument);
+    satp::algorithms::HyperLogLog wide(10, 64, defaultHash());
+    REQUIRE_THROWS_AS(a.merge(wide), invalid_argument);
 }
 
 TEST_CASE("HyperLogLog++ merge: seriale, commutativita', idempotenza", "[hyperloglogpp][merge]") {
@@ -168,6 +195,34 @@ TEST_CASE("HyperLogLog++ merge: seriale, commutativita', idempotenza", "[hyperlo
     REQUIRE(idemRelDelta <= 0.05);
 }
 
+TEST_CASE("HyperLogLog++ count() in sparse e' O(1) e non altera lo stato", "[hyperloglogpp][sparse]") {
+    constexpr uint32_t P = 18; // 20k distinti restano in rappresentazione sparse
+    satp::algorithms::HyperLogLogPlusPlus polled(P, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus quiet(P, defaultHash());
+    const satp::algorithms::HyperLogLogPlusPlus empty(P, defaultHash());
+
+    uint64_t previous = 0;
+    for (uint32_t v = 0; v < 20'000; ++v) {
+        polled.process(v);
+        quiet.process(v);
+        polled.process(v);
+        const uint64_t estimate = polled.count();
+        REQUIRE(estimate >= previous);
+        previous = estimate;
+
+        if (v % 997u == 0u) {
+            // Il merge fonde il buffer nella lista sparse: la stima incrementale coincide.
+            satp::algorithms::HyperLogLogPlusPlus flushed = polled;
+            flushed.merge(empty);
+            REQUIRE(flushed.count() == estimate);
+        }
+    }
+    REQUIRE(polled.count() == quiet.count());
+
+    polled.reset();
+    REQUIRE(polled.count() == 0u);
+}
+
 TEST_CASE("HyperLogLog++ merge valida compatibilita' parametri", "[hyperloglogpp][merge][params]") {
     satp::algorithms::HyperLogLogPlusPlus a(10, defaultHash());
     satp::algorithms::HyperLogLogPlusPlus b(11, defaultHash());
@@ -254,3 +309,210 @@ TEST_CASE("HyperLogLog++ valida i target di riduzione", "[hyperloglogpp][reduce]
     REQUIRE_THROWS_AS(source.reducedTo(3u), invalid_argument);
     REQUIRE_THROWS_AS(source.reducedTo(15u), invalid_argument);
 }
+
+TEST_CASE("HyperLogLog e HLL++ trattano le chiavi a 64 bit come quelle a 32 bit", "[hyperloglog][hyperloglogpp][keys64]") {
+    const auto values = satp::testdata::loadPartition(0);
+
+    satp::algorithms::HyperLogLog hll32(10u, 32u, defaultHash());
+    satp::algorithms::HyperLogLog hll64(10u, 32u, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus hllpp32(14u, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus hllpp64(14u, defaultHash());
+    for (const uint32_t v : values) {
+        hll32.process(v);
+        hll64.process(static_cast<uint64_t>(v));
+        hllpp32.process(v);
+        hllpp64.process(static_cast<uint64_t>(v));
+    }
+
+    REQUIRE(hll64.count() == hll32.count());
+    REQUIRE(hllpp64.count() == hllpp32.count());
+}
+
+TEST_CASE("HyperLogLog++ stima chiavi a 64 bit e chiavi stringa", "[hyperloglogpp][keys64][bytes]") {
+    constexpr uint32_t K = 14;
+    constexpr uint64_t DISTINCT = 100'000u;
+    const double RSE = 1.04 / sqrt(double(1u << K));
+
+    satp::algorithms::HyperLogLogPlusPlus wide(K, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus strings(K, defaultHash());
+    for (uint64_t i = 0; i < DISTINCT; ++i) {
+        // Chiavi che differiscono solo nei 32 bit alti.
+        wide.process(i << 32u);
+        wide.process(i << 32u);
+
+        const string key = "user-" + to_string(i);
+        strings.process(as_bytes(span(key.data(), key.size())));
+    }
+
+    for (auto *sketch : {&wide, &strings}) {
+        const auto estimate = static_cast<double>(sketch->count());
+        REQUIRE(estimate >= static_cast<double>(DISTINCT) * (1.0 - 3 * RSE));
+        REQUIRE(estimate <= static_cast<double>(DISTINCT) * (1.0 + 3 * RSE));
+    }
+}
+
+TEST_CASE("HyperLogLog saveState/loadState ricostruisce la stima", "[hyperloglog][state]") {
+    const auto part = satp::testdata::loadPartition(0);
+    satp::algorithms::HyperLogLog source(10, 32, defaultHash());
+    for (const auto v : part) source.process(v);
+
+    vector<uint8_t> state;
+    source.saveState(state);
+    satp::algorithms::HyperLogLog restored(10, 32, defaultHash());
+    restored.loadState(state);
+    REQUIRE(restored.count() == source.count());
+
+    // Lo stato riletto continua a ricevere elementi come l'originale.
+    source.process(123'456'789u);
+    restored.process(123'456'789u);
+    REQUIRE(restored.count() == source.count());
+
+    satp::algorithms::HyperLogLog otherK(11, 32, defaultHash());
+    REQUIRE_THROWS_AS(otherK.loadState(state), invalid_argument);
+    state.pop_back();
+    REQUIRE_THROWS_AS(restored.loadState(state), invalid_argument);
+}
+
+TEST_CASE("HyperLogLog++ saveState/loadState in sparse e normal", "[hyperloglogpp][state]") {
+    constexpr uint32_t P = 10;
+    satp::algorithms::HyperLogLogPlusPlus sparse(P, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus normal(P, defaultHash());
+    for (uint32_t v = 0; v < 128; ++v) sparse.process(v);
+    for (uint32_t v = 10'000; v < 40'000; ++v) normal.process(v);
+
+    for (auto *source : {&sparse, &normal}) {
+        vector<uint8_t> state;
+        source->saveState(state);
+        satp::algorithms::HyperLogLogPlusPlus restored(P, defaultHash());
+        restored.process(99u); // lo stato precedente viene sostituito
+        restored.loadState(state);
+        REQUIRE(restored.count() == source->count());
+
+        satp::algorithms::HyperLogLogPlusPlus merged = restored;
+        merged.merge(*source);
+        REQUIRE(merged.count() == source->count());
+    }
+
+    vector<uint8_t> state;
+    sparse.saveState(state);
+    satp::algorithms::HyperLogLogPlusPlus otherP(P + 1u, defaultHash());
+    REQUIRE_THROWS_AS(otherP.loadState(state), invalid_argument);
+    satp::algorithms::HyperLogLog hll(P, 32, defaultHash());
+    REQUIRE_THROWS_AS(hll.loadState(state), invalid_argument);
+}
+
+TEST_CASE("HyperLogLog++ con stimatore migliorato resta entro l'errore atteso", "[hyperloglogpp][improved]") {
+    using Mode = satp::algorithms::HyperLogLogPlusPlus::EstimatorMode;
+    constexpr uint32_t P = 12;
+    satp::algorithms::HyperLogLogPlusPlus improved(P, Mode::Improved, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus table(P, defaultHash());
+    REQUIRE(improved.estimatorMode() == Mode::Improved);
+    REQUIRE(table.estimatorMode() == Mode::BiasTable);
+
+    // Copre la zona di transizione (~5m) dove il paper usa le tabelle di bias.
+    const double RSE = 1.04 / sqrt(double(1u << P));
+    uint32_t next = 0;
+    for (const uint32_t n : {1'000u, 5'000u, 20'000u, 60'000u, 200'000u}) {
+        for (; next < n; ++next) {
+            improved.process(next);
+            table.process(next);
+        }
+        const double estimate = static_cast<double>(improved.count());
+        REQUIRE(abs(estimate - n) <= 4.0 * RSE * n);
+        if (n <= 5'000u) continue; // in sparse le due modalita' coincidono
+        REQUIRE(abs(estimate - static_cast<double>(table.count())) <= 4.0 * RSE * n);
+    }
+}
+
+TEST_CASE("HyperLogLog++ mantiene l'istogramma dei registri tra merge, stato e reset", "[hyperloglogpp][improved][state]") {
+    using Mode = satp::algorithms::HyperLogLogPlusPlus::EstimatorMode;
+    constexpr uint32_t P = 10;
+    const auto partA = satp::testdata::loadPartition(0);
+    const auto partB = satp::testdata::loadPartition(1);
+    satp::algorithms::HyperLogLogPlusPlus a(P, Mode::Improved, defaultHash());
+    satp::algorithms::HyperLogLogPlusPlus b(P, Mode::Improved, defaultHash());
+    for (const auto v : partA) a.process(v);
+    for (const auto v : partB) b.process(v);
+
+    // L'istogramma incrementale deve coincidere con quello ricostruito dai registri.
+    const auto improvedFromView = [](const satp::algorithms::HyperLogLogPlusPlus &sketch) {
+        const auto view = sketch.registerView();
+        return static_cast<uint64_t>(
+            satp::algorithms::estimators::improvedEstimate(view.histogram(), view.m()));
+    };
+    REQUIRE(a.count() == improvedFromView(a));
+
+    satp::algorithms::HyperLogLogPlusPlus merged = a;
+    merged.merge(b);
+    REQUIRE(merged.count() == improvedFromView(merged));
+
+    vector<uint8_t> state;
+    merged.saveState(state);
+    satp::algorithms::HyperLogLogPlusPlus restored(P, Mode::Improved, defaultHash());
+    restored.loadState(state);
+    REQUIRE(restored.count() == merged.count());
+
+    restored.reset();
+    REQUIRE(restored.count() == 0u);
+    for (const auto v : partA) restored.process(v);
+    REQUIRE(restored.count() == a.count());
+}
+
+TEST_CASE("HyperLogLog e HLL++ riportano memoria e bit logici", "[hyperloglog][hyperloglogpp][memory]") {
+    satp::algorithms::HyperLogLog hll(10, 32, defaultHash());
+    // Registri da 5 bit: il rango massimo L - k + 1 = 23 richiede 5 bit.
+    REQUIRE(hll.logicalBits() == (1u << 10u) * 5u);
+    REQUIRE(hll.memoryBytes() >= sizeof(hll) + (1u << 10u));
+
+    satp::algorithms::HyperLogLogPlusPlus sketch(14, defaultHash());
+    const size_t emptyBytes = sketch.memoryBytes();
+    REQUIRE(emptyBytes >= sizeof(sketch));
+    REQUIRE(sketch.logicalBits() < sketch.denseBits());
+
+    for (uint32_t v = 0; v < 100; ++v) sketch.process(v);
+    REQUIRE(sketch.logicalBits() > 0u);
+    REQUIRE(sketch.logicalBits() < sketch.denseBits());
+    REQUIRE(sketch.memoryBytes() == emptyBytes); // i primi indici restano nel buffer preallocato
+
+    // Oltre la soglia sparse il formato e' normale: 6 bit per registro.
+    for (uint32_t v = 0; v < 200'000; ++v) sketch.process(v);
+    REQUIRE(sketch.logicalBits() == sketch.denseBits());
+    REQUIRE(sketch.denseBits() == (1u << 14u) * 6u);
+    REQUIRE(sketch.memoryBytes() >= sizeof(sketch) + (1u << 14u));
+
+    // La misura dipende solo dallo stato: dopo reset() i buffer trattenuti
+    // per il riuso non contano e lo sketch riporta i byte di uno nuovo.
+    sketch.reset();
+    REQUIRE(sketch.memoryBytes() == emptyBytes);
+    for (uint32_t v = 0; v < 100; ++v) sketch.process(v);
+    REQUIRE(sketch.memoryBytes() == emptyBytes);
+}
+
+#if SATP_SKETCH_STATS
+TEST_CASE("HyperLogLog e HLL++ contano gli eventi interni", "[hyperloglog][hyperloglogpp][sketch-stats]") {
+    satp::algorithms::HyperLogLog hll(10, 32, defaultHash());
+    for (uint32_t v = 0; v < 100'000; ++v) hll.process(v);
+    const auto &hllStats = hll.stats();
+    REQUIRE(hllStats.inserts == 100'000u);
+    REQUIRE(hllStats.registerWrites + hllStats.noOpUpdates == hllStats.inserts);
+    // Con n >> m quasi tutti gli aggiornamenti trovano un registro gia' maggiore.
+    REQUIRE(hllStats.noOpUpdates > 10u * hllStats.registerWrites);
+    hll.reset();
+    REQUIRE(hll.stats().inserts == 0u);
+
+    satp::algorithms::HyperLogLogPlusPlus sketch(14, defaultHash());
+    for (uint32_t v = 0; v < 200'000; ++v) sketch.process(v);
+    const auto &stats = sketch.stats();
+    REQUIRE(stats.inserts == 200'000u);
+    REQUIRE(stats.sparseFlushes > 0u);
+    REQUIRE(stats.flushedEntries > 0u);
+    REQUIRE(stats.converted);
+    REQUIRE(stats.convertedAtInsert > 0u);
+    REQUIRE(stats.convertedAtInsert < stats.inserts);
+
+    satp::algorithms::HyperLogLogPlusPlus other(14, defaultHash());
+    other.process(1u);
+    sketch.merge(other);
+    REQUIRE(sketch.stats().merges == 1u);
+}
+#endif
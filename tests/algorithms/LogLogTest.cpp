@@ -1,7 +1,9 @@
 #include "catch2/catch_test_macros.hpp"
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 #include "satp/hashing/HashFactory.h"
+#include "satp/algorithms/HyperLogLog.h"
 #include "satp/algorithms/LogLog.h"
 #include "TestData.h"
 #include "support/AlgorithmLoop.h"
@@ -46,6 +48,28 @@ TEST_CASE("LogLog valida parametri", "[loglog-params]") {
     REQUIRE_THROWS_AS(satp::algorithms::LogLog(5, 33, defaultHash()), invalid_argument);
     REQUIRE_NOTHROW(satp::algorithms::LogLog(4, 32, defaultHash()));
     REQUIRE_NOTHROW(satp::algorithms::LogLog(16, 32, defaultHash()));
+    REQUIRE_THROWS_AS(satp::algorithms::LogLog(5, 63, defaultHash()), invalid_argument);
+    REQUIRE_THROWS_AS(satp::algorithms::LogLog(5, 65, defaultHash()), invalid_argument);
+    REQUIRE_NOTHROW(satp::algorithms::LogLog(4, 64, defaultHash()));
+    REQUIRE_NOTHROW(satp::algorithms::LogLog(16, 64, defaultHash()));
+}
+
+TEST_CASE("LogLog con L = 64 stima i distinti del dataset di test", "[log-count][l64]") {
+    constexpr uint32_t L = 64;
+    constexpr uint32_t K = 10;
+
+    auto dataset = satp::testdata::loadDataset();
+    auto NUMBER_OF_UNIQUE_ELEMENTS = dataset.distinct;
+
+    satp::algorithms::LogLog loglog(K, L, defaultHash());
+    satp::testsupport::AlgorithmLoop loop(std::move(loglog), std::move(dataset.values));
+
+    auto estimate = loop.process();
+
+    const double m = double(1u << K);
+    const double RSE = 1.30 / sqrt(m);
+    REQUIRE(static_cast<double>(estimate) >= static_cast<double>(NUMBER_OF_UNIQUE_ELEMENTS) * (1.0 - 4 * RSE));
+    REQUIRE(static_cast<double>(estimate) <= static_cast<double>(NUMBER_OF_UNIQUE_ELEMENTS) * (1.0 + 4 * RSE));
 }
 
 TEST_CASE("LogLog merge: seriale, commutativita', idempotenza", "[loglog][merge]") {
@@ -86,3 +110,29 @@ TEST_CASE("LogLog merge valida compatibilita' parametri", "[loglog][merge][param
     REQUIRE_THROWS_AS(a.merge(bK), invalid_argument);
     REQUIRE_NOTHROW(a.merge(bL));
 }
+
+TEST_CASE("LogLog condivide lo stato dei registri con HyperLogLog", "[loglog][state]") {
+    const auto part = satp::testdata::loadPartition(0);
+    satp::algorithms::LogLog loglog(10, 32, defaultHash());
+    satp::algorithms::HyperLogLog hll(10, 32, defaultHash());
+    for (const auto v : part) {
+        loglog.process(v);
+        hll.process(v);
+    }
+
+    vector<uint8_t> state;
+    loglog.saveState(state);
+    satp::algorithms::LogLog restored(10, 32, defaultHash());
+    restored.loadState(state);
+    REQUIRE(restored.count() == loglog.count());
+
+    // Stessi registri: lo stimatore LogLog sullo stato HLL coincide con LogLog.
+    vector<uint8_t> hllState;
+    hll.saveState(hllState);
+    satp::algorithms::LogLog fromHll(10, 32, defaultHash());
+    fromHll.loadState(hllState);
+    REQUIRE(fromHll.count() == loglog.count());
+
+    satp::algorithms::LogLog otherL(10, 64, defaultHash());
+    REQUIRE_THROWS_AS(otherL.loadState(state), invalid_argument);
+}
@@ -1,5 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstdint>
+#include <span>
+#include <string>
+
 #include "satp/hashing/HashFactory.h"
 #include "satp/algorithms/NaiveCounting.h"
 #include "TestData.h"
@@ -54,3 +58,37 @@ TEST_CASE("NaiveCounting merge: seriale, commutativita', idempotenza", "[naive][
     idem.merge(a);
     REQUIRE(idem.count() == a.count());
 }
+
+TEST_CASE("NaiveCounting conta chiavi a 64 bit e chiavi stringa", "[naive][keys64][bytes]") {
+    satp::algorithms::NaiveCounting algo(defaultHash());
+    for (uint64_t i = 0; i < 1000u; ++i) {
+        algo.process(i << 32u);
+        algo.process(i << 32u);
+    }
+    REQUIRE(algo.count() == 1000u);
+
+    for (const string key : {"alpha", "beta", "alpha", "gamma"}) {
+        algo.process(as_bytes(span(key.data(), key.size())));
+    }
+    REQUIRE(algo.count() == 1003u);
+}
+
+TEST_CASE("NaiveCounting riporta memoria e bit logici crescenti", "[naive][memory]") {
+    satp::algorithms::NaiveCounting algo(defaultHash());
+    const size_t emptyBytes = algo.memoryBytes();
+    REQUIRE(algo.logicalBits() == 0u);
+
+    for (uint32_t v = 0; v < 10'000; ++v) algo.process(v);
+    REQUIRE(algo.logicalBits() == 10'000u * 32u);
+    REQUIRE(algo.memoryBytes() > emptyBytes);
+
+    // Gli id larghi occupano un nodo ciascuno; reset() riporta ai byte di
+    // uno sketch nuovo anche se la tabella dei bucket resta allocata.
+    satp::algorithms::NaiveCounting wide(defaultHash());
+    const size_t wideEmptyBytes = wide.memoryBytes();
+    for (uint64_t v = 0; v < 1'000; ++v) wide.process((uint64_t{1} << 40u) + v);
+    REQUIRE(wide.memoryBytes() >= wideEmptyBytes + 1'000u * (sizeof(void *) + sizeof(uint64_t)));
+    wide.reset();
+    REQUIRE(wide.count() == 0u);
+    REQUIRE(wide.memoryBytes() == wideEmptyBytes);
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <stdexcept>
+#include <vector>
 
 #include "satp/hashing/HashFactory.h"
 #include "satp/algorithms/ProbabilisticCounting.h"
@@ -71,3 +72,18 @@ TEST_CASE("ProbabilisticCounting merge valida compatibilita' parametri", "[prob-
     satp::algorithms::ProbabilisticCounting b(15, defaultHash());
     REQUIRE_THROWS_AS(a.merge(b), invalid_argument);
 }
+
+TEST_CASE("ProbabilisticCounting saveState/loadState ricostruisce la bitmap", "[prob-count][state]") {
+    const auto part = satp::testdata::loadPartition(0);
+    satp::algorithms::ProbabilisticCounting source(16, defaultHash());
+    for (const auto v : part) source.process(v);
+
+    vector<uint8_t> state;
+    source.saveState(state);
+    satp::algorithms::ProbabilisticCounting restored(16, defaultHash());
+    restored.loadState(state);
+    REQUIRE(restored.count() == source.count());
+
+    satp::algorithms::ProbabilisticCounting otherL(15, defaultHash());
+    REQUIRE_THROWS_AS(otherL.loadState(state), invalid_argument);
+}
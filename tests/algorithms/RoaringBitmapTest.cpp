@@ -0,0 +1,93 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "satp/algorithms/RoaringBitmap.h"
+#include "TestData.h"
+
+using namespace std;
+
+using satp::algorithms::RoaringBitmap;
+
+TEST_CASE("RoaringBitmap conta esattamente i distinti del dataset di test", "[roaring]") {
+    const auto dataset = satp::testdata::loadDataset();
+
+    RoaringBitmap bitmap;
+    for (const auto value : dataset.values) {
+        bitmap.add(value);
+    }
+    REQUIRE(bitmap.cardinality() == dataset.distinct);
+    for (const auto value : dataset.values) {
+        REQUIRE(bitmap.contains(value));
+    }
+}
+
+TEST_CASE("RoaringBitmap coincide con std::set su array, bitmap e indice diretto", "[roaring]") {
+    mt19937 rng(7u);
+    // Chiavi alte concentrate: container densi (bitmap) e sparsi (array), oltre la soglia dell'indice diretto.
+    uniform_int_distribution<uint32_t> highDist(0u, 199u);
+    uniform_int_distribution<uint32_t> lowDist(0u, 0xFFFFu);
+
+    RoaringBitmap bitmap;
+    set<uint32_t> reference;
+    for (int i = 0; i < 300000; ++i) {
+        const uint32_t high = (i % 3 == 0) ? 5u : highDist(rng);
+        const uint32_t value = (high << 16u) | lowDist(rng);
+        REQUIRE(bitmap.add(value) == reference.insert(value).second);
+    }
+    REQUIRE(bitmap.cardinality() == reference.size());
+    REQUIRE(bitmap.containerCount() == 200u);
+
+    for (int i = 0; i < 10000; ++i) {
+        const uint32_t probe = (highDist(rng) << 16u) | lowDist(rng);
+        REQUIRE(bitmap.contains(probe) == reference.contains(probe));
+    }
+    REQUIRE_FALSE(bitmap.contains(0xFFFF0000u));
+}
+
+TEST_CASE("RoaringBitmap unione e runOptimize preservano il contenuto", "[roaring][merge]") {
+    RoaringBitmap sparse;
+    RoaringBitmap runs;
+    set<uint32_t> reference;
+    for (uint32_t v = 0; v < 200000u; v += 7u) {
+        sparse.add(v);
+        reference.insert(v);
+    }
+    for (uint32_t v = 100000u; v < 180000u; ++v) {
+        runs.add(v);
+        reference.insert(v);
+    }
+    const size_t denseBytes = runs.sizeInBytes();
+    runs.runOptimize();
+    REQUIRE(runs.sizeInBytes() < denseBytes);
+    REQUIRE(runs.cardinality() == 80000u);
+    REQUIRE(runs.contains(150000u));
+    REQUIRE_FALSE(runs.contains(99999u));
+
+    RoaringBitmap merged = sparse;
+    merged.unionWith(runs);
+    REQUIRE(merged.cardinality() == reference.size());
+
+    RoaringBitmap mergedRev = runs;
+    mergedRev.unionWith(sparse);
+    REQUIRE(mergedRev.cardinality() == reference.size());
+
+    merged.unionWith(merged);
+    REQUIRE(merged.cardinality() == reference.size());
+
+    // Un container a run torna modificabile dopo add().
+    REQUIRE(runs.add(99999u));
+    REQUIRE_FALSE(runs.add(150000u));
+    REQUIRE(runs.cardinality() == 80001u);
+
+    for (const uint32_t v : {0u, 7u, 99999u, 100000u, 179999u, 180000u, 199997u}) {
+        REQUIRE(merged.contains(v) == reference.contains(v));
+    }
+
+    merged.clear();
+    REQUIRE(merged.cardinality() == 0u);
+    REQUIRE_FALSE(merged.contains(0u));
+}
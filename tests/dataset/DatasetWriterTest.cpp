@@ -0,0 +1,170 @@
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "satp/dataset/Dataset.h"
+#include "TestData.h"
+
+using namespace std;
+
+namespace ds = satp::dataset;
+
+namespace {
+    [[nodiscard]] filesystem::path writerOutputPath(const string &name) {
+        return filesystem::temp_directory_path() / name;
+    }
+} // namespace
+
+TEST_CASE("DatasetWriter riproduce partizioni e truth bits del dataset", "[dataset][writer]") {
+    const auto source = ds::indexBinaryDataset(satp::testdata::datasetPath());
+    const auto outPath = writerOutputPath("satp_dataset_writer_roundtrip.bin");
+    filesystem::remove(outPath);
+
+    {
+        ds::DatasetWriterOptions options;
+        options.workers = 2;
+        ds::DatasetWriter writer(outPath, source.info, options);
+        vector<uint32_t> values;
+        for (size_t p = 0; p < source.info.partition_count; ++p) {
+            ds::loadBinaryPartition(source, p, values);
+            writer.append(span<const uint32_t>(values));
+        }
+        writer.close();
+        REQUIRE(writer.completedPartitions() == source.info.partition_count);
+    }
+
+    const auto written = ds::indexBinaryDataset(outPath);
+    REQUIRE(written.info.elements_per_partition == source.info.elements_per_partition);
+    REQUIRE(written.info.distinct_per_partition == source.info.distinct_per_partition);
+    REQUIRE(written.info.partition_count == source.info.partition_count);
+    REQUIRE(written.info.seed == source.info.seed);
+
+    ds::PartitionReader expectedReader(source);
+    ds::PartitionReader actualReader(written);
+    vector<uint32_t> expectedValues;
+    vector<uint32_t> actualValues;
+    vector<uint8_t> expectedTruth;
+    vector<uint8_t> actualTruth;
+    for (size_t p = 0; p < source.info.partition_count; ++p) {
+        expectedReader.loadWithTruthBits(p, expectedValues, expectedTruth);
+        actualReader.loadWithTruthBits(p, actualValues, actualTruth);
+        REQUIRE(actualValues == expectedValues);
+        REQUIRE(actualTruth == expectedTruth);
+    }
+
+    filesystem::remove(outPath);
+}
+
+TEST_CASE("DatasetWriter ricava distinct se non dichiarato", "[dataset][writer]") {
+    const auto outPath = writerOutputPath("satp_dataset_writer_derived.bin");
+    filesystem::remove(outPath);
+
+    ds::DatasetInfo info;
+    info.elements_per_partition = 6;
+    info.partition_count = 2;
+    info.seed = 7;
+    {
+        ds::DatasetWriter writer(outPath, info);
+        for (const uint32_t v : {1u, 2u, 1u, 3u, 2u, 9u, 4u, 4u, 5u, 6u, 4u, 7u}) {
+            writer.append(v);
+        }
+        writer.close();
+    }
+
+    const auto written = ds::indexBinaryDataset(outPath);
+    REQUIRE(written.info.distinct_per_partition == 4u);
+
+    vector<uint8_t> truth;
+    ds::loadBinaryPartitionTruthBits(written, 1, truth);
+    REQUIRE(truth.size() == 1u);
+    REQUIRE(truth[0] == 0b101101u);
+
+    filesystem::remove(outPath);
+}
+
+TEST_CASE("DatasetWriter valida il numero di valori e i distinct", "[dataset][writer]") {
+    const auto outPath = writerOutputPath("satp_dataset_writer_invalid.bin");
+
+    ds::DatasetInfo info;
+    info.elements_per_partition = 2;
+    info.distinct_per_partition = 2;
+    info.partition_count = 1;
+
+    {
+        ds::DatasetWriter writer(outPath, info);
+        writer.append(1u);
+        REQUIRE_THROWS_AS(writer.close(), runtime_error);
+    }
+    {
+        ds::DatasetWriter writer(outPath, info);
+        writer.append(1u);
+        writer.append(2u);
+        REQUIRE_THROWS_AS(writer.append(3u), runtime_error);
+    }
+    {
+        ds::DatasetWriter writer(outPath, info);
+        writer.append(1u);
+        writer.append(1u);
+        REQUIRE_THROWS_AS(writer.close(), runtime_error);
+    }
+
+    info.distinct_per_partition = 3;
+    REQUIRE_THROWS_AS(ds::DatasetWriter(outPath, info), invalid_argument);
+    filesystem::remove(outPath);
+}
+
+TEST_CASE("DatasetWriter scrive dataset v3 con chiavi a 64 bit", "[dataset][writer][keys64]") {
+    const auto outPath = writerOutputPath("satp_dataset_writer_u64.bin");
+    filesystem::remove(outPath);
+
+    ds::DatasetInfo info;
+    info.elements_per_partition = 4;
+    info.partition_count = 2;
+    info.value_bits = 64;
+    const vector<uint64_t> values{
+        1ull << 40u, 7u, 1ull << 40u, 0xffffffffffffffffull,
+        3u, 3u, 5ull << 33u, 9u
+    };
+    {
+        ds::DatasetWriter writer(outPath, info);
+        writer.append(span<const uint64_t>(values));
+        writer.close();
+    }
+
+    const auto written = ds::indexBinaryDataset(outPath);
+    REQUIRE(written.info.value_bits == 64u);
+    REQUIRE(written.info.distinct_per_partition == 3u);
+
+    ds::PartitionReader reader(written);
+    vector<uint64_t> loaded;
+    vector<uint8_t> truth;
+    reader.loadWithTruthBits(0, loaded, truth);
+    REQUIRE(loaded == vector<uint64_t>(values.begin(), values.begin() + 4));
+    REQUIRE(truth[0] == 0b1011u);
+    reader.load(1, loaded);
+    REQUIRE(loaded == vector<uint64_t>(values.begin() + 4, values.end()));
+
+    vector<uint32_t> narrow;
+    REQUIRE_THROWS_AS(reader.load(0, narrow), runtime_error);
+
+    filesystem::remove(outPath);
+}
+
+TEST_CASE("Dataset a 32 bit si legge anche in buffer a 64 bit", "[dataset][keys64]") {
+    const auto index = ds::indexBinaryDataset(satp::testdata::datasetPath());
+    REQUIRE(index.info.value_bits == 32u);
+
+    vector<uint32_t> narrow;
+    vector<uint64_t> wide;
+    ds::loadBinaryPartition(index, 1, narrow);
+    ds::loadBinaryPartition(index, 1, wide);
+    REQUIRE(wide == vector<uint64_t>(narrow.begin(), narrow.end()));
+
+    ds::DatasetInfo info;
+    info.elements_per_partition = 1;
+    info.partition_count = 1;
+    const auto outPath = writerOutputPath("satp_dataset_writer_narrow.bin");
+    ds::DatasetWriter writer(outPath, info);
+    REQUIRE_THROWS_AS(writer.append(uint64_t{1} << 32u), invalid_argument);
+}
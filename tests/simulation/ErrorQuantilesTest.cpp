@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "satp/simulation/detail/metrics/EarlyStopping.h"
+#include "satp/simulation/detail/metrics/ErrorAccumulator.h"
+#include "satp/simulation/detail/metrics/KllSketch.h"
+
+using namespace std;
+
+namespace eval = satp::evaluation;
+using Catch::Approx;
+
+namespace {
+    // Rango normalizzato di value nel campione ordinato.
+    [[nodiscard]] double rankOf(const vector<double> &sorted, const double value) {
+        const auto it = ranges::upper_bound(sorted, value);
+        return static_cast<double>(it - sorted.begin()) / static_cast<double>(sorted.size());
+    }
+} // namespace
+
+TEST_CASE("KllSketch e' esatto finche' il livello 0 non si riempie", "[metrics][quantiles]") {
+    eval::KllSketch sketch;
+    REQUIRE(isnan(sketch.quantile(0.5)));
+
+    for (int i = 100; i >= 1; --i) sketch.add(static_cast<double>(i));
+    REQUIRE(sketch.count() == 100u);
+    REQUIRE(sketch.quantile(0.0) == 1.0);
+    REQUIRE(sketch.quantile(0.5) == 50.0);
+    REQUIRE(sketch.quantile(0.95) == 95.0);
+    REQUIRE(sketch.quantile(1.0) == 100.0);
+
+    REQUIRE_THROWS_AS(eval::KllSketch(4u), invalid_argument);
+    eval::KllSketch other(100u);
+    REQUIRE_THROWS_AS(sketch.merge(other), invalid_argument);
+}
+
+TEST_CASE("KllSketch stima i quantili con errore di rango limitato e si fonde", "[metrics][quantiles]") {
+    mt19937_64 rng(5489u);
+    exponential_distribution<double> distribution(3.0);
+    vector<double> values(200'000);
+    for (auto &value : values) value = distribution(rng);
+
+    eval::KllSketch whole;
+    eval::KllSketch left;
+    eval::KllSketch right;
+    for (size_t i = 0; i < values.size(); ++i) {
+        whole.add(values[i]);
+        (i % 3u == 0u ? left : right).add(values[i]);
+    }
+    left.merge(right);
+    REQUIRE(left.count() == values.size());
+
+    vector<double> sorted = values;
+    ranges::sort(sorted);
+    for (const double q : {0.5, 0.95, 0.99}) {
+        REQUIRE(abs(rankOf(sorted, whole.quantile(q)) - q) <= 0.02);
+        REQUIRE(abs(rankOf(sorted, left.quantile(q)) - q) <= 0.02);
+    }
+}
+
+TEST_CASE("ErrorAccumulator merge coincide con l'accumulo su tutti i run", "[metrics][quantiles]") {
+    mt19937_64 rng(42u);
+    normal_distribution<double> noise(0.0, 25.0);
+
+    eval::ErrorAccumulator whole(true);
+    eval::ErrorAccumulator first(true);
+    eval::ErrorAccumulator second(true);
+    eval::ErrorAccumulator empty(true);
+    for (size_t run = 0; run < 1'000; ++run) {
+        const double truth = 1'000.0 + static_cast<double>(run % 7u);
+        const double estimate = truth + noise(rng);
+        whole.add(estimate, truth);
+        (run < 400u ? first : second).add(estimate, truth);
+    }
+    first.merge(second);
+    first.merge(empty);
+    empty.merge(first);
+
+    for (const auto &merged : {first, empty}) {
+        const auto expected = whole.toStreamingPoint(10u);
+        const auto actual = merged.toStreamingPoint(10u);
+        REQUIRE(actual.mean == Approx(expected.mean).epsilon(1e-12));
+        REQUIRE(actual.variance == Approx(expected.variance).epsilon(1e-9));
+        REQUIRE(actual.truth_mean == Approx(expected.truth_mean).epsilon(1e-12));
+        REQUIRE(actual.rmse == Approx(expected.rmse).epsilon(1e-12));
+        REQUIRE(actual.mean_relative_error == Approx(expected.mean_relative_error).epsilon(1e-12));
+        REQUIRE(actual.runs == expected.runs);
+        REQUIRE(merged.relativeErrorVariance() == Approx(whole.relativeErrorVariance()).epsilon(1e-9));
+        REQUIRE(isfinite(actual.relative_error_p50));
+        REQUIRE(actual.relative_error_p50 <= actual.relative_error_p95);
+        REQUIRE(actual.relative_error_p95 <= actual.relative_error_p99);
+    }
+
+    // Senza quantili le colonne restano NaN.
+    eval::ErrorAccumulator moments;
+    moments.add(10.0, 9.0);
+    REQUIRE(isnan(moments.toStreamingPoint(1u).relative_error_p50));
+}
+
+TEST_CASE("EarlyStopping usa l'intervallo di confidenza della metrica scelta", "[metrics][early-stopping]") {
+    eval::ErrorAccumulator accumulator;
+    const vector<pair<double, double>> samples{{110.0, 100.0}, {95.0, 100.0}, {102.0, 100.0}, {90.0, 100.0}};
+    for (const auto &[estimate, truth] : samples) accumulator.add(estimate, truth);
+
+    // Errori relativi 0.10, 0.05, 0.02, 0.10: media 0.0675, varianza campionaria.
+    const double mean = 0.0675;
+    double m2 = 0.0;
+    for (const double e : {0.10, 0.05, 0.02, 0.10}) m2 += (e - mean) * (e - mean);
+    REQUIRE(accumulator.relativeErrorVariance() == Approx(m2 / 3.0));
+    const double mreWidth = 2.0 * 1.959963984540054 * sqrt(m2 / 3.0 / 4.0);
+    REQUIRE(eval::confidenceWidth(accumulator, eval::StoppingMetric::MeanRelativeError) == Approx(mreWidth));
+    const double meanWidth = 2.0 * 1.959963984540054 * sqrt(accumulator.toStats().variance / 4.0) / 100.0;
+    REQUIRE(eval::confidenceWidth(accumulator, eval::StoppingMetric::Mean) == Approx(meanWidth));
+
+    eval::EarlyStoppingOptions options{mreWidth * 1.01, eval::StoppingMetric::MeanRelativeError, 4u};
+    REQUIRE(eval::hasConverged(options, accumulator));
+    options.minRuns = 5u;
+    REQUIRE_FALSE(eval::hasConverged(options, accumulator));
+    options = {mreWidth * 0.99, eval::StoppingMetric::MeanRelativeError, 2u};
+    REQUIRE_FALSE(eval::hasConverged(options, accumulator));
+    REQUIRE_FALSE(eval::hasConverged({}, accumulator));
+
+    REQUIRE(eval::parseStoppingMetric("mre") == eval::StoppingMetric::MeanRelativeError);
+    REQUIRE(eval::toString(eval::StoppingMetric::Mean) == "mean");
+    REQUIRE_FALSE(eval::parseStoppingMetric("rmse").has_value());
+}
@@ -1,14 +1,24 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <span>
 #include <stdexcept>
+#include <thread>
 
 #include "catch2/catch_approx.hpp"
 #include "catch2/catch_test_macros.hpp"
+#include "satp/algorithms/HyperLogLog.h"
 #include "satp/algorithms/HyperLogLogPlusPlus.h"
+#include "satp/algorithms/LogLog.h"
 #include "satp/algorithms/NaiveCounting.h"
 #include "satp/hashing/HashFactory.h"
+#include "satp/profiling/LatencyHistogram.h"
 #include "satp/simulation/Simulation.h"
 #include "TestData.h"
 
@@ -58,6 +68,43 @@ namespace {
     [[nodiscard]] filesystem::path heterogeneousMergeCsvPath() {
         return filesystem::temp_directory_path() / "satp_merge_heterogeneous_test.csv";
     }
+
+    // HLL++ la cui costruzione fallisce dopo `remaining` sketch: simula un
+    // processo interrotto a meta' valutazione.
+    class InterruptedHyperLogLogPlusPlus {
+    public:
+        static inline size_t remaining = numeric_limits<size_t>::max();
+
+        InterruptedHyperLogLogPlusPlus(const uint32_t precision, const satp::hashing::HashFunction &hashFunction)
+            : sketch_(precision, hashFunction) {
+            if (remaining == 0u) throw runtime_error("valutazione interrotta");
+            --remaining;
+        }
+
+        void process(const uint32_t value) {
+            sketch_.process(value);
+        }
+
+        void process(const uint64_t value) {
+            sketch_.process(value);
+        }
+
+        [[nodiscard]] uint64_t count() {
+            return sketch_.count();
+        }
+
+        [[nodiscard]] size_t memoryBytes() const {
+            return sketch_.memoryBytes();
+        }
+
+    private:
+        alg::HyperLogLogPlusPlus sketch_;
+    };
+
+    [[nodiscard]] string readFile(const filesystem::path &path) {
+        ifstream in(path, ios::binary);
+        return {istreambuf_iterator<char>(in), istreambuf_iterator<char>()};
+    }
 } // namespace
 
 TEST_CASE("Evaluation Framework usa sempre i metadata del dataset", "[eval-framework][metadata]") {
@@ -133,6 +180,693 @@ TEST_CASE("Evaluation Framework streaming notifica il progresso tramite callback
     REQUIRE(finishCalls == 1u);
 }
 
+TEST_CASE("Evaluation Framework streaming con budget denso traccia ogni elemento", "[eval-framework][streaming]") {
+    EvaluationFrameworkFixture fixture;
+    REQUIRE(fixture.bench.streamingCheckpoints() == eval::EvaluationFramework::DEFAULT_STREAMING_CHECKPOINTS);
+    REQUIRE_THROWS_AS(fixture.bench.setStreamingCheckpoints(0u), invalid_argument);
+
+    fixture.bench.setStreamingCheckpoints(eval::EvaluationFramework::ALL_STREAMING_CHECKPOINTS);
+    const auto dense = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(14u);
+    REQUIRE(dense.size() == fixture.sampleSize());
+    for (size_t i = 0; i < dense.size(); ++i) {
+        REQUIRE(dense[i].number_of_elements_processed == i + 1u);
+    }
+
+    // I checkpoint comuni coincidono con quelli del budget di default: le stime
+    // non dipendono da quante volte count() viene chiamato.
+    fixture.bench.setStreamingCheckpoints(eval::EvaluationFramework::DEFAULT_STREAMING_CHECKPOINTS);
+    const auto sparse = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(14u);
+    REQUIRE_FALSE(sparse.empty());
+    for (const auto &point : sparse) {
+        const auto &densePoint = dense[point.number_of_elements_processed - 1u];
+        REQUIRE(densePoint.mean == point.mean);
+        REQUIRE(densePoint.truth_mean == point.truth_mean);
+    }
+}
+
+TEST_CASE("Evaluation Framework streaming con quantili dell'errore relativo", "[eval-framework][streaming][quantiles]") {
+    EvaluationFrameworkFixture fixture;
+    const auto plain = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(10u);
+    REQUIRE_FALSE(plain.empty());
+    REQUIRE(isnan(plain.back().relative_error_p99));
+
+    fixture.bench.setStreamingErrorQuantiles(true);
+    REQUIRE(fixture.bench.streamingErrorQuantiles());
+    const auto series = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(10u);
+    REQUIRE(series.size() == plain.size());
+    for (size_t i = 0; i < series.size(); ++i) {
+        const auto &point = series[i];
+        // I momenti non cambiano abilitando i quantili.
+        REQUIRE(point.mean == plain[i].mean);
+        REQUIRE(point.mean_relative_error == plain[i].mean_relative_error);
+        REQUIRE(point.relative_error_p50 <= point.relative_error_p95);
+        REQUIRE(point.relative_error_p95 <= point.relative_error_p99);
+        REQUIRE(point.relative_error_p99 >= 0.0);
+    }
+
+    const auto exact = fixture.bench.evaluateStreaming<alg::NaiveCounting>();
+    REQUIRE(exact.back().relative_error_p99 == 0.0);
+
+    const auto csvPath = filesystem::temp_directory_path() / "satp_streaming_quantiles_test.csv";
+    filesystem::remove(csvPath);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog++", "k=10", fixture.bench.metadata(), 0.0};
+    eval::CsvResultWriter::appendStreaming(csvPath, descriptor, series, true);
+    ifstream in(csvPath);
+    string header;
+    string row;
+    REQUIRE(getline(in, header));
+    REQUIRE(getline(in, row));
+    REQUIRE(header == eval::CsvResultWriter::STREAMING_QUANTILES_HEADER);
+    REQUIRE(header.starts_with(eval::CsvResultWriter::STREAMING_HEADER));
+    REQUIRE(ranges::count(row, ',') == ranges::count(header, ','));
+    filesystem::remove(csvPath);
+}
+
+TEST_CASE("CsvResultWriter rifiuta l'append su un CSV con intestazione diversa", "[eval-framework][streaming][csv]") {
+    EvaluationFrameworkFixture fixture;
+    const auto series = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(10u);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog++", "k=10", fixture.bench.metadata(), 0.0};
+    const auto csvPath = filesystem::temp_directory_path() / "satp_streaming_header_mismatch_test.csv";
+    const auto readAll = [&] {
+        ifstream in(csvPath, ios::binary);
+        return string(istreambuf_iterator<char>(in), {});
+    };
+    filesystem::remove(csvPath);
+
+    eval::CsvResultWriter::appendStreaming(csvPath, descriptor, series);
+    eval::CsvResultWriter::appendStreaming(csvPath, descriptor, series);
+    const string plain = readAll();
+    REQUIRE(static_cast<size_t>(ranges::count(plain, '\n')) == 1u + 2u * series.size());
+
+    // La variante con i quantili ha colonne in piu': il file resta intatto.
+    REQUIRE_THROWS_AS(eval::CsvResultWriter::appendStreaming(csvPath, descriptor, series, true), runtime_error);
+    REQUIRE(readAll() == plain);
+
+    // Intestazione di una versione precedente, senza bytes_mean.
+    {
+        ofstream legacy(csvPath, ios::trunc);
+        legacy << "algorithm,params,mode,runs,sample_size,number_of_elements_processed,f0,seed,"
+                  "f0_mean_t,f0_hat_mean_t,variance,stddev,rse_theoretical,rse_observed,bias,"
+                  "absolute_bias,relative_bias,mean_relative_error,rmse,mae\n";
+    }
+    REQUIRE_THROWS_AS(eval::CsvResultWriter::appendStreaming(csvPath, descriptor, series), runtime_error);
+    filesystem::remove(csvPath);
+}
+
+TEST_CASE("Evaluation Framework streaming riprende da uno stato salvato con CSV identico", "[eval-framework][streaming][resume]") {
+    EvaluationFrameworkFixture fixture;
+    REQUIRE(fixture.runs() >= 2u);
+    fixture.bench.setStreamingErrorQuantiles(true);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog++", "k=10", fixture.bench.metadata(), 0.0};
+
+    const auto tmpDir = filesystem::temp_directory_path();
+    const auto statePath = tmpDir / "satp_streaming_resume_test.state";
+    const auto referenceCsv = tmpDir / "satp_streaming_resume_reference.csv";
+    const auto resumedCsv = tmpDir / "satp_streaming_resume_resumed.csv";
+    for (const auto &path : {statePath, referenceCsv, resumedCsv}) filesystem::remove(path);
+
+    const auto reference = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(10u);
+    eval::CsvResultWriter::appendStreaming(referenceCsv, descriptor, reference, true);
+
+    fixture.bench.setStreamingResumeState(statePath, chrono::milliseconds{0});
+    REQUIRE(fixture.bench.streamingResumeState() == statePath);
+    InterruptedHyperLogLogPlusPlus::remaining = fixture.runs() - 1u;
+    REQUIRE_THROWS_AS(fixture.bench.evaluateStreaming<InterruptedHyperLogLogPlusPlus>(10u), runtime_error);
+    REQUIRE(filesystem::exists(statePath));
+
+    // Il resume costruisce solo lo sketch dell'ultimo run.
+    InterruptedHyperLogLogPlusPlus::remaining = 1u;
+    size_t resumedTicks = 0;
+    const eval::ProgressCallbacks progress{
+        {},
+        [&resumedTicks](const size_t ticks) { resumedTicks += ticks; },
+        {}
+    };
+    const auto resumed = fixture.bench.evaluateStreaming<InterruptedHyperLogLogPlusPlus>(progress, 10u);
+    InterruptedHyperLogLogPlusPlus::remaining = numeric_limits<size_t>::max();
+    REQUIRE(resumedTicks == fixture.runs() * fixture.sampleSize());
+
+    eval::CsvResultWriter::appendStreaming(resumedCsv, descriptor, resumed, true);
+    REQUIRE(readFile(resumedCsv) == readFile(referenceCsv));
+
+    // Lo stato finale e' completo: rilanciare non rielabora alcun run.
+    InterruptedHyperLogLogPlusPlus::remaining = 0u;
+    const auto replayed = fixture.bench.evaluateStreaming<InterruptedHyperLogLogPlusPlus>(10u);
+    InterruptedHyperLogLogPlusPlus::remaining = numeric_limits<size_t>::max();
+    REQUIRE(replayed.back().mean == reference.back().mean);
+
+    // Uno stato di un'altra configurazione viene rifiutato.
+    fixture.bench.setStreamingCheckpoints(7u);
+    REQUIRE_THROWS_AS(fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(10u), runtime_error);
+
+    fixture.bench.setStreamingResumeState({});
+    for (const auto &path : {statePath, referenceCsv, resumedCsv}) filesystem::remove(path);
+}
+
+TEST_CASE("Evaluation Framework streaming si ferma quando l'intervallo e' stretto", "[eval-framework][streaming][early-stopping]") {
+    EvaluationFrameworkFixture fixture;
+    REQUIRE(fixture.runs() >= 3u);
+    REQUIRE_THROWS_AS(fixture.bench.setStreamingEarlyStopping({-1.0}), invalid_argument);
+    REQUIRE_THROWS_AS(fixture.bench.setStreamingEarlyStopping({0.01, eval::StoppingMetric::Mean, 1u}), invalid_argument);
+
+    const auto full = fixture.bench.evaluateStreaming<alg::NaiveCounting>();
+    REQUIRE(full.back().runs == fixture.runs());
+
+    // Il conteggio esatto ha errore nullo: l'intervallo e' degenere dopo minRuns run.
+    fixture.bench.setStreamingEarlyStopping({1e-9, eval::StoppingMetric::MeanRelativeError, 2u});
+    size_t advancedTicks = 0;
+    const eval::ProgressCallbacks progress{
+        {},
+        [&advancedTicks](const size_t ticks) { advancedTicks += ticks; },
+        {}
+    };
+    const auto stopped = fixture.bench.evaluateStreaming<alg::NaiveCounting>(progress);
+    REQUIRE(stopped.size() == full.size());
+    for (const auto &point : stopped) REQUIRE(point.runs == 2u);
+    REQUIRE(advancedTicks == fixture.runs() * fixture.sampleSize());
+
+    // HLL++ a bassa precisione non raggiunge un'ampiezza cosi' piccola.
+    const auto sketch = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(6u);
+    REQUIRE(sketch.back().runs == fixture.runs());
+
+    const auto csvPath = filesystem::temp_directory_path() / "satp_streaming_early_stopping_test.csv";
+    filesystem::remove(csvPath);
+    const eval::CsvRunDescriptor descriptor{"NaiveCounting", "", fixture.bench.metadata(), 0.0};
+    eval::CsvResultWriter::appendStreaming(csvPath, descriptor, stopped);
+    ifstream in(csvPath);
+    string header;
+    string row;
+    REQUIRE(getline(in, header));
+    REQUIRE(getline(in, row));
+    REQUIRE(row.starts_with("NaiveCounting,,streaming,2,"));
+    filesystem::remove(csvPath);
+}
+
+TEST_CASE("Evaluation Framework streaming: la re-stima dagli snapshot riproduce la serie", "[eval-framework][streaming][snapshots]") {
+    EvaluationFrameworkFixture fixture;
+    fixture.bench.setStreamingErrorQuantiles(true);
+    const auto tmpDir = filesystem::temp_directory_path();
+    const auto hllppSnapshots = tmpDir / "satp_streaming_snapshots_hllpp.bin";
+    const auto hllSnapshots = tmpDir / "satp_streaming_snapshots_hll.bin";
+    const auto referenceCsv = tmpDir / "satp_streaming_snapshots_reference.csv";
+    const auto reestimatedCsv = tmpDir / "satp_streaming_snapshots_reestimated.csv";
+    for (const auto &path : {hllppSnapshots, hllSnapshots, referenceCsv, reestimatedCsv}) filesystem::remove(path);
+
+    fixture.bench.setStreamingSnapshotFile(hllppSnapshots);
+    REQUIRE(fixture.bench.streamingSnapshotFile() == hllppSnapshots);
+    auto reference = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(10u);
+    // Gli snapshot conservano lo stato, non la memoria occupata durante la valutazione.
+    for (auto &point : reference) point.bytes_mean = numeric_limits<double>::quiet_NaN();
+
+    const auto hashFunction = satp::hashing::getHashFunctionBy();
+    alg::HyperLogLogPlusPlus hllpp(10u, *hashFunction);
+    const auto reestimated = eval::reestimateStreaming(hllppSnapshots, hllpp, true);
+    REQUIRE(reestimated.metadata.runs == fixture.runs());
+    REQUIRE(reestimated.metadata.sampleSize == fixture.sampleSize());
+
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog++", "k=10", fixture.bench.metadata(), 0.0};
+    eval::CsvResultWriter::appendStreaming(referenceCsv, descriptor, reference, true);
+    eval::CsvResultWriter::appendStreaming(reestimatedCsv, descriptor, reestimated.series, true);
+    REQUIRE(readFile(reestimatedCsv) == readFile(referenceCsv));
+
+    // Registri HLL ri-stimati con LogLog: stessa serie di una valutazione LogLog.
+    fixture.bench.setStreamingErrorQuantiles(false);
+    fixture.bench.setStreamingSnapshotFile(hllSnapshots);
+    (void) fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    fixture.bench.setStreamingSnapshotFile({});
+    const auto loglogSeries = fixture.bench.evaluateStreaming<alg::LogLog>(10u, 32u);
+    alg::LogLog loglog(10u, 32u, *hashFunction);
+    const auto crossEstimated = eval::reestimateStreaming(hllSnapshots, loglog);
+    REQUIRE(crossEstimated.series.size() == loglogSeries.size());
+    for (size_t i = 0; i < loglogSeries.size(); ++i) {
+        REQUIRE(crossEstimated.series[i].number_of_elements_processed == loglogSeries[i].number_of_elements_processed);
+        REQUIRE(crossEstimated.series[i].mean == loglogSeries[i].mean);
+        REQUIRE(crossEstimated.series[i].truth_mean == loglogSeries[i].truth_mean);
+    }
+
+    // Stato incompatibile con lo sketch di destinazione.
+    alg::HyperLogLog otherK(11u, 32u, *hashFunction);
+    REQUIRE_THROWS_AS(eval::reestimateStreaming(hllSnapshots, otherK), invalid_argument);
+
+    // Gli snapshot non si combinano con il resume.
+    fixture.bench.setStreamingSnapshotFile(hllSnapshots);
+    fixture.bench.setStreamingResumeState(tmpDir / "satp_streaming_snapshots.state");
+    REQUIRE_THROWS_AS(fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u), invalid_argument);
+    fixture.bench.setStreamingResumeState({});
+    fixture.bench.setStreamingSnapshotFile({});
+
+    for (const auto &path : {hllppSnapshots, hllSnapshots, referenceCsv, reestimatedCsv}) filesystem::remove(path);
+}
+
+TEST_CASE("Evaluation Framework streaming valuta piu' stimatori con un solo sketch per run", "[eval-framework][streaming][estimators]") {
+    EvaluationFrameworkFixture fixture;
+    const alg::HyperLogLogEstimator hll;
+    const alg::ImprovedEstimator improved;
+    const alg::MaximumLikelihoodEstimator ml;
+    const vector<const alg::CardinalityEstimator *> estimators{&hll, &improved, &ml};
+
+    size_t ticks = 0;
+    const eval::ProgressCallbacks progress{{}, [&ticks](const size_t advanced) { ticks += advanced; }, {}};
+    const auto results = fixture.bench.evaluateStreamingEstimators<alg::HyperLogLog>(estimators, progress, 10u, 32u);
+    REQUIRE(ticks == fixture.runs() * fixture.sampleSize());
+    REQUIRE(results.size() == 3u);
+    REQUIRE(results[0].estimator == "hll");
+    REQUIRE(results[2].estimator == "ml");
+
+    // Lo stimatore classico riproduce evaluateStreaming, a meno del troncamento di count().
+    const auto reference = fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    for (const auto &result : results) {
+        REQUIRE(result.series.size() == reference.size());
+        for (size_t i = 0; i < reference.size(); ++i) {
+            REQUIRE(result.series[i].number_of_elements_processed == reference[i].number_of_elements_processed);
+            REQUIRE(result.series[i].truth_mean == reference[i].truth_mean);
+            REQUIRE(result.series[i].runs == fixture.runs());
+        }
+    }
+    for (size_t i = 0; i < reference.size(); ++i) {
+        REQUIRE(results[0].series[i].mean == Approx(reference[i].mean).margin(1.0));
+    }
+    REQUIRE(results[1].series.back().mean_relative_error < 0.1);
+    REQUIRE(results[2].series.back().mean_relative_error < 0.1);
+
+    REQUIRE_THROWS_AS(fixture.bench.evaluateStreamingEstimators<alg::HyperLogLog>({}, 10u, 32u), invalid_argument);
+}
+
+TEST_CASE("Evaluation Framework riusa gli sketch senza allocare dopo il warm-up", "[eval-framework][allocations]") {
+    REQUIRE(eval::AllocationCounter::installed());
+    const auto source = satp::dataset::indexBinaryDataset(satp::testdata::datasetPath());
+    const auto path = filesystem::temp_directory_path() / "satp_eval_framework_allocations.bin";
+    constexpr size_t RUNS = 8;
+    {
+        auto info = source.info;
+        info.partition_count = RUNS;
+        satp::dataset::DatasetWriter writer(path, info);
+        vector<uint32_t> values;
+        for (size_t p = 0; p < RUNS; ++p) {
+            satp::dataset::loadBinaryPartition(source, p % source.info.partition_count, values);
+            writer.append(span<const uint32_t>(values));
+        }
+        writer.close();
+    }
+    eval::EvaluationFramework bench(path, satp::hashing::getHashFunctionBy());
+    bench.setWorkerCount(1);
+
+    // Primo run (o prima coppia) di warm-up, poi nessuna allocazione per run.
+    const auto requireSteadyState = [&](const size_t expectedRuns) {
+        const auto &diagnostics = bench.lastDiagnostics();
+        REQUIRE(diagnostics.allocationsTracked);
+        REQUIRE(diagnostics.warmupRuns == 1u);
+        REQUIRE(diagnostics.steadyRuns == expectedRuns - 1u);
+        REQUIRE(diagnostics.warmup.allocations > 0u);
+        REQUIRE(diagnostics.steadyState.allocations == 0u);
+        REQUIRE(diagnostics.steadyState.bytes == 0u);
+    };
+
+    (void) bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    requireSteadyState(RUNS);
+    (void) bench.evaluateStreaming<alg::LogLog>(10u, 32u);
+    requireSteadyState(RUNS);
+    (void) bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(14u);
+    requireSteadyState(RUNS);
+
+    (void) bench.evaluateMergePairs<alg::HyperLogLog>(10u, 32u);
+    requireSteadyState(RUNS / 2u);
+    (void) bench.evaluateMergePairs<alg::HyperLogLogPlusPlus>(14u);
+    requireSteadyState(RUNS / 2u);
+
+    // Uno sketch riportato a zero con reset() stima come uno nuovo.
+    const auto hash = satp::hashing::getHashFunctionBy();
+    alg::HyperLogLogPlusPlus reused(14u, *hash);
+    for (const auto value : satp::testdata::loadPartition(0)) reused.process(value);
+    const auto partition = satp::testdata::loadPartition(1);
+    reused.reset();
+    const eval::AllocationScope scope;
+    for (const auto value : partition) reused.process(value);
+    const uint64_t reusedCount = reused.count();
+    REQUIRE(scope.elapsed().allocations == 0u);
+
+    alg::HyperLogLogPlusPlus fresh(14u, *hash);
+    for (const auto value : partition) fresh.process(value);
+    REQUIRE(reusedCount == fresh.count());
+    filesystem::remove(path);
+}
+
+TEST_CASE("Evaluation Framework misura i tempi per fase e li scrive in timing.csv", "[eval-framework][timing]") {
+    using satp::profiling::Phase;
+    const EvaluationFrameworkFixture fixture;
+    const auto calls = [&](const Phase phase) {
+        return fixture.bench.lastDiagnostics().phases.calls[static_cast<size_t>(phase)];
+    };
+
+    const auto series = fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    const auto streaming = fixture.bench.lastDiagnostics();
+    REQUIRE(streaming.timedRuns == fixture.runs());
+    REQUIRE(streaming.elements == fixture.runs() * fixture.sampleSize());
+    REQUIRE(streaming.wall.count() > 0);
+    REQUIRE(calls(Phase::Read) == fixture.runs());
+    REQUIRE(calls(Phase::Inflate) == fixture.runs());
+    REQUIRE(calls(Phase::TruthDecode) == fixture.runs());
+    REQUIRE(calls(Phase::Ingest) == fixture.runs());
+    REQUIRE(calls(Phase::Estimate) == fixture.runs() * series.size());
+    REQUIRE(calls(Phase::Merge) == 0u);
+    REQUIRE(calls(Phase::Output) == 0u);
+
+    (void) fixture.bench.evaluateMergePairs<alg::HyperLogLog>(10u, 32u);
+    const size_t pairs = fixture.runs() / 2u;
+    REQUIRE(fixture.bench.lastDiagnostics().timedRuns == pairs);
+    REQUIRE(fixture.bench.lastDiagnostics().elements == pairs * 2u * fixture.sampleSize());
+    REQUIRE(calls(Phase::Read) == pairs * 2u);
+    REQUIRE(calls(Phase::TruthDecode) == 0u);
+    REQUIRE(calls(Phase::Merge) == pairs);
+    REQUIRE(calls(Phase::Estimate) == pairs);
+
+    const auto csvPath = filesystem::temp_directory_path() / "satp_eval_framework_timing.csv";
+    filesystem::remove(csvPath);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog", "k=10,L=32", fixture.bench.metadata(), 0.0};
+    eval::CsvResultWriter::appendTiming(csvPath, descriptor, "streaming", streaming);
+    eval::CsvResultWriter::appendTiming(csvPath, descriptor, "streaming", eval::EvaluationDiagnostics{});
+
+    ifstream in(csvPath);
+    string line;
+    REQUIRE(getline(in, line));
+    REQUIRE(line == eval::CsvResultWriter::TIMING_HEADER);
+    vector<string> phases;
+    while (getline(in, line)) {
+        // Dopo mode: runs, sample_size, seed, phase.
+        size_t field = line.find(",streaming,") + 10u;
+        for (int skip = 0; skip < 3; ++skip) field = line.find(',', field + 1u);
+        phases.push_back(line.substr(field + 1u, line.find(',', field + 1u) - field - 1u));
+    }
+    REQUIRE(phases == vector<string>{"read", "inflate", "truth_decode", "ingest", "estimate", "total"});
+    in.close();
+    filesystem::remove(csvPath);
+}
+
+TEST_CASE("Evaluation Framework campiona la memoria degli sketch ai checkpoint", "[eval-framework][streaming][memory]") {
+    EvaluationFrameworkFixture fixture;
+
+    const auto hll = fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    REQUIRE_FALSE(hll.empty());
+    const auto hash = satp::hashing::getHashFunctionBy();
+    const alg::HyperLogLog reference(10u, 32u, *hash);
+    for (const auto &point : hll) {
+        // Registri a dimensione fissa: la media coincide con lo sketch vuoto.
+        REQUIRE(point.bytes_mean == static_cast<double>(reference.memoryBytes()));
+    }
+    REQUIRE(fixture.bench.lastDiagnostics().peakRssBytes > 0u);
+
+    // HLL++ in sparse: lista e buffer crescono con gli elementi inseriti.
+    fixture.bench.setStreamingCheckpoints(2u);
+    const auto hllpp = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(18u);
+    REQUIRE(hllpp.front().bytes_mean >= static_cast<double>(sizeof(alg::HyperLogLogPlusPlus)));
+    REQUIRE(hllpp.back().bytes_mean > hllpp.front().bytes_mean);
+}
+
+TEST_CASE("Evaluation Framework riporta i contatori interni degli sketch ai checkpoint", "[eval-framework][streaming][sketch-stats]") {
+    EvaluationFrameworkFixture fixture;
+    fixture.bench.setStreamingCheckpoints(2u);
+
+    const auto points = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(14u);
+    const auto &stats = fixture.bench.lastDiagnostics().sketchStats;
+    if constexpr (!alg::SKETCH_STATS_ENABLED) {
+        REQUIRE(stats.empty());
+        return;
+    }
+    REQUIRE(stats.size() == points.size());
+    for (size_t i = 0; i < stats.size(); ++i) {
+        REQUIRE(stats[i].number_of_elements_processed == points[i].number_of_elements_processed);
+        REQUIRE(stats[i].runs == fixture.bench.metadata().runs);
+        REQUIRE(stats[i].inserts_mean == static_cast<double>(points[i].number_of_elements_processed));
+    }
+    REQUIRE(stats.back().sparse_flushes_mean >= stats.front().sparse_flushes_mean);
+
+    // La serie non sopravvive a una valutazione senza contatori.
+    (void) fixture.bench.evaluateMergePairs<alg::HyperLogLog>(10u, 32u);
+    REQUIRE(fixture.bench.lastDiagnostics().sketchStats.empty());
+}
+
+TEST_CASE("LatencyHistogram riporta quantili con errore relativo limitato", "[latency]") {
+    using satp::profiling::LatencyHistogram;
+    LatencyHistogram histogram;
+    REQUIRE(histogram.valueAtQuantile(0.99) == 0u);
+
+    for (uint64_t value = 1; value <= 10'000; ++value) histogram.record(value);
+    REQUIRE(histogram.count() == 10'000u);
+    REQUIRE(histogram.min() == 1u);
+    REQUIRE(histogram.max() == 10'000u);
+    REQUIRE(histogram.mean() == Catch::Approx(5000.5));
+    const double tolerance = 1.0 / static_cast<double>(LatencyHistogram::SUB_BUCKETS);
+    for (const double q : {0.5, 0.9, 0.99, 0.999}) {
+        const double exact = q * 10'000.0;
+        const auto reported = static_cast<double>(histogram.valueAtQuantile(q));
+        REQUIRE(reported >= exact);
+        REQUIRE(reported <= exact * (1.0 + tolerance));
+    }
+    REQUIRE(histogram.valueAtQuantile(1.0) == 10'000u);
+    REQUIRE_THROWS_AS(histogram.valueAtQuantile(1.5), invalid_argument);
+
+    // I bucket coprono tutto uint64_t, un picco isolato finisce in coda.
+    REQUIRE(LatencyHistogram::bucketIndex(numeric_limits<uint64_t>::max()) == LatencyHistogram::BUCKET_COUNT - 1u);
+    REQUIRE(LatencyHistogram::highestEquivalentValue(LatencyHistogram::BUCKET_COUNT - 1u)
+            == numeric_limits<uint64_t>::max());
+    LatencyHistogram spike;
+    spike.record(1'000'000);
+    histogram.merge(spike);
+    REQUIRE(histogram.max() == 1'000'000u);
+    REQUIRE(histogram.valueAtQuantile(0.5) == LatencyHistogram::highestEquivalentValue(LatencyHistogram::bucketIndex(5000u)));
+}
+
+TEST_CASE("Evaluation Framework misura la latenza di process, count e merge", "[eval-framework][latency]") {
+    EvaluationFrameworkFixture fixture;
+    fixture.bench.setStreamingCheckpoints(8u);
+    const auto &metadata = fixture.bench.metadata();
+
+    const auto result = fixture.bench.evaluateLatency<alg::HyperLogLogPlusPlus>(14u);
+    REQUIRE(result.runs == metadata.runs);
+    REQUIRE(result.batch == 1u);
+    REQUIRE(result.late_batches == 0u);
+    REQUIRE(result.operations.size() == 3u);
+    const auto &process = result.operations[0];
+    REQUIRE(process.operation == eval::LatencyOperation::Process);
+    REQUIRE(process.calls == metadata.runs * metadata.sampleSize);
+    REQUIRE(result.operations[1].operation == eval::LatencyOperation::Count);
+    REQUIRE(result.operations[1].calls == metadata.runs * 8u);
+    REQUIRE(result.operations[2].operation == eval::LatencyOperation::Merge);
+    REQUIRE(result.operations[2].calls == metadata.runs - 1u);
+    for (const auto &point : result.operations) {
+        REQUIRE(point.p50_ns <= point.p99_ns);
+        REQUIRE(point.p99_ns <= point.p999_ns);
+        REQUIRE(point.p999_ns <= point.max_ns);
+        REQUIRE(point.max_ns > 0.0);
+    }
+    REQUIRE(fixture.bench.lastDiagnostics().timedRuns == metadata.runs);
+
+    // Batch e ritmo: meno misure, e il replay a ritmo fisso rispetta la durata attesa.
+    fixture.bench.setLatencyOptions({64u, 2'000'000.0});
+    const auto start = chrono::steady_clock::now();
+    const auto paced = fixture.bench.evaluateLatency<alg::HyperLogLog>(10u, 32u);
+    const auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    REQUIRE(paced.operations[0].calls == metadata.runs * ((metadata.sampleSize + 63u) / 64u));
+    REQUIRE(elapsed >= 0.9 * static_cast<double>(metadata.runs * metadata.sampleSize) / 2'000'000.0);
+
+    const auto csvPath = filesystem::temp_directory_path() / "satp_eval_framework_latency.csv";
+    filesystem::remove(csvPath);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog", "k=10,L=32", metadata, 0.0};
+    eval::CsvResultWriter::appendLatency(csvPath, descriptor, paced);
+    const string csv = readFile(csvPath);
+    REQUIRE(csv.starts_with(string(eval::CsvResultWriter::LATENCY_HEADER) + "\n"));
+    REQUIRE(csv.find(",latency,") != string::npos);
+    REQUIRE(csv.find(",process,64,") != string::npos);
+    REQUIRE(csv.find(",merge,1,") != string::npos);
+
+    REQUIRE_THROWS_AS(fixture.bench.setLatencyOptions({0u, 0.0}), invalid_argument);
+    REQUIRE_THROWS_AS(fixture.bench.setLatencyOptions({1u, -1.0}), invalid_argument);
+}
+
+TEST_CASE("TraceSink scrive la timeline delle valutazioni in formato Chrome trace", "[eval-framework][trace-events]") {
+    using satp::profiling::TraceSink;
+    EvaluationFrameworkFixture fixture;
+    fixture.bench.setWorkerCount(2u);
+    const auto tracePath = filesystem::temp_directory_path() / "satp_eval_framework_trace.json";
+    const auto csvPath = filesystem::temp_directory_path() / "satp_eval_framework_trace.csv";
+    filesystem::remove(tracePath);
+    filesystem::remove(csvPath);
+
+    TraceSink::start();
+    (void) fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    const auto pairs = fixture.bench.evaluateMergePairs<alg::HyperLogLog>(10u, 32u);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog", "k=10,L=32", fixture.bench.metadata(), 0.0};
+    eval::CsvResultWriter::appendMergePairs(csvPath, descriptor, pairs);
+    TraceSink::stop();
+
+    // Disattivato, il sink non raccoglie altri span.
+    const size_t events = TraceSink::eventCount();
+    REQUIRE(events > 0u);
+    (void) fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    REQUIRE(TraceSink::eventCount() == events);
+
+    TraceSink::write(tracePath);
+    const string trace = readFile(tracePath);
+    REQUIRE(trace.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    REQUIRE(trace.ends_with("]}\n"));
+    for (const string name : {"streaming", "run", "read", "inflate", "truth_decode", "estimate",
+                              "merge_pairs", "pair", "ingest", "merge", "csv_merge"}) {
+        INFO(name);
+        REQUIRE(trace.find("\"name\":\"" + name + "\"") != string::npos);
+    }
+    const auto countOf = [&trace](const string &needle) {
+        size_t count = 0;
+        for (size_t pos = trace.find(needle); pos != string::npos; pos = trace.find(needle, pos + 1u)) ++count;
+        return count;
+    };
+    REQUIRE(countOf("\"ph\":\"X\"") == events);
+    REQUIRE(countOf("\"name\":\"run\"") == fixture.runs());
+    REQUIRE(countOf("\"name\":\"pair\"") == fixture.runs() / 2u);
+
+    // Ripartire scarta gli span precedenti.
+    TraceSink::start();
+    REQUIRE(TraceSink::eventCount() == 0u);
+    TraceSink::stop();
+    filesystem::remove(tracePath);
+    filesystem::remove(csvPath);
+}
+
+TEST_CASE("Evaluation Framework raccoglie i contatori hardware per fase se disponibili", "[eval-framework][timing][perf]") {
+    using satp::profiling::HardwareCounter;
+    using satp::profiling::Phase;
+    const satp::profiling::PerfCounters probe;
+    const auto before = probe.read();
+    REQUIRE(before.any() == probe.available());
+    if (!probe.available(HardwareCounter::Instructions)) {
+        REQUIRE_FALSE(before.has(HardwareCounter::Instructions));
+    }
+
+    EvaluationFrameworkFixture fixture;
+    fixture.bench.setHardwareCounters(true);
+    (void) fixture.bench.evaluateStreaming<alg::HyperLogLog>(10u, 32u);
+    const auto streaming = fixture.bench.lastDiagnostics();
+    REQUIRE(streaming.phases.counters == nullptr);
+    const auto &ingest = streaming.phases.counted(Phase::Ingest);
+    for (size_t i = 0; i < satp::profiling::HARDWARE_COUNTER_COUNT; ++i) {
+        REQUIRE(ingest.measured[i] == probe.available(static_cast<HardwareCounter>(i)));
+    }
+    if (probe.available(HardwareCounter::Instructions)) {
+        // Almeno un'istruzione per elemento ingerito.
+        REQUIRE(ingest.get(HardwareCounter::Instructions) >= streaming.elements);
+    }
+
+    (void) fixture.bench.evaluateMergePairs<alg::HyperLogLog>(10u, 32u);
+    REQUIRE(fixture.bench.lastDiagnostics().phases.counted(Phase::Merge).any() == probe.available());
+
+    // Senza contatori le colonne restano vuote ma presenti.
+    const auto csvPath = filesystem::temp_directory_path() / "satp_eval_framework_timing_counters.csv";
+    filesystem::remove(csvPath);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog", "k=10", fixture.bench.metadata(), 0.0};
+    eval::EvaluationDiagnostics untimed = streaming;
+    untimed.phases.hardware = {};
+    eval::CsvResultWriter::appendTiming(csvPath, descriptor, "streaming", untimed, true);
+    ifstream in(csvPath);
+    string line;
+    REQUIRE(getline(in, line));
+    REQUIRE(line == eval::CsvResultWriter::TIMING_COUNTERS_HEADER);
+    REQUIRE(getline(in, line));
+    REQUIRE(line.ends_with(",,,,,,,,,,"));
+    in.close();
+    filesystem::remove(csvPath);
+}
+
+TEST_CASE("StreamingTraceFile scrive e rilegge trace binari in append", "[eval-framework][streaming][trace]") {
+    const EvaluationFrameworkFixture fixture;
+    const auto series = fixture.bench.evaluateStreaming<alg::HyperLogLogPlusPlus>(12u);
+    REQUIRE_FALSE(series.empty());
+
+    const auto tracePath = filesystem::temp_directory_path() / "satp_streaming_trace_test.bin";
+    filesystem::remove(tracePath);
+    const eval::CsvRunDescriptor descriptor{"HyperLogLog++", "k=12", fixture.bench.metadata(), 0.03};
+    eval::StreamingTraceFile::append(tracePath, descriptor, series);
+    eval::StreamingTraceFile::append(tracePath, descriptor, {});
+
+    const size_t headerBytes = 72u + descriptor.algorithmName.size() + descriptor.algorithmParams.size();
+    REQUIRE(filesystem::file_size(tracePath) ==
+            2u * headerBytes + series.size() * eval::StreamingTraceFile::RECORD_BYTES);
+
+    const auto traces = eval::StreamingTraceFile::read(tracePath);
+    REQUIRE(traces.size() == 2u);
+    REQUIRE(traces[1].series.empty());
+
+    const auto &trace = traces[0];
+    REQUIRE(trace.descriptor.algorithmName == descriptor.algorithmName);
+    REQUIRE(trace.descriptor.algorithmParams == descriptor.algorithmParams);
+    REQUIRE(trace.descriptor.metadata.runs == fixture.runs());
+    REQUIRE(trace.descriptor.metadata.sampleSize == fixture.sampleSize());
+    REQUIRE(trace.descriptor.metadata.seed == fixture.dataset.seed);
+    REQUIRE(trace.descriptor.rseTheoretical == 0.03);
+    REQUIRE(trace.series.size() == series.size());
+    for (size_t i = 0; i < series.size(); ++i) {
+        const auto &expected = series[i];
+        const auto &actual = trace.series[i];
+        REQUIRE(actual.number_of_elements_processed == expected.number_of_elements_processed);
+        REQUIRE(actual.mean == expected.mean);
+        REQUIRE(actual.truth_mean == expected.truth_mean);
+        REQUIRE(actual.variance == expected.variance);
+        REQUIRE(actual.rmse == expected.rmse);
+        REQUIRE(actual.stddev == Approx(expected.stddev));
+        REQUIRE(actual.relative_bias == Approx(expected.relative_bias).margin(1e-12));
+        REQUIRE(actual.rse_observed == Approx(expected.rse_observed).margin(1e-12));
+    }
+
+    filesystem::resize_file(tracePath, headerBytes + 10u);
+    REQUIRE_THROWS_AS(eval::StreamingTraceFile::read(tracePath), runtime_error);
+    filesystem::remove(tracePath);
+}
+
+TEST_CASE("ProgressTracker pubblica a blocchi da piu' worker senza perdere tick", "[eval-framework][progress][parallel]") {
+    size_t startedWith = 0;
+    size_t advancedTicks = 0;
+    size_t advanceCalls = 0;
+    size_t finishCalls = 0;
+    atomic<int> inCallback{0};
+    bool overlapped = false;
+    const eval::ProgressCallbacks progress{
+        [&](const size_t totalTicks) { startedWith = totalTicks; },
+        [&](const size_t ticks) {
+            overlapped = overlapped || inCallback.fetch_add(1) != 0;
+            advancedTicks += ticks;
+            ++advanceCalls;
+            inCallback.fetch_sub(1);
+        },
+        [&]() { ++finishCalls; }
+    };
+
+    constexpr size_t items = 2'000u;
+    constexpr size_t ticksPerItem = 7u;
+    {
+        eval::detail::ProgressTracker tracker(&progress, items * ticksPerItem, chrono::milliseconds(1));
+        eval::detail::parallelFor(items, 4u, [&](size_t, size_t) {
+            this_thread::sleep_for(chrono::microseconds(20));
+            tracker.advance(ticksPerItem);
+        });
+        tracker.finish();
+        tracker.finish();
+    }
+    REQUIRE(startedWith == items * ticksPerItem);
+    REQUIRE(advancedTicks == items * ticksPerItem);
+    REQUIRE(advanceCalls < items);
+    REQUIRE(finishCalls == 1u);
+    REQUIRE_FALSE(overlapped);
+
+    // Senza finish() (es. eccezione) il reporter si ferma e onFinish non viene chiamato.
+    {
+        eval::detail::ProgressTracker tracker(&progress, 1u);
+        tracker.advance(1u);
+    }
+    REQUIRE(finishCalls == 1u);
+
+    eval::detail::ProgressTracker silent(nullptr, 10u);
+    silent.advance(10u);
+    silent.finish();
+}
+
 TEST_CASE("Checkpoint planner rispetta il budget e copre l'intero stream", "[eval-framework][streaming]") {
     constexpr size_t n = 10'000'000u;
     constexpr size_t maxPoints = eval::EvaluationFramework::DEFAULT_STREAMING_CHECKPOINTS;
@@ -210,8 +944,9 @@ TEST_CASE("Evaluation Framework merge notifica il progresso tramite callback", "
     const auto points = fixture.bench.evaluateMergePairs<alg::NaiveCounting>(progress);
 
     REQUIRE(points.size() == fixture.runs() / 2u);
-    REQUIRE(startedWith == (fixture.runs() / 2u) * fixture.sampleSize() * 4u);
-    REQUIRE(advancedTicks == (fixture.runs() / 2u) * fixture.sampleSize() * 4u);
+    // sketchA + sketchB + coda seriale su partB: partA non viene reingerita.
+    REQUIRE(startedWith == (fixture.runs() / 2u) * fixture.sampleSize() * 3u);
+    REQUIRE(advancedTicks == (fixture.runs() / 2u) * fixture.sampleSize() * 3u);
     REQUIRE(finishCalls == 1u);
 }
 
@@ -334,6 +1069,18 @@ TEST_CASE("Evaluation Framework merge eterogeneo diretto coincide con la baselin
     REQUIRE(points.size() == fixture.runs() / 2u);
     REQUIRE_FALSE(points.empty());
 
+    // Ogni partizione e' decodificata una volta, truth bit compresi; merge e
+    // stime contano sia il merge sia la baseline.
+    using satp::profiling::Phase;
+    const auto &diagnostics = fixture.bench.lastDiagnostics();
+    const auto calls = [&](const Phase phase) { return diagnostics.phases.calls[static_cast<size_t>(phase)]; };
+    REQUIRE(diagnostics.timedRuns == points.size());
+    REQUIRE(diagnostics.elements == points.size() * 2u * fixture.sampleSize());
+    REQUIRE(calls(Phase::Read) == points.size() * 2u);
+    REQUIRE(calls(Phase::TruthDecode) == points.size() * 2u);
+    REQUIRE(calls(Phase::Merge) == points.size() * 2u);
+    REQUIRE(calls(Phase::Estimate) == points.size() * 3u);
+
     for (const auto &point : points) {
         REQUIRE(isfinite(point.exact_union));
         REQUIRE(isfinite(point.estimate_merge));
@@ -437,3 +1184,283 @@ TEST_CASE("Evaluation Framework merge eterogeneo recoverable supporta unsafe_nai
         return point.delta_vs_baseline > 0.0;
     }));
 }
+
+TEST_CASE("Evaluation Framework su dataset v3 a 64 bit coincide con il dataset a 32 bit", "[eval-framework][keys64]") {
+    const auto source = satp::dataset::indexBinaryDataset(satp::testdata::datasetPath());
+    const auto widePath = filesystem::temp_directory_path() / "satp_eval_framework_u64.bin";
+    {
+        auto info = source.info;
+        info.value_bits = 64;
+        satp::dataset::DatasetWriter writer(widePath, info);
+        vector<uint32_t> values;
+        for (size_t p = 0; p < source.info.partition_count; ++p) {
+            satp::dataset::loadBinaryPartition(source, p, values);
+            writer.append(span<const uint32_t>(values));
+        }
+        writer.close();
+    }
+
+    const eval::EvaluationFramework narrow(satp::testdata::datasetPath(), satp::hashing::getHashFunctionBy());
+    const eval::EvaluationFramework wide(widePath, satp::hashing::getHashFunctionBy());
+
+    const auto narrowSeries = narrow.evaluateStreaming<alg::HyperLogLogPlusPlus>(14u);
+    const auto wideSeries = wide.evaluateStreaming<alg::HyperLogLogPlusPlus>(14u);
+    REQUIRE(wideSeries.size() == narrowSeries.size());
+    for (size_t i = 0; i < narrowSeries.size(); ++i) {
+        REQUIRE(wideSeries[i].mean == narrowSeries[i].mean);
+        REQUIRE(wideSeries[i].truth_mean == narrowSeries[i].truth_mean);
+    }
+
+    const auto narrowMerge = narrow.evaluateMergePairs<alg::HyperLogLogPlusPlus>(14u);
+    const auto wideMerge = wide.evaluateMergePairs<alg::HyperLogLogPlusPlus>(14u);
+    REQUIRE(wideMerge.size() == narrowMerge.size());
+    for (size_t i = 0; i < narrowMerge.size(); ++i) {
+        REQUIRE(wideMerge[i].estimate_merge == narrowMerge[i].estimate_merge);
+        REQUIRE(wideMerge[i].estimate_serial == narrowMerge[i].estimate_serial);
+    }
+
+    filesystem::remove(widePath);
+}
+
+TEST_CASE("Evaluation Framework merge topology: livelli e drift con NaiveCounting", "[eval-framework][merge][topology]") {
+    const EvaluationFrameworkFixture fixture;
+    set<uint32_t> exact;
+    for (size_t p = 0; p < fixture.runs(); ++p) {
+        const auto values = satp::testdata::loadPartition(p);
+        exact.insert(values.begin(), values.end());
+    }
+
+    eval::MergeTopologyOptions options;
+    options.workers = 2;
+
+    options.topology = eval::MergeTopology::BalancedTree;
+    const auto tree = fixture.bench.evaluateMergeTopology<alg::NaiveCounting>(options);
+    REQUIRE(tree.partitions == fixture.runs());
+    REQUIRE(tree.workers == 2u);
+    REQUIRE(tree.levels.size() == 3u); // 3 foglie -> 2 nodi -> radice
+    REQUIRE(tree.levels[0].nodes == 3u);
+    REQUIRE(tree.levels[0].merges == 0u);
+    REQUIRE(tree.levels[1].nodes == 2u);
+    REQUIRE(tree.levels[1].merges == 1u);
+    REQUIRE(tree.levels[2].nodes == 1u);
+
+    options.topology = eval::MergeTopology::LeftDeepChain;
+    const auto chain = fixture.bench.evaluateMergeTopology<alg::NaiveCounting>(options);
+    REQUIRE(chain.levels.size() == fixture.runs());
+
+    using satp::profiling::Phase;
+    const auto &diagnostics = fixture.bench.lastDiagnostics();
+    const auto calls = [&](const Phase phase) { return diagnostics.phases.calls[static_cast<size_t>(phase)]; };
+    REQUIRE(diagnostics.timedRuns == fixture.runs());
+    REQUIRE(calls(Phase::Read) == fixture.runs());
+    REQUIRE(calls(Phase::TruthDecode) == fixture.runs());
+    REQUIRE(calls(Phase::Ingest) == fixture.runs());
+    REQUIRE(calls(Phase::Merge) == fixture.runs() - 1u);
+    REQUIRE(calls(Phase::Estimate) == fixture.runs() + (fixture.runs() - 1u));
+
+    for (const auto *result : {&tree, &chain}) {
+        for (const auto &level : result->levels) {
+            REQUIRE(level.drift_rel_max == Approx(0.0).margin(1e-12));
+            REQUIRE(level.wall_seconds >= 0.0);
+        }
+        REQUIRE(result->levels.back().exact_union_mean == Approx(static_cast<double>(exact.size())));
+        REQUIRE(result->levels.back().estimate_mean == Approx(static_cast<double>(exact.size())));
+    }
+}
+
+TEST_CASE("Evaluation Framework merge topology: parallelo deterministico e sottoinsiemi", "[eval-framework][merge][topology]") {
+    const EvaluationFrameworkFixture fixture;
+    constexpr uint32_t P = 10;
+
+    eval::MergeTopologyOptions serialOptions;
+    serialOptions.workers = 1;
+    eval::MergeTopologyOptions parallelOptions;
+    parallelOptions.workers = 3;
+    const auto serial = fixture.bench.evaluateMergeTopology<alg::HyperLogLogPlusPlus>(serialOptions, P);
+    const auto parallel = fixture.bench.evaluateMergeTopology<alg::HyperLogLogPlusPlus>(parallelOptions, P);
+    REQUIRE(serial.levels.size() == parallel.levels.size());
+    for (size_t i = 0; i < serial.levels.size(); ++i) {
+        REQUIRE(serial.levels[i].estimate_mean == parallel.levels[i].estimate_mean);
+        REQUIRE(serial.levels[i].drift_rel_mean == parallel.levels[i].drift_rel_mean);
+    }
+
+    eval::MergeTopologyOptions sampled;
+    sampled.partitions = 2;
+    sampled.sampleSeed = 11u;
+    const auto subset = fixture.bench.evaluateMergeTopology<alg::NaiveCounting>(sampled);
+    REQUIRE(subset.partitions == 2u);
+    REQUIRE(subset.levels.size() == 2u);
+
+    eval::MergeTopologyOptions tooMany;
+    tooMany.partitions = fixture.runs() + 1u;
+    REQUIRE_THROWS_AS(fixture.bench.evaluateMergeTopology<alg::NaiveCounting>(tooMany), invalid_argument);
+
+    eval::MergeTopologyOptions custom;
+    custom.topology = eval::MergeTopology::Custom;
+    REQUIRE_THROWS_AS(fixture.bench.evaluateMergeTopology<alg::NaiveCounting>(custom), invalid_argument);
+}
+
+TEST_CASE("CsvResultWriter serializza il CSV della merge topology", "[eval-framework][merge][topology][csv]") {
+    const EvaluationFrameworkFixture fixture;
+    const auto csvPath = filesystem::temp_directory_path() / "satp_merge_topology_test.csv";
+    filesystem::remove(csvPath);
+
+    eval::MergeTopologyOptions options;
+    options.workers = 1;
+    const auto result = fixture.bench.evaluateMergeTopology<alg::NaiveCounting>(options);
+    const eval::CsvRunDescriptor descriptor{"NaiveCounting", "", fixture.bench.metadata(), 0.0};
+    eval::CsvResultWriter::appendMergeTopology(csvPath, descriptor, result);
+
+    ifstream in(csvPath);
+    string header;
+    getline(in, header);
+    REQUIRE(header == eval::CsvResultWriter::MERGE_TOPOLOGY_HEADER);
+    size_t rows = 0;
+    for (string line; getline(in, line);) {
+        REQUIRE(line.starts_with("NaiveCounting,,merge_topology,balanced_tree,3,"));
+        ++rows;
+    }
+    REQUIRE(rows == result.levels.size());
+    filesystem::remove(csvPath);
+}
+
+TEST_CASE("Evaluation Framework merge pairs in parallelo coincide con l'esecuzione seriale", "[eval-framework][merge][parallel]") {
+    const auto source = satp::dataset::indexBinaryDataset(satp::testdata::datasetPath());
+    const auto path = filesystem::temp_directory_path() / "satp_eval_framework_pairs.bin";
+    {
+        auto info = source.info;
+        info.partition_count = 8;
+        satp::dataset::DatasetWriter writer(path, info);
+        vector<uint32_t> values;
+        for (size_t p = 0; p < info.partition_count; ++p) {
+            satp::dataset::loadBinaryPartition(source, p % source.info.partition_count, values);
+            writer.append(span<const uint32_t>(values));
+        }
+        writer.close();
+    }
+
+    eval::EvaluationFramework serialBench(path, satp::hashing::getHashFunctionBy());
+    eval::EvaluationFramework parallelBench(path, satp::hashing::getHashFunctionBy());
+    serialBench.setWorkerCount(1);
+    parallelBench.setWorkerCount(4);
+    REQUIRE(parallelBench.workerCount() == 4u);
+
+    const auto serialPoints = serialBench.evaluateMergePairs<alg::HyperLogLogPlusPlus>(14u);
+    const auto parallelPoints = parallelBench.evaluateMergePairs<alg::HyperLogLogPlusPlus>(14u);
+    REQUIRE(parallelPoints.size() == 4u);
+    REQUIRE(serialPoints.size() == parallelPoints.size());
+    for (size_t i = 0; i < serialPoints.size(); ++i) {
+        REQUIRE(parallelPoints[i].pair_index == i);
+        REQUIRE(parallelPoints[i].estimate_merge == serialPoints[i].estimate_merge);
+        REQUIRE(parallelPoints[i].estimate_serial == serialPoints[i].estimate_serial);
+    }
+
+    // Il seriale derivato dalla copia di sketchA coincide con uno sketch
+    // costruito da zero su partA e poi partB.
+    const auto hash = satp::hashing::getHashFunctionBy();
+    alg::HyperLogLogPlusPlus fresh(14u, *hash);
+    for (const size_t p : {size_t{2}, size_t{0}}) {
+        for (const auto value : satp::testdata::loadPartition(p)) fresh.process(value);
+    }
+    REQUIRE(parallelPoints[1].estimate_serial == static_cast<double>(fresh.count()));
+
+    size_t startedWith = 0;
+    size_t advancedTicks = 0;
+    const eval::ProgressCallbacks progress{
+        [&](const size_t totalTicks) { startedWith = totalTicks; },
+        [&](const size_t ticks) { advancedTicks += ticks; },
+        []() {}
+    };
+    const eval::HeterogeneousMergeRunDescriptor descriptor{
+        "HyperLogLog++",
+        {"splitmix64", 0u, "k=14"},
+        {"splitmix64", 0u, "k=14"},
+        eval::MergeStrategy::Direct,
+        eval::MergeValidity::Valid,
+        eval::MergeTopology::Pairwise,
+        parallelBench.metadata(),
+        eval::MergeSketchContext{"splitmix64", 0u, "k=14"},
+        eval::MergeSketchContext{"splitmix64", 0u, "k=14"}
+    };
+    const auto serialHetero = serialBench.evaluateHeterogeneousMergePairs<alg::HyperLogLogPlusPlus>(
+        descriptor,
+        buildHllppFromContext);
+    const auto parallelHetero = parallelBench.evaluateHeterogeneousMergePairs<alg::HyperLogLogPlusPlus>(
+        descriptor,
+        progress,
+        buildHllppFromContext);
+    // Seriale e baseline riusano sketchA/sketchB: 3n tick per coppia.
+    REQUIRE(startedWith == 4u * source.info.elements_per_partition * 3u);
+    REQUIRE(advancedTicks == startedWith);
+    REQUIRE(serialHetero.size() == parallelHetero.size());
+    for (size_t i = 0; i < serialHetero.size(); ++i) {
+        REQUIRE(parallelHetero[i].exact_union == serialHetero[i].exact_union);
+        REQUIRE(parallelHetero[i].estimate_serial == serialHetero[i].estimate_serial);
+        REQUIRE(parallelHetero[i].estimate_serial == parallelPoints[i].estimate_serial);
+        REQUIRE(parallelHetero[i].baseline_homogeneous == parallelPoints[i].estimate_merge);
+    }
+    filesystem::remove(path);
+}
+
+TEST_CASE("Evaluation Framework matrice di merge eterogeneo coincide con le singole celle", "[eval-framework][merge][heterogeneous][matrix]") {
+    EvaluationFrameworkFixture fixture;
+    const auto metadata = fixture.bench.metadata();
+    const eval::MergeSketchContext splitmix14{"splitmix64", 0u, "k=14"};
+    const eval::MergeSketchContext splitmix10{"splitmix64", 0u, "k=10"};
+    const eval::MergeSketchContext xxhash14{"xxhash64", 123u, "k=14"};
+
+    const vector<eval::HeterogeneousMergeRunDescriptor> cells{
+        {"HyperLogLog++", splitmix14, splitmix14, eval::MergeStrategy::Direct, eval::MergeValidity::Valid,
+         eval::MergeTopology::Pairwise, metadata, splitmix14, splitmix14},
+        {"HyperLogLog++", splitmix14, splitmix10, eval::MergeStrategy::ReduceThenMerge,
+         eval::MergeValidity::Recoverable, eval::MergeTopology::Pairwise, metadata, splitmix10, splitmix10},
+        {"HyperLogLog++", splitmix14, splitmix10, eval::MergeStrategy::UnsafeNaiveMerge,
+         eval::MergeValidity::Recoverable, eval::MergeTopology::Pairwise, metadata, splitmix10, splitmix10},
+        {"HyperLogLog++", splitmix14, xxhash14, eval::MergeStrategy::Reject, eval::MergeValidity::Invalid,
+         eval::MergeTopology::Pairwise, metadata}
+    };
+
+    size_t startedWith = 0;
+    size_t advancedTicks = 0;
+    const eval::ProgressCallbacks progress{
+        [&](const size_t totalTicks) { startedWith = totalTicks; },
+        [&](const size_t ticks) { advancedTicks += ticks; },
+        []() {}
+    };
+    fixture.bench.setWorkerCount(2);
+    const auto matrix = fixture.bench.evaluateHeterogeneousMergeMatrix<alg::HyperLogLogPlusPlus>(
+        cells,
+        progress,
+        buildHllppFromContext);
+
+    const auto &diagnostics = fixture.bench.lastDiagnostics();
+    REQUIRE(diagnostics.timedRuns == fixture.runs() / 2u);
+    REQUIRE(diagnostics.phases.calls[static_cast<size_t>(satp::profiling::Phase::Read)] == 2u * (fixture.runs() / 2u));
+    REQUIRE(diagnostics.phases.calls[static_cast<size_t>(satp::profiling::Phase::Ingest)] > 0u);
+
+    // Tre sketch distinti (splitmix k=14, splitmix k=10, xxhash k=14) e due seriali.
+    REQUIRE(startedWith == (fixture.runs() / 2u) * fixture.sampleSize() * (2u * 3u + 2u));
+    REQUIRE(advancedTicks == startedWith);
+    REQUIRE(matrix.size() == cells.size());
+    for (size_t c = 0; c < cells.size(); ++c) {
+        const auto single = fixture.bench.evaluateHeterogeneousMergePairs<alg::HyperLogLogPlusPlus>(
+            cells[c],
+            buildHllppFromContext);
+        REQUIRE(matrix[c].size() == single.size());
+        for (size_t i = 0; i < single.size(); ++i) {
+            const auto sameOrBothNan = [](const double a, const double b) {
+                return (isnan(a) && isnan(b)) || a == b;
+            };
+            REQUIRE(matrix[c][i].pair_index == single[i].pair_index);
+            REQUIRE(matrix[c][i].exact_union == single[i].exact_union);
+            REQUIRE(sameOrBothNan(matrix[c][i].estimate_merge, single[i].estimate_merge));
+            REQUIRE(matrix[c][i].estimate_serial == single[i].estimate_serial);
+            REQUIRE(sameOrBothNan(matrix[c][i].baseline_homogeneous, single[i].baseline_homogeneous));
+            REQUIRE(sameOrBothNan(matrix[c][i].delta_vs_baseline, single[i].delta_vs_baseline));
+        }
+    }
+
+    REQUIRE(fixture.bench.evaluateHeterogeneousMergeMatrix<alg::HyperLogLogPlusPlus>(
+        vector<eval::HeterogeneousMergeRunDescriptor>{},
+        buildHllppFromContext).empty());
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "satp/simulation/Simulation.h"
+#include "TestData.h"
+
+using namespace std;
+
+namespace detail = satp::evaluation::detail;
+
+TEST_CASE("ExactDistinctCache ricava i distinti ordinati dai truth bits", "[simulation][exact-union]") {
+    const auto index = satp::dataset::indexBinaryDataset(satp::testdata::datasetPath());
+    detail::ExactDistinctCache cache;
+
+    for (size_t p = 0; p < index.info.partition_count; ++p) {
+        const auto values = satp::testdata::loadPartition(p);
+        const set<uint32_t> expected(values.begin(), values.end());
+
+        const auto distinct = cache.sortedDistinct<uint32_t>(index, p);
+        REQUIRE(distinct->size() == index.info.distinct_per_partition);
+        REQUIRE(ranges::equal(*distinct, expected));
+
+        const auto wide = cache.sortedDistinct<uint64_t>(index, p);
+        REQUIRE(ranges::equal(*wide, expected));
+    }
+    REQUIRE(cache.misses() == 2u * index.info.partition_count);
+
+    const auto again = cache.sortedDistinct<uint32_t>(index, 0);
+    REQUIRE(cache.hits() == 1u);
+    REQUIRE(again->size() == index.info.distinct_per_partition);
+}
+
+TEST_CASE("ExactDistinctCache costruisce i distinti da una partizione gia' decodificata", "[simulation][exact-union]") {
+    const auto index = satp::dataset::indexBinaryDataset(satp::testdata::datasetPath());
+    satp::dataset::PartitionReader reader(index);
+    vector<uint32_t> values;
+    vector<uint8_t> truthBits;
+    reader.loadWithTruthBits(1, values, truthBits);
+
+    detail::ExactDistinctCache fromDataset;
+    detail::ExactDistinctCache fromBuffers;
+    const auto expected = fromDataset.sortedDistinct<uint32_t>(index, 1);
+    const auto built = fromBuffers.sortedDistinct(1, values, truthBits);
+    REQUIRE(*built == *expected);
+    REQUIRE(built->capacity() == built->size());
+
+    const auto distinct = detail::ExactDistinctCache::firstOccurrences(values, truthBits);
+    REQUIRE(distinct.size() == index.info.distinct_per_partition);
+    REQUIRE(set<uint32_t>(distinct.begin(), distinct.end()) == set<uint32_t>(values.begin(), values.end()));
+
+    // Hit: la partizione non viene ricostruita, qualunque sia l'overload.
+    REQUIRE(fromBuffers.sortedDistinct(1, vector<uint32_t>{}) == built);
+    REQUIRE(fromBuffers.sortedDistinct<uint32_t>(index, 1) == built);
+    REQUIRE(fromBuffers.hits() == 2u);
+    REQUIRE(fromBuffers.misses() == 1u);
+
+    truthBits.pop_back();
+    REQUIRE_THROWS_AS(detail::ExactDistinctCache::firstOccurrences(values, truthBits), runtime_error);
+}
+
+TEST_CASE("Unione esatta da array ordinati coincide con l'insieme", "[simulation][exact-union]") {
+    const auto index = satp::dataset::indexBinaryDataset(satp::testdata::datasetPath());
+    const auto partA = satp::testdata::loadPartition(0);
+    const auto partB = satp::testdata::loadPartition(1);
+    set<uint32_t> expected(partA.begin(), partA.end());
+    expected.insert(partB.begin(), partB.end());
+
+    detail::ExactDistinctCache cache;
+    const auto distinctA = cache.sortedDistinct<uint32_t>(index, 0);
+    const auto distinctB = cache.sortedDistinct<uint32_t>(index, 1);
+    REQUIRE(detail::sortedUnionCardinality(*distinctA, *distinctB) == expected.size());
+    REQUIRE(detail::sortedUnionCardinality(*distinctA, *distinctA) == distinctA->size());
+    REQUIRE(detail::sortedUnionCardinality(*distinctA, vector<uint32_t>{}) == distinctA->size());
+
+    const vector<uint32_t> left{1u, 3u, 5u, 7u};
+    const vector<uint32_t> right{2u, 3u, 7u, 9u, 11u};
+    REQUIRE(detail::sortedUnionCardinality(left, right) == 7u);
+}
+
+TEST_CASE("ExactDistinctCache rispetta il budget in ordine LRU", "[simulation][exact-union]") {
+    const auto index = satp::dataset::indexBinaryDataset(satp::testdata::datasetPath());
+    const size_t arrayBytes = index.info.distinct_per_partition * sizeof(uint32_t);
+    detail::ExactDistinctCache cache(2u * arrayBytes);
+
+    const auto first = cache.sortedDistinct<uint32_t>(index, 0);
+    (void) cache.sortedDistinct<uint32_t>(index, 1);
+    (void) cache.sortedDistinct<uint32_t>(index, 0); // 0 diventa il piu' recente
+    (void) cache.sortedDistinct<uint32_t>(index, 2); // espelle 1
+    REQUIRE(cache.cachedBytes() == 2u * arrayBytes);
+    REQUIRE(cache.hits() == 1u);
+
+    (void) cache.sortedDistinct<uint32_t>(index, 0);
+    REQUIRE(cache.hits() == 2u);
+    (void) cache.sortedDistinct<uint32_t>(index, 1);
+    REQUIRE(cache.misses() == 4u);
+
+    // Un array espulso resta valido per chi lo sta usando.
+    REQUIRE(first->size() == index.info.distinct_per_partition);
+}
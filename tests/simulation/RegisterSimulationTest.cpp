@@ -0,0 +1,116 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "satp/algorithms/Estimators.h"
+#include "satp/algorithms/HyperLogLog.h"
+#include "satp/hashing/HashFactory.h"
+#include "satp/simulation/detail/metrics/ErrorAccumulator.h"
+#include "satp/simulation/detail/streaming/RegisterSimulation.h"
+
+using namespace std;
+
+namespace eval = satp::evaluation;
+
+TEST_CASE("La simulazione dei registri riproduce l'ingestione reale a piccoli n", "[simulation][register-sim]") {
+    constexpr uint32_t P = 8;
+    constexpr size_t RUNS = 400;
+    const vector<size_t> cardinalities{100u, 1'000u, 10'000u};
+    const auto estimator = satp::algorithms::estimators::makeEstimator("hll");
+
+    // Ingestione reale: un HyperLogLog per run su valori distinti disgiunti.
+    const auto hash = satp::hashing::getHashFunctionBy();
+    vector<eval::ErrorAccumulator> real(cardinalities.size());
+    for (size_t run = 0; run < RUNS; ++run) {
+        satp::algorithms::HyperLogLog hll(P, 32, *hash);
+        uint32_t next = 0;
+        for (size_t i = 0; i < cardinalities.size(); ++i) {
+            for (; next < cardinalities[i]; ++next) hll.process(static_cast<uint32_t>(run * 1'000'000u) + next);
+            real[i].add(estimator->estimate(hll.registerView()), static_cast<double>(cardinalities[i]));
+        }
+    }
+
+    eval::RegisterSimulationOptions options;
+    options.precision = P;
+    options.hashBits = 32;
+    options.cardinalities = cardinalities;
+    options.runs = RUNS;
+    options.seed = 7;
+    const auto simulated = eval::simulateRegisterStreaming(options, {estimator.get()});
+    REQUIRE(simulated.size() == 1u);
+    REQUIRE(simulated.front().estimator == "hll");
+    REQUIRE(simulated.front().series.size() == cardinalities.size());
+
+    for (size_t i = 0; i < cardinalities.size(); ++i) {
+        const auto &point = simulated.front().series[i];
+        const auto expected = real[i].toStreamingPoint(cardinalities[i]);
+        REQUIRE(point.number_of_elements_processed == cardinalities[i]);
+        REQUIRE(point.runs == RUNS);
+        REQUIRE(point.truth_mean == static_cast<double>(cardinalities[i]));
+        // Media entro ~3 errori standard della differenza, dispersione entro il 15%.
+        REQUIRE(abs(point.mean - expected.mean) <= 0.015 * static_cast<double>(cardinalities[i]));
+        REQUIRE(abs(point.rse_observed - expected.rse_observed) <= 0.15 * expected.rse_observed);
+    }
+}
+
+TEST_CASE("La simulazione dei registri raggiunge cardinalita' estreme", "[simulation][register-sim]") {
+    constexpr uint32_t P = 12;
+    const auto improved = satp::algorithms::estimators::makeEstimator("improved");
+    const auto hllpp = satp::algorithms::estimators::makeEstimator("hllpp");
+
+    eval::RegisterSimulationOptions options;
+    options.precision = P;
+    options.hashBits = 64;
+    options.cardinalities = {1'000'000u, 1'000'000'000u, 1'000'000'000'000u};
+    options.runs = 64;
+    options.seed = 11;
+    const auto results = eval::simulateRegisterStreaming(options, {improved.get(), hllpp.get()});
+    REQUIRE(results.size() == 2u);
+
+    const double rse = 1.04 / sqrt(static_cast<double>(1u << P));
+    for (const auto &result : results) {
+        for (const auto &point : result.series) {
+            REQUIRE(abs(point.relative_bias) <= 3.0 * rse / sqrt(64.0) + 0.005);
+            REQUIRE(point.rse_observed <= 1.5 * rse);
+        }
+    }
+
+    // Stesso seed, stessi risultati bit a bit con qualunque numero di worker.
+    for (const size_t workers : {size_t{1}, size_t{3}, size_t{8}}) {
+        options.workers = workers;
+        const auto other = eval::simulateRegisterStreaming(options, {improved.get(), hllpp.get()});
+        REQUIRE(other.size() == results.size());
+        for (size_t column = 0; column < results.size(); ++column) {
+            const auto &expected = results[column].series;
+            const auto &actual = other[column].series;
+            REQUIRE(actual.size() == expected.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                REQUIRE(actual[i].mean == expected[i].mean);
+                REQUIRE(actual[i].variance == expected[i].variance);
+                REQUIRE(actual[i].rse_observed == expected[i].rse_observed);
+                REQUIRE(actual[i].mae == expected[i].mae);
+            }
+        }
+    }
+}
+
+TEST_CASE("La simulazione dei registri valida i parametri", "[simulation][register-sim][params]") {
+    const auto estimator = satp::algorithms::estimators::makeEstimator("hll");
+    eval::RegisterSimulationOptions options;
+    options.cardinalities = {10u, 10u};
+    REQUIRE_THROWS_AS(eval::simulateRegisterStreaming(options, {estimator.get()}), invalid_argument);
+    options.cardinalities = {10u};
+    REQUIRE_THROWS_AS(eval::simulateRegisterStreaming(options, {}), invalid_argument);
+    REQUIRE_THROWS_AS(eval::simulateRegisterStreaming(options, {nullptr}), invalid_argument);
+    options.precision = 32;
+    REQUIRE_THROWS_AS(eval::simulateRegisterStreaming(options, {estimator.get()}), invalid_argument);
+
+    eval::RegisterSimulator simulator(4u, 32u, 1u);
+    simulator.addDistinct(0u);
+    REQUIRE(simulator.view().zeroRegisters() == 16u);
+    simulator.addDistinct(100'000u);
+    REQUIRE(simulator.view().zeroRegisters() == 0u);
+}
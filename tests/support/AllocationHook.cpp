@@ -0,0 +1,29 @@
+#include <cstdlib>
+#include <new>
+
+#include "satp/simulation/detail/metrics/AllocationCounter.h"
+
+// Sostituisce operator new/delete globali per contare le allocazioni per
+// thread (vedi AllocationCounter). new[], nothrow e le varianti allineate di
+// libstdc++ passano da qui o da aligned_alloc/free, compatibili con free().
+
+namespace {
+    [[maybe_unused]] const bool hookInstalled = [] {
+        satp::evaluation::AllocationCounter::markInstalled();
+        return true;
+    }();
+} // namespace
+
+void *operator new(const std::size_t bytes) {
+    satp::evaluation::AllocationCounter::record(bytes);
+    if (void *ptr = std::malloc(bytes == 0u ? 1u : bytes)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}